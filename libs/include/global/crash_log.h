@@ -0,0 +1,122 @@
+/** ****************************************************************************
+ * @file   crash_log.h
+ *
+ * @author Michael R.
+ *
+ * @brief  Crash-surviving RAM log ring and post-mortem dump
+ *
+ * Every debug message is also copied into a ring in uninitialised RAM, which
+ * keeps its content over a watchdog or software reset. panic(), hard faults
+ * and the FreeRTOS hooks store the reason, task, core and registers next to
+ * it and reboot. On the next boot the ring of the previous run is frozen
+ * (the new messages go to a second ring) and replayed once WLAN is up.
+ *
+ * Records are checked by a marker, length and checksum, the ring header and
+ * the crash info by a check word / CRC, so a cold start or a partly written
+ * record is detected and skipped.
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+#ifndef CRASH_LOG_H
+#define CRASH_LOG_H
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// pico-sdk includes
+// FreeRTOS includes
+// Project includes
+#include "global/error_types.h"
+
+/* --- Public macro definitions --------------------------------------------- */
+
+/** Size of one ring (power of 2), two rings are kept */
+#ifndef CRASH_LOG_SIZE
+    #define CRASH_LOG_SIZE (4096U)
+#endif
+
+/** Delay of the reboot after a crash, the UART gets the chance to drain */
+#ifndef CRASH_LOG_REBOOT_MS
+    #define CRASH_LOG_REBOOT_MS (100U)
+#endif
+
+#define CRASH_LOG_REASON_SIZE (64U)
+#define CRASH_LOG_TASK_SIZE   (16U)
+
+/* --- Public type/struct definitions --------------------------------------- */
+
+/**
+ * @brief Kind of the crash
+ */
+typedef enum eCrashKind_tag
+{
+    CrashNone,
+    CrashPanic,             ///< panic(), also the malloc failed hook
+    CrashHardFault,         ///< Hard fault, registers are valid
+    CrashStackOverflow,     ///< FreeRTOS stack overflow hook
+    NumCrashKind
+} eCrashKind_t;
+
+/**
+ * @brief Post-mortem data of the previous run
+ */
+typedef struct sCrashInfo_tag
+{
+    uint32_t uKind;                         ///< eCrashKind_t
+    uint32_t uCore;
+    uint32_t uUptimeMs;
+    uint32_t uaRegs[8];                     ///< r0-r3, r12, lr, pc, xpsr (hard fault only)
+    uint32_t uSp;                           ///< Stack pointer at the crash
+    char caTask[CRASH_LOG_TASK_SIZE];
+    char caReason[CRASH_LOG_REASON_SIZE];
+    uint32_t uCrc;                          ///< CRC-32 of the fields above
+} sCrashInfo_t;
+
+/* --- Public variables ----------------------------------------------------- */
+
+/* --- Public function prototypes ------------------------------------------- */
+
+/**
+ * @brief Pre-FreeRTOS initialisiation
+ *
+ * Checks and freezes the ring of the previous run and installs the hard fault
+ * handler. Must be called before the first debug message.
+ *
+ * @return eRetVal_t Returns success/error
+ */
+eRetVal_t eCrashLogPreInit(void);
+
+/**
+ * @brief Append a message to the ring
+ *
+ * Not thread-safe, the caller serialises (debug message semaphore).
+ *
+ * @param cpText Message
+ * @param uLen   Length of the message, at most 255
+ */
+void vCrashLogWrite(const char *cpText, const uint16_t uLen);
+
+/**
+ * @brief Record a fatal error and reboot
+ *
+ * @param eKind    Kind of the crash
+ * @param cpTask   Task name or NULL for the current task
+ * @param cpReason Reason text
+ */
+void vCrashLogFatal(const eCrashKind_t eKind, const char *cpTask, const char *cpReason)
+    __attribute__((noreturn));
+
+/**
+ * @brief Replacement of the pico-sdk panic output (PICO_PANIC_FUNCTION)
+ *
+ * @param cpFormat Format string
+ * @param ...      Arguments
+ */
+void vCrashLogPanic(const char *cpFormat, ...)
+    __attribute__((noreturn, format(printf, 1, 2)));
+
+#endif /* CRASH_LOG_H */
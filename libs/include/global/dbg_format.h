@@ -0,0 +1,73 @@
+/** ****************************************************************************
+ * @file   dbg_format.h
+ *
+ * @author Michael R.
+ *
+ * @brief  Small printf-style formatter used by DBG_PR
+ *
+ * Writes directly into the caller's buffer, needs no heap, no locks and no
+ * newlib reentrancy structures. The target's -fstack-usage output is the
+ * reference for the stack use; on an x86-64 host (-O2) uDbgVFormat with
+ * vDbgEmit takes 272 bytes. Supported is the subset used in the project:
+ *
+ * - <code>%d %i %u %x %X %o %c %s %p %%</code>
+ * - flags <code>- 0 + space</code>, width and precision (also <code>*</code>)
+ * - length modifiers <code>hh h l ll z</code>
+ * - <code>%f</code> as fixed-point with up to 9 decimals (default 6),
+ *   values beyond +/-2^64 are printed as "ovf"
+ *
+ * Unknown conversions are copied unchanged.
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+#ifndef DBG_FORMAT_H
+#define DBG_FORMAT_H
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdarg.h>
+#include <stdint.h>
+
+// pico-sdk includes
+// FreeRTOS includes
+// Project includes
+
+/* --- Public macro definitions --------------------------------------------- */
+
+/* --- Public type/struct definitions --------------------------------------- */
+
+/* --- Public variables ----------------------------------------------------- */
+
+/* --- Public function prototypes ------------------------------------------- */
+
+/**
+ * @brief Format into a buffer, like vsnprintf
+ *
+ * The output is always zero terminated (if uSize > 0) and truncated if
+ * needed.
+ *
+ * @param cpBuffer Target
+ * @param uSize    Size of the target including the terminating zero
+ * @param cpFormat Format string
+ * @param xArgs    Arguments
+ *
+ * @return Number of characters written (without the terminating zero)
+ */
+uint32_t uDbgVFormat(char *const cpBuffer, const uint32_t uSize, const char *cpFormat, va_list xArgs);
+
+/**
+ * @brief Format into a buffer, like snprintf
+ *
+ * @param cpBuffer Target
+ * @param uSize    Size of the target including the terminating zero
+ * @param cpFormat Format string
+ * @param ...      Arguments
+ *
+ * @return Number of characters written (without the terminating zero)
+ */
+uint32_t uDbgFormat(char *const cpBuffer, const uint32_t uSize, const char *cpFormat, ...)
+    __attribute__((format(printf, 3, 4)));
+
+#endif /* DBG_FORMAT_H */
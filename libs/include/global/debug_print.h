@@ -5,6 +5,17 @@
  *
  * @brief  Functions for debug-prints with debug-level.
  *
+ * A message is formatted once into a record. The record is handed by
+ * reference to every registered sink (output) whose level admits it. Each
+ * sink has its own level, can be switched on and off and is either
+ *  - direct: its write function runs in the printing task and must only copy
+ *    the text into a buffer of its own (stdout ring, stream queue, flash log
+ *    image, crash log), or
+ *  - queued: the record is copied into the sink's own slot queue and written
+ *    later by the "LogSink" task, in batches (uBatch records or after
+ *    uFlushMs). A full queue drops the record for this sink only.
+ * A slow sink therefore never delays the printing task or the other sinks.
+ *
  * @date   2023-08-26
  **************************************************************************** */
 
@@ -15,16 +26,39 @@
 
 // libc includes
 #include <stdarg.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 // pico-sdk includes
 // FreeRTOS includes
+#include "FreeRTOS.h" /* Must come first. */
+
 // Project includes
 #include "global/error_types.h"
+#include "global/spsc_ring.h"
 
 
 /* --- Public macro definitions --------------------------------------------- */
 
+/** Default burst of distinct messages per call-site (0 = no limit) */
+#ifndef DEFAULT_DEBUG_RATE_BURST
+    #define DEFAULT_DEBUG_RATE_BURST (10U)
+#endif
+
+/** Default refill of the burst in messages per second per call-site */
+#ifndef DEFAULT_DEBUG_RATE_PER_SEC
+    #define DEFAULT_DEBUG_RATE_PER_SEC (2U)
+#endif
+
+/** Longest record including the terminating zero, same as MAX_UDP_BUFFER */
+#define DEBUG_MSG_SIZE (128U)
+
+/** Call-sites tracked at the same time (power of 2) */
+#define DEBUG_SITES (32U)
+
+/** A folded repetition is reported at the latest after this time */
+#define DEBUG_REPEAT_FLUSH_MS (5000U)
+
 #ifndef __FILE_NAME__
 #define __FILE_NAME__ __FILE__
 #endif
@@ -75,9 +109,78 @@ typedef enum function_tag
     FN_WLAN,
     FN_SNTP,
     FN_TCPUDP,
+    FN_TELEMETRY,
+    FN_HTTP,
+    FN_MQTT,
+    FN_CTRL,
+    FN_POWER,
     NumCl
 } function_t;
 
+/**
+ * @brief A formatted message, handed to the sinks by reference
+ */
+typedef struct sDebugRecord_tag
+{
+    char *cpText;              ///< Zero terminated, sinks must not change it
+    uint16_t uLen;             ///< Length of the text without the zero
+    logLevel_t eLevel;
+    function_t eFunction;
+    uint8_t uCore;
+    bool bReplay;              ///< Replayed from a store (@ref vDebugPrintRaw)
+} sDebugRecord_t;
+
+/**
+ * @brief Write function of a sink
+ *
+ * Direct sinks: called by the printing task with the message mutex held,
+ * must not block. Queued sinks: called by the LogSink task.
+ *
+ * @param sRecord Record, only valid during the call
+ * @param pvCtx   Context given to @ref eDebugSinkAdd
+ *
+ * @return false if the record was not taken: dropped (direct) or kept for a
+ *         retry after the flush time (queued)
+ */
+typedef bool (*pfDebugSinkWrite_t)(const sDebugRecord_t *const sRecord, void *pvCtx);
+
+/**
+ * @brief Flush function of a queued sink, called after a batch was written
+ *
+ * @param pvCtx Context given to @ref eDebugSinkAdd
+ */
+typedef void (*pfDebugSinkFlush_t)(void *pvCtx);
+
+/**
+ * @brief Slot of a sink queue, record and its copy of the text
+ */
+typedef struct sDebugSlot_tag
+{
+    sDebugRecord_t sRecord;
+    char caText[DEBUG_MSG_SIZE];
+} sDebugSlot_t;
+
+/**
+ * @brief Sink, owned by the caller (static). Use a record only once.
+ */
+typedef struct sDebugSink_tag
+{
+    struct sDebugSink_tag *volatile sNext;
+    const char *cpName;            ///< Name for the remote control
+    pfDebugSinkWrite_t pfWrite;
+    pfDebugSinkFlush_t pfFlush;    ///< Queued sinks only, may be NULL
+    void *pvCtx;
+    volatile logLevel_t eLevel;    ///< Records up to this level are written
+    volatile bool bEnabled;
+    sSpscRing_t sQueue;            ///< Slots of a queued sink, pSlots NULL = direct
+    uint32_t uBatch;               ///< Queued: write at once from this fill on
+    TickType_t xFlush;             ///< Queued: latest write after the first record
+    TickType_t xDue;               ///< Queued: LogSink task only
+    bool bPending;                 ///< Queued: LogSink task only
+    volatile bool bFlushReq;       ///< Queued: call pfFlush at the next run
+    volatile uint32_t uDropped;    ///< Records this sink lost
+} sDebugSink_t;
+
 /* --- Public variables ----------------------------------------------------- */
 
 /* --- Public function prototypes ------------------------------------------- */
@@ -109,6 +212,121 @@ eRetVal_t eDebugRtosInit(void);
  */
 void vDebugSetSeverity(const function_t eFunction, const logLevel_t eSeverity);
 
+
+/**
+ * @brief Get the severity-level of selected class
+ *
+ * @param eFunction  Selecting the class
+ *
+ * @return Current severity, DBG_OFF for an invalid class
+ */
+logLevel_t eDebugGetSeverity(const function_t eFunction);
+
+
+/**
+ * @brief Change the rate limit of selected class
+ *
+ * Each call-site (file and line) of the class may print uBurst distinct
+ * messages in a row, after that uPerSec messages per second. Identical
+ * repeated messages are folded independently of the limit.
+ *
+ * @param eFunction  Selecting the class that limit to be changed
+ * @param uBurst     Messages in a row, 0 disables the limit
+ * @param uPerSec    Messages per second after the burst
+ */
+void vDebugSetRateLimit(const function_t eFunction, const uint16_t uBurst, const uint16_t uPerSec);
+
+
+/**
+ * @brief Register a direct sink, see @ref pfDebugSinkWrite_t
+ *
+ * Sinks are written in the order they were added.
+ *
+ * @param sSink   Sink record (static)
+ * @param cpName  Name, also for @ref sDebugSinkFind
+ * @param pfWrite Write function
+ * @param pvCtx   Context of the write and flush function
+ * @param eLevel  Initial level, records up to this level are written
+ *
+ * @return ErrNoError, ErrError if the record is already in use
+ */
+eRetVal_t eDebugSinkAdd(
+    sDebugSink_t *const sSink,
+    const char *const cpName,
+    const pfDebugSinkWrite_t pfWrite,
+    void *const pvCtx,
+    const logLevel_t eLevel);
+
+/**
+ * @brief Make a sink queued, call before @ref eDebugSinkAdd
+ *
+ * @param sSink    Sink record
+ * @param saSlots  Slot memory (static)
+ * @param uSlots   Number of slots, power of 2
+ * @param uBatch   Write at once when this many records wait, 1 = always
+ * @param uFlushMs Write at the latest this long after the first record
+ * @param pfFlush  Called after each batch, may be NULL
+ */
+void vDebugSinkSetQueue(
+    sDebugSink_t *const sSink,
+    sDebugSlot_t *const saSlots,
+    const uint32_t uSlots,
+    const uint32_t uBatch,
+    const uint32_t uFlushMs,
+    const pfDebugSinkFlush_t pfFlush);
+
+/**
+ * @brief Let the LogSink task call the flush function of a queued sink
+ *
+ * Only sets a flag and wakes the task, never blocks (e.g. timer callbacks).
+ *
+ * @param sSink Queued sink with a flush function
+ */
+void vDebugSinkRequestFlush(sDebugSink_t *const sSink);
+
+/**
+ * @brief Find a registered sink by its name
+ *
+ * @param cpName Name
+ *
+ * @return Sink, NULL if not found
+ */
+sDebugSink_t *sDebugSinkFind(const char *cpName);
+
+/**
+ * @brief First registered sink, continue with sNext
+ *
+ * @return Sink, NULL if there is none
+ */
+sDebugSink_t *sDebugSinkFirst(void);
+
+/**
+ * @brief Enable or disable a sink
+ *
+ * @param sSink   Sink
+ * @param bEnable true to enable
+ */
+void vDebugSinkEnable(sDebugSink_t *const sSink, const bool bEnable);
+
+/**
+ * @brief Change the level of a sink
+ *
+ * @param sSink  Sink
+ * @param eLevel Records up to this level are written, DBG_OFF = none
+ */
+void vDebugSinkSetLevel(sDebugSink_t *const sSink, const logLevel_t eLevel);
+
+
+/**
+ * @brief Print a preformatted text without prefix and limits
+ *
+ * Used for replaying stored messages, the crash and flash log sinks skip
+ * it. Waits for the message buffer.
+ *
+ * @param cpText Text, at most DEBUG_MSG_SIZE - 1 characters
+ */
+void vDebugPrintRaw(char *const cpText);
+
 /**
  * @brief A private function that does the actual printing
  *
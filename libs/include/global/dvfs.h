@@ -0,0 +1,97 @@
+/** ****************************************************************************
+ * @file   dvfs.h
+ *
+ * @author Michael R.
+ *
+ * @brief  Load driven system clock and core voltage governor
+ *
+ * The FreeRTOS idle hooks of both cores (@ref vDvfsIdle) sum up the idle
+ * time. Every DVFS_PERIOD_MS the governor task turns it into the load of each
+ * core, lets @ref dvfs_policy.h pick a clock step for the busier one and
+ * switches sys_clk and the core voltage.
+ *
+ * Safe bounds: the fastest step is the SDK default clock (SYS_CLK_KHZ) at
+ * the default voltage, the governor never clocks above it. The voltage is
+ * only lowered on the slow steps, raised before and lowered after the clock
+ * change. The FreeRTOS tick runs from the 1 MHz reference
+ * (configSYSTICK_CLOCK_HZ) and stays exact across a change.
+ *
+ * Off by default (measure only): clk_peri follows sys_clk, so every user of
+ * SPI/I2C/UART/PWM has to set its divider again on EventClockChanged.
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+#ifndef DVFS_H
+#define DVFS_H
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdint.h>
+
+// pico-sdk includes
+// FreeRTOS includes
+// Project includes
+#include "global/dvfs_policy.h"
+#include "global/error_types.h"
+
+/* --- Public macro definitions --------------------------------------------- */
+
+/** 1 = the governor changes the clock, 0 = only the load is measured */
+#ifndef DVFS_ENABLED
+    #define DVFS_ENABLED (0U)
+#endif
+
+/** Decision period */
+#ifndef DVFS_PERIOD_MS
+    #define DVFS_PERIOD_MS (100UL)
+#endif
+
+/** 1 = lower the core voltage on the slow steps, below the datasheet values */
+#ifndef DVFS_VOLTAGE
+    #define DVFS_VOLTAGE (0U)
+#endif
+
+/* --- Public type/struct definitions --------------------------------------- */
+
+/* --- Public variables ----------------------------------------------------- */
+
+/* --- Public function prototypes ------------------------------------------- */
+
+/**
+ * @brief FreeRTOS related initialisation (starts the governor task)
+ *
+ * @return eRetVal_t Returns success/error
+ */
+eRetVal_t eDvfsRtosInit(void);
+
+/**
+ * @brief Idle time accounting, called by the idle hooks of both cores
+ */
+void vDvfsIdle(void);
+
+/**
+ * @brief Time the own core slept in the idle hook (tickless idle)
+ *
+ * @param uSleptUs Time slept in us, counted as idle
+ */
+void vDvfsIdleSlept(const uint32_t uSleptUs);
+
+/**
+ * @brief Change the settings of the governor
+ *
+ * @param sPolicy New settings
+ *
+ * @return ErrNoError, ErrError if the settings are not usable
+ */
+eRetVal_t eDvfsSetPolicy(const sDvfsPolicy_t *const sPolicy);
+
+/**
+ * @brief Current settings of the governor
+ *
+ * @param sPolicy Target for the settings
+ */
+void vDvfsGetPolicy(sDvfsPolicy_t *const sPolicy);
+
+#endif /* DVFS_H */
@@ -0,0 +1,128 @@
+/** ****************************************************************************
+ * @file   dvfs_policy.h
+ *
+ * @author Michael R.
+ *
+ * @brief  Decision logic of the system clock governor
+ *
+ * Once per period the governor hands in the load of the busiest core and
+ * gets the clock step to run at. The logic knows nothing about the hardware:
+ * @ref dvfs.h applies the step, the host simulator in
+ * <code>tools/dvfs_sim</code> replays load traces through it unchanged.
+ *
+ * The rules (similar to the Linux "ondemand" governor):
+ *  - busy >= uUpPermille: straight to the fastest step, a burst shall not
+ *    wait for a slow ramp
+ *  - otherwise the lowest step at which the same work would keep the core
+ *    at most uTargetPermille busy
+ *  - a higher step is taken at once, a lower one only after uDownPeriods
+ *    periods in a row asked for it
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+#ifndef DVFS_POLICY_H
+#define DVFS_POLICY_H
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdint.h>
+
+// pico-sdk includes
+// FreeRTOS includes
+// Project includes
+
+/* --- Public macro definitions --------------------------------------------- */
+
+/** Load at which the governor jumps to the fastest step */
+#ifndef DVFS_UP_PERMILLE
+    #define DVFS_UP_PERMILLE (800UL)
+#endif
+
+/** Load the governor aims for after a step down */
+#ifndef DVFS_TARGET_PERMILLE
+    #define DVFS_TARGET_PERMILLE (600UL)
+#endif
+
+/** Periods in a row asking for a lower step before it is taken */
+#ifndef DVFS_DOWN_PERIODS
+    #define DVFS_DOWN_PERIODS (5UL)
+#endif
+
+/* --- Public type/struct definitions --------------------------------------- */
+
+/**
+ * @brief Settings, may be changed between two decisions
+ */
+typedef struct sDvfsPolicy_tag
+{
+    uint32_t uUpPermille;
+    uint32_t uTargetPermille;  ///< Below uUpPermille, otherwise it oscillates
+    uint32_t uDownPeriods;
+} sDvfsPolicy_t;
+
+/**
+ * @brief State of the decision
+ */
+typedef struct sDvfsDecision_tag
+{
+    uint32_t uStep;            ///< Current step, index into the step table
+    uint32_t uLower;           ///< Periods in a row asking for a lower step
+} sDvfsDecision_t;
+
+/* --- Public variables ----------------------------------------------------- */
+
+
+/* --- Public function prototypes ------------------------------------------- */
+
+/**
+ * @brief Next clock step for the load of the last period
+ *
+ * @param sState        State, uStep is updated
+ * @param sPolicy       Settings
+ * @param uaStepKhz     Clock of each step, ascending
+ * @param uSteps        Number of steps
+ * @param uBusyPermille Load of the busiest core at the current step
+ *
+ * @return New step (also in sState->uStep)
+ */
+static inline uint32_t uDvfsDecide(
+    sDvfsDecision_t *const sState,
+    const sDvfsPolicy_t *const sPolicy,
+    const uint32_t *const uaStepKhz,
+    const uint32_t uSteps,
+    const uint32_t uBusyPermille)
+{
+    const uint64_t uWork = (uint64_t)uBusyPermille * uaStepKhz[sState->uStep];
+    uint32_t uWanted = 0UL;
+
+    if (uBusyPermille >= sPolicy->uUpPermille)
+    {
+        uWanted = uSteps - 1UL;
+    }
+    else
+    {
+        // Same work at another clock: busy scales with 1 / clock
+        while (((uWanted + 1UL) < uSteps) &&
+               (uWork > ((uint64_t)sPolicy->uTargetPermille * uaStepKhz[uWanted])))
+        {
+            uWanted++;
+        }
+    }
+
+    if (uWanted >= sState->uStep)
+    {
+        sState->uLower = 0UL;
+        sState->uStep = uWanted;
+    }
+    else if (++sState->uLower >= sPolicy->uDownPeriods)
+    {
+        sState->uLower = 0UL;
+        sState->uStep = uWanted;
+    }
+
+    return (sState->uStep);
+}
+
+#endif /* DVFS_POLICY_H */
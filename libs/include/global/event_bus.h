@@ -0,0 +1,151 @@
+/** ****************************************************************************
+ * @file   event_bus.h
+ *
+ * @author Michael R.
+ *
+ * @brief  Publish/subscribe of framework events between the modules
+ *
+ * A module publishes an event without knowing who listens, the listeners
+ * subscribe in their own init function. Subscriptions are records owned by
+ * the subscriber (static), so there is no allocation and a publish only
+ * walks the list of the event.
+ *
+ * A subscriber either
+ *  - gets a function call in the publisher's task (short, must not block),
+ *  - or gets notification bits set on its task (eSetBits) and reads the
+ *    argument with @ref uEventLast.
+ *
+ * Function subscribers are called in @ref eEventOrder_t order, equal orders
+ * in the order of subscription. Events are delivered from the subscription
+ * on; subscribe during the init to see the first one.
+ *
+ * Publish from tasks only (the lwIP thread counts as a task).
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+#ifndef EVENT_BUS_H
+#define EVENT_BUS_H
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdint.h>
+
+// pico-sdk includes
+// FreeRTOS includes
+#include "FreeRTOS.h" /* Must come first. */
+#include "task.h"
+
+// Project includes
+
+/* --- Public macro definitions --------------------------------------------- */
+
+
+/* --- Public type/struct definitions --------------------------------------- */
+
+/**
+ * @brief All events with the meaning of their argument
+ */
+typedef enum eEvent_tag
+{
+    EventLinkUp,          ///< WLAN connected, IPv4 address (lwIP byte order)
+    EventLinkDown,        ///< WLAN lost, 0
+    EventTimeSynced,      ///< SNTP update, Unix time in s
+    EventConfigChanged,   ///< Runtime setting changed, @ref eEventConfig_t
+    EventClockChanged,    ///< sys_clk changed (and clk_peri with it), kHz
+    NumEvent
+} eEvent_t;
+
+/**
+ * @brief Argument of EventConfigChanged
+ */
+typedef enum eEventConfig_tag
+{
+    EventCfgLogLevel,     ///< Debug level of a class
+    EventCfgLogSink,      ///< Debug sink switched on/off or its level changed
+    EventCfgLogRate,      ///< Debug rate limit of a class
+    EventCfgDvfs,         ///< Clock governor settings
+} eEventConfig_t;
+
+/**
+ * @brief Call order of function subscribers
+ */
+typedef enum eEventOrder_tag
+{
+    EventOrderFirst,      ///< State caches others rely on
+    EventOrderNormal,
+    EventOrderLast,       ///< Users of the other services
+} eEventOrder_t;
+
+/**
+ * @brief Function subscriber
+ *
+ * @param eEvent Event
+ * @param uArg   Argument, see @ref eEvent_t
+ */
+typedef void (*pfEventHandler_t)(const eEvent_t eEvent, const uint32_t uArg);
+
+/**
+ * @brief Subscription, owned by the subscriber. Use a record only once.
+ */
+typedef struct sEventSub_tag
+{
+    struct sEventSub_tag *volatile sNext;
+    pfEventHandler_t pfHandler;   ///< NULL: notify xTask
+    TaskHandle_t xTask;
+    uint32_t uBits;
+    eEventOrder_t eOrder;
+} sEventSub_t;
+
+/* --- Public variables ----------------------------------------------------- */
+
+
+/* --- Public function prototypes ------------------------------------------- */
+
+/**
+ * @brief Subscribe a function, called in the publisher's task
+ *
+ * @param sSub      Subscription record (static)
+ * @param eEvent    Event
+ * @param pfHandler Function
+ * @param eOrder    Position among the function subscribers
+ */
+void vEventSubscribe(
+    sEventSub_t *const sSub,
+    const eEvent_t eEvent,
+    const pfEventHandler_t pfHandler,
+    const eEventOrder_t eOrder);
+
+/**
+ * @brief Subscribe a task, the event sets uBits in its notification value
+ *
+ * @param sSub   Subscription record (static)
+ * @param eEvent Event
+ * @param xTask  Task
+ * @param uBits  Notification bits
+ */
+void vEventSubscribeTask(
+    sEventSub_t *const sSub,
+    const eEvent_t eEvent,
+    const TaskHandle_t xTask,
+    const uint32_t uBits);
+
+/**
+ * @brief Deliver an event to all subscribers
+ *
+ * @param eEvent Event
+ * @param uArg   Argument, see @ref eEvent_t
+ */
+void vEventPublish(const eEvent_t eEvent, const uint32_t uArg);
+
+/**
+ * @brief Argument of the last publication of an event
+ *
+ * @param eEvent Event
+ *
+ * @return Argument, 0 if never published
+ */
+uint32_t uEventLast(const eEvent_t eEvent);
+
+#endif /* EVENT_BUS_H */
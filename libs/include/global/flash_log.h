@@ -0,0 +1,164 @@
+/** ****************************************************************************
+ * @file   flash_log.h
+ *
+ * @author Michael R.
+ *
+ * @brief  Wear-levelled log store in the last sectors of the flash
+ *
+ * The debug messages are collected in a RAM image of one flash sector and
+ * written by a background task: complete pages every FLASH_LOG_FLUSH_MS, the
+ * rest when the sector is full. The sectors are used as a ring (log
+ * structured), so every sector is erased equally often. Each sector starts
+ * with a header holding a sequence number; at boot only these headers are
+ * read to rebuild the index. Every record is protected by a CRC-32.
+ *
+ * Erasing or programming stops the XIP execution of both cores. Programming
+ * is split so a single stop stays below FLASH_LOG_STALL_US; erasing one
+ * sector is the smallest possible step and typically takes longer. The
+ * measured stalls are in the histogram <code>flash_stall_us</code>.
+ *
+ * The records are downloaded via HTTP, e.g.
+ * <code>GET /log?from=1700000000&to=1700003600&level=2</code>.
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+#ifndef FLASH_LOG_H
+#define FLASH_LOG_H
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// pico-sdk includes
+// FreeRTOS includes
+// Project includes
+#include "global/error_types.h"
+#include "global/debug_print.h"
+
+/* --- Public macro definitions --------------------------------------------- */
+
+/** Number of 4 kB sectors at the end of the flash used for the log */
+#ifndef FLASH_LOG_SECTORS
+    #define FLASH_LOG_SECTORS (64U)
+#endif
+
+/** Initial level of the "flash" debug sink, messages up to it are stored */
+#ifndef FLASH_LOG_LEVEL
+    #define FLASH_LOG_LEVEL (DBG_INFO)
+#endif
+
+/** Interval for writing the completed pages of the current sector */
+#ifndef FLASH_LOG_FLUSH_MS
+    #define FLASH_LOG_FLUSH_MS (60UL * 1000UL)
+#endif
+
+/** Upper limit of a single XIP stall while programming */
+#ifndef FLASH_LOG_STALL_US
+    #define FLASH_LOG_STALL_US (2000UL)
+#endif
+
+/** Longest stored text (debug message buffer) */
+#define FLASH_LOG_MAX_TEXT (128U)
+
+/* --- Public type/struct definitions --------------------------------------- */
+
+/**
+ * @brief One record returned by a query
+ */
+typedef struct sFlashLogRecord_tag
+{
+    uint32_t uTime;                         ///< Unix time in s (uptime before SNTP)
+    logLevel_t eLevel;
+    function_t eFunction;
+    uint16_t uLen;
+    char caText[FLASH_LOG_MAX_TEXT + 1U];   ///< Zero terminated
+} sFlashLogRecord_t;
+
+/**
+ * @brief Result of a query step
+ */
+typedef enum eFlashLogQueryResult_tag
+{
+    FlashLogQueryRecord,                    ///< Record returned
+    FlashLogQueryPending,                   ///< Nothing found yet, call again
+    FlashLogQueryEnd                        ///< No more records
+} eFlashLogQueryResult_t;
+
+/**
+ * @brief Position and filter of a query
+ */
+typedef struct sFlashLogQuery_tag
+{
+    uint32_t uFrom;
+    uint32_t uTo;
+    logLevel_t eLevel;                      ///< Records up to this level
+    uint32_t uSeq;                          ///< Sequence number of the sector
+    uint32_t uOffset;                       ///< Next record within the sector
+} sFlashLogQuery_t;
+
+/* --- Public variables ----------------------------------------------------- */
+
+/* --- Public function prototypes ------------------------------------------- */
+
+/**
+ * @brief Pre-FreeRTOS initialisiation, scans the sector headers
+ *
+ * @return eRetVal_t Returns success/error
+ */
+eRetVal_t eFlashLogPreInit(void);
+
+/**
+ * @brief FreeRTOS related initialisation (starts the writer task)
+ *
+ * @return eRetVal_t Returns success/error
+ */
+eRetVal_t eFlashLogRtosInit(void);
+
+/**
+ * @brief Add a message to the RAM image
+ *
+ * Only copies, never touches the flash. Not thread-safe, the caller
+ * serialises (debug message semaphore).
+ *
+ * @param eLevel    Level of the message
+ * @param eFunction Class of the message
+ * @param cpText    Message
+ * @param uLen      Length of the message
+ */
+void vFlashLogWrite(const logLevel_t eLevel, const function_t eFunction, const char *cpText, uint16_t uLen);
+
+/**
+ * @brief Start a query, records still in RAM are not included
+ *
+ * Records from before the SNTP sync carry the uptime, so the times are not
+ * in order and every query checks the whole log.
+ *
+ * @param sQuery Query
+ * @param uFrom  First time (unix s), 0 = oldest
+ * @param uTo    Last time (unix s), UINT32_MAX = newest
+ * @param eLevel Records up to this level
+ */
+void vFlashLogQueryStart(
+    sFlashLogQuery_t *const sQuery,
+    const uint32_t uFrom,
+    const uint32_t uTo,
+    const logLevel_t eLevel);
+
+/**
+ * @brief Get the next matching record, oldest first
+ *
+ * Checks at most a few records per call, a query over the whole log is
+ * spread over many calls.
+ *
+ * @param sQuery  Query
+ * @param sRecord Target
+ *
+ * @return FlashLogQueryRecord with sRecord filled, FlashLogQueryPending if
+ *         the step ended without a match or FlashLogQueryEnd
+ */
+eFlashLogQueryResult_t eFlashLogQueryNext(sFlashLogQuery_t *const sQuery, sFlashLogRecord_t *const sRecord);
+
+#endif /* FLASH_LOG_H */
@@ -0,0 +1,124 @@
+/** ****************************************************************************
+ * @file   log_lz.h
+ *
+ * @author Michael R.
+ *
+ * @brief  Small LZSS compressor for the network log stream
+ *
+ * Text is appended line by line and compressed right away, so the work is
+ * spread over the DBG_PR calls. Each block (one UDP datagram) can be
+ * decompressed on its own: the window holds a preset dictionary with the
+ * usual log prefixes plus the data of the current block only. A lost
+ * datagram does not affect the following ones.
+ *
+ * Format: groups of a flag byte followed by 8 items (LSB first). Flag bit 1
+ * is a literal byte, 0 a match of two bytes (big endian)
+ * <code>(distance - 1) << 4 | (length - 3)</code>, distance 1..4096,
+ * length 3..18. The decoder is <code>tools/log_lz/log_lz.py</code>.
+ * No dependencies, the same code is used by the host tools.
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+#ifndef LOG_LZ_H
+#define LOG_LZ_H
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// pico-sdk includes
+// FreeRTOS includes
+// Project includes
+
+/* --- Public macro definitions --------------------------------------------- */
+
+/** Raw text per block (dictionary + block must not exceed 4096) */
+#ifndef LOG_LZ_BLOCK
+    #define LOG_LZ_BLOCK (2048U)
+#endif
+
+/** Number of hash chain entries tested per position (CPU vs. ratio) */
+#ifndef LOG_LZ_DEPTH
+    #define LOG_LZ_DEPTH (8U)
+#endif
+
+/** Entries of the hash table (power of 2) */
+#define LOG_LZ_HASH_SIZE  (1024U)
+
+/** Size of the preset dictionary */
+#define LOG_LZ_DICT_SIZE  (128U)
+
+#define LOG_LZ_MIN_MATCH  (3U)
+#define LOG_LZ_MAX_MATCH  (18U)
+
+/** Worst case output for uLen input bytes */
+#define LOG_LZ_BOUND(_LEN) ((_LEN) + ((_LEN) + 7U) / 8U)
+
+/* --- Public type/struct definitions --------------------------------------- */
+
+/**
+ * @brief Compressor state, about 3 * LOG_LZ_BLOCK + 2.4 kB
+ */
+typedef struct sLogLz_tag
+{
+    uint8_t uaWindow[LOG_LZ_DICT_SIZE + LOG_LZ_BLOCK];
+    uint16_t uaPrev[LOG_LZ_DICT_SIZE + LOG_LZ_BLOCK];
+    uint16_t uaHead[LOG_LZ_HASH_SIZE];
+    uint16_t uEnd;            ///< End of the data in uaWindow
+
+    uint8_t *pOut;
+    uint16_t uOutSize;
+    uint16_t uOutPos;
+    uint16_t uFlagPos;        ///< Position of the current flag byte
+    uint8_t uFlagBit;         ///< Next bit in the flag byte, 8 = none open
+} sLogLz_t;
+
+/* --- Public variables ----------------------------------------------------- */
+
+/* --- Public function prototypes ------------------------------------------- */
+
+/**
+ * @brief Start a new block
+ *
+ * @param sLz      Compressor
+ * @param pOut     Output buffer of the block
+ * @param uOutSize Size of the output buffer
+ */
+void vLogLzReset(sLogLz_t *const sLz, uint8_t *const pOut, const uint16_t uOutSize);
+
+/**
+ * @brief Compress and append data to the current block
+ *
+ * @param sLz   Compressor
+ * @param pData Data
+ * @param uLen  Length of the data
+ *
+ * @return false if the data does not fit into the block (nothing appended)
+ */
+bool bLogLzAppend(sLogLz_t *const sLz, const void *pData, const uint16_t uLen);
+
+/**
+ * @brief Raw bytes in the current block
+ *
+ * @param sLz Compressor
+ *
+ * @return Number of bytes
+ */
+uint16_t uLogLzRawLen(const sLogLz_t *const sLz);
+
+/**
+ * @brief Decompress one block (host tools, not used by the firmware)
+ *
+ * @param pIn      Compressed data (without the datagram header)
+ * @param uInLen   Length of the compressed data
+ * @param pOut     Output buffer
+ * @param uOutSize Size of the output buffer, at most LOG_LZ_BLOCK is needed
+ *
+ * @return Number of decompressed bytes, -1 if the data is corrupt
+ */
+int32_t iLogLzDecode(const uint8_t *pIn, const uint16_t uInLen, uint8_t *const pOut, const uint16_t uOutSize);
+
+#endif /* LOG_LZ_H */
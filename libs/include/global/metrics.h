@@ -0,0 +1,257 @@
+/** ****************************************************************************
+ * @file   metrics.h
+ *
+ * @author Michael R.
+ *
+ * @brief  Registry for counters, gauges and histograms.
+ *
+ * Counters and histograms are sharded per core. An update only touches the
+ * shard of the calling core with interrupts masked for the read-modify-write,
+ * so no lock or atomic instruction is needed (the M0+ has none). The shards
+ * are summed up when a snapshot is taken.
+ *
+ * Cost of an increment, counted from the Cortex-M0+ instruction timings (not
+ * measured): MRS/CPSID, the SIO CPUID load, load-add-store and MSR, about
+ * 15-20 cycles or 0.15 us at 125 MHz. The M33 of the RP2350 needs fewer.
+ *
+ * New metrics are added to @ref eMetric_t and the description table in
+ * metrics.c.
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdint.h>
+
+// pico-sdk includes
+#include "pico/platform.h"
+#include "hardware/sync.h"
+
+// FreeRTOS includes
+#include "FreeRTOS.h" /* Must come first. */
+
+// Project includes
+#include "global/error_types.h"
+
+/* --- Public macro definitions --------------------------------------------- */
+
+#ifndef METRICS_PORT
+    #define METRICS_PORT (54325U)
+#endif
+
+/** Export interval of the metrics snapshot, 0 disables the periodic export */
+#ifndef METRICS_EXPORT_MS
+    #define METRICS_EXPORT_MS (10UL * 1000UL)
+#endif
+
+/** Export format: 0 = Prometheus text, 1 = binary telemetry records */
+#ifndef METRICS_EXPORT_FORMAT
+    #define METRICS_EXPORT_FORMAT (0U)
+#endif
+
+/** Size of a rendered text snapshot, also used by the HTTP /metrics page */
+#define METRICS_TEXT_SIZE (12288U)
+
+/** Number of buckets per histogram, bucket n counts values < 2^n */
+#define METRICS_HISTO_BUCKETS (16U)
+
+/* --- Public type/struct definitions --------------------------------------- */
+
+/**
+ * @brief All counters
+ */
+typedef enum eMetricCounter_tag
+{
+    MetricLogDropped,       ///< DBG_PR messages dropped (buffer busy)
+    MetricWlanReconnects,   ///< WLAN connection attempts
+    MetricSntpSyncs,        ///< Time updates received via SNTP
+    MetricUdpSendFailed,    ///< UDP packets that could not be sent
+    MetricLogRawBytes,      ///< Log text handed to the compressor
+    MetricLogWireBytes,     ///< Compressed log datagrams sent
+    MetricMqttConnects,     ///< MQTT connection attempts
+    MetricMqttPublishes,    ///< MQTT PUBLISH packets sent
+    MetricMqttDropped,      ///< MQTT messages dropped (queue full)
+    MetricTlsFull,          ///< Full TLS handshakes
+    MetricTlsResumed,       ///< Abbreviated (resumed) TLS handshakes
+    MetricWsDropped,        ///< Stream frames dropped (client queue full)
+    MetricWsStalled,        ///< Stream clients dropped for not reading
+    MetricLogSuppressed,    ///< DBG_PR messages folded or rate limited
+    MetricFlashLogDropped,  ///< Messages not stored in the flash log
+    MetricFlashLogErases,   ///< Flash log sectors erased
+    MetricCtrlCommands,     ///< Remote control commands executed
+    MetricCtrlRejected,     ///< Remote control packets rejected (auth/replay)
+    MetricDvfsUp,           ///< Clock governor steps up
+    MetricDvfsDown,         ///< Clock governor steps down
+    MetricDvfsFailed,       ///< Clock changes the hardware refused
+    MetricTicklessSleeps,   ///< Sleeps of the tick core with the tick stopped
+    MetricCore0Wakeups,     ///< Wake-ups of core 0 from the idle sleep
+    MetricCore1Wakeups,     ///< Wake-ups of core 1 from the idle sleep
+    MetricCore0SleepMs,     ///< Time core 0 slept in the idle hook in ms
+    MetricCore1SleepMs,     ///< Time core 1 slept in the idle hook in ms
+    MetricPeriodicOverruns, ///< Periodic jobs finished after their deadline
+    MetricPeriodicSkipped,  ///< Periodic job releases dropped (a period behind)
+    MetricStdoutDropped,    ///< stdout writes dropped (ring full)
+    MetricStdoutDroppedBytes, ///< Bytes of the dropped stdout writes
+    MetricLogSinkDropped,   ///< Debug records a sink lost (queue full or refused)
+    MetricNetRxPackets,     ///< Frames from the CYW43 driver to lwIP
+    MetricNetRxBytes,       ///< Bytes of the received frames
+    MetricNetRxDropped,     ///< Received frames lwIP refused
+    MetricNetTxPackets,     ///< Frames from lwIP to the CYW43 driver
+    MetricNetTxBytes,       ///< Bytes of the sent frames
+    MetricNetTxFailed,      ///< Frames the CYW43 driver failed to send
+    MetricPcapPackets,      ///< Frames captured for the pcapng stream
+    MetricPcapDropped,      ///< Frames not captured (ring full or over budget)
+    NumMetricCounter
+} eMetricCounter_t;
+
+/**
+ * @brief All gauges
+ */
+typedef enum eMetricGauge_tag
+{
+    MetricFreeHeap,         ///< Free FreeRTOS heap in bytes
+    MetricMinFreeHeap,      ///< Lowest free FreeRTOS heap in bytes
+    MetricWsClients,        ///< Connected stream clients
+    MetricXipHitPermille,   ///< XIP cache hits per 1000 accesses (XIP_PROFILE)
+    MetricSysClkKhz,        ///< Current sys_clk in kHz
+    MetricCore0BusyPermille, ///< Load of core 0 in the last governor period
+    MetricCore1BusyPermille, ///< Load of core 1 in the last governor period
+    NumMetricGauge
+} eMetricGauge_t;
+
+/**
+ * @brief All histograms
+ */
+typedef enum eMetricHisto_tag
+{
+    MetricLogPrintUs,       ///< Time spent in _vDebugPrint in us
+    MetricLogFormatUs,      ///< Time spent formatting a DBG_PR message in us
+    MetricTlsHandshakeMs,   ///< Duration of TLS handshakes in ms
+    MetricFlashStallUs,     ///< XIP stall of a flash log erase/program in us
+    MetricLogUdpUs,         ///< Time spent sending a DBG_PR message via UDP in us
+    MetricLogXipMiss,       ///< XIP cache misses per DBG_PR message (XIP_PROFILE)
+    MetricUdpXipMiss,       ///< XIP cache misses per UDP log record (XIP_PROFILE)
+    MetricPeriodicJitterUs, ///< Start jitter of the periodic jobs in us
+    MetricPeriodicExecUs,   ///< Execution time of the periodic jobs in us
+    NumMetricHisto
+} eMetricHisto_t;
+
+/**
+ * @brief Per-core shard. Only written by its own core.
+ */
+typedef struct sMetricShard_tag
+{
+    uint32_t uaCounter[NumMetricCounter];
+    uint32_t uaHisto[NumMetricHisto][METRICS_HISTO_BUCKETS];
+    uint32_t uaHistoSum[NumMetricHisto];
+} sMetricShard_t;
+
+/**
+ * @brief Aggregated view of all shards
+ */
+typedef struct sMetricSnapshot_tag
+{
+    uint32_t uaCounter[NumMetricCounter];
+    int32_t iaGauge[NumMetricGauge];
+    uint32_t uaHisto[NumMetricHisto][METRICS_HISTO_BUCKETS];
+    uint32_t uaHistoSum[NumMetricHisto];
+} sMetricSnapshot_t;
+
+/* --- Public variables ----------------------------------------------------- */
+
+/** Shards, use the functions below to access them */
+extern sMetricShard_t saMetricShard[configNUMBER_OF_CORES];
+
+/** Gauges are single words, a plain store is atomic */
+extern volatile int32_t iaMetricGauge[NumMetricGauge];
+
+/* --- Public function prototypes ------------------------------------------- */
+
+/**
+ * @brief Add a value to a counter
+ *
+ * Safe to be called from tasks and interrupts on both cores.
+ *
+ * @param eCounter Counter
+ * @param uValue   Value to add
+ */
+static inline void vMetricsAdd(const eMetricCounter_t eCounter, const uint32_t uValue)
+{
+    const uint32_t uIrq = save_and_disable_interrupts();
+
+    saMetricShard[get_core_num()].uaCounter[eCounter] += uValue;
+
+    restore_interrupts(uIrq);
+}
+
+/**
+ * @brief Increment a counter by one
+ *
+ * @param eCounter Counter
+ */
+static inline void vMetricsInc(const eMetricCounter_t eCounter)
+{
+    vMetricsAdd(eCounter, 1UL);
+}
+
+/**
+ * @brief Set a gauge
+ *
+ * @param eGauge  Gauge
+ * @param iValue  New value
+ */
+static inline void vMetricsSet(const eMetricGauge_t eGauge, const int32_t iValue)
+{
+    iaMetricGauge[eGauge] = iValue;
+}
+
+/**
+ * @brief Add an observation to a histogram
+ *
+ * @param eHisto  Histogram
+ * @param uValue  Observed value
+ */
+void vMetricsObserve(const eMetricHisto_t eHisto, const uint32_t uValue);
+
+/**
+ * @brief FreeRTOS related initialisation (starts the exporter)
+ *
+ * @return eRetVal_t Returns success/error
+ */
+eRetVal_t eMetricsRtosInit(void);
+
+/**
+ * @brief Send a snapshot right away (outside the METRICS_EXPORT_MS period)
+ *
+ * Does nothing if the exporter is disabled.
+ */
+void vMetricsExportNow(void);
+
+/**
+ * @brief Sum up all shards
+ *
+ * @param sSnapshot Target
+ */
+void vMetricsSnapshot(sMetricSnapshot_t *const sSnapshot);
+
+/**
+ * @brief Render a snapshot in the Prometheus text exposition format
+ *
+ * @param sSnapshot  Snapshot to render
+ * @param cpBuffer   Target buffer
+ * @param uSize      Size of the target buffer
+ *
+ * @return Number of characters written (without the terminating zero),
+ *         uSize - 1 if the buffer was too small
+ */
+uint32_t uMetricsRenderText(
+    const sMetricSnapshot_t *const sSnapshot,
+    char *const cpBuffer,
+    const uint32_t uSize);
+
+#endif /* METRICS_H */
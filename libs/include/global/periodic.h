@@ -0,0 +1,144 @@
+/** ****************************************************************************
+ * @file   periodic.h
+ *
+ * @author Michael R.
+ *
+ * @brief  Periodic jobs run by a shared worker task per priority class
+ *
+ * A job is a function with a period, an offset of its first release, a
+ * deadline and a priority class. Instead of a task (and stack) per job, the
+ * jobs of a class share one worker task, created with the first job of the
+ * class. The worker runs the job with the earliest release next.
+ *
+ * Releases are absolute ticks (release += period, like vTaskDelayUntil), so
+ * the run time of a job does not shift its period. A job that falls behind by
+ * a whole period skips the missed releases instead of running them in a burst.
+ *
+ * Per job the worker records:
+ *  - the start jitter: start time minus release in us (tick resolution for
+ *    the wake-up, exact for the wait behind other jobs of the worker),
+ *  - the execution time,
+ *  - deadline overruns: finished later than release + deadline.
+ *
+ * Jobs must not block for long, they delay the other jobs of their class.
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+#ifndef PERIODIC_H
+#define PERIODIC_H
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdint.h>
+
+// pico-sdk includes
+// FreeRTOS includes
+#include "FreeRTOS.h" /* Must come first. */
+
+// Project includes
+#include "global/error_types.h"
+#include "global/metrics.h"
+
+/* --- Public macro definitions --------------------------------------------- */
+
+
+/* --- Public type/struct definitions --------------------------------------- */
+
+/**
+ * @brief Priority classes, one worker task each
+ */
+typedef enum ePeriodicClass_tag
+{
+    PeriodicClassHigh,    ///< Above the WLAN and MQTT tasks
+    PeriodicClassNormal,  ///< Same as the WLAN and MQTT tasks
+    PeriodicClassLow,     ///< Same as the background services
+    NumPeriodicClass
+} ePeriodicClass_t;
+
+/**
+ * @brief Job function
+ *
+ * @param pvArg Argument given to @ref ePeriodicAdd
+ */
+typedef void (*pfPeriodicJob_t)(void *pvArg);
+
+/**
+ * @brief Statistics of a job
+ */
+typedef struct sPeriodicStats_tag
+{
+    uint32_t uRuns;
+    uint32_t uOverruns;         ///< Finished after the deadline
+    uint32_t uSkipped;          ///< Releases dropped, a period behind
+    uint32_t uExecMaxUs;
+    uint64_t uExecSumUs;
+    uint32_t uJitterMaxUs;
+    uint32_t uaJitter[METRICS_HISTO_BUCKETS]; ///< Start jitter, bucket i: < 2^i us
+} sPeriodicStats_t;
+
+/**
+ * @brief Job, owned by the caller (static). Use a record only once.
+ */
+typedef struct sPeriodicJob_tag
+{
+    struct sPeriodicJob_tag *volatile sNext;
+    const char *cpName;
+    pfPeriodicJob_t pfJob;
+    void *pvArg;
+    TickType_t xPeriod;
+    TickType_t xDeadline;       ///< Relative to the release
+    TickType_t xRelease;        ///< Next release
+    ePeriodicClass_t eClass;
+    sPeriodicStats_t sStats;
+} sPeriodicJob_t;
+
+/* --- Public variables ----------------------------------------------------- */
+
+
+/* --- Public function prototypes ------------------------------------------- */
+
+/**
+ * @brief Add a job, creates the worker of the class with its first job
+ *
+ * @param sJob        Job record (static)
+ * @param cpName      Name for the statistics
+ * @param pfJob       Function
+ * @param pvArg       Argument of the function
+ * @param uPeriodMs   Period
+ * @param uOffsetMs   First release after now
+ * @param uDeadlineMs Deadline after each release, 0 = the period
+ * @param eClass      Priority class
+ *
+ * @return ErrNoError, ErrError if the period is 0 or the worker failed
+ */
+eRetVal_t ePeriodicAdd(
+    sPeriodicJob_t *const sJob,
+    const char *const cpName,
+    const pfPeriodicJob_t pfJob,
+    void *const pvArg,
+    const uint32_t uPeriodMs,
+    const uint32_t uOffsetMs,
+    const uint32_t uDeadlineMs,
+    const ePeriodicClass_t eClass);
+
+/**
+ * @brief Copy of the statistics of a job
+ *
+ * @param sJob   Job
+ * @param sStats Target
+ */
+void vPeriodicGetStats(const sPeriodicJob_t *const sJob, sPeriodicStats_t *const sStats);
+
+/**
+ * @brief Render the statistics of all jobs as text table
+ *
+ * @param cpBuffer Target buffer
+ * @param uSize    Size of the buffer
+ *
+ * @return Length of the text (without terminating zero)
+ */
+uint32_t uPeriodicRenderText(char *const cpBuffer, const uint32_t uSize);
+
+#endif /* PERIODIC_H */
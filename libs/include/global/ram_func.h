@@ -0,0 +1,83 @@
+/** ****************************************************************************
+ * @file   ram_func.h
+ *
+ * @author Michael R.
+ *
+ * @brief  Places hot functions of a module in SRAM instead of XIP flash.
+ *
+ * Every module has its own switch RAM_HOT_&lt;MODULE&gt; (0 or 1) set in the
+ * top-level <code>CMakeLists.txt</code>. A function definition is marked with
+ * <code>RAM_FUNC(RAM_HOT_DEBUG, _vDebugPrint)(...)</code>; with the switch on
+ * it lands in the <code>.time_critical</code> section the SDK copies to SRAM
+ * at boot, otherwise it stays in flash.
+ *
+ * Only the code moves. Constant data (format strings, tables) and the SDK
+ * libraries (lwIP, CYW43 driver, FreeRTOS kernel) are still read via XIP;
+ * the <code>copy_to_ram</code> binary type moves everything.
+ *
+ * Off the device (host tools) the marker does nothing.
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+#ifndef RAM_FUNC_H
+#define RAM_FUNC_H
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+// pico-sdk includes
+#if __has_include("pico/platform.h")
+    #include "pico/platform.h"
+#endif
+
+// FreeRTOS includes
+// Project includes
+
+/* --- Public macro definitions --------------------------------------------- */
+
+// The switches are pasted into a macro name: plain 0 or 1, no brackets
+
+/** _vDebugPrint, its helpers and the DBG_PR formatter */
+#ifndef RAM_HOT_DEBUG
+    #define RAM_HOT_DEBUG 0
+#endif
+
+/** UDP log send path (sequence prefix, pbuf, compressor feed) */
+#ifndef RAM_HOT_UDP
+    #define RAM_HOT_UDP 0
+#endif
+
+/** LZSS log compressor */
+#ifndef RAM_HOT_LZ
+    #define RAM_HOT_LZ 0
+#endif
+
+/** Histogram updates of the metrics */
+#ifndef RAM_HOT_METRICS
+    #define RAM_HOT_METRICS 0
+#endif
+
+/** Marks the function _NAME for SRAM if _ENABLE is 1 */
+#define RAM_FUNC(_ENABLE, _NAME)     RAM_FUNC_SEL(_ENABLE, _NAME)
+
+// Second level, so _ENABLE is expanded before it is pasted
+#define RAM_FUNC_SEL(_ENABLE, _NAME) RAM_FUNC_##_ENABLE(_NAME)
+#define RAM_FUNC_0(_NAME)            _NAME
+
+#ifdef __not_in_flash_func
+    #define RAM_FUNC_1(_NAME)        __not_in_flash_func(_NAME)
+#else
+    #define RAM_FUNC_1(_NAME)        _NAME
+#endif
+
+/* --- Public type/struct definitions --------------------------------------- */
+
+
+/* --- Public variables ----------------------------------------------------- */
+
+
+/* --- Public function prototypes ------------------------------------------- */
+
+
+#endif /* RAM_FUNC_H */
@@ -0,0 +1,96 @@
+/** ****************************************************************************
+ * @file   sha1.h
+ *
+ * @author Michael R.
+ *
+ * @brief  Small SHA-1 and HMAC-SHA1
+ *
+ * Used for the WebSocket handshake and to authenticate remote control
+ * commands. No dependencies, no heap.
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+#ifndef SHA1_H
+#define SHA1_H
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdint.h>
+
+// pico-sdk includes
+// FreeRTOS includes
+// Project includes
+
+/* --- Public macro definitions --------------------------------------------- */
+
+#define SHA1_DIGEST_SIZE (20U)
+#define SHA1_BLOCK_SIZE  (64U)
+
+/* --- Public type/struct definitions --------------------------------------- */
+
+/**
+ * @brief State of an incremental hash
+ */
+typedef struct sSha1_tag
+{
+    uint32_t uaH[5];
+    uint32_t uTotal;                        ///< Bytes hashed so far
+    uint8_t uaBlock[SHA1_BLOCK_SIZE];       ///< Incomplete block
+} sSha1_t;
+
+/* --- Public variables ----------------------------------------------------- */
+
+/* --- Public function prototypes ------------------------------------------- */
+
+/**
+ * @brief Start a new hash
+ *
+ * @param sSha1 State
+ */
+void vSha1Init(sSha1_t *const sSha1);
+
+/**
+ * @brief Add data to the hash
+ *
+ * @param sSha1 State
+ * @param pData Data
+ * @param uLen  Length of the data
+ */
+void vSha1Update(sSha1_t *const sSha1, const uint8_t *pData, uint32_t uLen);
+
+/**
+ * @brief Finish the hash
+ *
+ * @param sSha1   State
+ * @param pDigest 20 byte result
+ */
+void vSha1Final(sSha1_t *const sSha1, uint8_t *const pDigest);
+
+/**
+ * @brief SHA-1 of a message
+ *
+ * @param pData   Message
+ * @param uLen    Length of the message
+ * @param pDigest 20 byte result
+ */
+void vSha1(const uint8_t *pData, const uint32_t uLen, uint8_t *const pDigest);
+
+/**
+ * @brief HMAC-SHA1 (RFC 2104) of a message
+ *
+ * @param pKey    Key
+ * @param uKeyLen Length of the key
+ * @param pData   Message
+ * @param uLen    Length of the message
+ * @param pDigest 20 byte result
+ */
+void vHmacSha1(
+    const uint8_t *pKey,
+    const uint32_t uKeyLen,
+    const uint8_t *pData,
+    const uint32_t uLen,
+    uint8_t *const pDigest);
+
+#endif /* SHA1_H */
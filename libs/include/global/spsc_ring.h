@@ -0,0 +1,171 @@
+/** ****************************************************************************
+ * @file   spsc_ring.h
+ *
+ * @author Michael R.
+ *
+ * @brief  Lock-free single-producer/single-consumer ring of fixed size slots
+ *
+ * The producer writes directly into a reserved slot and commits it, the
+ * consumer works on the slot in place and releases it: no copy, no lock, no
+ * atomic read-modify-write (the M0+ has none). Each index is written by one
+ * side only, a barrier orders the slot content against the index.
+ *
+ * The ring itself never blocks. @ref xcore_chan.h adds the wake-up of a
+ * waiting consumer. The header has no pico-sdk dependency besides the
+ * barrier, the host benchmark in <code>tools/xcore_bench</code> uses it
+ * unchanged.
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stddef.h>
+#include <stdint.h>
+
+// pico-sdk includes
+#if __has_include("hardware/sync.h")
+    #include "hardware/sync.h"
+#endif
+
+// FreeRTOS includes
+// Project includes
+
+/* --- Public macro definitions --------------------------------------------- */
+
+/** Orders the slot accesses against the index update (both cores) */
+#if __has_include("hardware/sync.h")
+    #define SPSC_BARRIER() __dmb()
+#else
+    #define SPSC_BARRIER() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+/* --- Public type/struct definitions --------------------------------------- */
+
+/**
+ * @brief Ring state. The indices run freely, the slot is index & uMask.
+ */
+typedef struct sSpscRing_tag
+{
+    volatile uint32_t uHead;   ///< Next slot to fill, written by the producer only
+    volatile uint32_t uTail;   ///< Next slot to read, written by the consumer only
+    uint8_t *pSlots;           ///< uSlots * uSlotSize bytes
+    uint32_t uSlotSize;
+    uint32_t uMask;            ///< uSlots - 1
+} sSpscRing_t;
+
+/* --- Public variables ----------------------------------------------------- */
+
+
+/* --- Public function prototypes ------------------------------------------- */
+
+/**
+ * @brief Initialise a ring, before any producer or consumer uses it
+ *
+ * @param sRing     Ring
+ * @param pvBuffer  Slot memory of uSlots * uSlotSize bytes
+ * @param uSlotSize Size of a slot in bytes (multiple of 4 keeps slots aligned)
+ * @param uSlots    Number of slots, power of 2
+ */
+static inline void vSpscInit(
+    sSpscRing_t *const sRing,
+    void *const pvBuffer,
+    const uint32_t uSlotSize,
+    const uint32_t uSlots)
+{
+    sRing->uHead = 0UL;
+    sRing->uTail = 0UL;
+    sRing->pSlots = (uint8_t *)pvBuffer;
+    sRing->uSlotSize = uSlotSize;
+    sRing->uMask = uSlots - 1UL;
+}
+
+/**
+ * @brief Producer: next free slot
+ *
+ * Repeated calls return the same slot until it is committed.
+ *
+ * @param sRing Ring
+ *
+ * @return Slot to fill, NULL if the ring is full
+ */
+static inline void *pvSpscReserve(sSpscRing_t *const sRing)
+{
+    void *pvSlot = NULL;
+    const uint32_t uHead = sRing->uHead;
+
+    if ((uHead - sRing->uTail) <= sRing->uMask)
+    {
+        // The consumer has finished with the slot before it moved uTail
+        SPSC_BARRIER();
+        pvSlot = &sRing->pSlots[(uHead & sRing->uMask) * sRing->uSlotSize];
+    }
+
+    return (pvSlot);
+}
+
+/**
+ * @brief Producer: hand the reserved slot to the consumer
+ *
+ * @param sRing Ring
+ */
+static inline void vSpscCommit(sSpscRing_t *const sRing)
+{
+    // Slot content first, then the index
+    SPSC_BARRIER();
+    sRing->uHead = sRing->uHead + 1UL;
+}
+
+/**
+ * @brief Consumer: oldest committed slot
+ *
+ * @param sRing Ring
+ *
+ * @return Slot to read, NULL if the ring is empty
+ */
+static inline void *pvSpscPeek(sSpscRing_t *const sRing)
+{
+    void *pvSlot = NULL;
+    const uint32_t uTail = sRing->uTail;
+
+    if (uTail != sRing->uHead)
+    {
+        // Index seen, so the content is complete
+        SPSC_BARRIER();
+        pvSlot = &sRing->pSlots[(uTail & sRing->uMask) * sRing->uSlotSize];
+    }
+
+    return (pvSlot);
+}
+
+/**
+ * @brief Consumer: give the peeked slot back to the producer
+ *
+ * @param sRing Ring
+ */
+static inline void vSpscRelease(sSpscRing_t *const sRing)
+{
+    // Done with the content before the producer may reuse the slot
+    SPSC_BARRIER();
+    sRing->uTail = sRing->uTail + 1UL;
+}
+
+/**
+ * @brief Number of committed, not yet released slots
+ *
+ * Exact only for the producer or the consumer, a snapshot for everyone else.
+ *
+ * @param sRing Ring
+ *
+ * @return Used slots
+ */
+static inline uint32_t uSpscCount(const sSpscRing_t *const sRing)
+{
+    return (sRing->uHead - sRing->uTail);
+}
+
+#endif /* SPSC_RING_H */
@@ -0,0 +1,102 @@
+/** ****************************************************************************
+ * @file   stdout_async.h
+ *
+ * @author Michael R.
+ *
+ * @brief  Non-blocking stdout: printf copies into a ring, DMA/a task drains it
+ *
+ * The module replaces the UART and USB drivers of the pico-sdk stdio for the
+ * output. A printf (and with it the debug output under the log mutex) only
+ * copies its text into a ring buffer in SRAM:
+ *  - UART (STDIO_UART): a DMA channel paced by the UART TX request drains
+ *    the ring, its completion interrupt starts the next piece.
+ *  - USB CDC (STDIO_USB): a low priority task hands the ring to the USB
+ *    driver of the pico-sdk, whose background task sends it. Only this task
+ *    waits for the host.
+ *
+ * Overflow policy (STDOUT_OVERFLOW) if a write does not fit into the ring:
+ *  - StdoutOverflowDrop: the whole write is dropped and counted, the caller
+ *    never waits.
+ *  - StdoutOverflowWait: a task waits up to STDOUT_WAIT_MS for space, then
+ *    drops. Interrupts and the code before the scheduler drop at once.
+ *
+ * Partial writes never happen, a line is either complete or missing. The
+ * input (getchar) still comes from the pico-sdk drivers. Output that is still
+ * in the ring when the system stops (panic) is lost, the crash log keeps it.
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+#ifndef STDOUT_ASYNC_H
+#define STDOUT_ASYNC_H
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+// pico-sdk includes
+// FreeRTOS includes
+// Project includes
+#include "global/error_types.h"
+
+/* --- Public macro definitions --------------------------------------------- */
+
+/** 1 = asynchronous stdout, 0 = the blocking pico-sdk drivers */
+#ifndef STDOUT_ASYNC
+    #define STDOUT_ASYNC (1U)
+#endif
+
+/** stdio via UART, same as pico_enable_stdio_uart() */
+#ifndef STDIO_UART
+    #define STDIO_UART (0U)
+#endif
+
+/** stdio via USB CDC, same as pico_enable_stdio_usb() */
+#ifndef STDIO_USB
+    #define STDIO_USB (1U)
+#endif
+
+/** Size of the ring in bytes, power of 2 */
+#ifndef STDOUT_RING_SIZE
+    #define STDOUT_RING_SIZE (4096U)
+#endif
+
+/** Overflow policy, see @ref eStdoutOverflow_t */
+#ifndef STDOUT_OVERFLOW
+    #define STDOUT_OVERFLOW (0U)
+#endif
+
+/** Longest wait for space with StdoutOverflowWait */
+#ifndef STDOUT_WAIT_MS
+    #define STDOUT_WAIT_MS (10UL)
+#endif
+
+/* --- Public type/struct definitions --------------------------------------- */
+
+/**
+ * @brief Values of STDOUT_OVERFLOW
+ */
+typedef enum eStdoutOverflow_tag
+{
+    StdoutOverflowDrop,   ///< Drop the write
+    StdoutOverflowWait,   ///< Wait for space (tasks only), then drop
+} eStdoutOverflow_t;
+
+/* --- Public variables ----------------------------------------------------- */
+
+/* --- Public function prototypes ------------------------------------------- */
+
+/**
+ * @brief Bare-metal init, takes over the output after stdio_init_all()
+ *
+ * @return eRetVal_t Returns success/error
+ */
+eRetVal_t eStdoutPreInit(void);
+
+/**
+ * @brief FreeRTOS related initialisation (starts the USB drain task)
+ *
+ * @return eRetVal_t Returns success/error
+ */
+eRetVal_t eStdoutRtosInit(void);
+
+#endif /* STDOUT_ASYNC_H */
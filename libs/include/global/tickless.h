@@ -0,0 +1,104 @@
+/** ****************************************************************************
+ * @file   tickless.h
+ *
+ * @author Michael R.
+ *
+ * @brief  Tickless idle for the SMP kernel
+ *
+ * The SMP kernel has no tickless idle (configUSE_TICKLESS_IDLE must stay 0
+ * with two cores), so the idle hooks of both cores call @ref vTicklessIdle:
+ *
+ *  - Tick core: if no task is ready, it stops its SysTick, sets a timer
+ *    alarm to the next task time-out and sleeps (WFI) until the alarm or any
+ *    interrupt. Before interrupts are enabled again the missed ticks up to the
+ *    next time-out are stepped (@ref xTaskStepIdleTicks), the SysTick
+ *    continues in phase. The ticks that unblock tasks follow with
+ *    xTaskCatchUpTicks().
+ *  - Other core: sleeps (WFI) with its SysTick paused. The tick core only
+ *    stops its tick while the other core sleeps. Any interrupt of the other
+ *    core wakes the tick core (forced alarm interrupt) and waits until it has
+ *    stepped the ticks, so a task readied there sees the right tick count.
+ *
+ * The next deadline is xNextTaskUnblockTime of the kernel: the FreeRTOS
+ * timers (timer task), the CYW43 driver (async context) and the lwIP time-outs
+ * (tcpip thread) all wait in a blocked task. Interrupts of the pico-sdk
+ * (e.g. the USB stdio poll every ms) end a sleep early, the wake-up counters
+ * show them.
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+#ifndef TICKLESS_H
+#define TICKLESS_H
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+// pico-sdk includes
+// FreeRTOS includes
+#include "FreeRTOS.h" /* Must come first. */
+
+// Project includes
+#include "global/error_types.h"
+
+/* --- Public macro definitions --------------------------------------------- */
+
+/** 1 = the idle cores sleep, 0 = they spin (the behaviour before) */
+#ifndef TICKLESS_IDLE
+    #define TICKLESS_IDLE (1U)
+#endif
+
+/** Longest sleep in ticks, bounds the error of a missed wake-up */
+#ifndef TICKLESS_MAX_TICKS
+    #define TICKLESS_MAX_TICKS (1000UL)
+#endif
+
+/** Shorter idle times only wait for the next tick (WFI with the tick running) */
+#ifndef TICKLESS_MIN_TICKS
+    #define TICKLESS_MIN_TICKS (2UL)
+#endif
+
+/* --- Public type/struct definitions --------------------------------------- */
+
+/* --- Public variables ----------------------------------------------------- */
+
+/* --- Public function prototypes ------------------------------------------- */
+
+/**
+ * @brief Bare-metal init (claims the wake-up alarm, runs on the tick core)
+ *
+ * @return eRetVal_t Returns success/error
+ */
+eRetVal_t eTicklessPreInit(void);
+
+/**
+ * @brief Sleep until the next deadline, called by the idle hooks of both cores
+ */
+void vTicklessIdle(void);
+
+/**
+ * @brief Ticks until the next blocked task times out (kernel extension)
+ *
+ * Defined in src/freertos_tasks_c_additions.h.
+ *
+ * @return Ticks, 0 if a task is ready
+ */
+TickType_t xTaskGetIdleTicks(void);
+
+/**
+ * @brief Advance the tick count by slept ticks (kernel extension)
+ *
+ * Like vTaskStepTick() of the single core kernel: called on the tick core with
+ * interrupts disabled, so no task or interrupt sees the old count. Steps at
+ * most to one tick before the next time-out, the rest (unblocking tasks,
+ * tick count wrap) is left to xTaskCatchUpTicks().
+ *
+ * Defined in src/freertos_tasks_c_additions.h.
+ *
+ * @param xTicks Ticks passed with the tick stopped
+ *
+ * @return Ticks not stepped, for xTaskCatchUpTicks()
+ */
+TickType_t xTaskStepIdleTicks(const TickType_t xTicks);
+
+#endif /* TICKLESS_H */
@@ -0,0 +1,173 @@
+/** ****************************************************************************
+ * @file   xcore_chan.h
+ *
+ * @author Michael R.
+ *
+ * @brief  Zero-copy message channel between tasks on different cores
+ *
+ * A channel is a @ref spsc_ring.h ring plus a wake-up for a consumer blocked
+ * in @ref pvXcoreReceive. Data never passes the kernel: the producer fills a
+ * slot in place and commits it, the consumer reads it in place and releases
+ * it. Only if the consumer is actually waiting the producer rings a SIO
+ * doorbell (RP2350). The doorbell interrupt on the other core gives the task
+ * notification XCORE_NOTIFY_INDEX, so the kernel lock is only taken there.
+ * The RP2040 has no doorbells and its FreeRTOS port owns the SIO FIFO for
+ * the cross-core yield; there the producer gives the notification directly.
+ *
+ * Exactly one producer and one consumer per channel. Reserve/commit may be
+ * called from interrupts, receive only from a task.
+ *
+ * <code>
+ * XCORE_CHAN_BUFFER(uaSampleBuf, sizeof(sSample_t), 16U);
+ * eXcoreChanInit(&sSampleChan, uaSampleBuf, sizeof(sSample_t), 16U);
+ *
+ * // Task on core 1
+ * sSample_t *sOut = pvXcoreReserve(&sSampleChan);
+ * sOut->uValue = 42U;
+ * vXcoreCommit(&sSampleChan);
+ *
+ * // Task on core 0
+ * sSample_t *sIn = pvXcoreReceive(&sSampleChan, portMAX_DELAY);
+ * vUseSample(sIn->uValue);
+ * vXcoreRelease(&sSampleChan);
+ * </code>
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+#ifndef XCORE_CHAN_H
+#define XCORE_CHAN_H
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// pico-sdk includes
+// FreeRTOS includes
+#include "FreeRTOS.h" /* Must come first. */
+#include "task.h"
+
+// Project includes
+#include "global/error_types.h"
+#include "global/spsc_ring.h"
+
+/* --- Public macro definitions --------------------------------------------- */
+
+/** Notification index used for the wake-up, index 0 stays free for the task */
+#define XCORE_NOTIFY_INDEX (1U)
+
+#if (configTASK_NOTIFICATION_ARRAY_ENTRIES <= XCORE_NOTIFY_INDEX)
+    #error "configTASK_NOTIFICATION_ARRAY_ENTRIES too small for XCORE_NOTIFY_INDEX"
+#endif
+
+/** Word aligned slot memory of a channel (static, in the shared SRAM) */
+#define XCORE_CHAN_BUFFER(_NAME, _SLOT_SIZE, _SLOTS) \
+    static uint32_t _NAME[(((_SLOT_SIZE) * (_SLOTS)) + 3U) / 4U]
+
+/* --- Public type/struct definitions --------------------------------------- */
+
+/**
+ * @brief Channel state
+ */
+typedef struct sXcoreChan_tag
+{
+    sSpscRing_t sRing;
+    TaskHandle_t volatile xConsumer;  ///< Set while the consumer waits
+    int32_t iBell;                    ///< Doorbell, -1 = direct notification
+} sXcoreChan_t;
+
+/* --- Public variables ----------------------------------------------------- */
+
+
+/* --- Public function prototypes ------------------------------------------- */
+
+/**
+ * @brief Install the doorbell interrupt on both cores. Call once before the
+ *        scheduler starts.
+ *
+ * @return eRetVal_t Returns success/error
+ */
+eRetVal_t eXcoreRtosInit(void);
+
+/**
+ * @brief Initialise a channel and claim its doorbell
+ *
+ * @param sChan     Channel
+ * @param pvBuffer  Slot memory, see XCORE_CHAN_BUFFER
+ * @param uSlotSize Size of a slot in bytes
+ * @param uSlots    Number of slots, power of 2
+ *
+ * @return eRetVal_t Error if uSlots is no power of 2
+ */
+eRetVal_t eXcoreChanInit(
+    sXcoreChan_t *const sChan,
+    void *const pvBuffer,
+    const uint32_t uSlotSize,
+    const uint32_t uSlots);
+
+/**
+ * @brief Producer: next free slot, see @ref pvSpscReserve
+ *
+ * @param sChan Channel
+ *
+ * @return Slot to fill, NULL if the channel is full
+ */
+static inline void *pvXcoreReserve(sXcoreChan_t *const sChan)
+{
+    return (pvSpscReserve(&sChan->sRing));
+}
+
+/**
+ * @brief Producer: publish the reserved slot and wake the consumer if it
+ *        waits
+ *
+ * @param sChan Channel
+ */
+void vXcoreCommit(sXcoreChan_t *const sChan);
+
+/**
+ * @brief Producer: copy a message into the next slot and commit it
+ *
+ * @param sChan  Channel
+ * @param pvData Message
+ * @param uLen   Length, at most the slot size
+ *
+ * @return false if the channel was full
+ */
+bool bXcoreSend(sXcoreChan_t *const sChan, const void *pvData, const uint32_t uLen);
+
+/**
+ * @brief Consumer: oldest slot without waiting
+ *
+ * @param sChan Channel
+ *
+ * @return Slot to read, NULL if the channel is empty
+ */
+static inline void *pvXcorePeek(sXcoreChan_t *const sChan)
+{
+    return (pvSpscPeek(&sChan->sRing));
+}
+
+/**
+ * @brief Consumer: oldest slot, waits up to xWait ticks for one
+ *
+ * @param sChan Channel
+ * @param xWait Ticks to wait, portMAX_DELAY forever
+ *
+ * @return Slot to read, NULL on timeout
+ */
+void *pvXcoreReceive(sXcoreChan_t *const sChan, const TickType_t xWait);
+
+/**
+ * @brief Consumer: give the slot back to the producer
+ *
+ * @param sChan Channel
+ */
+static inline void vXcoreRelease(sXcoreChan_t *const sChan)
+{
+    vSpscRelease(&sChan->sRing);
+}
+
+#endif /* XCORE_CHAN_H */
@@ -0,0 +1,108 @@
+/** ****************************************************************************
+ * @file   xip_profile.h
+ *
+ * @author Michael R.
+ *
+ * @brief  XIP cache miss profiling of the log and network paths.
+ *
+ * With XIP_PROFILE=1 a probe reads the hit and access counters of the XIP
+ * cache before and after a code path and adds the misses to a histogram.
+ * The counters are shared by both cores, a probe therefore also counts the
+ * misses of the other core in that time. Compare the histograms of builds
+ * with different RAM_HOT_&lt;MODULE&gt; switches or the copy_to_ram binary type
+ * under the same load, not single values.
+ *
+ * The hardware counters saturate at 2^32, they are cleared whenever the hit
+ * rate is taken (metrics snapshot). Probes overlapping a clear or a
+ * saturated counter are discarded.
+ *
+ * With XIP_PROFILE=0 all functions are empty.
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+#ifndef XIP_PROFILE_H
+#define XIP_PROFILE_H
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdint.h>
+
+// pico-sdk includes
+#include "hardware/structs/xip_ctrl.h"
+
+// FreeRTOS includes
+// Project includes
+#include "global/metrics.h"
+
+/* --- Public macro definitions --------------------------------------------- */
+
+#ifndef XIP_PROFILE
+    #define XIP_PROFILE (0U)
+#endif
+
+/* --- Public type/struct definitions --------------------------------------- */
+
+/**
+ * @brief Counter values at the start of a probe
+ */
+typedef struct sXipProbe_tag
+{
+    uint32_t uHit;
+    uint32_t uAcc;
+} sXipProbe_t;
+
+/* --- Public variables ----------------------------------------------------- */
+
+
+/* --- Public function prototypes ------------------------------------------- */
+
+/**
+ * @brief Start a probe
+ *
+ * @param sProbe Probe (on the stack of the caller)
+ */
+static inline void vXipProbeStart(sXipProbe_t *const sProbe)
+{
+#if XIP_PROFILE
+    sProbe->uHit = xip_ctrl_hw->ctr_hit;
+    sProbe->uAcc = xip_ctrl_hw->ctr_acc;
+#else
+    (void)sProbe;
+#endif
+}
+
+/**
+ * @brief End a probe and add the misses since the start to a histogram
+ *
+ * Inline, so the end is not delayed by a miss on the way to the counters.
+ *
+ * @param sProbe Probe started with @ref vXipProbeStart
+ * @param eHisto Histogram of the misses
+ */
+static inline void vXipProbeEnd(const sXipProbe_t *const sProbe, const eMetricHisto_t eHisto)
+{
+#if XIP_PROFILE
+    const uint32_t uAcc = xip_ctrl_hw->ctr_acc;
+    const uint32_t uHit = xip_ctrl_hw->ctr_hit;
+
+    // Cleared or saturated in between: no valid difference
+    if ((uAcc >= sProbe->uAcc) && (uHit >= sProbe->uHit) && (UINT32_MAX != uAcc))
+    {
+        vMetricsObserve(eHisto, (uAcc - sProbe->uAcc) - (uHit - sProbe->uHit));
+    }
+#else
+    (void)sProbe;
+    (void)eHisto;
+#endif
+}
+
+/**
+ * @brief Hit rate of the XIP cache since the last call, clears the counters
+ *
+ * @return Hits per 1000 accesses, -1 without accesses or if XIP_PROFILE=0
+ */
+int32_t iXipProfileHitPermille(void);
+
+#endif /* XIP_PROFILE_H */
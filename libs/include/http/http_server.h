@@ -0,0 +1,56 @@
+/** ****************************************************************************
+ * @file   http_server.h
+ *
+ * @author Michael R.
+ *
+ * @brief  Minimal HTTP/1.1 status server (/metrics, /tasks, /net, /jobs, /log)
+ *
+ * The pages are rendered periodically by a background task into double
+ * buffered static memory including the complete response header. A request
+ * only hands the current buffer to lwIP (no copy). Connections are kept
+ * alive unless the client asks for the opposite. Requests for WS_PATH are
+ * handed over to the WebSocket stream (see http/websocket.h). /log streams
+ * the records of the flash log (see global/flash_log.h) and closes.
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+// pico-sdk includes
+// FreeRTOS includes
+// Project includes
+#include "global/error_types.h"
+
+/* --- Public macro definitions --------------------------------------------- */
+
+#ifndef HTTP_PORT
+    #define HTTP_PORT (80U)
+#endif
+
+/** Render interval of the pre-rendered pages */
+#define HTTP_RENDER_MS (1000UL)
+
+/* --- Public type/struct definitions --------------------------------------- */
+
+/* --- Public variables ----------------------------------------------------- */
+
+/* --- Public function prototypes ------------------------------------------- */
+
+/**
+ * @brief FreeRTOS related initialisation (starts the render task)
+ *
+ * @return eRetVal_t Returns success/error
+ */
+eRetVal_t eHttpRtosInit(void);
+
+/**
+ * @brief Start listening. Needs an initialised lwIP, multiple calls are fine.
+ */
+void vHttpStart(void);
+
+#endif /* HTTP_SERVER_H */
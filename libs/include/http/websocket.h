@@ -0,0 +1,107 @@
+/** ****************************************************************************
+ * @file   websocket.h
+ *
+ * @author Michael R.
+ *
+ * @brief  WebSocket stream of the debug output and the telemetry batches
+ *
+ * Clients connect via the HTTP server (<code>ws://picow/stream</code>). The
+ * DBG_PR output is sent as text frames, telemetry batches as binary frames
+ * (same CBOR sequence as the UDP datagrams).
+ *
+ * Each client has its own queue. Producers only copy the frame into the
+ * queues and never wait for the network; the WebSocket task hands all queued
+ * frames of a client to lwIP in one go. If the queue of a slow client is
+ * full, new frames are dropped for this client and a notice is sent once
+ * there is space again. A client that does not acknowledge any data for
+ * WS_STALL_SEC seconds is disconnected.
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+#ifndef WEBSOCKET_H
+#define WEBSOCKET_H
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// pico-sdk includes
+#include "lwip/tcp.h"
+
+// FreeRTOS includes
+// Project includes
+#include "global/error_types.h"
+
+/* --- Public macro definitions --------------------------------------------- */
+
+/** Path of the stream on the HTTP server */
+#ifndef WS_PATH
+    #define WS_PATH "/stream"
+#endif
+
+/** Number of simultaneous stream clients */
+#ifndef WS_MAX_CLIENTS
+    #define WS_MAX_CLIENTS (3U)
+#endif
+
+/** Queue size per client in bytes (power of 2) */
+#ifndef WS_QUEUE_SIZE
+    #define WS_QUEUE_SIZE (4096U)
+#endif
+
+/** Time frames are collected before they are handed to lwIP */
+#define WS_COALESCE_MS (10UL)
+
+/** A client without any progress for this number of seconds is dropped */
+#define WS_STALL_SEC   (10U)
+
+/* --- Public type/struct definitions --------------------------------------- */
+
+/**
+ * @brief Frame type of @ref vWsPublish
+ */
+typedef enum eWsFrame_tag
+{
+    WsText   = 0x1,     ///< UTF-8 text (log output)
+    WsBinary = 0x2,     ///< Binary data (telemetry)
+} eWsFrame_t;
+
+/* --- Public variables ----------------------------------------------------- */
+
+/* --- Public function prototypes ------------------------------------------- */
+
+/**
+ * @brief FreeRTOS related initialisation (starts the WebSocket task)
+ *
+ * @return eRetVal_t Returns success/error
+ */
+eRetVal_t eWsRtosInit(void);
+
+/**
+ * @brief Take over a HTTP connection that requested the upgrade
+ *
+ * Must be called in the lwIP context. On success the connection belongs to
+ * the WebSocket server (including the lwIP callbacks).
+ *
+ * @param sPcb       Connection
+ * @param cpHeader   Request header lines (zero terminated)
+ *
+ * @return true if the connection was upgraded
+ */
+bool bWsUpgrade(struct tcp_pcb *const sPcb, const char *cpHeader);
+
+/**
+ * @brief Queue a frame for all connected clients. Never blocks.
+ *
+ * Not usable from interrupts.
+ *
+ * @param eType  Frame type
+ * @param pvData Payload
+ * @param uLen   Length of the payload
+ */
+void vWsPublish(const eWsFrame_t eType, const void *pvData, const uint16_t uLen);
+
+#endif /* WEBSOCKET_H */
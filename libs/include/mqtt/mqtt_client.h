@@ -0,0 +1,113 @@
+/** ****************************************************************************
+ * @file   mqtt_client.h
+ *
+ * @author Michael R.
+ *
+ * @brief  MQTT 3.1.1 publish client
+ *
+ * Keeps a persistent connection to the broker while the WLAN is up. Publish
+ * requests are queued without blocking. The client task batches queued
+ * messages into a single TCP write and keeps up to MQTT_INFLIGHT_MAX QoS1
+ * publishes unacknowledged (pipelining); QoS0 messages pass QoS1 ones held
+ * back by a full window. The session is kept by the broker (no clean
+ * session), unacknowledged messages are sent again with DUP after a
+ * reconnect. Reconnects use an exponential backoff, a refused connection
+ * counts as failed at once.
+ *
+ * While connected the task sleeps in the socket, a new publish is picked
+ * up within 100 ms.
+ *
+ * Static memory: MQTT_QUEUE_LEN * sizeof(sMqttMsg_t) for the messages plus
+ * MQTT_TX_SIZE + MQTT_RX_SIZE for the batch and receive buffers.
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+#ifndef MQTT_CLIENT_H
+#define MQTT_CLIENT_H
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdint.h>
+
+// pico-sdk includes
+// FreeRTOS includes
+// Project includes
+#include "global/error_types.h"
+
+/* --- Public macro definitions --------------------------------------------- */
+
+/** 1 = the client is built and started, 0 = not built at all */
+#ifndef MQTT_ENABLED
+    #define MQTT_ENABLED (0)
+#endif
+
+#ifndef MQTT_BROKER_HOST
+    #define MQTT_BROKER_HOST "mqtt.local"
+#endif
+
+#ifndef MQTT_BROKER_PORT
+    #define MQTT_BROKER_PORT (1883U)
+#endif
+
+/** Connect via TLS (needs TLS_ENABLED) */
+#ifndef MQTT_USE_TLS
+    #define MQTT_USE_TLS (0)
+#endif
+
+#ifndef MQTT_CLIENT_ID
+    #define MQTT_CLIENT_ID "picow"
+#endif
+
+/** Keep-alive interval announced to the broker */
+#define MQTT_KEEPALIVE_S   (30U)
+
+/** Number of queued messages (QoS0 and QoS1 waiting for PUBACK) */
+#define MQTT_QUEUE_LEN     (16U)
+
+/** Maximum number of unacknowledged QoS1 publishes */
+#define MQTT_INFLIGHT_MAX  (8U)
+
+#define MQTT_MAX_TOPIC     (48U)
+#define MQTT_MAX_PAYLOAD   (192U)
+
+/* --- Public type/struct definitions --------------------------------------- */
+
+/**
+ * @brief Quality of service of a publish
+ */
+typedef enum eMqttQos_tag
+{
+    MqttQos0 = 0,   ///< At most once, no acknowledge
+    MqttQos1 = 1,   ///< At least once, acknowledged by PUBACK
+} eMqttQos_t;
+
+/* --- Public variables ----------------------------------------------------- */
+
+/* --- Public function prototypes ------------------------------------------- */
+
+/**
+ * @brief FreeRTOS related initialisation
+ *
+ * @return eRetVal_t Returns success/error
+ */
+eRetVal_t eMqttRtosInit(void);
+
+/**
+ * @brief Queue a message for publishing. Does not block.
+ *
+ * @param cpTopic   Topic (zero terminated, < MQTT_MAX_TOPIC)
+ * @param pPayload  Payload
+ * @param uLen      Payload length (<= MQTT_MAX_PAYLOAD)
+ * @param eQos      Quality of service
+ *
+ * @return eRetVal_t ErrError if the queue is full or the message too large
+ */
+eRetVal_t eMqttPublish(
+    const char *cpTopic,
+    const uint8_t *pPayload,
+    const uint16_t uLen,
+    const eMqttQos_t eQos);
+
+#endif /* MQTT_CLIENT_H */
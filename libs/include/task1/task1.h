@@ -35,7 +35,7 @@
 eRetVal_t eTask1HwInit(void);
 
 /**
- * @brief Initializes the FreeRTOS task for the example-code.
+ * @brief Adds the periodic job of the example-code (global/periodic.h).
  *
  * Can/should be called before the FreeRTOS sheduler starts.
  *
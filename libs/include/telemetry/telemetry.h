@@ -0,0 +1,194 @@
+/** ****************************************************************************
+ * @file   telemetry.h
+ *
+ * @author Michael R.
+ *
+ * @brief  Typed binary telemetry (CBOR) with a batching UDP transport.
+ *
+ * A telemetry record is a CBOR array
+ * <code>[channel, timestamp, field_0, ..., field_n]</code>. Records are
+ * appended to a batch buffer and sent as CBOR sequence (RFC 8742) via UDP
+ * once the batch is full or the flush timer expires. Each datagram starts
+ * with the self-describe CBOR tag (0xd9d9f7) followed by the device header
+ * record. See <code>tools/telemetry/tlm_decode.py</code> for the decoder.
+ *
+ * Example:
+ * <code>
+ * sTlmEncoder_t *sEnc = sTelemetryBegin(TLM_CH_TASK1, 2U);
+ * vTlmEncUint(sEnc, uCounter);
+ * vTlmEncFloat(sEnc, fTemperature);
+ * vTelemetryEnd(sEnc);
+ * </code>
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// pico-sdk includes
+// FreeRTOS includes
+// Project includes
+#include "global/error_types.h"
+
+/* --- Public macro definitions --------------------------------------------- */
+
+#ifndef TELEMETRY_PORT
+    #define TELEMETRY_PORT (54324U)
+#endif
+
+/** Size of one batch, should fit into a single WLAN frame */
+#define TELEMETRY_BATCH_SIZE (1024U)
+
+/** Largest record, a new record is only started with this much space left */
+#define TELEMETRY_RECORD_MAX (256U)
+
+/** Latest time a non-empty batch is sent */
+#define TELEMETRY_FLUSH_MS   (500UL)
+
+/* --- Public type/struct definitions --------------------------------------- */
+
+/**
+ * @brief Incremental CBOR encoder writing into a caller provided buffer.
+ *
+ * The encoder never allocates. If the buffer runs out of space bOverflow is
+ * set and all further writes are ignored.
+ */
+typedef struct sTlmEncoder_tag
+{
+    uint8_t *pBuf;      ///< Target buffer
+    uint16_t uSize;     ///< Size of the target buffer
+    uint16_t uPos;      ///< Current write position
+    bool bOverflow;     ///< Set if a write did not fit into the buffer
+} sTlmEncoder_t;
+
+/* --- Public variables ----------------------------------------------------- */
+
+/* --- Public function prototypes ------------------------------------------- */
+
+/**
+ * @brief Initialise an encoder on a buffer
+ *
+ * @param sEnc   Encoder
+ * @param pBuf   Target buffer
+ * @param uSize  Size of pBuf in bytes
+ */
+void vTlmEncInit(sTlmEncoder_t *const sEnc, uint8_t *const pBuf, const uint16_t uSize);
+
+/**
+ * @brief Encode an unsigned integer
+ */
+void vTlmEncUint(sTlmEncoder_t *const sEnc, const uint64_t uValue);
+
+/**
+ * @brief Encode a signed integer
+ */
+void vTlmEncInt(sTlmEncoder_t *const sEnc, const int64_t iValue);
+
+/**
+ * @brief Encode a single precision float (lossless)
+ */
+void vTlmEncFloat(sTlmEncoder_t *const sEnc, const float fValue);
+
+/**
+ * @brief Encode a boolean
+ */
+void vTlmEncBool(sTlmEncoder_t *const sEnc, const bool bValue);
+
+/**
+ * @brief Encode a timestamp as extended time (tag 1001, RFC 9581)
+ *
+ * @param sEnc   Encoder
+ * @param uTimeUs Microseconds since 1970-01-01 (or since boot if not synced)
+ */
+void vTlmEncTimestamp(sTlmEncoder_t *const sEnc, const uint64_t uTimeUs);
+
+/**
+ * @brief Encode a byte string
+ *
+ * @param sEnc   Encoder
+ * @param pData  Bytes
+ * @param uLen   Number of bytes
+ */
+void vTlmEncBytes(sTlmEncoder_t *const sEnc, const void *pData, const uint16_t uLen);
+
+/**
+ * @brief Encode a tag, the next item is the tagged one
+ */
+void vTlmEncTag(sTlmEncoder_t *const sEnc, const uint64_t uTag);
+
+/**
+ * @brief Encode a text string
+ *
+ * @param sEnc   Encoder
+ * @param cpText Text
+ * @param uLen   Length of the text in bytes
+ */
+void vTlmEncText(sTlmEncoder_t *const sEnc, const char *cpText, const uint16_t uLen);
+
+/**
+ * @brief Start an array. The next uNumItems items belong to the array.
+ */
+void vTlmEncArray(sTlmEncoder_t *const sEnc, const uint16_t uNumItems);
+
+/**
+ * @brief Encode an array of signed integers
+ */
+void vTlmEncIntArray(sTlmEncoder_t *const sEnc, const int32_t *ipValues, const uint16_t uNum);
+
+/**
+ * @brief Encode an array of floats
+ */
+void vTlmEncFloatArray(sTlmEncoder_t *const sEnc, const float *fpValues, const uint16_t uNum);
+
+/**
+ * @brief FreeRTOS related initialisation
+ *
+ * @return eRetVal_t Returns success/error
+ */
+eRetVal_t eTelemetryRtosInit(void);
+
+/**
+ * @brief Current time used for records in microseconds
+ *
+ * @return Wall-clock time if SNTP synced, otherwise time since boot
+ */
+uint64_t uTelemetryNowUs(void);
+
+/**
+ * @brief Start a new record in the current batch
+ *
+ * Locks the batch until @ref vTelemetryEnd is called, so keep the time in
+ * between short. Exactly uNumFields items must be encoded.
+ *
+ * @param uChannel   Application defined channel/record id
+ * @param uNumFields Number of fields following the timestamp
+ *
+ * @return Encoder to be used for the fields, NULL if telemetry is not ready
+ */
+sTlmEncoder_t *sTelemetryBegin(const uint16_t uChannel, const uint16_t uNumFields);
+
+/**
+ * @brief Finish a record started with @ref sTelemetryBegin
+ *
+ * A record that did not fit into the rest of the batch is dropped and
+ * counted in the header of the next batch, the records before stay. Less than
+ * TELEMETRY_RECORD_MAX bytes left already start a new batch in
+ * @ref sTelemetryBegin, so only larger records are lost.
+ *
+ * @param sEnc Encoder returned by @ref sTelemetryBegin (NULL is ignored)
+ */
+void vTelemetryEnd(sTlmEncoder_t *const sEnc);
+
+/**
+ * @brief Force sending the current batch
+ */
+void vTelemetryFlush(void);
+
+#endif /* TELEMETRY_H */
@@ -0,0 +1,71 @@
+/** ****************************************************************************
+ * @file   log_tcp.h
+ *
+ * @author Michael R.
+ *
+ * @brief  Debug sink "tcp": log stream to one TCP client
+ *
+ * Listens on HOST_LOG_TCP_PORT once the link is up. One client (e.g.
+ * <code>nc picow 54327</code>) receives the records as plain text lines, a
+ * new connection replaces the previous one. Unlike the UDP stream nothing is
+ * lost on the air, but a client that does not read fills the queue of the
+ * sink: its records are dropped, the other sinks are not affected.
+ *
+ * The sink is queued (see global/debug_print.h): records are written in
+ * batches of LOG_TCP_BATCH or after LOG_TCP_FLUSH_MS, each batch is sent
+ * with one tcp_output.
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+#ifndef LOG_TCP_H
+#define LOG_TCP_H
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+// pico-sdk includes
+// FreeRTOS includes
+// Project includes
+#include "global/error_types.h"
+
+/* --- Public macro definitions --------------------------------------------- */
+
+#ifndef HOST_LOG_TCP_PORT
+    #define HOST_LOG_TCP_PORT (54327U)
+#endif
+
+/** Queue of the sink in records (power of 2) */
+#ifndef LOG_TCP_SLOTS
+    #define LOG_TCP_SLOTS (16U)
+#endif
+
+/** Records written at once */
+#ifndef LOG_TCP_BATCH
+    #define LOG_TCP_BATCH (8U)
+#endif
+
+/** Latest write after the first waiting record */
+#ifndef LOG_TCP_FLUSH_MS
+    #define LOG_TCP_FLUSH_MS (50UL)
+#endif
+
+/* --- Public type/struct definitions --------------------------------------- */
+
+/* --- Public variables ----------------------------------------------------- */
+
+/* --- Public function prototypes ------------------------------------------- */
+
+/**
+ * @brief Register the sink and subscribe to the link, call after eDebugPreInit
+ *
+ * @return ErrNoError, ErrError if the sink could not be added
+ */
+eRetVal_t eLogTcpPreInit(void);
+
+/**
+ * @brief Start listening. Needs an initialised lwIP, multiple calls are fine.
+ */
+void vLogTcpStart(void);
+
+#endif /* LOG_TCP_H */
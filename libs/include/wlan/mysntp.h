@@ -52,6 +52,29 @@ void vSntpStart(void);
  */
 void vSntpStop(void);
 
+/**
+ * @brief Set the AON timer; called by the SNTP client (SNTP_SET_SYSTEM_TIME_US)
+ *
+ * @param uSeconds Seconds since 1970-01-01
+ * @param uMicros  Fraction of the second in us
+ */
+void vSntpSetSystemTime(const uint32_t uSeconds, const uint32_t uMicros);
+
+/**
+ * @brief Get the time; called by the SNTP client (SNTP_GET_SYSTEM_TIME)
+ *
+ * @param uSeconds Seconds since 1970-01-01 (uptime if not synced)
+ * @param uMicros  Fraction of the second in us
+ */
+void vSntpGetSystemTime(uint32_t *const uSeconds, uint32_t *const uMicros);
+
+/**
+ * @brief Get the time in us with the resolution of the system timer
+ *
+ * @return Microseconds since 1970-01-01 if synced, otherwise the uptime
+ */
+uint64_t uSntpGetTimeUs(void);
+
 /**
  * @brief Get the current time in BCD format
  *
@@ -0,0 +1,73 @@
+/** ****************************************************************************
+ * @file   net_stats.h
+ *
+ * @author Michael R.
+ *
+ * @brief  lwIP and CYW43 statistics that stay enabled in release builds
+ *
+ * Two sources, both cheap enough for production:
+ *  - Hooks on the input and link output of the STA netif count every frame
+ *    between lwIP and the CYW43 driver: packets and bytes per direction,
+ *    frames the stack refused (input) and frames the driver failed to send.
+ *    They are metrics counters (net_*_total), exported with the others.
+ *  - The lwIP statistics (src/lwipopts.h, LWIP_STATS without the display
+ *    code): pool use, high-water mark and allocation failures per memory
+ *    pool and for the heap, failed mbox posts (tcpip mbox overflow) and
+ *    the IP/UDP/TCP counters including TCP retransmissions.
+ *    @ref uNetStatsRenderText appends them to the text metrics export.
+ *
+ * The hooks also hand the frames to the packet capture (wlan/pcap.h). They
+ * are installed with every link up, a re-initialised driver adds its netif
+ * anew.
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+#ifndef NET_STATS_H
+#define NET_STATS_H
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdint.h>
+
+// pico-sdk includes
+// FreeRTOS includes
+// Project includes
+#include "global/error_types.h"
+
+/* --- Public macro definitions --------------------------------------------- */
+
+/* --- Public type/struct definitions --------------------------------------- */
+
+/* --- Public variables ----------------------------------------------------- */
+
+/* --- Public function prototypes ------------------------------------------- */
+
+/**
+ * @brief Subscribe to the link, the hooks are installed with the link up
+ *
+ * @return ErrNoError
+ */
+eRetVal_t eNetStatsPreInit(void);
+
+/**
+ * @brief Install the netif hooks. Needs an initialised driver, repeated
+ *        calls are fine.
+ */
+void vNetStatsInstall(void);
+
+/**
+ * @brief Render the lwIP statistics in the Prometheus text format
+ *
+ * Takes a copy under the lwIP lock, renders outside of it. Uses a static
+ * copy: one caller (the metrics exporter) only.
+ *
+ * @param cpBuffer Target buffer
+ * @param uSize    Size of the buffer
+ *
+ * @return Length of the text (without terminating zero)
+ */
+uint32_t uNetStatsRenderText(char *const cpBuffer, const uint32_t uSize);
+
+#endif /* NET_STATS_H */
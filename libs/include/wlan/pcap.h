@@ -0,0 +1,152 @@
+/** ****************************************************************************
+ * @file   pcap.h
+ *
+ * @author Michael R.
+ *
+ * @brief  Capture of the STA netif traffic, streamed as pcapng via TCP
+ *
+ * The netif hooks of @ref net_stats.h hand every frame to @ref vPcapCapture.
+ * While a client is connected to PCAP_PORT, frames passing the filter are
+ * copied (Ethernet, IPv4 and TCP/UDP/ICMP headers plus the snap length of
+ * payload, at most PCAP_SNAP_MAX bytes) into a lock-free ring per direction:
+ * the receive path runs in the CYW43 driver, the send path under the lwIP
+ * lock, so each ring has one producer. The "Pcap" task streams the rings as
+ * pcapng to the client, Wireshark reads it directly:
+ *
+ * <code>wireshark -k -i TCP@picow:54328</code> or
+ * <code>nc picow 54328 > trace.pcapng</code>
+ *
+ * The filter (protocol, port in either direction, snap length) is set with
+ * @ref vPcapSetFilter or the remote control command <code>pcap</code>. The
+ * stream itself is never captured.
+ *
+ * CPU budget: without a client a frame costs one flag test. With a client
+ * at most PCAP_SNAP_MAX bytes are copied per frame and at most PCAP_MAX_PPS
+ * frames per direction and second are captured. Frames over the budget or
+ * with a full ring are dropped and counted (pcap_dropped_total).
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+#ifndef PCAP_H
+#define PCAP_H
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdint.h>
+
+// pico-sdk includes
+#include "lwip/pbuf.h"
+
+// FreeRTOS includes
+// Project includes
+#include "global/error_types.h"
+
+/* --- Public macro definitions --------------------------------------------- */
+
+#ifndef PCAP_PORT
+    #define PCAP_PORT (54328U)
+#endif
+
+/** Frames per direction in flight (power of 2) */
+#ifndef PCAP_SLOTS
+    #define PCAP_SLOTS (16U)
+#endif
+
+/** Bytes copied per frame at most (multiple of 4) */
+#ifndef PCAP_SNAP_MAX
+    #define PCAP_SNAP_MAX (128U)
+#endif
+
+/** Frames captured per direction and second at most */
+#ifndef PCAP_MAX_PPS
+    #define PCAP_MAX_PPS (200UL)
+#endif
+
+/** Latest send after a frame was captured */
+#ifndef PCAP_FLUSH_MS
+    #define PCAP_FLUSH_MS (50UL)
+#endif
+
+/* --- Public type/struct definitions --------------------------------------- */
+
+/**
+ * @brief Direction of a captured frame
+ */
+typedef enum ePcapDir_tag
+{
+    PcapDirRx,     ///< Driver to lwIP
+    PcapDirTx,     ///< lwIP to driver
+    NumPcapDir
+} ePcapDir_t;
+
+/**
+ * @brief Protocol of the filter
+ */
+typedef enum ePcapProto_tag
+{
+    PcapProtoAny,
+    PcapProtoTcp,
+    PcapProtoUdp,
+    PcapProtoIcmp,
+    PcapProtoArp,
+    NumPcapProto
+} ePcapProto_t;
+
+/**
+ * @brief Capture filter
+ */
+typedef struct sPcapFilter_tag
+{
+    ePcapProto_t eProto;
+    uint16_t uPort;        ///< Source or destination port, 0 = any
+    uint16_t uSnap;        ///< Payload bytes after the headers, PCAP_SNAP_MAX caps the frame
+} sPcapFilter_t;
+
+/* --- Public variables ----------------------------------------------------- */
+
+/* --- Public function prototypes ------------------------------------------- */
+
+/**
+ * @brief Subscribe to the link, listening starts with the link up
+ *
+ * @return ErrNoError
+ */
+eRetVal_t ePcapPreInit(void);
+
+/**
+ * @brief Create the stream task
+ *
+ * @return ErrNoError, ErrError if the task could not be created
+ */
+eRetVal_t ePcapRtosInit(void);
+
+/**
+ * @brief Start listening. Needs an initialised lwIP, multiple calls are fine.
+ */
+void vPcapStart(void);
+
+/**
+ * @brief Capture a frame (netif hook), returns at once without a client
+ *
+ * @param sPb  Frame including the Ethernet header, not modified
+ * @param eDir Direction, one caller per direction at a time
+ */
+void vPcapCapture(const struct pbuf *sPb, const ePcapDir_t eDir);
+
+/**
+ * @brief Set the capture filter, applies to the next frame
+ *
+ * @param sFilter Filter
+ */
+void vPcapSetFilter(const sPcapFilter_t *const sFilter);
+
+/**
+ * @brief Get the capture filter
+ *
+ * @param sFilter Target
+ */
+void vPcapGetFilter(sPcapFilter_t *const sFilter);
+
+#endif /* PCAP_H */
@@ -0,0 +1,79 @@
+/** ****************************************************************************
+ * @file   remote_ctrl.h
+ *
+ * @author Michael R.
+ *
+ * @brief  Authenticated runtime control of the debug output via UDP
+ *
+ * A datagram to CTRL_PORT consists of the 20 byte HMAC-SHA1 of the text
+ * followed by the text <code>&lt;nonce&gt; &lt;command&gt; [arguments]</code>.
+ * The nonce is the sender's Unix time in ms. It must be larger than the one of
+ * the last accepted command and, once the time is set via SNTP, within
+ * CTRL_WINDOW_S of the own clock. Packets failing one of the checks are
+ * dropped silently. Until SNTP has set the clock only <code>get</code> and
+ * <code>stats</code> are executed, the others are answered with
+ * <code>err no time</code>: the last nonce is lost with a reboot, so an old
+ * command could be replayed.
+ *
+ * Commands:
+ *  - <code>get</code> current levels, sinks (level or off), DVFS policy and
+ *    capture filter
+ *  - <code>level &lt;class|all&gt; &lt;0-4&gt;</code>
+ *  - <code>sink &lt;name&gt; &lt;on|off|0-4&gt;</code> switch a debug sink or
+ *    set its level (crash, uart, flash, ws, udp, tcp or user-defined)
+ *  - <code>rate &lt;class|all&gt; &lt;burst&gt; &lt;per second&gt;</code>
+ *  - <code>pcap &lt;any|tcp|udp|icmp|arp&gt; &lt;port|0&gt; &lt;snap&gt;</code>
+ *    capture filter of the pcapng stream (wlan/pcap.h)
+ *  - <code>stats</code> send a metrics snapshot now
+ *
+ * The reply is signed the same way: HMAC followed by
+ * <code>&lt;nonce&gt; ok|err [text]</code>. Host tool:
+ * <code>tools/remote_ctrl/log_ctrl.py</code>.
+ *
+ * The key CTRL_KEY is taken from <code>_wlan_credentials.h</code>. Without a
+ * key the listener is not started.
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+#ifndef REMOTE_CTRL_H
+#define REMOTE_CTRL_H
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+// pico-sdk includes
+// FreeRTOS includes
+// Project includes
+#include "global/error_types.h"
+
+/* --- Public macro definitions --------------------------------------------- */
+
+#ifndef CTRL_PORT
+    #define CTRL_PORT (54326U)
+#endif
+
+/** Accepted difference between the nonce and the own clock */
+#ifndef CTRL_WINDOW_S
+    #define CTRL_WINDOW_S (30UL)
+#endif
+
+/* --- Public type/struct definitions --------------------------------------- */
+
+/* --- Public variables ----------------------------------------------------- */
+
+/* --- Public function prototypes ------------------------------------------- */
+
+/**
+ * @brief Subscribe to the link events, listening starts with the link
+ *
+ * @return ErrNoError
+ */
+eRetVal_t eRemoteCtrlPreInit(void);
+
+/**
+ * @brief Start listening. Needs an initialised lwIP, multiple calls are fine.
+ */
+void vRemoteCtrlStart(void);
+
+#endif /* REMOTE_CTRL_H */
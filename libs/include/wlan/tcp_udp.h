@@ -13,6 +13,7 @@
 
 /* --- Includes ------------------------------------------------------------- */
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "global/error_types.h"
@@ -26,6 +27,49 @@
     #define HOST_LOG_PORT (54323U)
 #endif
 
+/** Default destination of the log stream, see @ref eTcpUdpLogDest_t */
+#ifndef HOST_LOG_DEST
+    #define HOST_LOG_DEST (0U)
+#endif
+
+/** Multicast group or collector address used by HOST_LOG_DEST 1 and 2 */
+#ifndef HOST_LOG_ADDR
+    #define HOST_LOG_ADDR "239.255.43.23"
+#endif
+
+/** IP TTL of multicast log packets (1 = do not leave the local subnet) */
+#ifndef HOST_LOG_MCAST_TTL
+    #define HOST_LOG_MCAST_TTL (1U)
+#endif
+
+/**
+ * Compress the log stream (see global/log_lz.h). Lines are collected into
+ * datagrams of up to HOST_LOG_DATAGRAM bytes and sent when full or after
+ * HOST_LOG_FLUSH_MS. Decoder: tools/log_lz/log_lz.py
+ */
+#ifndef HOST_LOG_COMPRESS
+    #define HOST_LOG_COMPRESS (0U)
+#endif
+
+#ifndef HOST_LOG_FLUSH_MS
+    #define HOST_LOG_FLUSH_MS (100UL)
+#endif
+
+#define HOST_LOG_DATAGRAM (1400U)
+
+/**
+ * Prefix every log record with <code>#&lt;sequence&gt;@&lt;time us&gt; </code>.
+ * The sequence number counts every record handed to the UDP stream (also the
+ * ones that could not be sent), the time is the Unix time in us once SNTP
+ * has synced, the uptime before. Analyser: tools/log_stats/log_stats.py
+ */
+#ifndef HOST_LOG_SEQ
+    #define HOST_LOG_SEQ (1U)
+#endif
+
+/** Longest prefix: '#' 10 digits '@' 20 digits ' ', plus room for the NUL */
+#define HOST_LOG_SEQ_SIZE (34U)
+
 /* --- Public type/struct definitions --------------------------------------- */
 
 typedef enum eTcpUdpSocketType_tag
@@ -35,6 +79,27 @@ typedef enum eTcpUdpSocketType_tag
     IP_NUMEL
 } eTcpUdpSocketType_t;
 
+/**
+ * @brief Destination modes of the UDP log stream
+ */
+typedef enum eTcpUdpLogDest_tag
+{
+    LogDestBroadcast = 0,  ///< Subnet broadcast, every station receives it
+    LogDestMulticast = 1,  ///< IP multicast group, only subscribers receive it
+    LogDestUnicast   = 2,  ///< Single collector host
+    NumLogDest
+} eTcpUdpLogDest_t;
+
+/**
+ * @brief Outgoing TCP connection (client side)
+ */
+typedef struct sTcpUdpConn_tag
+{
+    int iSocket;                 ///< lwIP socket, -1 if not connected
+    uint32_t uRecvTimeoutMs;     ///< Currently configured receive timeout
+    void *pvTls;                 ///< TLS context, NULL for plain TCP
+} sTcpUdpConn_t;
+
 /* --- Public variables ----------------------------------------------------- */
 
 /* --- Public function prototypes ------------------------------------------- */
@@ -43,8 +108,114 @@ eRetVal_t eTcpUdpRtosInit(void);
 eRetVal_t eTcpUdpOpenSocket(const eTcpUdpSocketType_t eType, const uint16_t uPort);
 void vTcpUdpCloseSocket(const eTcpUdpSocketType_t eType);
 
+/**
+ * @brief Select where the UDP log messages are sent to.
+ *
+ * Takes the lwIP lock: call with an initialised driver, e.g. from an
+ * EventLinkUp subscriber. The next message uses the new destination. The
+ * default (HOST_LOG_DEST, HOST_LOG_ADDR) is set by eTcpUdpRtosInit.
+ *
+ * @param eDest   Destination mode
+ * @param cpAddr  Multicast group or collector IP in dotted notation. Ignored
+ *                for @ref LogDestBroadcast.
+ *
+ * @return eRetVal_t ErrError if the mode or address is invalid, also for a
+ *         broadcast address given as @ref LogDestUnicast
+ */
+eRetVal_t eTcpUdpSetLogDest(const eTcpUdpLogDest_t eDest, const char *cpAddr);
+
 void vTcpUdpSendTcp(char *const cpMessage);
 
-void vTcpUdpPrintUdp(char *const cpMessage);
+/**
+ * @brief Resolve the host and open a TCP connection (blocking).
+ *
+ * @param sConn   Connection object
+ * @param cpHost  Host name or IP in dotted notation
+ * @param uPort   TCP port
+ *
+ * @return eRetVal_t ErrError if the connection could not be established
+ */
+eRetVal_t eTcpUdpConnect(sTcpUdpConn_t *const sConn, const char *cpHost, const uint16_t uPort);
+
+/**
+ * @brief Open a TCP connection secured by TLS (blocking).
+ *
+ * A session of an earlier connection to the same host is resumed if the
+ * server still accepts it. Needs TLS_ENABLED, otherwise it always fails.
+ *
+ * @param sConn   Connection object
+ * @param cpHost  Host name (also used for SNI and the certificate check)
+ * @param uPort   TCP port
+ *
+ * @return eRetVal_t ErrError if the connection could not be established
+ */
+eRetVal_t eTcpUdpConnectTls(sTcpUdpConn_t *const sConn, const char *cpHost, const uint16_t uPort);
+
+/**
+ * @brief Send all data on a connection (blocking).
+ *
+ * @param sConn   Connection object
+ * @param pData   Data
+ * @param uLen    Number of bytes
+ *
+ * @return eRetVal_t ErrError if the connection failed
+ */
+eRetVal_t eTcpUdpWrite(sTcpUdpConn_t *const sConn, const uint8_t *pData, const uint32_t uLen);
+
+/**
+ * @brief Receive data from a connection.
+ *
+ * @param sConn       Connection object
+ * @param pBuffer     Target buffer
+ * @param uSize       Size of the target buffer
+ * @param uTimeoutMs  Maximum time to wait, 0 does not block
+ *
+ * @return Number of bytes received, 0 on timeout, -1 if the connection failed
+ */
+int32_t iTcpUdpRead(
+    sTcpUdpConn_t *const sConn,
+    uint8_t *const pBuffer,
+    const uint32_t uSize,
+    const uint32_t uTimeoutMs);
+
+/**
+ * @brief Close a connection opened by @ref eTcpUdpConnect
+ *
+ * @param sConn   Connection object
+ */
+void vTcpUdpDisconnect(sTcpUdpConn_t *const sConn);
+
+/**
+ * @brief Send a log record to the log destination (or into the compressed
+ *        datagram)
+ *
+ * LogSink task only. The record is not changed, it is copied behind the
+ * optional sequence prefix and cut to MAX_UDP_BUFFER - 1 bytes.
+ *
+ * @param cpMessage Record text, needs no terminating zero
+ * @param uLen      Length of the text
+ */
+void vTcpUdpPrintUdp(const char *cpMessage, const uint16_t uLen);
+
+/**
+ * @brief Send the compressed datagram if its flush time has passed
+ *
+ * LogSink task only, like @ref vTcpUdpPrintUdp. Without HOST_LOG_COMPRESS
+ * there is nothing to do.
+ *
+ * @param bLinkUp false: discard the datagram, the lwIP lock may be invalid
+ */
+void vTcpUdpFlushUdp(const bool bLinkUp);
+
+/**
+ * @brief Send binary data via UDP to the log destination host/group.
+ *
+ * @param pData   Data to be sent (must stay valid until the function returns)
+ * @param uLen    Number of bytes
+ * @param uPort   Destination port
+ *
+ * @return eRetVal_t ErrError if the data could not be sent
+ */
+eRetVal_t eTcpUdpSendUdp(const uint8_t *pData, const uint16_t uLen, const uint16_t uPort);
 
 #endif /* TCP_UDP_H */
@@ -0,0 +1,98 @@
+/** ****************************************************************************
+ * @file   tls.h
+ *
+ * @author Michael R.
+ *
+ * @brief  mbedTLS transport for the TCP connections of tcp_udp
+ *
+ * All memory of mbedTLS comes from a static heap of TLS_HEAP_SIZE bytes and
+ * a fixed pool of TLS_MAX_CONN contexts. The session (ticket) of the last
+ * handshake per host is kept in RAM, so a reconnect after a WLAN drop only
+ * needs an abbreviated handshake.
+ *
+ * Records are limited to 2 kB in both directions (max fragment length
+ * extension), the server has to support it. The lock around mbedTLS is
+ * released while a connection waits for its socket, so a slow handshake or
+ * a blocking read does not stall the other connections. A connection must
+ * be used by one task only.
+ *
+ * Only used through eTcpUdpConnectTls() and the generic read/write functions
+ * of tcp_udp.
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+#ifndef TLS_H
+#define TLS_H
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdint.h>
+
+// pico-sdk includes
+// FreeRTOS includes
+// Project includes
+#include "global/error_types.h"
+
+/* --- Public macro definitions --------------------------------------------- */
+
+#ifndef TLS_ENABLED
+    #define TLS_ENABLED (0)
+#endif
+
+/** Number of simultaneous TLS connections */
+#define TLS_MAX_CONN   (2U)
+
+/** Number of hosts whose session is cached for resumption */
+#define TLS_MAX_CACHE  (2U)
+
+/** Static heap for mbedTLS (records, handshake, certificates) */
+#define TLS_HEAP_SIZE  (40U * 1024U)
+
+/* --- Public type/struct definitions --------------------------------------- */
+
+/* --- Public variables ----------------------------------------------------- */
+
+/* --- Public function prototypes ------------------------------------------- */
+
+/**
+ * @brief FreeRTOS related initialisation (static heap, RNG, configuration)
+ *
+ * Called by eTcpUdpRtosInit().
+ *
+ * @return eRetVal_t Returns success/error
+ */
+eRetVal_t eTlsRtosInit(void);
+
+/**
+ * @brief Run the TLS handshake on a connected socket
+ *
+ * @param iSocket  Connected lwIP socket
+ * @param cpHost   Host name (SNI, certificate check and session cache key)
+ * @param ppvTls   Returns the TLS context
+ *
+ * @return eRetVal_t Returns success/error
+ */
+eRetVal_t eTlsHandshake(const int iSocket, const char *cpHost, void **ppvTls);
+
+/**
+ * @brief Write all data
+ *
+ * @return eRetVal_t ErrError if the connection failed
+ */
+eRetVal_t eTlsWrite(void *pvTls, const uint8_t *pData, const uint32_t uLen);
+
+/**
+ * @brief Read data
+ *
+ * @return Number of bytes received, 0 on timeout, -1 if the connection failed
+ */
+int32_t iTlsRead(void *pvTls, uint8_t *const pBuffer, const uint32_t uSize, const uint32_t uTimeoutMs);
+
+/**
+ * @brief Send close-notify and free the context (the socket is not closed)
+ */
+void vTlsClose(void *pvTls);
+
+#endif /* TLS_H */
@@ -50,4 +50,15 @@ eRetVal_t eWlanRtosInit(void);
  */
 bool bWlanIsConnected(void);
 
+/**
+ * @brief Returns whether the CYW43 driver is initialised
+ *
+ * Only then cyw43_arch_lwip_begin() may be used. Cleared before the WLAN
+ * task de-initialises the driver.
+ *
+ * @return true   Driver (and the lwIP lock) available.
+ * @return false  Not yet initialised or de-initialised.
+ */
+bool bWlanDriverUp(void);
+
 #endif /* WLAN_H */
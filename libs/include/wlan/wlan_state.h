@@ -13,6 +13,8 @@
 
 /* --- Includes ------------------------------------------------------------- */
 
+#include <stdbool.h>
+
 #include "FreeRTOS.h" /* Must come first. */
 #include "task.h"     /* RTOS task related API prototypes. */
 #include "timers.h"   /* RTOS timer related API prototypes. */
@@ -35,6 +37,9 @@ typedef struct sWlanState_tag
     // RTOS related variables
     TaskHandle_t xMainTask;
     TimerHandle_t xTimer;
+
+    bool bLinkUp;   ///< Last published link state
+    volatile bool bDriverUp;   ///< cyw43_arch_init done, the lwIP lock is valid
 } sWlanState_t;
 
 /* --- Public variables ----------------------------------------------------- */
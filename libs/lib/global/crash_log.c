@@ -0,0 +1,447 @@
+/** ****************************************************************************
+ * @file   crash_log.c
+ *
+ * @author Michael R.
+ *
+ * @brief  Crash-surviving RAM log ring and post-mortem dump
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+// pico-sdk includes
+#include "pico/stdlib.h"
+#include "hardware/exception.h"
+#include "hardware/watchdog.h"
+
+// FreeRTOS includes
+#include "FreeRTOS.h" /* Must come first. */
+#include "task.h"
+
+// Project includes
+#include "global/crash_log.h"
+#include "global/dbg_format.h"
+#include "global/debug_print.h"
+#include "global/event_bus.h"
+
+#include "wlan/tcp_udp.h"
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+#define CRASH_LOG_MAGIC      (0x43524C47UL)   // "CRLG"
+#define CRASH_RING_MAGIC     (0x52494E47UL)   // "RING"
+#define CRASH_RECORD_MARKER  (0xA5U)
+
+/** Marker, length and checksum in front of each message */
+#define CRASH_RECORD_HEADER  (3U)
+
+#define CRASH_LOG_MASK       (CRASH_LOG_SIZE - 1U)
+#define CRASH_NO_REPLAY      (0xFFU)
+
+/* --- Local type/struct definitions ---------------------------------------- */
+
+/**
+ * @brief One ring, uHead and uTail count bytes since the reset of the ring
+ */
+typedef struct sCrashRing_tag
+{
+    uint32_t uMagic;
+    uint32_t uHead;             ///< End of the newest record
+    uint32_t uTail;             ///< Start of the oldest complete record
+    uint32_t uCheck;            ///< Check word of the three fields above
+    uint8_t uaData[CRASH_LOG_SIZE];
+} sCrashRing_t;
+
+/**
+ * @brief Everything that survives a reset
+ */
+typedef struct sCrashLog_tag
+{
+    uint32_t uMagic;
+    uint32_t uActive;           ///< Ring that takes the messages of this run
+    uint32_t uBoots;            ///< Warm boots since the last cold start
+    sCrashInfo_t sInfo;
+    sCrashRing_t saRing[2];
+} sCrashLog_t;
+
+/* --- Static variables ----------------------------------------------------- */
+
+/** Not cleared by the C runtime */
+static sCrashLog_t __uninitialized_ram(sCrashLog);
+
+static uint8_t uReplayRing = CRASH_NO_REPLAY;
+static bool bReplayInfo = false;
+
+static sEventSub_t sCrashLinkUpSub;
+
+/* --- Static function prototypes ------------------------------------------- */
+
+/**
+ * @brief EventLinkUp: replay the previous run
+ *
+ * Only the first call after boot prints something. Subscribed last, the
+ * UDP output is ready by then.
+ *
+ * @param eEvent Event
+ * @param uArg   IPv4 address
+ */
+static void vCrashLogOnLinkUp(const eEvent_t eEvent, const uint32_t uArg);
+
+/**
+ * @brief Check word of a ring header
+ *
+ * @param sRing Ring
+ *
+ * @return Check word
+ */
+static inline uint32_t uCrashRingCheck(const sCrashRing_t *const sRing);
+
+/**
+ * @brief Empty a ring
+ *
+ * @param sRing Ring
+ */
+static void vCrashRingReset(sCrashRing_t *const sRing);
+
+/**
+ * @brief CRC-32 (reflected, 0xEDB88320) of the crash info
+ *
+ * @param sInfo Crash info
+ *
+ * @return CRC
+ */
+static uint32_t uCrashInfoCrc(const sCrashInfo_t *const sInfo);
+
+/**
+ * @brief Fill the common part of the crash info
+ *
+ * @param eKind  Kind of the crash
+ * @param cpTask Task name or NULL for the current task
+ */
+static void vCrashInfoBegin(const eCrashKind_t eKind, const char *cpTask);
+
+/**
+ * @brief Seal the crash info, print it and reboot
+ */
+static void vCrashInfoEnd(void) __attribute__((noreturn));
+
+/**
+ * @brief Hard fault entry, selects the stack of the exception frame
+ */
+static void vCrashLogHardFault(void) __attribute__((naked));
+
+/**
+ * @brief Hard fault handler
+ *
+ * @param puFrame Stacked r0-r3, r12, lr, pc, xpsr
+ */
+void vCrashLogFault(const uint32_t *puFrame) __attribute__((used, noreturn));
+
+/* --- Public functions ----------------------------------------------------- */
+
+eRetVal_t eCrashLogPreInit(void)
+{
+    eRetVal_t eRetVal = ErrNoError;
+    sCrashRing_t *sRing;
+
+    if ((CRASH_LOG_MAGIC == sCrashLog.uMagic) && (sCrashLog.uActive < 2UL))
+    {
+        sRing = &sCrashLog.saRing[sCrashLog.uActive];
+
+        // Replay after a recorded crash only, no watchdog is running
+        bReplayInfo = (CrashNone < sCrashLog.sInfo.uKind) &&
+                      (NumCrashKind > sCrashLog.sInfo.uKind) &&
+                      (sCrashLog.sInfo.uCrc == uCrashInfoCrc(&sCrashLog.sInfo));
+
+        if (bReplayInfo &&
+            (CRASH_RING_MAGIC == sRing->uMagic) &&
+            (sRing->uCheck == uCrashRingCheck(sRing)))
+        {
+            uReplayRing = (uint8_t)sCrashLog.uActive;
+        }
+
+        sCrashLog.uActive ^= 1UL;
+        sCrashLog.uBoots++;
+    }
+    else
+    {
+        // Cold start
+        memset(&sCrashLog.sInfo, 0, sizeof(sCrashInfo_t));
+        sCrashLog.uMagic = CRASH_LOG_MAGIC;
+        sCrashLog.uActive = 0UL;
+        sCrashLog.uBoots = 0UL;
+    }
+
+    vCrashRingReset(&sCrashLog.saRing[sCrashLog.uActive]);
+
+    if (!bReplayInfo)
+    {
+        sCrashLog.sInfo.uKind = CrashNone;
+    }
+
+    exception_set_exclusive_handler(HARDFAULT_EXCEPTION, vCrashLogHardFault);
+
+    vEventSubscribe(&sCrashLinkUpSub, EventLinkUp, vCrashLogOnLinkUp, EventOrderLast);
+
+    return (eRetVal);
+}
+
+
+void vCrashLogWrite(const char *cpText, const uint16_t uLen)
+{
+    sCrashRing_t *const sRing = &sCrashLog.saRing[sCrashLog.uActive];
+    const uint32_t uRecord = CRASH_RECORD_HEADER + uLen;
+    uint32_t uPos;
+    uint8_t uSum = 0U;
+
+    if ((0U != uLen) && (uLen <= UINT8_MAX))
+    {
+        // Drop the oldest records until the new one fits
+        while ((sRing->uHead + uRecord - sRing->uTail) > CRASH_LOG_SIZE)
+        {
+            sRing->uTail += CRASH_RECORD_HEADER + sRing->uaData[(sRing->uTail + 1U) & CRASH_LOG_MASK];
+        }
+
+        // Text first, the header marks the record as complete
+        uPos = sRing->uHead + CRASH_RECORD_HEADER;
+        for (uint16_t i = 0U; i < uLen; i++)
+        {
+            sRing->uaData[(uPos + i) & CRASH_LOG_MASK] = (uint8_t)cpText[i];
+            uSum += (uint8_t)cpText[i];
+        }
+
+        uPos = sRing->uHead;
+        sRing->uaData[(uPos + 1U) & CRASH_LOG_MASK] = (uint8_t)uLen;
+        sRing->uaData[(uPos + 2U) & CRASH_LOG_MASK] = uSum;
+        sRing->uaData[uPos & CRASH_LOG_MASK] = CRASH_RECORD_MARKER;
+
+        sRing->uHead += uRecord;
+        sRing->uCheck = uCrashRingCheck(sRing);
+    }
+}
+
+
+void vCrashLogFatal(const eCrashKind_t eKind, const char *cpTask, const char *cpReason)
+{
+    vCrashInfoBegin(eKind, cpTask);
+    strncpy(sCrashLog.sInfo.caReason, cpReason, CRASH_LOG_REASON_SIZE - 1U);
+    vCrashInfoEnd();
+}
+
+
+void vCrashLogPanic(const char *cpFormat, ...)
+{
+    va_list args;
+
+    vCrashInfoBegin(CrashPanic, NULL);
+
+    va_start(args, cpFormat);
+    uDbgVFormat(sCrashLog.sInfo.caReason, CRASH_LOG_REASON_SIZE, cpFormat, args);
+    va_end(args);
+
+    vCrashInfoEnd();
+}
+
+/* --- Static functions ----------------------------------------------------- */
+
+static void vCrashLogOnLinkUp(const eEvent_t eEvent, const uint32_t uArg)
+{
+    const sCrashInfo_t *const sInfo = &sCrashLog.sInfo;
+    static const char *const cpaKind[NumCrashKind] =
+    {
+        [CrashNone]          = "reset",
+        [CrashPanic]         = "panic",
+        [CrashHardFault]     = "hard fault",
+        [CrashStackOverflow] = "stack overflow",
+    };
+    char caLine[MAX_UDP_BUFFER];
+    sCrashRing_t *sRing = NULL;
+    uint32_t uPos = 0UL;
+    uint8_t uLen = 0U;
+    uint8_t uSum;
+
+    (void)eEvent; // Silence 'unused parameters'
+    (void)uArg;
+
+    if ((CRASH_NO_REPLAY != uReplayRing) || bReplayInfo)
+    {
+        if (CRASH_NO_REPLAY != uReplayRing)
+        {
+            sRing = &sCrashLog.saRing[uReplayRing];
+            uPos = sRing->uTail;
+        }
+
+        uDbgFormat(caLine, MAX_UDP_BUFFER, "=== Post-mortem of the previous run: %s (warm boot %lu) ===\n",
+                   cpaKind[bReplayInfo ? sInfo->uKind : CrashNone], sCrashLog.uBoots);
+        vDebugPrintRaw(caLine);
+
+        if (bReplayInfo)
+        {
+            uDbgFormat(caLine, MAX_UDP_BUFFER, "Reason: %.*s\n", CRASH_LOG_REASON_SIZE, sInfo->caReason);
+            vDebugPrintRaw(caLine);
+            uDbgFormat(caLine, MAX_UDP_BUFFER, "Task %.*s on core %lu after %lu ms, sp=%08lx\n",
+                       CRASH_LOG_TASK_SIZE, sInfo->caTask, sInfo->uCore, sInfo->uUptimeMs, sInfo->uSp);
+            vDebugPrintRaw(caLine);
+
+            if (CrashHardFault == sInfo->uKind)
+            {
+                uDbgFormat(caLine, MAX_UDP_BUFFER, "r0=%08lx r1=%08lx r2=%08lx r3=%08lx r12=%08lx\n",
+                           sInfo->uaRegs[0], sInfo->uaRegs[1], sInfo->uaRegs[2], sInfo->uaRegs[3], sInfo->uaRegs[4]);
+                vDebugPrintRaw(caLine);
+                uDbgFormat(caLine, MAX_UDP_BUFFER, "lr=%08lx pc=%08lx xpsr=%08lx\n",
+                           sInfo->uaRegs[5], sInfo->uaRegs[6], sInfo->uaRegs[7]);
+                vDebugPrintRaw(caLine);
+            }
+        }
+
+        // Stop at the first damaged record, everything after it is unsure
+        for ( ; (NULL != sRing) && (uPos != sRing->uHead); uPos += CRASH_RECORD_HEADER + uLen)
+        {
+            uLen = sRing->uaData[(uPos + 1U) & CRASH_LOG_MASK];
+            if ((CRASH_RECORD_MARKER != sRing->uaData[uPos & CRASH_LOG_MASK]) ||
+                (uLen >= MAX_UDP_BUFFER) ||
+                ((sRing->uHead - uPos) < (CRASH_RECORD_HEADER + uLen)))
+            {
+                break;
+            }
+
+            uSum = 0U;
+            for (uint8_t i = 0U; i < uLen; i++)
+            {
+                caLine[i] = (char)sRing->uaData[(uPos + CRASH_RECORD_HEADER + i) & CRASH_LOG_MASK];
+                uSum += (uint8_t)caLine[i];
+            }
+            caLine[uLen] = '\0';
+
+            if (uSum != sRing->uaData[(uPos + 2U) & CRASH_LOG_MASK])
+            {
+                break;
+            }
+
+            vDebugPrintRaw(caLine);
+        }
+
+        uDbgFormat(caLine, MAX_UDP_BUFFER, "=== End of post-mortem%s ===\n",
+                   ((NULL == sRing) || (uPos == sRing->uHead)) ? "" : " (damaged record)");
+        vDebugPrintRaw(caLine);
+
+        if (NULL != sRing)
+        {
+            sRing->uMagic = 0UL;
+        }
+        uReplayRing = CRASH_NO_REPLAY;
+        bReplayInfo = false;
+        sCrashLog.sInfo.uKind = CrashNone;
+    }
+}
+
+
+static inline uint32_t uCrashRingCheck(const sCrashRing_t *const sRing)
+{
+    return (sRing->uMagic ^ sRing->uHead ^ (sRing->uTail << 1U) ^ 0x5A5A5A5AUL);
+}
+
+
+static void vCrashRingReset(sCrashRing_t *const sRing)
+{
+    sRing->uMagic = CRASH_RING_MAGIC;
+    sRing->uHead = 0UL;
+    sRing->uTail = 0UL;
+    sRing->uCheck = uCrashRingCheck(sRing);
+}
+
+
+static uint32_t uCrashInfoCrc(const sCrashInfo_t *const sInfo)
+{
+    const uint8_t *pData = (const uint8_t *)sInfo;
+    uint32_t uCrc = 0xFFFFFFFFUL;
+
+    for (uint32_t i = 0UL; i < offsetof(sCrashInfo_t, uCrc); i++)
+    {
+        uCrc ^= pData[i];
+        for (uint8_t uBit = 0U; uBit < 8U; uBit++)
+        {
+            uCrc = (uCrc >> 1U) ^ (0xEDB88320UL & (0UL - (uCrc & 1UL)));
+        }
+    }
+
+    return (~uCrc);
+}
+
+
+static void vCrashInfoBegin(const eCrashKind_t eKind, const char *cpTask)
+{
+    sCrashInfo_t *const sInfo = &sCrashLog.sInfo;
+    uint32_t uSp;
+
+    __asm volatile ("mov %0, sp" : "=r" (uSp));
+
+    memset(sInfo, 0, sizeof(sCrashInfo_t));
+    sInfo->uKind = eKind;
+    sInfo->uCore = get_core_num();
+    sInfo->uUptimeMs = to_ms_since_boot(get_absolute_time());
+    sInfo->uSp = uSp;
+
+    if ((NULL == cpTask) && (taskSCHEDULER_NOT_STARTED != xTaskGetSchedulerState()))
+    {
+        cpTask = pcTaskGetName(NULL);
+    }
+    strncpy(sInfo->caTask, (NULL != cpTask) ? cpTask : "-", CRASH_LOG_TASK_SIZE - 1U);
+}
+
+
+static void vCrashInfoEnd(void)
+{
+    sCrashLog.sInfo.uCrc = uCrashInfoCrc(&sCrashLog.sInfo);
+
+    // Arm the reboot first, the print might block
+    watchdog_reboot(0UL, 0UL, CRASH_LOG_REBOOT_MS);
+
+    printf("\n*** FATAL: %s (task %s) - rebooting ***\n", sCrashLog.sInfo.caReason, sCrashLog.sInfo.caTask);
+
+    // No breakpoint: without a debugger it escalates to a hard fault, whose
+    // handler would overwrite this record
+    while (true)
+    {
+        tight_loop_contents();
+    }
+}
+
+
+static void vCrashLogHardFault(void)
+{
+    // Exception frame on PSP (task) or MSP (ISR, pre-scheduler), also for M0+
+    __asm volatile (
+        "movs r0, #4            \n"
+        "mov  r1, lr            \n"
+        "tst  r0, r1            \n"
+        "beq  1f                \n"
+        "mrs  r0, psp           \n"
+        "b    2f                \n"
+        "1:                     \n"
+        "mrs  r0, msp           \n"
+        "2:                     \n"
+        "ldr  r1, =vCrashLogFault \n"
+        "bx   r1                \n"
+        ".ltorg                 \n"
+        );
+}
+
+
+void vCrashLogFault(const uint32_t *puFrame)
+{
+    vCrashInfoBegin(CrashHardFault, NULL);
+
+    memcpy(sCrashLog.sInfo.uaRegs, puFrame, sizeof(sCrashLog.sInfo.uaRegs));
+    sCrashLog.sInfo.uSp = (uint32_t)(uintptr_t)puFrame;
+    strncpy(sCrashLog.sInfo.caReason, "hard fault", CRASH_LOG_REASON_SIZE - 1U);
+
+    vCrashInfoEnd();
+}
@@ -0,0 +1,529 @@
+/** ****************************************************************************
+ * @file   dbg_format.c
+ *
+ * @author Michael R.
+ *
+ * @brief  Small printf-style formatter used by DBG_PR
+ *
+ * Numbers are converted with 32 bit divisions (hardware divider on the
+ * RP2040) as long as the value fits, 64 bit arithmetic is only used for
+ * larger values.
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+// pico-sdk includes
+// FreeRTOS includes
+// Project includes
+#include "global/dbg_format.h"
+#include "global/ram_func.h"
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+/** Largest conversion: sign, 20 integer digits, point, 9 decimals */
+#define DBG_FMT_NUM_SIZE  (32U)
+
+#define DBG_FMT_MAX_PREC  (9U)
+#define DBG_FMT_DEF_PREC  (6U)
+
+/* --- Local type/struct definitions ---------------------------------------- */
+
+typedef struct sDbgOut_tag
+{
+    char *cpBuffer;
+    uint32_t uSize;
+    uint32_t uPos;
+} sDbgOut_t;
+
+/**
+ * @brief Parsed conversion specification
+ */
+typedef struct sDbgSpec_tag
+{
+    bool bLeft;       ///< '-' flag
+    bool bZero;       ///< '0' flag
+    bool bPlus;       ///< '+' flag
+    bool bSpace;      ///< ' ' flag
+    uint32_t uWidth;
+    int32_t iPrec;    ///< -1 if not given
+    uint8_t uLength;  ///< Number of 'l' (2 = long long), 0 for int
+} sDbgSpec_t;
+
+/* --- Static variables ----------------------------------------------------- */
+
+static const char caDbgDigitsLower[] = "0123456789abcdef";
+static const char caDbgDigitsUpper[] = "0123456789ABCDEF";
+
+static const uint32_t uaDbgPow10[DBG_FMT_MAX_PREC + 1U] =
+{
+    1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL,
+    1000000UL, 10000000UL, 100000000UL, 1000000000UL
+};
+
+/* --- Static function prototypes ------------------------------------------- */
+
+/**
+ * @brief Append one character if there is space (keeps room for the zero)
+ */
+static inline void vDbgPut(sDbgOut_t *const sOut, const char cChar);
+
+/**
+ * @brief Append a character multiple times
+ */
+static void vDbgRepeat(sDbgOut_t *const sOut, const char cChar, uint32_t uCount);
+
+/**
+ * @brief Convert an unsigned value, digits are written backwards
+ *
+ * @param cpEnd   End of the target (exclusive)
+ * @param uValue  Value
+ * @param uBase   8, 10 or 16
+ * @param bUpper  Upper case hex digits
+ *
+ * @return Number of digits
+ */
+static uint32_t uDbgDigits(char *const cpEnd, uint64_t uValue, const uint32_t uBase, const bool bUpper);
+
+/**
+ * @brief Emit a converted item with padding
+ *
+ * @param sOut     Output
+ * @param sSpec    Conversion specification
+ * @param cpPrefix Sign or "0x", may be empty
+ * @param cpBody   Characters of the item
+ * @param uLen     Number of characters in cpBody
+ * @param uZeros   Leading zeros required by the precision
+ */
+static void vDbgEmit(
+    sDbgOut_t *const sOut,
+    const sDbgSpec_t *const sSpec,
+    const char *cpPrefix,
+    const char *cpBody,
+    const uint32_t uLen,
+    const uint32_t uZeros);
+
+/**
+ * @brief Integer conversions (d i u x X o p)
+ */
+static void vDbgInteger(sDbgOut_t *const sOut, const sDbgSpec_t *const sSpec, const char cConv, va_list *pxArgs);
+
+/**
+ * @brief Fixed-point conversion (f F)
+ */
+static void vDbgFloat(sDbgOut_t *const sOut, const sDbgSpec_t *const sSpec, double dValue);
+
+/* --- Public functions ----------------------------------------------------- */
+
+uint32_t RAM_FUNC(RAM_HOT_DEBUG, uDbgVFormat)(char *const cpBuffer, const uint32_t uSize, const char *cpFormat, va_list xArgs)
+{
+    sDbgOut_t sOut = {.cpBuffer = cpBuffer, .uSize = uSize, .uPos = 0U};
+    sDbgSpec_t sSpec;
+    const char *cpStart;
+    const char *cpString;
+    uint32_t uLen;
+    int iValue;
+    char cChar;
+    va_list xCopy;
+
+    // Work on a copy, it is passed on by pointer
+    va_copy(xCopy, xArgs);
+
+    while (('\0' != *cpFormat) && ((sOut.uPos + 1U) < uSize))
+    {
+        if ('%' != *cpFormat)
+        {
+            vDbgPut(&sOut, *cpFormat++);
+            continue;
+        }
+
+        cpStart = cpFormat++;
+        memset(&sSpec, 0, sizeof(sSpec));
+        sSpec.iPrec = -1;
+
+        // Flags
+        for (bool bFlag = true; bFlag; )
+        {
+            switch (*cpFormat)
+            {
+            case '-': sSpec.bLeft = true;  cpFormat++; break;
+            case '0': sSpec.bZero = true;  cpFormat++; break;
+            case '+': sSpec.bPlus = true;  cpFormat++; break;
+            case ' ': sSpec.bSpace = true; cpFormat++; break;
+            default:  bFlag = false;                   break;
+            }
+        }
+
+        // Width
+        if ('*' == *cpFormat)
+        {
+            iValue = va_arg(xCopy, int);
+            sSpec.bLeft |= (iValue < 0);
+            sSpec.uWidth = (uint32_t)((iValue < 0) ? -iValue : iValue);
+            cpFormat++;
+        }
+        else
+        {
+            while ((*cpFormat >= '0') && (*cpFormat <= '9'))
+            {
+                sSpec.uWidth = sSpec.uWidth * 10U + (uint32_t)(*cpFormat++ - '0');
+            }
+        }
+
+        // Precision
+        if ('.' == *cpFormat)
+        {
+            cpFormat++;
+            sSpec.iPrec = 0;
+
+            if ('*' == *cpFormat)
+            {
+                iValue = va_arg(xCopy, int);
+                sSpec.iPrec = (iValue < 0) ? -1 : iValue;
+                cpFormat++;
+            }
+            else
+            {
+                while ((*cpFormat >= '0') && (*cpFormat <= '9'))
+                {
+                    sSpec.iPrec = sSpec.iPrec * 10 + (*cpFormat++ - '0');
+                }
+            }
+        }
+
+        // Length modifiers; h and hh are promoted to int anyway
+        while (('h' == *cpFormat) || ('l' == *cpFormat) || ('z' == *cpFormat))
+        {
+            if ('l' == *cpFormat)
+            {
+                sSpec.uLength++;
+            }
+            else if ('z' == *cpFormat)
+            {
+                sSpec.uLength = (sizeof(size_t) > sizeof(long)) ? 2U : 1U;
+            }
+            cpFormat++;
+        }
+
+        cChar = *cpFormat++;
+
+        switch (cChar)
+        {
+        case 'd':
+        case 'i':
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'o':
+        case 'p':
+            vDbgInteger(&sOut, &sSpec, cChar, &xCopy);
+            break;
+
+        case 'f':
+        case 'F':
+            vDbgFloat(&sOut, &sSpec, va_arg(xCopy, double));
+            break;
+
+        case 'c':
+            cChar = (char)va_arg(xCopy, int);
+            sSpec.bZero = false;
+            vDbgEmit(&sOut, &sSpec, "", &cChar, 1U, 0U);
+            break;
+
+        case 's':
+            cpString = va_arg(xCopy, const char *);
+            if (NULL == cpString)
+            {
+                cpString = "(null)";
+            }
+            uLen = 0U;
+            while (('\0' != cpString[uLen]) && ((sSpec.iPrec < 0) || (uLen < (uint32_t)sSpec.iPrec)))
+            {
+                uLen++;
+            }
+            sSpec.bZero = false;
+            vDbgEmit(&sOut, &sSpec, "", cpString, uLen, 0U);
+            break;
+
+        case '%':
+            vDbgPut(&sOut, '%');
+            break;
+
+        default:
+            // Unknown (or end of string): copy the specification unchanged
+            if ('\0' == cChar)
+            {
+                cpFormat--;
+            }
+            while (cpStart < cpFormat)
+            {
+                vDbgPut(&sOut, *cpStart++);
+            }
+            break;
+        }
+    }
+
+    va_end(xCopy);
+
+    if (0U != uSize)
+    {
+        cpBuffer[sOut.uPos] = '\0';
+    }
+
+    return (sOut.uPos);
+}
+
+
+uint32_t RAM_FUNC(RAM_HOT_DEBUG, uDbgFormat)(char *const cpBuffer, const uint32_t uSize, const char *cpFormat, ...)
+{
+    uint32_t uLen;
+    va_list xArgs;
+
+    va_start(xArgs, cpFormat);
+    uLen = uDbgVFormat(cpBuffer, uSize, cpFormat, xArgs);
+    va_end(xArgs);
+
+    return (uLen);
+}
+
+/* --- Static functions ----------------------------------------------------- */
+
+static inline void vDbgPut(sDbgOut_t *const sOut, const char cChar)
+{
+    if ((sOut->uPos + 1U) < sOut->uSize)
+    {
+        sOut->cpBuffer[sOut->uPos++] = cChar;
+    }
+}
+
+
+static void RAM_FUNC(RAM_HOT_DEBUG, vDbgRepeat)(sDbgOut_t *const sOut, const char cChar, uint32_t uCount)
+{
+    while ((0U != uCount) && ((sOut->uPos + 1U) < sOut->uSize))
+    {
+        sOut->cpBuffer[sOut->uPos++] = cChar;
+        uCount--;
+    }
+}
+
+
+static uint32_t RAM_FUNC(RAM_HOT_DEBUG, uDbgDigits)(char *const cpEnd, uint64_t uValue, const uint32_t uBase, const bool bUpper)
+{
+    const char *const cpDigits = bUpper ? caDbgDigitsUpper : caDbgDigitsLower;
+    uint32_t uNum = 0U;
+    uint32_t uSmall;
+
+    // 64 bit divisions only while needed
+    while (uValue > UINT32_MAX)
+    {
+        cpEnd[-(int32_t)++uNum] = cpDigits[uValue % uBase];
+        uValue /= uBase;
+    }
+
+    uSmall = (uint32_t)uValue;
+    do
+    {
+        cpEnd[-(int32_t)++uNum] = cpDigits[uSmall % uBase];
+        uSmall /= uBase;
+    } while (0U != uSmall);
+
+    return (uNum);
+}
+
+
+static void RAM_FUNC(RAM_HOT_DEBUG, vDbgEmit)(
+    sDbgOut_t *const sOut,
+    const sDbgSpec_t *const sSpec,
+    const char *cpPrefix,
+    const char *cpBody,
+    const uint32_t uLen,
+    const uint32_t uZeros)
+{
+    const uint32_t uPrefixLen = (uint32_t)strlen(cpPrefix);
+    const uint32_t uTotal = uPrefixLen + uZeros + uLen;
+    const uint32_t uPad = (sSpec->uWidth > uTotal) ? (sSpec->uWidth - uTotal) : 0U;
+    const bool bZeroPad = sSpec->bZero && !sSpec->bLeft;
+
+    if (!sSpec->bLeft && !bZeroPad)
+    {
+        vDbgRepeat(sOut, ' ', uPad);
+    }
+
+    for (uint32_t i = 0U; i < uPrefixLen; i++)
+    {
+        vDbgPut(sOut, cpPrefix[i]);
+    }
+
+    vDbgRepeat(sOut, '0', uZeros + (bZeroPad ? uPad : 0U));
+
+    for (uint32_t i = 0U; i < uLen; i++)
+    {
+        vDbgPut(sOut, cpBody[i]);
+    }
+
+    if (sSpec->bLeft)
+    {
+        vDbgRepeat(sOut, ' ', uPad);
+    }
+}
+
+
+static void RAM_FUNC(RAM_HOT_DEBUG, vDbgInteger)(sDbgOut_t *const sOut, const sDbgSpec_t *const sSpec, const char cConv, va_list *pxArgs)
+{
+    char caNum[DBG_FMT_NUM_SIZE];
+    sDbgSpec_t sLocal = *sSpec;
+    const char *cpPrefix = "";
+    uint64_t uValue;
+    int64_t iValue;
+    uint32_t uBase = 10U;
+    uint32_t uLen;
+    uint32_t uZeros = 0U;
+
+    if (('d' == cConv) || ('i' == cConv))
+    {
+        if (sLocal.uLength >= 2U)
+        {
+            iValue = va_arg(*pxArgs, long long);
+        }
+        else if (1U == sLocal.uLength)
+        {
+            iValue = va_arg(*pxArgs, long);
+        }
+        else
+        {
+            iValue = va_arg(*pxArgs, int);
+        }
+
+        if (iValue < 0)
+        {
+            cpPrefix = "-";
+            uValue = (uint64_t)0U - (uint64_t)iValue;
+        }
+        else
+        {
+            cpPrefix = sLocal.bPlus ? "+" : (sLocal.bSpace ? " " : "");
+            uValue = (uint64_t)iValue;
+        }
+    }
+    else if ('p' == cConv)
+    {
+        uValue = (uintptr_t)va_arg(*pxArgs, void *);
+        cpPrefix = "0x";
+        uBase = 16U;
+    }
+    else
+    {
+        if (sLocal.uLength >= 2U)
+        {
+            uValue = va_arg(*pxArgs, unsigned long long);
+        }
+        else if (1U == sLocal.uLength)
+        {
+            uValue = va_arg(*pxArgs, unsigned long);
+        }
+        else
+        {
+            uValue = va_arg(*pxArgs, unsigned int);
+        }
+
+        uBase = ('o' == cConv) ? 8U : ((('x' == cConv) || ('X' == cConv)) ? 16U : 10U);
+    }
+
+    if ((0 == sLocal.iPrec) && (0U == uValue))
+    {
+        // "%.0d" of 0 prints nothing
+        uLen = 0U;
+    }
+    else
+    {
+        uLen = uDbgDigits(&caNum[DBG_FMT_NUM_SIZE], uValue, uBase, ('X' == cConv));
+    }
+
+    if (sLocal.iPrec >= 0)
+    {
+        // Precision is the minimum number of digits, '0' flag is ignored
+        sLocal.bZero = false;
+        uZeros = ((uint32_t)sLocal.iPrec > uLen) ? ((uint32_t)sLocal.iPrec - uLen) : 0U;
+    }
+
+    vDbgEmit(sOut, &sLocal, cpPrefix, &caNum[DBG_FMT_NUM_SIZE - uLen], uLen, uZeros);
+}
+
+
+static void vDbgFloat(sDbgOut_t *const sOut, const sDbgSpec_t *const sSpec, double dValue)
+{
+    char caNum[DBG_FMT_NUM_SIZE];
+    const char *cpPrefix = sSpec->bPlus ? "+" : (sSpec->bSpace ? " " : "");
+    uint32_t uPrec = DBG_FMT_DEF_PREC;
+    uint32_t uLen = 0U;
+    uint32_t uFrac;
+    uint64_t uInt;
+    uint64_t uTwice;
+    double dTwice;
+
+    if (sSpec->iPrec >= 0)
+    {
+        uPrec = ((uint32_t)sSpec->iPrec > DBG_FMT_MAX_PREC) ? DBG_FMT_MAX_PREC : (uint32_t)sSpec->iPrec;
+    }
+
+    if (dValue < 0.0)
+    {
+        cpPrefix = "-";
+        dValue = -dValue;
+    }
+
+    if (isnan(dValue))
+    {
+        vDbgEmit(sOut, sSpec, "", "nan", 3U, 0U);
+    }
+    else if (dValue >= 18446744073709551615.0)
+    {
+        vDbgEmit(sOut, sSpec, cpPrefix, "ovf", 3U, 0U);
+    }
+    else
+    {
+        uInt = (uint64_t)dValue;
+
+        // Twice the scaled fraction (exact), its lowest bit is the half digit
+        dTwice = (dValue - (double)uInt) * (double)uaDbgPow10[uPrec] * 2.0;
+        uTwice = (uint64_t)dTwice;
+        uFrac = (uint32_t)(uTwice >> 1U);
+
+        // Round half to even like the libc, e.g. 2.5 -> "2", 0.25 -> "0.2".
+        // A remainder below the half bit makes it more than a tie.
+        if ((0U != (uTwice & 1U)) &&
+            ((dTwice > (double)uTwice) || (0U != (((0U == uPrec) ? (uint32_t)uInt : uFrac) & 1U))))
+        {
+            uFrac++;
+        }
+
+        // Rounding may carry into the integer part
+        if (uFrac >= uaDbgPow10[uPrec])
+        {
+            uFrac -= uaDbgPow10[uPrec];
+            uInt++;
+        }
+
+        if (0U != uPrec)
+        {
+            for (uint32_t i = 0U; i < uPrec; i++)
+            {
+                caNum[DBG_FMT_NUM_SIZE - 1U - i] = (char)('0' + (uFrac % 10U));
+                uFrac /= 10U;
+            }
+            caNum[DBG_FMT_NUM_SIZE - 1U - uPrec] = '.';
+            uLen = uPrec + 1U;
+        }
+
+        uLen += uDbgDigits(&caNum[DBG_FMT_NUM_SIZE - uLen], uInt, 10U, false);
+
+        vDbgEmit(sOut, sSpec, cpPrefix, &caNum[DBG_FMT_NUM_SIZE - uLen], uLen, 0U);
+    }
+}
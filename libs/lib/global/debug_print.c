@@ -11,31 +11,104 @@
 /* --- Includes ------------------------------------------------------------- */
 
 // libc includes
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 // pico-sdk includes
+#include "pico/platform.h"
+#include "pico/time.h"
+#include "hardware/sync.h"
+
 // FreeRTOS includes
 #include "FreeRTOS.h" /* Must come first. */
 #include "semphr.h"
+#include "task.h"
 
 // Project includes
 #include "global/debug_print.h"
+#include "global/crash_log.h"
+#include "global/dbg_format.h"
+#include "global/event_bus.h"
+#include "global/flash_log.h"
+#include "global/metrics.h"
+#include "global/ram_func.h"
+#include "global/xip_profile.h"
 
-#include "wlan/wlan.h"
 #include "wlan/tcp_udp.h"
+#include "http/websocket.h"
 
 
 /* --- Local macro definitions ---------------------------------------------- */
 
+/** Fixed point scale of the token bucket (one message) */
+#define DEBUG_TOKEN (1000UL)
+
+/** Queue of the UDP sink, records in flight while lwIP is busy */
+#define DEBUG_UDP_SLOTS (16U)
+
+#define DEBUG_SINK_STACK (768UL)
+#define DEBUG_SINK_PRIO  (tskIDLE_PRIORITY + 2UL)
+
+#if DEBUG_MSG_SIZE != MAX_UDP_BUFFER
+    #error "DEBUG_MSG_SIZE must match MAX_UDP_BUFFER (record sent as is via UDP)"
+#endif
+
 /* --- Local type/struct definitions ---------------------------------------- */
 
+/**
+ * @brief Rate limit of a class
+ */
+typedef struct sDebugRate_tag
+{
+    uint16_t uBurst;           ///< Messages in a row, 0 = unlimited
+    uint16_t uPerSec;          ///< Refill in messages per second
+} sDebugRate_t;
+
+/**
+ * @brief State of one call-site
+ */
+typedef struct sDebugSite_tag
+{
+    const char *cpFileName;    ///< Owner of the entry (pointer compare)
+    const char *cpFunction;
+    uint32_t uLineNumber;
+    uint32_t uTokens;          ///< Available messages * DEBUG_TOKEN
+    uint32_t uRefillMs;        ///< Time of the last refill
+    uint32_t uLastHash;        ///< Hash of the last printed message
+    uint32_t uRepeatMs;        ///< Time the last message was printed
+    uint16_t uRepeated;        ///< Identical messages folded since
+    uint16_t uSuppressed;      ///< Messages dropped by the rate limit since
+    logLevel_t eLevel;         ///< Level of the last message, for the summary
+} sDebugSite_t;
+
 /* --- Static variables ----------------------------------------------------- */
 
 static SemaphoreHandle_t xMessageBufferSem = NULL;
-static char caMessageBuffer[MAX_UDP_BUFFER];
+static char caMessageBuffer[DEBUG_MSG_SIZE];
+
+static char caSummaryBuffer[DEBUG_MSG_SIZE];
 
 static logLevel_t eaDebugServerityLevel[NumCl];
+static sDebugRate_t saDebugRate[NumCl];
+static sDebugSite_t saDebugSite[DEBUG_SITES];
+static uint32_t uDebugSweep = 0UL;
+
+static sDebugSink_t *volatile sDebugSinks = NULL;
+static volatile logLevel_t eDebugSinkMax = DBG_OFF;   ///< Highest level of the enabled sinks
+static TaskHandle_t xDebugSinkTask = NULL;
+
+static sDebugSink_t sDebugSinkCrash;
+static sDebugSink_t sDebugSinkUart;
+static sDebugSink_t sDebugSinkFlash;
+static sDebugSink_t sDebugSinkWs;
+static sDebugSink_t sDebugSinkUdp;
+static sDebugSlot_t saDebugUdpSlots[DEBUG_UDP_SLOTS];
+
+static volatile bool bDebugLinkUp = false;
+static sEventSub_t sDebugLinkUpSub;
+static sEventSub_t sDebugLinkDownSub;
 static char caLevelIndicator[NumDbgLvl + 1UL][13U] =
 {
     {},
@@ -48,6 +121,124 @@ static char caLevelIndicator[NumDbgLvl + 1UL][13U] =
 
 /* --- Static function prototypes ------------------------------------------- */
 
+/**
+ * @brief EventLinkUp/EventLinkDown: switch the UDP output
+ *
+ * @param eEvent Event
+ * @param uArg   Unused
+ */
+static void vDebugOnLink(const eEvent_t eEvent, const uint32_t uArg);
+
+/**
+ * @brief Find the entry of a call-site, a different owner is replaced
+ *
+ * @param cpFileName  Filename of the call-site
+ * @param cpFunction  Function of the call-site
+ * @param uLineNumber Line of the call-site
+ *
+ * @return Entry
+ */
+static sDebugSite_t *sDebugSiteGet(const char *cpFileName, const char *cpFunction, const uint32_t uLineNumber);
+
+/**
+ * @brief Take one message from the token bucket of the call-site
+ *
+ * @param sSite     Call-site
+ * @param eFunction Class of the call-site
+ * @param uNowMs    Current time
+ *
+ * @return true if the message may be printed
+ */
+static bool bDebugSiteTake(sDebugSite_t *const sSite, const function_t eFunction, const uint32_t uNowMs);
+
+/**
+ * @brief Print and clear the folded and rate limited counts of a call-site
+ *
+ * @param sSite Call-site
+ * @param uCore The active core
+ */
+static void vDebugSummary(sDebugSite_t *const sSite, const uint8_t uCore);
+
+/**
+ * @brief FNV-1a hash of the message text
+ *
+ * @param cpText Text
+ *
+ * @return Hash
+ */
+static uint32_t uDebugHash(const char *cpText);
+
+/**
+ * @brief Hand a record to all sinks whose level admits it
+ *
+ * @param sRecord Record
+ */
+static void vDebugOutput(const sDebugRecord_t *const sRecord);
+
+/**
+ * @brief Copy a record into the queue of a sink
+ *
+ * @param sSink       Queued sink
+ * @param sRecord     Record
+ * @param bRtosActive true if the LogSink task may be notified
+ *
+ * @return false if the queue is full
+ */
+static bool bDebugSinkQueue(sDebugSink_t *const sSink, const sDebugRecord_t *const sRecord, const bool bRtosActive);
+
+/**
+ * @brief Recalculate eDebugSinkMax after a change of a sink
+ */
+static void vDebugSinkUpdateMax(void);
+
+/**
+ * @brief LogSink task, writes the records of the queued sinks
+ *
+ * @param pvParameters Unused
+ */
+static void vDebugSinkTask(void *pvParameters);
+
+/**
+ * @brief Write the waiting records of a queued sink if its batch is full or
+ *        its flush time has come
+ *
+ * @param sSink Queued sink
+ * @param xNow  Current tick
+ *
+ * @return Ticks until the sink needs the task again
+ */
+static TickType_t xDebugSinkDrain(sDebugSink_t *const sSink, const TickType_t xNow);
+
+/**
+ * @brief Sink: crash log (RAM ring kept over resets)
+ */
+static bool bDebugWriteCrash(const sDebugRecord_t *const sRecord, void *pvCtx);
+
+/**
+ * @brief Sink: printf, only copied into the stdout ring (see global/stdout_async.h)
+ */
+static bool bDebugWriteUart(const sDebugRecord_t *const sRecord, void *pvCtx);
+
+/**
+ * @brief Sink: flash log, copied into the RAM image of the current sector
+ */
+static bool bDebugWriteFlash(const sDebugRecord_t *const sRecord, void *pvCtx);
+
+/**
+ * @brief Sink: WebSocket stream clients, only queued per client
+ */
+static bool bDebugWriteWs(const sDebugRecord_t *const sRecord, void *pvCtx);
+
+/**
+ * @brief Sink: UDP log stream, queued sink (LogSink task)
+ */
+static bool bDebugWriteUdp(const sDebugRecord_t *const sRecord, void *pvCtx);
+
+/**
+ * @brief Flush of the UDP sink, sends a due compressed datagram
+ */
+static void vDebugFlushUdp(void *pvCtx);
+
 /* --- Public functions ----------------------------------------------------- */
 
 eRetVal_t eDebugPreInit(void)
@@ -60,6 +251,31 @@ eRetVal_t eDebugPreInit(void)
     eaDebugServerityLevel[FN_SNTP]    = DEFAULT_DEBUG_LEVEL;
     eaDebugServerityLevel[FN_TCPUDP]  = DEFAULT_DEBUG_LEVEL;
     eaDebugServerityLevel[FN_SNTP]    = DEFAULT_DEBUG_LEVEL;
+    eaDebugServerityLevel[FN_TELEMETRY] = DEFAULT_DEBUG_LEVEL;
+    eaDebugServerityLevel[FN_HTTP]    = DEFAULT_DEBUG_LEVEL;
+    eaDebugServerityLevel[FN_MQTT]    = DEFAULT_DEBUG_LEVEL;
+    eaDebugServerityLevel[FN_CTRL]    = DEFAULT_DEBUG_LEVEL;
+    eaDebugServerityLevel[FN_POWER]   = DEFAULT_DEBUG_LEVEL;
+
+    for (uint32_t uClass = 0UL; uClass < NumCl; uClass++)
+    {
+        saDebugRate[uClass].uBurst  = DEFAULT_DEBUG_RATE_BURST;
+        saDebugRate[uClass].uPerSec = DEFAULT_DEBUG_RATE_PER_SEC;
+    }
+
+    // First, the other link subscribers may already print via UDP
+    vEventSubscribe(&sDebugLinkUpSub, EventLinkUp, vDebugOnLink, EventOrderFirst);
+    vEventSubscribe(&sDebugLinkDownSub, EventLinkDown, vDebugOnLink, EventOrderFirst);
+
+    // Built-in sinks, the crash log first. The UDP send waits for lwIP and
+    // the WLAN chip, so it is queued; the others only copy.
+    vDebugSinkSetQueue(&sDebugSinkUdp, saDebugUdpSlots, DEBUG_UDP_SLOTS, 1U, 0UL, vDebugFlushUdp);
+
+    (void)eDebugSinkAdd(&sDebugSinkCrash, "crash", bDebugWriteCrash, NULL, DBG_ALL);
+    (void)eDebugSinkAdd(&sDebugSinkUart,  "uart",  bDebugWriteUart,  NULL, DBG_ALL);
+    (void)eDebugSinkAdd(&sDebugSinkFlash, "flash", bDebugWriteFlash, NULL, FLASH_LOG_LEVEL);
+    (void)eDebugSinkAdd(&sDebugSinkWs,    "ws",    bDebugWriteWs,    NULL, DBG_ALL);
+    (void)eDebugSinkAdd(&sDebugSinkUdp,   "udp",   bDebugWriteUdp,   NULL, DBG_ALL);
 
     return(eRetVal);
 }
@@ -69,6 +285,8 @@ eRetVal_t eDebugRtosInit(void)
 {
     eRetVal_t eRetVal = ErrNoError;
 
+    BaseType_t xReturned;
+
     xMessageBufferSem = xSemaphoreCreateMutex();
 
     if(NULL == xMessageBufferSem)
@@ -76,6 +294,22 @@ eRetVal_t eDebugRtosInit(void)
         eRetVal = ErrError;
     }
 
+    if (IS_NO_ERR(eRetVal))
+    {
+        xReturned = xTaskCreate(
+                        vDebugSinkTask,
+                        "LogSink",
+                        DEBUG_SINK_STACK,
+                        NULL,
+                        DEBUG_SINK_PRIO,
+                        &xDebugSinkTask);
+
+        if (pdPASS != xReturned)
+        {
+            eRetVal = ErrError;
+        }
+    }
+
     return(eRetVal);
 }
 
@@ -84,12 +318,175 @@ void vDebugSetSeverity(const function_t eFunction, const logLevel_t eSeverity)
 {
     if ((eFunction < NumCl) && (eSeverity < NumDbgLvl))
     {
-        eaDebugServerityLevel[eFunction] = NumDbgLvl;
+        eaDebugServerityLevel[eFunction] = eSeverity;
+    }
+}
+
+
+logLevel_t eDebugGetSeverity(const function_t eFunction)
+{
+    logLevel_t eSeverity = DBG_OFF;
+
+    if (eFunction < NumCl)
+    {
+        eSeverity = eaDebugServerityLevel[eFunction];
+    }
+
+    return (eSeverity);
+}
+
+
+void vDebugSetRateLimit(const function_t eFunction, const uint16_t uBurst, const uint16_t uPerSec)
+{
+    if (eFunction < NumCl)
+    {
+        saDebugRate[eFunction].uBurst  = uBurst;
+        saDebugRate[eFunction].uPerSec = uPerSec;
+    }
+}
+
+
+eRetVal_t eDebugSinkAdd(
+    sDebugSink_t *const sSink,
+    const char *const cpName,
+    const pfDebugSinkWrite_t pfWrite,
+    void *const pvCtx,
+    const logLevel_t eLevel)
+{
+    const bool bRtosActive = !(taskSCHEDULER_NOT_STARTED == xTaskGetSchedulerState());
+    eRetVal_t eRetVal = ErrNoError;
+    sDebugSink_t *volatile *psLink = &sDebugSinks;
+
+    if ((NULL != sSink->pfWrite) || (NULL == pfWrite) || (eLevel >= NumDbgLvl))
+    {
+        eRetVal = ErrError;
+    }
+    else
+    {
+        sSink->sNext = NULL;
+        sSink->cpName = cpName;
+        sSink->pfWrite = pfWrite;
+        sSink->pvCtx = pvCtx;
+        sSink->eLevel = eLevel;
+        sSink->bEnabled = true;
+        sSink->bPending = false;
+        sSink->uDropped = 0UL;
+
+        // Appended, the printing task walks the list without the lock
+        if (bRtosActive)
+        {
+            taskENTER_CRITICAL();
+        }
+
+        while (NULL != *psLink)
+        {
+            psLink = &(*psLink)->sNext;
+        }
+        __dmb();
+        *psLink = sSink;
+
+        if (bRtosActive)
+        {
+            taskEXIT_CRITICAL();
+        }
+
+        vDebugSinkUpdateMax();
+    }
+
+    return (eRetVal);
+}
+
+
+void vDebugSinkSetQueue(
+    sDebugSink_t *const sSink,
+    sDebugSlot_t *const saSlots,
+    const uint32_t uSlots,
+    const uint32_t uBatch,
+    const uint32_t uFlushMs,
+    const pfDebugSinkFlush_t pfFlush)
+{
+    vSpscInit(&sSink->sQueue, saSlots, sizeof(sDebugSlot_t), uSlots);
+    sSink->uBatch = (0UL == uBatch) ? 1UL : uBatch;
+    sSink->xFlush = pdMS_TO_TICKS(uFlushMs);
+    sSink->pfFlush = pfFlush;
+}
+
+
+void vDebugSinkRequestFlush(sDebugSink_t *const sSink)
+{
+    sSink->bFlushReq = true;
+
+    if (NULL != xDebugSinkTask)
+    {
+        xTaskNotifyGive(xDebugSinkTask);
+    }
+}
+
+
+sDebugSink_t *sDebugSinkFind(const char *cpName)
+{
+    sDebugSink_t *sSink = sDebugSinks;
+
+    while ((NULL != sSink) && (0 != strcmp(sSink->cpName, cpName)))
+    {
+        sSink = sSink->sNext;
+    }
+
+    return (sSink);
+}
+
+
+sDebugSink_t *sDebugSinkFirst(void)
+{
+    return (sDebugSinks);
+}
+
+
+void vDebugSinkEnable(sDebugSink_t *const sSink, const bool bEnable)
+{
+    sSink->bEnabled = bEnable;
+    vDebugSinkUpdateMax();
+}
+
+
+void vDebugSinkSetLevel(sDebugSink_t *const sSink, const logLevel_t eLevel)
+{
+    if (eLevel < NumDbgLvl)
+    {
+        sSink->eLevel = eLevel;
+        vDebugSinkUpdateMax();
     }
 }
 
 
-void _vDebugPrint(
+void vDebugPrintRaw(char *const cpText)
+{
+    const bool bRtosActive = !(taskSCHEDULER_NOT_STARTED == xTaskGetSchedulerState());
+    const sDebugRecord_t sRecord =
+    {
+        .cpText = cpText,
+        .uLen = (uint16_t)strnlen(cpText, DEBUG_MSG_SIZE - 1U),
+        .eLevel = DBG_ERROR,
+        .eFunction = FN_UNKNOWN,
+        .uCore = (uint8_t)get_core_num(),
+        .bReplay = true,
+    };
+
+    if (bRtosActive)
+    {
+        xSemaphoreTake(xMessageBufferSem, portMAX_DELAY);
+    }
+
+    vDebugOutput(&sRecord);
+
+    if (bRtosActive)
+    {
+        xSemaphoreGive(xMessageBufferSem);
+    }
+}
+
+
+void RAM_FUNC(RAM_HOT_DEBUG, _vDebugPrint)(
     const function_t eFunction,
     const logLevel_t eLevel,
     const char* cpFileName,
@@ -103,11 +500,16 @@ void _vDebugPrint(
     uint16_t uCurrPos;
     va_list args;
     BaseType_t xGotSema = pdTRUE;
+    sXipProbe_t sProbe;
+    const uint32_t uStartUs = time_us_32();
     const bool bRtosActive = !(taskSCHEDULER_NOT_STARTED == xTaskGetSchedulerState());
 
 
-    if (eLevel <= eaDebugServerityLevel[eFunction])
+    // Formatted only if a class and a sink want it
+    if ((eLevel <= eaDebugServerityLevel[eFunction]) && (eLevel <= eDebugSinkMax))
     {
+        vXipProbeStart(&sProbe);
+
         if (eLevel < NumDbgLvl)
         {
             cDbgLvl = caLevelIndicator[eLevel];
@@ -124,10 +526,17 @@ void _vDebugPrint(
 
         if(pdTRUE == xGotSema)
         {
-
-            uCurrPos = snprintf(
+            const uint32_t uFormatStartUs = time_us_32();
+            const uint32_t uNowMs = uStartUs / 1000UL;
+            sDebugSite_t *const sSite = sDebugSiteGet(cpFileName, cpFunction, uLineNumber);
+            uint32_t uHash;
+            sDebugRecord_t sRecord;
+            bool bPrint = true;
+
+            // Own formatter: no heap, no newlib reentrancy, little stack
+            uCurrPos = uDbgFormat(
                 caMessageBuffer,
-                MAX_UDP_BUFFER,
+                DEBUG_MSG_SIZE,
                 "%s C%d %s:%s.%d\e[0m: ",
                 cDbgLvl,
                 uCore,
@@ -137,28 +546,426 @@ void _vDebugPrint(
                 );
 
             va_start(args, format);
-            vsnprintf(
+            uDbgVFormat(
                 &caMessageBuffer[uCurrPos],
-                (MAX_UDP_BUFFER - uCurrPos),
+                (DEBUG_MSG_SIZE - uCurrPos),
                 format, args
                 );
             va_end(args);
 
-            // Print to UART
-            printf("%s", caMessageBuffer);
+            vMetricsObserve(MetricLogFormatUs, time_us_32() - uFormatStartUs);
+
+            // Fold identical messages, a summary is printed at least every
+            // DEBUG_REPEAT_FLUSH_MS while the repetition lasts
+            uHash = uDebugHash(&caMessageBuffer[uCurrPos]);
+            if ((uHash == sSite->uLastHash) &&
+                ((uNowMs - sSite->uRepeatMs) < DEBUG_REPEAT_FLUSH_MS))
+            {
+                sSite->uRepeated++;
+                bPrint = false;
+            }
+            else if (!bDebugSiteTake(sSite, eFunction, uNowMs))
+            {
+                sSite->uSuppressed++;
+                bPrint = false;
+            }
 
-            // If WIFI is up, send the string via UDP
-            if (bWlanIsConnected())
+            if (bPrint)
+            {
+                vDebugSummary(sSite, uCore);
+
+                sSite->uLastHash = uHash;
+                sSite->uRepeatMs = uNowMs;
+                sSite->eLevel = eLevel;
+
+                sRecord.cpText = caMessageBuffer;
+                sRecord.uLen = (uint16_t)strlen(caMessageBuffer);
+                sRecord.eLevel = eLevel;
+                sRecord.eFunction = eFunction;
+                sRecord.uCore = uCore;
+                sRecord.bReplay = false;
+                vDebugOutput(&sRecord);
+            }
+            else
             {
-                vTcpUdpPrintUdp(caMessageBuffer);
+                vMetricsInc(MetricLogSuppressed);
+            }
+
+            // Check one more entry per call, so a folded repetition is also
+            // reported if its call-site stays silent afterwards
+            uDebugSweep = (uDebugSweep + 1U) & (DEBUG_SITES - 1U);
+            if ((uNowMs - saDebugSite[uDebugSweep].uRepeatMs) >= DEBUG_REPEAT_FLUSH_MS)
+            {
+                vDebugSummary(&saDebugSite[uDebugSweep], uCore);
             }
 
             if (bRtosActive)
             {
                 xSemaphoreGive(xMessageBufferSem);
             }
+
+            vMetricsObserve(MetricLogPrintUs, time_us_32() - uStartUs);
+            vXipProbeEnd(&sProbe, MetricLogXipMiss);
+        }
+        else
+        {
+            vMetricsInc(MetricLogDropped);
         }
     }
 }
 
 /* --- Static functions ----------------------------------------------------- */
+
+static void vDebugOnLink(const eEvent_t eEvent, const uint32_t uArg)
+{
+    (void)uArg; // Silence 'unused parameters'
+
+    bDebugLinkUp = (EventLinkUp == eEvent);
+}
+
+
+static sDebugSite_t *RAM_FUNC(RAM_HOT_DEBUG, sDebugSiteGet)(const char *cpFileName, const char *cpFunction, const uint32_t uLineNumber)
+{
+    // File names are string literals, the pointer identifies the file
+    const uint32_t uKey = (uint32_t)(uintptr_t)cpFileName + uLineNumber;
+    const uint32_t uIndex = ((uKey * 2654435761UL) >> 16U) & (DEBUG_SITES - 1U);
+    sDebugSite_t *const sSite = &saDebugSite[uIndex];
+
+    if ((sSite->cpFileName != cpFileName) || (sSite->uLineNumber != uLineNumber))
+    {
+        // Collision or first use: start with a full bucket, pending counts
+        // of the previous owner are lost
+        memset(sSite, 0, sizeof(sDebugSite_t));
+        sSite->cpFileName = cpFileName;
+        sSite->cpFunction = cpFunction;
+        sSite->uLineNumber = uLineNumber;
+        sSite->uTokens = UINT32_MAX;
+    }
+
+    return (sSite);
+}
+
+
+static bool RAM_FUNC(RAM_HOT_DEBUG, bDebugSiteTake)(sDebugSite_t *const sSite, const function_t eFunction, const uint32_t uNowMs)
+{
+    const sDebugRate_t *const sRate = &saDebugRate[(eFunction < NumCl) ? eFunction : FN_UNKNOWN];
+    const uint32_t uMax = sRate->uBurst * DEBUG_TOKEN;
+    bool bRetVal = true;
+
+    if (0U != sRate->uBurst)
+    {
+        // Messages per second equal tokens per ms
+        const uint32_t uElapsedMs = uNowMs - sSite->uRefillMs;
+        const uint64_t uTokens = (uint64_t)sSite->uTokens + ((uint64_t)uElapsedMs * sRate->uPerSec);
+
+        sSite->uTokens = (uTokens > uMax) ? uMax : (uint32_t)uTokens;
+        sSite->uRefillMs = uNowMs;
+
+        if (sSite->uTokens >= DEBUG_TOKEN)
+        {
+            sSite->uTokens -= DEBUG_TOKEN;
+        }
+        else
+        {
+            bRetVal = false;
+        }
+    }
+
+    return (bRetVal);
+}
+
+
+static void vDebugSummary(sDebugSite_t *const sSite, const uint8_t uCore)
+{
+    uint32_t uPos;
+    sDebugRecord_t sRecord;
+
+    if ((0U != sSite->uRepeated) || (0U != sSite->uSuppressed))
+    {
+        uPos = uDbgFormat(
+            caSummaryBuffer,
+            DEBUG_MSG_SIZE,
+            "%s C%d %s:%s.%d\e[0m:",
+            caLevelIndicator[NumDbgLvl],
+            uCore,
+            sSite->cpFileName,
+            sSite->cpFunction,
+            (int)sSite->uLineNumber
+            );
+
+        if (0U != sSite->uRepeated)
+        {
+            uPos += uDbgFormat(
+                &caSummaryBuffer[uPos],
+                (DEBUG_MSG_SIZE - uPos),
+                " last message repeated %u times",
+                sSite->uRepeated
+                );
+        }
+        if (0U != sSite->uSuppressed)
+        {
+            uPos += uDbgFormat(
+                &caSummaryBuffer[uPos],
+                (DEBUG_MSG_SIZE - uPos),
+                " %u messages rate limited",
+                sSite->uSuppressed
+                );
+        }
+        uDbgFormat(&caSummaryBuffer[uPos], (DEBUG_MSG_SIZE - uPos), "\n");
+
+        // Same level as the folded messages, so the same sinks get it
+        sRecord.cpText = caSummaryBuffer;
+        sRecord.uLen = (uint16_t)strlen(caSummaryBuffer);
+        sRecord.eLevel = sSite->eLevel;
+        sRecord.eFunction = FN_UNKNOWN;
+        sRecord.uCore = uCore;
+        sRecord.bReplay = false;
+        vDebugOutput(&sRecord);
+
+        sSite->uRepeated = 0U;
+        sSite->uSuppressed = 0U;
+    }
+}
+
+
+static uint32_t RAM_FUNC(RAM_HOT_DEBUG, uDebugHash)(const char *cpText)
+{
+    uint32_t uHash = 2166136261UL;
+
+    while ('\0' != *cpText)
+    {
+        uHash = (uHash ^ (uint8_t)*cpText++) * 16777619UL;
+    }
+
+    return (uHash);
+}
+
+
+static void RAM_FUNC(RAM_HOT_DEBUG, vDebugOutput)(const sDebugRecord_t *const sRecord)
+{
+    const bool bRtosActive = !(taskSCHEDULER_NOT_STARTED == xTaskGetSchedulerState());
+    bool bTaken;
+
+    for (sDebugSink_t *sSink = sDebugSinks; NULL != sSink; sSink = sSink->sNext)
+    {
+        if (sSink->bEnabled && (sRecord->eLevel <= sSink->eLevel))
+        {
+            if (NULL != sSink->sQueue.pSlots)
+            {
+                bTaken = bDebugSinkQueue(sSink, sRecord, bRtosActive);
+            }
+            else
+            {
+                bTaken = sSink->pfWrite(sRecord, sSink->pvCtx);
+            }
+
+            if (!bTaken)
+            {
+                sSink->uDropped++;
+                vMetricsInc(MetricLogSinkDropped);
+            }
+        }
+    }
+}
+
+
+static bool RAM_FUNC(RAM_HOT_DEBUG, bDebugSinkQueue)(sDebugSink_t *const sSink, const sDebugRecord_t *const sRecord, const bool bRtosActive)
+{
+    sDebugSlot_t *const sSlot = (sDebugSlot_t *)pvSpscReserve(&sSink->sQueue);
+    uint32_t uCount;
+
+    // Single producer: the callers hold the message mutex
+    if (NULL != sSlot)
+    {
+        sSlot->sRecord = *sRecord;
+        sSlot->sRecord.cpText = sSlot->caText;
+        memcpy(sSlot->caText, sRecord->cpText, sRecord->uLen);
+        sSlot->caText[sRecord->uLen] = '\0';
+        vSpscCommit(&sSink->sQueue);
+
+        // The first record starts the flush time, a full batch is due now
+        uCount = uSpscCount(&sSink->sQueue);
+        if (bRtosActive && (NULL != xDebugSinkTask) && ((1UL == uCount) || (uCount >= sSink->uBatch)))
+        {
+            xTaskNotifyGive(xDebugSinkTask);
+        }
+    }
+
+    return (NULL != sSlot);
+}
+
+
+static void vDebugSinkUpdateMax(void)
+{
+    logLevel_t eMax = DBG_OFF;
+
+    for (const sDebugSink_t *sSink = sDebugSinks; NULL != sSink; sSink = sSink->sNext)
+    {
+        if (sSink->bEnabled && (sSink->eLevel > eMax))
+        {
+            eMax = sSink->eLevel;
+        }
+    }
+
+    eDebugSinkMax = eMax;
+}
+
+
+static void vDebugSinkTask(void *pvParameters)
+{
+    TickType_t xWait;
+    TickType_t xNow;
+    TickType_t xSinkWait;
+
+    (void)pvParameters; // Silence 'unused parameters'
+
+    while (true)
+    {
+        xWait = portMAX_DELAY;
+        xNow = xTaskGetTickCount();
+
+        for (sDebugSink_t *sSink = sDebugSinks; NULL != sSink; sSink = sSink->sNext)
+        {
+            if (NULL != sSink->sQueue.pSlots)
+            {
+                xSinkWait = xDebugSinkDrain(sSink, xNow);
+                xWait = (xSinkWait < xWait) ? xSinkWait : xWait;
+            }
+        }
+
+        (void)ulTaskNotifyTake(pdTRUE, xWait);
+    }
+}
+
+
+static TickType_t xDebugSinkDrain(sDebugSink_t *const sSink, const TickType_t xNow)
+{
+    TickType_t xWait = portMAX_DELAY;
+    sDebugSlot_t *sSlot;
+    bool bWritten = false;
+    const uint32_t uCount = uSpscCount(&sSink->sQueue);
+
+    if (0UL == uCount)
+    {
+        sSink->bPending = false;
+    }
+    else
+    {
+        if (!sSink->bPending)
+        {
+            sSink->bPending = true;
+            sSink->xDue = xNow + sSink->xFlush;
+        }
+
+        if ((uCount >= sSink->uBatch) || ((int32_t)(xNow - sSink->xDue) >= 0))
+        {
+            sSlot = (sDebugSlot_t *)pvSpscPeek(&sSink->sQueue);
+            while ((NULL != sSlot) && sSink->pfWrite(&sSlot->sRecord, sSink->pvCtx))
+            {
+                vSpscRelease(&sSink->sQueue);
+                bWritten = true;
+                sSlot = (sDebugSlot_t *)pvSpscPeek(&sSink->sQueue);
+            }
+
+            if (bWritten && (NULL != sSink->pfFlush))
+            {
+                sSink->bFlushReq = false;
+                sSink->pfFlush(sSink->pvCtx);
+            }
+
+            if (NULL != sSlot)
+            {
+                // Refused, retry after the flush time (at least a tick)
+                sSink->xDue = xNow + ((0UL == sSink->xFlush) ? 1UL : sSink->xFlush);
+                xWait = sSink->xDue - xNow;
+            }
+            else
+            {
+                sSink->bPending = false;
+            }
+        }
+        else
+        {
+            xWait = sSink->xDue - xNow;
+        }
+    }
+
+    // Requested from outside the task, see vDebugSinkRequestFlush
+    if (sSink->bFlushReq && (NULL != sSink->pfFlush))
+    {
+        sSink->bFlushReq = false;
+        sSink->pfFlush(sSink->pvCtx);
+    }
+
+    return (xWait);
+}
+
+
+static bool bDebugWriteCrash(const sDebugRecord_t *const sRecord, void *pvCtx)
+{
+    (void)pvCtx; // Silence 'unused parameters'
+
+    // Replayed lines come from the crash log itself
+    if (!sRecord->bReplay)
+    {
+        vCrashLogWrite(sRecord->cpText, sRecord->uLen);
+    }
+
+    return (true);
+}
+
+
+static bool RAM_FUNC(RAM_HOT_DEBUG, bDebugWriteUart)(const sDebugRecord_t *const sRecord, void *pvCtx)
+{
+    (void)pvCtx; // Silence 'unused parameters'
+
+    printf("%s", sRecord->cpText);
+
+    return (true);
+}
+
+
+static bool bDebugWriteFlash(const sDebugRecord_t *const sRecord, void *pvCtx)
+{
+    (void)pvCtx; // Silence 'unused parameters'
+
+    if (!sRecord->bReplay)
+    {
+        vFlashLogWrite(sRecord->eLevel, sRecord->eFunction, sRecord->cpText, sRecord->uLen);
+    }
+
+    return (true);
+}
+
+
+static bool RAM_FUNC(RAM_HOT_DEBUG, bDebugWriteWs)(const sDebugRecord_t *const sRecord, void *pvCtx)
+{
+    (void)pvCtx; // Silence 'unused parameters'
+
+    vWsPublish(WsText, sRecord->cpText, sRecord->uLen);
+
+    return (true);
+}
+
+
+static bool bDebugWriteUdp(const sDebugRecord_t *const sRecord, void *pvCtx)
+{
+    (void)pvCtx; // Silence 'unused parameters'
+
+    // Without a link the records are discarded, not kept
+    if (bDebugLinkUp)
+    {
+        vTcpUdpPrintUdp(sRecord->cpText, sRecord->uLen);
+    }
+
+    return (true);
+}
+
+
+static void vDebugFlushUdp(void *pvCtx)
+{
+    (void)pvCtx; // Silence 'unused parameters'
+
+    // Without a link the driver may be gone, like in bDebugWriteUdp
+    vTcpUdpFlushUdp(bDebugLinkUp);
+}
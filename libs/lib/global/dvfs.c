@@ -0,0 +1,386 @@
+/** ****************************************************************************
+ * @file   dvfs.c
+ *
+ * @author Michael R.
+ *
+ * @brief  Load driven system clock and core voltage governor
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdbool.h>
+
+// pico-sdk includes
+#include "pico/stdlib.h"
+#include "pico/cyw43_arch.h"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+#include "hardware/vreg.h"
+#if PICO_RP2040
+    #include "hardware/structs/vreg_and_chip_reset.h"
+#else
+    #include "hardware/structs/powman.h"
+#endif
+
+// FreeRTOS includes
+#include "FreeRTOS.h" /* Must come first. */
+#include "task.h"
+
+// Project includes
+#include "global/dvfs.h"
+#include "global/debug_print.h"
+#include "global/event_bus.h"
+#include "global/metrics.h"
+#include "global/stdout_async.h"
+
+#include "wlan/wlan.h"
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+#define DVFS_PRIORITY       (tskIDLE_PRIORITY + 3UL)
+#define DVFS_STACK          (512UL)
+
+/** A longer gap between two idle hook calls means the idle task was preempted */
+#define DVFS_IDLE_GAP_US    (100UL)
+
+/** Settling time of the regulator after raising the voltage */
+#define DVFS_VREG_SETTLE_US (1000UL)
+
+#define DVFS_STEPS          (sizeof(uaDvfsStepKhz) / sizeof(uaDvfsStepKhz[0]))
+
+/* --- Local type/struct definitions ---------------------------------------- */
+
+typedef struct sDvfsState_tag
+{
+    sDvfsPolicy_t sPolicy;
+    sDvfsDecision_t sDecision;
+    uint32_t uaIdleUs[configNUMBER_OF_CORES];   ///< Idle sum at the last period
+    uint32_t uPeriodUs;                         ///< Start of the current period
+    enum vreg_voltage eBootVoltage;             ///< Voltage of the fastest step
+    bool bUsable;                               ///< All steps are reachable
+} sDvfsState_t;
+
+/* --- Static variables ----------------------------------------------------- */
+
+/** Clock steps, ascending. The last one is the SDK default. */
+static const uint32_t uaDvfsStepKhz[] = {48000UL, 72000UL, 96000UL, SYS_CLK_KHZ};
+
+/** Voltage of the steps, the fastest one keeps the voltage set at boot */
+static const enum vreg_voltage eaDvfsStepVoltage[DVFS_STEPS - 1U] =
+{
+    VREG_VOLTAGE_1_00,
+    VREG_VOLTAGE_1_05,
+    VREG_VOLTAGE_1_05,
+};
+
+static sDvfsState_t sDvfsState =
+{
+    .sPolicy = {DVFS_UP_PERMILLE, DVFS_TARGET_PERMILLE, DVFS_DOWN_PERIODS},
+    .sDecision = {DVFS_STEPS - 1U, 0UL},
+};
+
+/** Only written by the idle hook of the own core */
+static volatile uint32_t uaDvfsIdleUs[configNUMBER_OF_CORES];
+static uint32_t uaDvfsIdleLastUs[configNUMBER_OF_CORES];
+
+/* --- Static function prototypes ------------------------------------------- */
+
+/**
+ * @brief The governor task
+ *
+ * @param pvParameters Unused
+ */
+static void vDvfsTask(void *pvParameters);
+
+/**
+ * @brief Load of both cores since the last call, gauges updated
+ *
+ * @return Load of the busier core in permille
+ */
+static uint32_t uDvfsBusyPermille(void);
+
+/**
+ * @brief Switch clock and voltage
+ *
+ * @param uFrom Current step
+ * @param uTo   New step
+ *
+ * @return true if the clock was changed
+ */
+static bool bDvfsApply(const uint32_t uFrom, const uint32_t uTo);
+
+/**
+ * @brief Voltage of a step
+ *
+ * @param uStep Step
+ *
+ * @return Voltage, never above the boot voltage
+ */
+static enum vreg_voltage eDvfsVoltage(const uint32_t uStep);
+
+/**
+ * @brief Voltage selected in the regulator
+ *
+ * @return Voltage
+ */
+static enum vreg_voltage eDvfsVoltageNow(void);
+
+/* --- Public functions ----------------------------------------------------- */
+
+eRetVal_t eDvfsRtosInit(void)
+{
+    eRetVal_t eRetVal = ErrNoError;
+    BaseType_t xReturned;
+    uint uVco;
+    uint uDiv1;
+    uint uDiv2;
+
+    sDvfsState.eBootVoltage = eDvfsVoltageNow();
+    sDvfsState.bUsable = (clock_get_hz(clk_sys) == (SYS_CLK_KHZ * 1000UL));
+
+    for (uint32_t i = 0U; i < DVFS_STEPS; i++)
+    {
+        sDvfsState.bUsable = sDvfsState.bUsable && check_sys_clock_khz(uaDvfsStepKhz[i], &uVco, &uDiv1, &uDiv2);
+    }
+
+    if (DVFS_ENABLED && !sDvfsState.bUsable)
+    {
+        DBG_PR(DBG_WARN, FN_POWER, "Clock steps not reachable, governor only measures\n");
+    }
+
+    vMetricsSet(MetricSysClkKhz, (int32_t)(clock_get_hz(clk_sys) / 1000UL));
+
+    xReturned = xTaskCreate(
+                    vDvfsTask,
+                    "DVFS",
+                    DVFS_STACK,
+                    NULL,
+                    DVFS_PRIORITY,
+                    NULL);
+
+    if (pdPASS != xReturned)
+    {
+        eRetVal = ErrError;
+    }
+
+    return (eRetVal);
+}
+
+
+void vDvfsIdle(void)
+{
+    const uint32_t uIrq = save_and_disable_interrupts();
+    const uint32_t uCore = get_core_num();
+    const uint32_t uNowUs = time_us_32();
+    const uint32_t uGapUs = uNowUs - uaDvfsIdleLastUs[uCore];
+
+    if (uGapUs < DVFS_IDLE_GAP_US)
+    {
+        uaDvfsIdleUs[uCore] += uGapUs;
+    }
+    uaDvfsIdleLastUs[uCore] = uNowUs;
+
+    restore_interrupts(uIrq);
+}
+
+
+void vDvfsIdleSlept(const uint32_t uSleptUs)
+{
+    const uint32_t uIrq = save_and_disable_interrupts();
+    const uint32_t uCore = get_core_num();
+
+    // The gap of the next vDvfsIdle() call starts after the sleep
+    uaDvfsIdleUs[uCore] += uSleptUs;
+    uaDvfsIdleLastUs[uCore] = time_us_32();
+
+    restore_interrupts(uIrq);
+}
+
+
+eRetVal_t eDvfsSetPolicy(const sDvfsPolicy_t *const sPolicy)
+{
+    eRetVal_t eRetVal = ErrNoError;
+
+    if ((sPolicy->uUpPermille > 1000UL) ||
+        (sPolicy->uTargetPermille >= sPolicy->uUpPermille) ||
+        (0UL == sPolicy->uDownPeriods))
+    {
+        eRetVal = ErrError;
+    }
+    else
+    {
+        taskENTER_CRITICAL();
+        sDvfsState.sPolicy = *sPolicy;
+        taskEXIT_CRITICAL();
+    }
+
+    return (eRetVal);
+}
+
+
+void vDvfsGetPolicy(sDvfsPolicy_t *const sPolicy)
+{
+    taskENTER_CRITICAL();
+    *sPolicy = sDvfsState.sPolicy;
+    taskEXIT_CRITICAL();
+}
+
+/* --- Static functions ----------------------------------------------------- */
+
+static void vDvfsTask(void *pvParameters)
+{
+    (void)pvParameters; // Silence 'unused parameters'
+
+    TickType_t xLastWake = xTaskGetTickCount();
+    sDvfsPolicy_t sPolicy;
+    uint32_t uBusy;
+    uint32_t uFrom;
+    uint32_t uTo;
+
+    DBG_PR(DBG_INFO, FN_POWER, "\n");
+
+    sDvfsState.uPeriodUs = time_us_32();
+
+    while (true)
+    {
+        vTaskDelayUntil(&xLastWake, pdMS_TO_TICKS(DVFS_PERIOD_MS));
+
+        uBusy = uDvfsBusyPermille();
+
+        if (DVFS_ENABLED && sDvfsState.bUsable)
+        {
+            vDvfsGetPolicy(&sPolicy);
+            uFrom = sDvfsState.sDecision.uStep;
+            uTo = uDvfsDecide(&sDvfsState.sDecision, &sPolicy, uaDvfsStepKhz, DVFS_STEPS, uBusy);
+
+            if (uTo != uFrom)
+            {
+                if (bDvfsApply(uFrom, uTo))
+                {
+                    vMetricsInc((uTo > uFrom) ? MetricDvfsUp : MetricDvfsDown);
+                    vMetricsSet(MetricSysClkKhz, (int32_t)uaDvfsStepKhz[uTo]);
+                    vEventPublish(EventClockChanged, uaDvfsStepKhz[uTo]);
+                }
+                else
+                {
+                    // Stay where the hardware is, try again next period
+                    vMetricsInc(MetricDvfsFailed);
+                    sDvfsState.sDecision.uStep = uFrom;
+                }
+            }
+        }
+    }
+}
+
+
+static uint32_t uDvfsBusyPermille(void)
+{
+    const uint32_t uNowUs = time_us_32();
+    const uint32_t uPeriodUs = uNowUs - sDvfsState.uPeriodUs;
+    uint32_t uIdleUs;
+    uint32_t uBusy;
+    uint32_t uMaxBusy = 0UL;
+
+    sDvfsState.uPeriodUs = uNowUs;
+
+    for (uint32_t uCore = 0U; uCore < configNUMBER_OF_CORES; uCore++)
+    {
+        uIdleUs = uaDvfsIdleUs[uCore] - sDvfsState.uaIdleUs[uCore];
+        sDvfsState.uaIdleUs[uCore] += uIdleUs;
+
+        uBusy = 0UL;
+        if ((0UL != uPeriodUs) && (uIdleUs < uPeriodUs))
+        {
+            uBusy = 1000UL - (uint32_t)(((uint64_t)uIdleUs * 1000ULL) / uPeriodUs);
+        }
+
+        vMetricsSet((0U == uCore) ? MetricCore0BusyPermille : MetricCore1BusyPermille, (int32_t)uBusy);
+        if (uBusy > uMaxBusy)
+        {
+            uMaxBusy = uBusy;
+        }
+    }
+
+    return (uMaxBusy);
+}
+
+
+static bool bDvfsApply(const uint32_t uFrom, const uint32_t uTo)
+{
+    bool bOk;
+    // The CYW43 lock only exists while the driver is initialised
+    const bool bCyw43 = bWlanDriverUp();
+
+    // No SPI transfer to the CYW43 while clk_sys runs from clk_ref, without
+    // the driver at least no task switch in the middle of the change
+    if (bCyw43)
+    {
+        cyw43_arch_lwip_begin();
+    }
+    else
+    {
+        vTaskSuspendAll();
+    }
+
+    if (DVFS_VOLTAGE && (uTo > uFrom))
+    {
+        vreg_set_voltage(eDvfsVoltage(uTo));
+        busy_wait_us(DVFS_VREG_SETTLE_US);
+    }
+
+    bOk = set_sys_clock_khz(uaDvfsStepKhz[uTo], false);
+
+    if (DVFS_VOLTAGE && bOk && (uTo < uFrom))
+    {
+        vreg_set_voltage(eDvfsVoltage(uTo));
+    }
+
+#if STDIO_UART
+    // clk_peri follows clk_sys
+    uart_set_baudrate(uart_default, PICO_DEFAULT_UART_BAUD_RATE);
+#endif
+
+    // The CYW43 PIO divider stays: slower on the low steps, never above spec
+
+    if (bCyw43)
+    {
+        cyw43_arch_lwip_end();
+    }
+    else
+    {
+        (void)xTaskResumeAll();
+    }
+
+    return (bOk);
+}
+
+
+static enum vreg_voltage eDvfsVoltage(const uint32_t uStep)
+{
+    enum vreg_voltage eVoltage = sDvfsState.eBootVoltage;
+
+    if (((uStep + 1U) < DVFS_STEPS) && (eaDvfsStepVoltage[uStep] < eVoltage))
+    {
+        eVoltage = eaDvfsStepVoltage[uStep];
+    }
+
+    return (eVoltage);
+}
+
+
+static enum vreg_voltage eDvfsVoltageNow(void)
+{
+    enum vreg_voltage eVoltage;
+
+#if PICO_RP2040
+    eVoltage = (enum vreg_voltage)((vreg_and_chip_reset_hw->vreg & VREG_AND_CHIP_RESET_VREG_VSEL_BITS) >>
+                                   VREG_AND_CHIP_RESET_VREG_VSEL_LSB);
+#else
+    eVoltage = (enum vreg_voltage)((powman_hw->vreg & POWMAN_VREG_VSEL_BITS) >> POWMAN_VREG_VSEL_LSB);
+#endif
+
+    return (eVoltage);
+}
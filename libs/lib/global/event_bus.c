@@ -0,0 +1,132 @@
+/** ****************************************************************************
+ * @file   event_bus.c
+ *
+ * @author Michael R.
+ *
+ * @brief  Publish/subscribe of framework events between the modules
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdbool.h>
+#include <stddef.h>
+
+// pico-sdk includes
+#include "hardware/sync.h"
+
+// FreeRTOS includes
+#include "FreeRTOS.h" /* Must come first. */
+#include "task.h"
+
+// Project includes
+#include "global/event_bus.h"
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+/* --- Local type/struct definitions ---------------------------------------- */
+
+/* --- Static variables ----------------------------------------------------- */
+
+/** Subscriptions per event, sorted by eOrder */
+static sEventSub_t *volatile saEventHead[NumEvent];
+
+static volatile uint32_t uaEventArg[NumEvent];
+
+/* --- Static function prototypes ------------------------------------------- */
+
+/**
+ * @brief Insert behind all subscriptions of the same or a lower order
+ *
+ * The list is never modified in a way a concurrent publish could see broken:
+ * the new record is complete before the single store linking it in.
+ *
+ * @param sSub   Subscription
+ * @param eEvent Event
+ */
+static void vEventInsert(sEventSub_t *const sSub, const eEvent_t eEvent);
+
+/* --- Public functions ----------------------------------------------------- */
+
+void vEventSubscribe(
+    sEventSub_t *const sSub,
+    const eEvent_t eEvent,
+    const pfEventHandler_t pfHandler,
+    const eEventOrder_t eOrder)
+{
+    sSub->pfHandler = pfHandler;
+    sSub->xTask = NULL;
+    sSub->uBits = 0UL;
+    sSub->eOrder = eOrder;
+
+    vEventInsert(sSub, eEvent);
+}
+
+
+void vEventSubscribeTask(
+    sEventSub_t *const sSub,
+    const eEvent_t eEvent,
+    const TaskHandle_t xTask,
+    const uint32_t uBits)
+{
+    sSub->pfHandler = NULL;
+    sSub->xTask = xTask;
+    sSub->uBits = uBits;
+    sSub->eOrder = EventOrderNormal;
+
+    vEventInsert(sSub, eEvent);
+}
+
+
+void vEventPublish(const eEvent_t eEvent, const uint32_t uArg)
+{
+    uaEventArg[eEvent] = uArg;
+
+    for (sEventSub_t *sSub = saEventHead[eEvent]; NULL != sSub; sSub = sSub->sNext)
+    {
+        if (NULL != sSub->pfHandler)
+        {
+            sSub->pfHandler(eEvent, uArg);
+        }
+        else if (NULL != sSub->xTask)
+        {
+            xTaskNotify(sSub->xTask, sSub->uBits, eSetBits);
+        }
+    }
+}
+
+
+uint32_t uEventLast(const eEvent_t eEvent)
+{
+    return (uaEventArg[eEvent]);
+}
+
+/* --- Static functions ----------------------------------------------------- */
+
+static void vEventInsert(sEventSub_t *const sSub, const eEvent_t eEvent)
+{
+    const bool bRtosActive = !(taskSCHEDULER_NOT_STARTED == xTaskGetSchedulerState());
+    sEventSub_t *volatile *psLink = &saEventHead[eEvent];
+
+    // Subscriptions from the init functions come before the scheduler
+    if (bRtosActive)
+    {
+        taskENTER_CRITICAL();
+    }
+
+    while ((NULL != *psLink) && ((*psLink)->eOrder <= sSub->eOrder))
+    {
+        psLink = &(*psLink)->sNext;
+    }
+
+    sSub->sNext = *psLink;
+    __dmb();
+    *psLink = sSub;
+
+    if (bRtosActive)
+    {
+        taskEXIT_CRITICAL();
+    }
+}
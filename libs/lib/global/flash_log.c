@@ -0,0 +1,651 @@
+/** ****************************************************************************
+ * @file   flash_log.c
+ *
+ * @author Michael R.
+ *
+ * @brief  Wear-levelled log store in the last sectors of the flash
+ *
+ * Sector layout: 16 byte header (magic, sequence number, reserved, CRC of
+ * the header), followed by records (12 byte header, text padded to 4 bytes).
+ * The sector with the sequence number n is always the sector
+ * n % FLASH_LOG_SECTORS, so the ring order follows from the numbers alone.
+ * After a reboot a new sector is started, the rest of the last one stays
+ * erased.
+ *
+ * Two RAM images: DBG_PR fills one while the task may still write the other.
+ * The CRCs are calculated by the task, DBG_PR only copies.
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+// pico-sdk includes
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "pico/aon_timer.h"
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+
+// FreeRTOS includes
+#include "FreeRTOS.h" /* Must come first. */
+#include "task.h"
+
+// Project includes
+#include "global/flash_log.h"
+#include "global/metrics.h"
+#include "global/utils.h"
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+#define FLASH_LOG_PRIORITY     (tskIDLE_PRIORITY + 1UL)
+#define FLASH_LOG_STACK        (512UL * 2U)
+
+#define FLASH_LOG_MAGIC        (0x464C4F47UL)   // "FLOG"
+
+#define FLASH_LOG_AREA_SIZE    (FLASH_LOG_SECTORS * FLASH_SECTOR_SIZE)
+#define FLASH_LOG_OFFSET       (PICO_FLASH_SIZE_BYTES - FLASH_LOG_AREA_SIZE)
+
+/** Sector header and record header */
+#define FLASH_LOG_SECTOR_HDR   (sizeof(sFlashLogSector_t))
+#define FLASH_LOG_RECORD_HDR   (sizeof(sFlashLogRec_t))
+
+/** Records are padded to 4 bytes, the headers stay aligned (Cortex-M0+) */
+#define FLASH_LOG_RECORD_SIZE(_LEN) (FLASH_LOG_RECORD_HDR + (((_LEN) + 3U) & ~3U))
+
+/** Start estimate of the time to program one page */
+#define FLASH_LOG_PAGE_US      (1000UL)
+
+/** Timeout of flash_safe_execute() for stopping the other core */
+#define FLASH_LOG_LOCK_MS      (100UL)
+
+/** Records (or skipped sectors) a query checks per call */
+#define FLASH_LOG_QUERY_STEPS  (16UL)
+
+/* --- Local type/struct definitions ---------------------------------------- */
+
+/**
+ * @brief Ennumeration of the Notification flags for the flash log task
+ */
+typedef enum eFlashLogNotifications_tag
+{
+    FlashLogImageFull = (1UL << 0U),
+} eFlashLogNotifications_t;
+
+typedef struct sFlashLogSector_tag
+{
+    uint32_t uMagic;
+    uint32_t uSeq;
+    uint32_t uReserved;
+    uint32_t uCrc;                  ///< CRC-32 of the fields above
+} sFlashLogSector_t;
+
+typedef struct sFlashLogRec_tag
+{
+    uint16_t uLen;                  ///< Text length, 0xFFFF = erased
+    uint8_t uLevel;
+    uint8_t uFunction;
+    uint32_t uTime;
+    uint32_t uCrc;                  ///< CRC-32 of header (without uCrc) and text
+} sFlashLogRec_t;
+
+typedef enum eFlashLogImage_tag
+{
+    ImageFree,
+    ImageFilling,
+    ImageFull
+} eFlashLogImage_t;
+
+/**
+ * @brief RAM copy of the sector currently written
+ */
+typedef struct sFlashLogImage_tag
+{
+    uint8_t uaData[FLASH_SECTOR_SIZE] __attribute__((aligned(4)));
+    volatile uint16_t uUsed;        ///< Written by DBG_PR
+    volatile uint8_t eState;        ///< eFlashLogImage_t
+    uint16_t uCrcPos;               ///< Next record without CRC (task)
+    uint16_t uProgrammed;           ///< Bytes already in the flash (task)
+    uint32_t uSeq;                  ///< Target sector (task)
+} sFlashLogImage_t;
+
+/**
+ * @brief Parameter of the flash operations
+ */
+typedef struct sFlashLogOp_tag
+{
+    uint32_t uOffset;
+    const uint8_t *pData;           ///< NULL = erase
+    uint32_t uLen;
+} sFlashLogOp_t;
+
+typedef struct sFlashLogState_tag
+{
+    bool bEnabled;
+    TaskHandle_t xTask;
+    sFlashLogImage_t saImage[2];
+    uint8_t uFillImage;             ///< Image DBG_PR writes into
+    uint8_t uFlushImage;            ///< Oldest image not completely written
+
+    volatile uint32_t uMinSeq;      ///< Oldest valid sector
+    volatile uint32_t uNextSeq;     ///< Sequence number of the next sector
+    uint32_t uaSeq[FLASH_LOG_SECTORS];
+
+    volatile uint32_t uTimeOffset;  ///< Unix time - uptime in s
+    uint32_t uPageUs;               ///< Measured time to program a page
+} sFlashLogState_t;
+
+/* --- Static variables ----------------------------------------------------- */
+
+static sFlashLogState_t sFlashLogState;
+
+/* --- Static function prototypes ------------------------------------------- */
+
+/**
+ * @brief Flash log task. Writes the RAM images.
+ *
+ * @param pvParameters Unused
+ */
+static void vFlashLogTask(void *pvParameters);
+
+/**
+ * @brief Write the completed part of an image
+ *
+ * @param sImage Image
+ * @param bFinal true: also the last partial page, the image is full
+ */
+static void vFlashLogFlush(sFlashLogImage_t *const sImage, const bool bFinal);
+
+/**
+ * @brief Execute one erase or program with the other core stopped
+ *
+ * @param uOffset Flash offset
+ * @param pData   Data to program, NULL to erase one sector
+ * @param uLen    Length of the data
+ *
+ * @return Duration of the stall in us
+ */
+static uint32_t uFlashLogExecute(const uint32_t uOffset, const uint8_t *pData, const uint32_t uLen);
+
+/**
+ * @brief Called by flash_safe_execute() with the XIP stopped
+ *
+ * @param pvParam sFlashLogOp_t
+ */
+static void __not_in_flash_func(vFlashLogOp)(void *pvParam);
+
+/**
+ * @brief CRC-32 (reflected, 0xEDB88320), continued from uCrc
+ *
+ * @param uCrc  Start value, 0 for a new CRC
+ * @param pData Data
+ * @param uLen  Length of the data
+ *
+ * @return CRC
+ */
+static uint32_t uFlashLogCrc(uint32_t uCrc, const void *pData, const uint32_t uLen);
+
+/**
+ * @brief Check the header of a sector in the flash
+ *
+ * @param uSector Sector index
+ * @param puSeq   Sequence number of the sector
+ *
+ * @return true if the header is valid
+ */
+static bool bFlashLogSectorValid(const uint32_t uSector, uint32_t *const puSeq);
+
+/**
+ * @brief Current time for the records
+ *
+ * @return Unix time in s
+ */
+static inline uint32_t uFlashLogNow(void);
+
+/* --- Public functions ----------------------------------------------------- */
+
+eRetVal_t eFlashLogPreInit(void)
+{
+    eRetVal_t eRetVal = ErrNoError;
+    extern char __flash_binary_end;
+    bool bAny = false;
+    uint32_t uSeq;
+    uint32_t uMax = 0UL;
+    uint32_t uMin = UINT32_MAX;
+
+    memset(&sFlashLogState, 0, sizeof(sFlashLogState));
+    sFlashLogState.uPageUs = FLASH_LOG_PAGE_US;
+
+    // Never overwrite the firmware
+    sFlashLogState.bEnabled = (((uintptr_t)&__flash_binary_end - XIP_BASE) <= FLASH_LOG_OFFSET);
+
+    // Index scan: only the sector headers are read
+    for (uint32_t uSector = 0UL; sFlashLogState.bEnabled && (uSector < FLASH_LOG_SECTORS); uSector++)
+    {
+        sFlashLogState.uaSeq[uSector] = UINT32_MAX;
+
+        if (bFlashLogSectorValid(uSector, &uSeq))
+        {
+            sFlashLogState.uaSeq[uSector] = uSeq;
+
+            uMax = (uSeq > uMax) ? uSeq : uMax;
+            uMin = (uSeq < uMin) ? uSeq : uMin;
+            bAny = true;
+        }
+    }
+
+    if (bAny)
+    {
+        // Sectors from an older cycle might survive a reboot during erase
+        sFlashLogState.uMinSeq = ((uMax - uMin) >= FLASH_LOG_SECTORS) ? (uMax - FLASH_LOG_SECTORS + 1UL) : uMin;
+        sFlashLogState.uNextSeq = uMax + 1UL;
+    }
+
+    sFlashLogState.saImage[0].eState = ImageFilling;
+    sFlashLogState.saImage[0].uUsed = FLASH_LOG_SECTOR_HDR;
+    sFlashLogState.saImage[0].uCrcPos = FLASH_LOG_SECTOR_HDR;
+    sFlashLogState.saImage[1].uCrcPos = FLASH_LOG_SECTOR_HDR;
+
+    return (eRetVal);
+}
+
+
+eRetVal_t eFlashLogRtosInit(void)
+{
+    eRetVal_t eRetVal = ErrNoError;
+    BaseType_t xReturned;
+
+    if (sFlashLogState.bEnabled)
+    {
+        DBG_PR(
+            DBG_INFO,
+            FN_MAIN,
+            "Flash log: %u sectors at 0x%08lx, sequence %lu..%lu\n",
+            FLASH_LOG_SECTORS,
+            (unsigned long)FLASH_LOG_OFFSET,
+            sFlashLogState.uMinSeq,
+            sFlashLogState.uNextSeq);
+
+        xReturned = xTaskCreate(
+                        vFlashLogTask,
+                        "FlashLog",
+                        FLASH_LOG_STACK,
+                        NULL,
+                        FLASH_LOG_PRIORITY,
+                        &sFlashLogState.xTask);
+
+        if (pdPASS != xReturned)
+        {
+            eRetVal = ErrError;
+        }
+    }
+    else
+    {
+        DBG_PR(DBG_ERROR, FN_MAIN, "Flash log overlaps the firmware, disabled!\n");
+    }
+
+    return (eRetVal);
+}
+
+
+void vFlashLogWrite(const logLevel_t eLevel, const function_t eFunction, const char *cpText, uint16_t uLen)
+{
+    sFlashLogImage_t *sImage = &sFlashLogState.saImage[sFlashLogState.uFillImage];
+    sFlashLogImage_t *sOther;
+    sFlashLogRec_t *sRec;
+    bool bFits = true;
+
+    // The level is checked by the debug sink
+    if (sFlashLogState.bEnabled)
+    {
+        uLen = (uLen > FLASH_LOG_MAX_TEXT) ? FLASH_LOG_MAX_TEXT : uLen;
+
+        if ((sImage->uUsed + FLASH_LOG_RECORD_SIZE(uLen)) > FLASH_SECTOR_SIZE)
+        {
+            sOther = &sFlashLogState.saImage[sFlashLogState.uFillImage ^ 1U];
+
+            taskENTER_CRITICAL();
+            if (ImageFree == sOther->eState)
+            {
+                sOther->uUsed = FLASH_LOG_SECTOR_HDR;
+                sOther->eState = ImageFilling;
+                sImage->eState = ImageFull;
+                sFlashLogState.uFillImage ^= 1U;
+                sImage = sOther;
+            }
+            else
+            {
+                bFits = false;
+            }
+            taskEXIT_CRITICAL();
+
+            if (NULL != sFlashLogState.xTask)
+            {
+                xTaskNotify(sFlashLogState.xTask, FlashLogImageFull, eSetBits);
+            }
+        }
+
+        if (bFits)
+        {
+            sRec = (sFlashLogRec_t *)&sImage->uaData[sImage->uUsed];
+            sRec->uLen = uLen;
+            sRec->uLevel = (uint8_t)eLevel;
+            sRec->uFunction = (uint8_t)eFunction;
+            sRec->uTime = uFlashLogNow();
+            sRec->uCrc = 0UL;
+            memcpy(&sImage->uaData[sImage->uUsed + FLASH_LOG_RECORD_HDR], cpText, uLen);
+
+            // The task only looks at complete records
+            __dmb();
+            sImage->uUsed += FLASH_LOG_RECORD_SIZE(uLen);
+        }
+        else
+        {
+            // Both images busy: the flash can not keep up
+            vMetricsInc(MetricFlashLogDropped);
+        }
+    }
+}
+
+
+void vFlashLogQueryStart(
+    sFlashLogQuery_t *const sQuery,
+    const uint32_t uFrom,
+    const uint32_t uTo,
+    const logLevel_t eLevel)
+{
+    // Records from before the SNTP sync carry the uptime, the times are not
+    // in order: all sectors are checked
+    sQuery->uFrom = uFrom;
+    sQuery->uTo = uTo;
+    sQuery->eLevel = eLevel;
+    sQuery->uSeq = sFlashLogState.uMinSeq;
+    sQuery->uOffset = FLASH_LOG_SECTOR_HDR;
+}
+
+
+eFlashLogQueryResult_t eFlashLogQueryNext(sFlashLogQuery_t *const sQuery, sFlashLogRecord_t *const sRecord)
+{
+    eFlashLogQueryResult_t eResult = FlashLogQueryPending;
+    uint32_t uSteps = 0UL;
+    bool bNextSector;
+    uint32_t uSector;
+    uint32_t uSeq;
+    uint32_t uCrc;
+    sFlashLogRec_t sRec;
+    const uint8_t *pSector;
+
+    // Bounded, the caller runs in the lwIP context
+    while ((FlashLogQueryPending == eResult) &&
+           (uSteps < FLASH_LOG_QUERY_STEPS) &&
+           sFlashLogState.bEnabled &&
+           (sQuery->uSeq < sFlashLogState.uNextSeq))
+    {
+        uSteps++;
+        bNextSector = true;
+
+        // The writer overtook the query
+        if (sQuery->uSeq < sFlashLogState.uMinSeq)
+        {
+            sQuery->uSeq = sFlashLogState.uMinSeq;
+            sQuery->uOffset = FLASH_LOG_SECTOR_HDR;
+        }
+
+        uSector = sQuery->uSeq % FLASH_LOG_SECTORS;
+        pSector = (const uint8_t *)(XIP_BASE + FLASH_LOG_OFFSET + (uSector * FLASH_SECTOR_SIZE));
+
+        if ((sFlashLogState.uaSeq[uSector] == sQuery->uSeq) &&
+            ((sQuery->uOffset + FLASH_LOG_RECORD_HDR) <= FLASH_SECTOR_SIZE))
+        {
+            // Copy first, the sector might be erased meanwhile
+            memcpy(&sRec, &pSector[sQuery->uOffset], FLASH_LOG_RECORD_HDR);
+
+            if ((sRec.uLen <= FLASH_LOG_MAX_TEXT) &&
+                ((sQuery->uOffset + FLASH_LOG_RECORD_HDR + sRec.uLen) <= FLASH_SECTOR_SIZE))
+            {
+                memcpy(sRecord->caText, &pSector[sQuery->uOffset + FLASH_LOG_RECORD_HDR], sRec.uLen);
+                sRecord->caText[sRec.uLen] = '\0';
+
+                uCrc = uFlashLogCrc(0UL, &sRec, offsetof(sFlashLogRec_t, uCrc));
+                uCrc = uFlashLogCrc(uCrc, sRecord->caText, sRec.uLen);
+
+                // A bad CRC marks the end of the written part
+                if ((uCrc == sRec.uCrc) && bFlashLogSectorValid(uSector, &uSeq) && (uSeq == sQuery->uSeq))
+                {
+                    bNextSector = false;
+                    sQuery->uOffset += FLASH_LOG_RECORD_SIZE(sRec.uLen);
+
+                    if ((sRec.uTime >= sQuery->uFrom) &&
+                        (sRec.uTime <= sQuery->uTo) &&
+                        (sRec.uLevel <= sQuery->eLevel))
+                    {
+                        sRecord->uTime = sRec.uTime;
+                        sRecord->eLevel = (logLevel_t)sRec.uLevel;
+                        sRecord->eFunction = (function_t)sRec.uFunction;
+                        sRecord->uLen = sRec.uLen;
+                        eResult = FlashLogQueryRecord;
+                    }
+                }
+            }
+        }
+
+        if (bNextSector)
+        {
+            sQuery->uSeq++;
+            sQuery->uOffset = FLASH_LOG_SECTOR_HDR;
+        }
+    }
+
+    if ((FlashLogQueryPending == eResult) &&
+        (!sFlashLogState.bEnabled || (sQuery->uSeq >= sFlashLogState.uNextSeq)))
+    {
+        eResult = FlashLogQueryEnd;
+    }
+
+    return (eResult);
+}
+
+/* --- Static functions ----------------------------------------------------- */
+
+static void vFlashLogTask(void *pvParameters)
+{
+    (void)pvParameters; // Silence 'unused parameters'
+
+    uint32_t uNotifyVector = 0UL;
+    sFlashLogImage_t *sImage;
+    struct timespec sTime;
+
+    while (1)
+    {
+        uNotifyVector = 0UL;
+        xTaskNotifyWait(0UL, UINT32_MAX, &uNotifyVector, pdMS_TO_TICKS(FLASH_LOG_FLUSH_MS));
+
+        // Follow the SNTP time
+        if (aon_timer_get_time(&sTime))
+        {
+            sFlashLogState.uTimeOffset = (uint32_t)sTime.tv_sec - (uint32_t)(time_us_64() / 1000000ULL);
+        }
+
+        // Complete images in order, then the completed pages of the current
+        // one (only on the periodic flush)
+        sImage = &sFlashLogState.saImage[sFlashLogState.uFlushImage];
+        while (ImageFull == sImage->eState)
+        {
+            vFlashLogFlush(sImage, true);
+
+            sImage->uProgrammed = 0U;
+            sImage->uCrcPos = FLASH_LOG_SECTOR_HDR;
+            taskENTER_CRITICAL();
+            sImage->eState = ImageFree;
+            taskEXIT_CRITICAL();
+
+            sFlashLogState.uFlushImage ^= 1U;
+            sImage = &sFlashLogState.saImage[sFlashLogState.uFlushImage];
+        }
+
+        if ((ImageFilling == sImage->eState) && !TEST_PAT(uNotifyVector, FlashLogImageFull))
+        {
+            vFlashLogFlush(sImage, false);
+        }
+    }
+}
+
+
+static void vFlashLogFlush(sFlashLogImage_t *const sImage, const bool bFinal)
+{
+    const uint16_t uUsed = sImage->uUsed;
+    sFlashLogSector_t sHeader;
+    sFlashLogRec_t *sRec;
+    uint32_t uSector;
+    uint32_t uEnd;
+    uint32_t uPages;
+    uint32_t uStallUs;
+
+    // CRCs of the complete records
+    while ((sImage->uCrcPos + FLASH_LOG_RECORD_HDR) <= uUsed)
+    {
+        sRec = (sFlashLogRec_t *)&sImage->uaData[sImage->uCrcPos];
+        sRec->uCrc = uFlashLogCrc(0UL, sRec, offsetof(sFlashLogRec_t, uCrc));
+        sRec->uCrc = uFlashLogCrc(sRec->uCrc, &sImage->uaData[sImage->uCrcPos + FLASH_LOG_RECORD_HDR], sRec->uLen);
+        sImage->uCrcPos += FLASH_LOG_RECORD_SIZE(sRec->uLen);
+    }
+
+    uEnd = bFinal ? ((uUsed + FLASH_PAGE_SIZE - 1U) & ~(FLASH_PAGE_SIZE - 1U))
+                  : (uUsed & ~(FLASH_PAGE_SIZE - 1U));
+
+    if (bFinal)
+    {
+        memset(&sImage->uaData[uUsed], 0xFF, uEnd - uUsed);
+    }
+
+    if ((0U == sImage->uProgrammed) && (uEnd > 0U))
+    {
+        // First page: take the next sector of the ring
+        sImage->uSeq = sFlashLogState.uNextSeq++;
+        uSector = sImage->uSeq % FLASH_LOG_SECTORS;
+
+        sHeader.uMagic = FLASH_LOG_MAGIC;
+        sHeader.uSeq = sImage->uSeq;
+        sHeader.uReserved = UINT32_MAX;
+        sHeader.uCrc = uFlashLogCrc(0UL, &sHeader, offsetof(sFlashLogSector_t, uCrc));
+        memcpy(sImage->uaData, &sHeader, FLASH_LOG_SECTOR_HDR);
+
+        // Invalidate the index entry before the old content is gone
+        sFlashLogState.uaSeq[uSector] = UINT32_MAX;
+        if (sImage->uSeq >= FLASH_LOG_SECTORS)
+        {
+            sFlashLogState.uMinSeq = sImage->uSeq - FLASH_LOG_SECTORS + 1UL;
+        }
+
+        uStallUs = uFlashLogExecute(FLASH_LOG_OFFSET + (uSector * FLASH_SECTOR_SIZE), NULL, FLASH_SECTOR_SIZE);
+        vMetricsInc(MetricFlashLogErases);
+        DBG_PR(DBG_DEBUG, FN_MAIN, "Sector %lu (seq %lu) erased in %lu us\n", uSector, sImage->uSeq, uStallUs);
+
+        sFlashLogState.uaSeq[uSector] = sImage->uSeq;
+    }
+
+    uSector = sImage->uSeq % FLASH_LOG_SECTORS;
+
+    while (sImage->uProgrammed < uEnd)
+    {
+        // As many pages as the stall budget allows, at least one
+        uPages = FLASH_LOG_STALL_US / sFlashLogState.uPageUs;
+        uPages = (0UL == uPages) ? 1UL : uPages;
+        if ((sImage->uProgrammed + (uPages * FLASH_PAGE_SIZE)) > uEnd)
+        {
+            uPages = (uEnd - sImage->uProgrammed) / FLASH_PAGE_SIZE;
+        }
+
+        uStallUs = uFlashLogExecute(
+                        FLASH_LOG_OFFSET + (uSector * FLASH_SECTOR_SIZE) + sImage->uProgrammed,
+                        &sImage->uaData[sImage->uProgrammed],
+                        uPages * FLASH_PAGE_SIZE);
+
+        // Moving average of the page time
+        sFlashLogState.uPageUs = ((3UL * sFlashLogState.uPageUs) + (uStallUs / uPages) + 3UL) / 4UL;
+
+        sImage->uProgrammed += uPages * FLASH_PAGE_SIZE;
+
+        // Let the other tasks use the flash again
+        vTaskDelay(1);
+    }
+}
+
+
+static uint32_t uFlashLogExecute(const uint32_t uOffset, const uint8_t *pData, const uint32_t uLen)
+{
+    sFlashLogOp_t sOp = {.uOffset = uOffset, .pData = pData, .uLen = uLen};
+    const uint32_t uStartUs = time_us_32();
+    uint32_t uStallUs;
+
+    if (PICO_OK != flash_safe_execute(vFlashLogOp, &sOp, FLASH_LOG_LOCK_MS))
+    {
+        vMetricsInc(MetricFlashLogDropped);
+    }
+
+    uStallUs = time_us_32() - uStartUs;
+    vMetricsObserve(MetricFlashStallUs, uStallUs);
+
+    return (uStallUs);
+}
+
+
+static void __not_in_flash_func(vFlashLogOp)(void *pvParam)
+{
+    const sFlashLogOp_t *const sOp = (const sFlashLogOp_t *)pvParam;
+
+    if (NULL == sOp->pData)
+    {
+        flash_range_erase(sOp->uOffset, sOp->uLen);
+    }
+    else
+    {
+        flash_range_program(sOp->uOffset, sOp->pData, sOp->uLen);
+    }
+}
+
+
+static uint32_t uFlashLogCrc(uint32_t uCrc, const void *pData, const uint32_t uLen)
+{
+    const uint8_t *pByte = (const uint8_t *)pData;
+
+    uCrc = ~uCrc;
+
+    for (uint32_t i = 0UL; i < uLen; i++)
+    {
+        uCrc ^= pByte[i];
+        for (uint8_t uBit = 0U; uBit < 8U; uBit++)
+        {
+            uCrc = (uCrc >> 1U) ^ (0xEDB88320UL & (0UL - (uCrc & 1UL)));
+        }
+    }
+
+    return (~uCrc);
+}
+
+
+static bool bFlashLogSectorValid(const uint32_t uSector, uint32_t *const puSeq)
+{
+    sFlashLogSector_t sHeader;
+    bool bRetVal;
+
+    memcpy(&sHeader, (const void *)(XIP_BASE + FLASH_LOG_OFFSET + (uSector * FLASH_SECTOR_SIZE)), FLASH_LOG_SECTOR_HDR);
+
+    bRetVal = (FLASH_LOG_MAGIC == sHeader.uMagic) &&
+              ((sHeader.uSeq % FLASH_LOG_SECTORS) == uSector) &&
+              (sHeader.uCrc == uFlashLogCrc(0UL, &sHeader, offsetof(sFlashLogSector_t, uCrc)));
+    *puSeq = sHeader.uSeq;
+
+    return (bRetVal);
+}
+
+
+static inline uint32_t uFlashLogNow(void)
+{
+    return ((uint32_t)(time_us_64() / 1000000ULL) + sFlashLogState.uTimeOffset);
+}
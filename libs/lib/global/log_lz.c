@@ -0,0 +1,262 @@
+/** ****************************************************************************
+ * @file   log_lz.c
+ *
+ * @author Michael R.
+ *
+ * @brief  Small LZSS compressor for the network log stream
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <string.h>
+
+// pico-sdk includes
+// FreeRTOS includes
+// Project includes
+#include "global/log_lz.h"
+#include "global/ram_func.h"
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+#define LOG_LZ_NONE       (0xFFFFU)
+#define LOG_LZ_MAX_DIST   (4096U)
+
+#if ((LOG_LZ_DICT_SIZE + LOG_LZ_BLOCK) > LOG_LZ_MAX_DIST)
+    #error "LOG_LZ_BLOCK too large"
+#endif
+
+/* --- Local type/struct definitions ---------------------------------------- */
+
+/* --- Static variables ----------------------------------------------------- */
+
+/**
+ * Preset dictionary, the host decoder uses the same bytes. Later strings are
+ * cheaper to reference, so the most frequent ones are at the end.
+ */
+static const char caLogLzDict[LOG_LZ_DICT_SIZE] =
+    "failed!\n connected\n"
+    "\e[0;37m---\e[0;37m-D- C1 \e[0;33m-W- C1 \e[0;31m-E- C1 "
+    ".c:vTask.c:eWlan\e[0;32m-I- C0 \e[0m: \n";
+
+/* --- Static function prototypes ------------------------------------------- */
+
+/**
+ * @brief Hash of the 3 bytes at uPos
+ */
+static inline uint16_t uLogLzHash(const uint8_t *pData);
+
+/**
+ * @brief Insert position into the hash chains
+ */
+static inline void vLogLzInsert(sLogLz_t *const sLz, const uint16_t uPos);
+
+/**
+ * @brief Start a new flag byte if needed and return the bit for the next item
+ */
+static inline uint8_t uLogLzFlag(sLogLz_t *const sLz);
+
+/* --- Public functions ----------------------------------------------------- */
+
+void vLogLzReset(sLogLz_t *const sLz, uint8_t *const pOut, const uint16_t uOutSize)
+{
+    memset(sLz->uaHead, 0xFF, sizeof(sLz->uaHead));
+    memcpy(sLz->uaWindow, caLogLzDict, LOG_LZ_DICT_SIZE);
+
+    for (uint16_t i = 0U; i < (LOG_LZ_DICT_SIZE - 2U); i++)
+    {
+        vLogLzInsert(sLz, i);
+    }
+
+    sLz->uEnd = LOG_LZ_DICT_SIZE;
+    sLz->pOut = pOut;
+    sLz->uOutSize = uOutSize;
+    sLz->uOutPos = 0U;
+    sLz->uFlagPos = 0U;
+    sLz->uFlagBit = 8U;
+}
+
+
+bool RAM_FUNC(RAM_HOT_LZ, bLogLzAppend)(sLogLz_t *const sLz, const void *pData, const uint16_t uLen)
+{
+    const uint16_t uEnd = sLz->uEnd + uLen;
+    const uint8_t *const pWin = sLz->uaWindow;
+    bool bFits = false;
+    uint16_t uPos = sLz->uEnd;
+    uint16_t uBestLen;
+    uint16_t uBestPos = 0U;
+    uint16_t uCand;
+    uint16_t uMaxLen;
+    uint16_t uLen2;
+    uint16_t uToken;
+    uint8_t uDepth;
+    uint8_t uBit;
+
+    if ((uEnd <= sizeof(sLz->uaWindow)) &&
+        ((uint32_t)sLz->uOutPos + LOG_LZ_BOUND(uLen) + 1U <= sLz->uOutSize))
+    {
+        bFits = true;
+        memcpy(&sLz->uaWindow[sLz->uEnd], pData, uLen);
+        sLz->uEnd = uEnd;
+
+        while (uPos < uEnd)
+        {
+            uBestLen = 0U;
+            uMaxLen = uEnd - uPos;
+
+            if (uMaxLen > LOG_LZ_MAX_MATCH)
+            {
+                uMaxLen = LOG_LZ_MAX_MATCH;
+            }
+
+            if (uMaxLen >= LOG_LZ_MIN_MATCH)
+            {
+                uCand = sLz->uaHead[uLogLzHash(&pWin[uPos])];
+                uDepth = LOG_LZ_DEPTH;
+
+                while ((LOG_LZ_NONE != uCand) && (0U != uDepth))
+                {
+                    uLen2 = 0U;
+                    while ((uLen2 < uMaxLen) && (pWin[uCand + uLen2] == pWin[uPos + uLen2]))
+                    {
+                        uLen2++;
+                    }
+
+                    if (uLen2 > uBestLen)
+                    {
+                        uBestLen = uLen2;
+                        uBestPos = uCand;
+                    }
+
+                    uCand = (uBestLen == uMaxLen) ? LOG_LZ_NONE : sLz->uaPrev[uCand];
+                    uDepth--;
+                }
+            }
+
+            uBit = uLogLzFlag(sLz);
+
+            if (uBestLen >= LOG_LZ_MIN_MATCH)
+            {
+                uToken = (uint16_t)(((uPos - uBestPos - 1U) << 4U) | (uBestLen - LOG_LZ_MIN_MATCH));
+                sLz->pOut[sLz->uOutPos++] = (uint8_t)(uToken >> 8U);
+                sLz->pOut[sLz->uOutPos++] = (uint8_t)uToken;
+            }
+            else
+            {
+                sLz->pOut[sLz->uFlagPos] |= uBit;
+                sLz->pOut[sLz->uOutPos++] = pWin[uPos];
+                uBestLen = 1U;
+            }
+
+            // Positions with less than 3 bytes left cannot be hashed
+            for (uint16_t i = 0U; i < uBestLen; i++)
+            {
+                if ((uPos + 2U) < uEnd)
+                {
+                    vLogLzInsert(sLz, uPos);
+                }
+                uPos++;
+            }
+        }
+    }
+
+    return (bFits);
+}
+
+
+uint16_t uLogLzRawLen(const sLogLz_t *const sLz)
+{
+    return (sLz->uEnd - LOG_LZ_DICT_SIZE);
+}
+
+int32_t iLogLzDecode(const uint8_t *pIn, const uint16_t uInLen, uint8_t *const pOut, const uint16_t uOutSize)
+{
+    int32_t iOutPos = 0;
+    uint16_t uPos = 0U;
+    uint16_t uToken;
+    uint16_t uDist;
+    uint16_t uLen;
+    uint8_t uFlags;
+
+    while ((uPos < uInLen) && (iOutPos >= 0))
+    {
+        uFlags = pIn[uPos++];
+
+        for (uint8_t uBit = 0U; (uBit < 8U) && (uPos < uInLen) && (iOutPos >= 0); uBit++)
+        {
+            if (0U != (uFlags & (1U << uBit)))
+            {
+                if (iOutPos < uOutSize)
+                {
+                    pOut[iOutPos++] = pIn[uPos++];
+                }
+                else
+                {
+                    iOutPos = -1;
+                }
+            }
+            else if ((uPos + 1U) < uInLen)
+            {
+                uToken = (uint16_t)(((uint16_t)pIn[uPos] << 8U) | pIn[uPos + 1U]);
+                uPos += 2U;
+                uDist = (uint16_t)((uToken >> 4U) + 1U);
+                uLen = (uint16_t)((uToken & 0x0FU) + LOG_LZ_MIN_MATCH);
+
+                if ((uDist > (iOutPos + LOG_LZ_DICT_SIZE)) || ((iOutPos + uLen) > uOutSize))
+                {
+                    iOutPos = -1;
+                }
+                else
+                {
+                    // The source may be in the dictionary and may overlap the target
+                    for (uint16_t i = 0U; i < uLen; i++)
+                    {
+                        const int32_t iSrc = iOutPos - uDist;
+
+                        pOut[iOutPos] = (iSrc < 0) ? (uint8_t)caLogLzDict[LOG_LZ_DICT_SIZE + iSrc] : pOut[iSrc];
+                        iOutPos++;
+                    }
+                }
+            }
+            else
+            {
+                iOutPos = -1;
+            }
+        }
+    }
+
+    return (iOutPos);
+}
+
+/* --- Static functions ----------------------------------------------------- */
+
+static inline uint16_t uLogLzHash(const uint8_t *pData)
+{
+    const uint32_t uKey = ((uint32_t)pData[0] << 16U) | ((uint32_t)pData[1] << 8U) | pData[2];
+
+    return ((uint16_t)((uint32_t)(uKey * 2654435761UL) >> 22U) & (LOG_LZ_HASH_SIZE - 1U));
+}
+
+
+static inline void vLogLzInsert(sLogLz_t *const sLz, const uint16_t uPos)
+{
+    const uint16_t uHash = uLogLzHash(&sLz->uaWindow[uPos]);
+
+    sLz->uaPrev[uPos] = sLz->uaHead[uHash];
+    sLz->uaHead[uHash] = uPos;
+}
+
+
+static inline uint8_t uLogLzFlag(sLogLz_t *const sLz)
+{
+    if (8U == sLz->uFlagBit)
+    {
+        sLz->uFlagPos = sLz->uOutPos;
+        sLz->pOut[sLz->uOutPos++] = 0U;
+        sLz->uFlagBit = 0U;
+    }
+
+    return ((uint8_t)(1U << sLz->uFlagBit++));
+}
@@ -0,0 +1,465 @@
+/** ****************************************************************************
+ * @file   metrics.c
+ *
+ * @author Michael R.
+ *
+ * @brief  Registry for counters, gauges and histograms.
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdio.h>
+#include <string.h>
+
+// pico-sdk includes
+// FreeRTOS includes
+#include "FreeRTOS.h" /* Must come first. */
+#include "task.h"
+
+// Project includes
+#include "global/metrics.h"
+#include "global/debug_print.h"
+#include "global/ram_func.h"
+#include "global/xip_profile.h"
+
+#include "wlan/wlan.h"
+#include "wlan/net_stats.h"
+#include "wlan/tcp_udp.h"
+#include "telemetry/telemetry.h"
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+#define METRICS_PRIORITY    (tskIDLE_PRIORITY + 1UL)
+#define METRICS_STACK       (512UL * 2U)
+
+/** Maximum size of a single exported UDP datagram */
+#define METRICS_DATAGRAM    (1400U)
+
+/** Telemetry channels of the binary export, one record each */
+#define METRICS_TLM_COUNTERS (0xFF00U)
+#define METRICS_TLM_GAUGES   (0xFF01U)
+#define METRICS_TLM_HISTO    (0xFF02U)
+
+/** Record header: array, channel and timestamp, see sTelemetryBegin */
+#define METRICS_TLM_HEAD     (20U)
+
+/** Longest CBOR encoding of a 32 bit value */
+#define METRICS_TLM_UINT     (5U)
+
+// Every record must fit, the telemetry drops larger ones
+_Static_assert(
+    (METRICS_TLM_HEAD + 3U + (NumMetricCounter * METRICS_TLM_UINT)) <= TELEMETRY_RECORD_MAX,
+    "Counter record exceeds TELEMETRY_RECORD_MAX, split it");
+_Static_assert(
+    (METRICS_TLM_HEAD + 3U + (NumMetricGauge * METRICS_TLM_UINT)) <= TELEMETRY_RECORD_MAX,
+    "Gauge record exceeds TELEMETRY_RECORD_MAX, split it");
+_Static_assert(
+    (METRICS_TLM_HEAD + 1U + 3U + ((METRICS_HISTO_BUCKETS + 1U) * METRICS_TLM_UINT)) <= TELEMETRY_RECORD_MAX,
+    "Histogram record exceeds TELEMETRY_RECORD_MAX");
+
+/* --- Local type/struct definitions ---------------------------------------- */
+
+typedef struct sMetricDesc_tag
+{
+    const char *cpName;
+    const char *cpHelp;
+} sMetricDesc_t;
+
+/* --- Public variables ----------------------------------------------------- */
+
+sMetricShard_t saMetricShard[configNUMBER_OF_CORES];
+volatile int32_t iaMetricGauge[NumMetricGauge];
+
+/* --- Static variables ----------------------------------------------------- */
+
+static const sMetricDesc_t saCounterDesc[NumMetricCounter] =
+{
+    [MetricLogDropped]     = {"log_dropped_total",     "Debug messages dropped"},
+    [MetricWlanReconnects] = {"wlan_reconnects_total", "WLAN connection attempts"},
+    [MetricSntpSyncs]      = {"sntp_syncs_total",      "SNTP time updates"},
+    [MetricUdpSendFailed]  = {"udp_send_failed_total", "UDP packets not sent"},
+    [MetricLogRawBytes]    = {"log_raw_bytes_total",   "Log text before compression"},
+    [MetricLogWireBytes]   = {"log_wire_bytes_total",  "Compressed log datagrams"},
+    [MetricMqttConnects]   = {"mqtt_connects_total",   "MQTT connection attempts"},
+    [MetricMqttPublishes]  = {"mqtt_publishes_total",  "MQTT publishes sent"},
+    [MetricMqttDropped]    = {"mqtt_dropped_total",    "MQTT messages dropped"},
+    [MetricTlsFull]        = {"tls_full_handshakes_total",    "Full TLS handshakes"},
+    [MetricTlsResumed]     = {"tls_resumed_handshakes_total", "Resumed TLS handshakes"},
+    [MetricWsDropped]      = {"ws_dropped_total",      "Stream frames dropped"},
+    [MetricWsStalled]      = {"ws_stalled_total",      "Stream clients dropped as stalled"},
+    [MetricLogSuppressed]  = {"log_suppressed_total",  "Debug messages folded or rate limited"},
+    [MetricFlashLogDropped] = {"flash_log_dropped_total", "Messages not stored in the flash log"},
+    [MetricFlashLogErases] = {"flash_log_erases_total", "Flash log sectors erased"},
+    [MetricCtrlCommands]   = {"ctrl_commands_total",   "Remote control commands executed"},
+    [MetricCtrlRejected]   = {"ctrl_rejected_total",   "Remote control packets rejected"},
+    [MetricDvfsUp]         = {"dvfs_up_total",         "Clock governor steps up"},
+    [MetricDvfsDown]       = {"dvfs_down_total",       "Clock governor steps down"},
+    [MetricDvfsFailed]     = {"dvfs_failed_total",     "Clock changes refused by the hardware"},
+    [MetricTicklessSleeps] = {"tickless_sleeps_total", "Idle sleeps with the tick stopped"},
+    [MetricCore0Wakeups]   = {"core0_wakeups_total",   "Wake-ups of core 0 from the idle sleep"},
+    [MetricCore1Wakeups]   = {"core1_wakeups_total",   "Wake-ups of core 1 from the idle sleep"},
+    [MetricCore0SleepMs]   = {"core0_sleep_ms_total",  "Time core 0 slept in ms"},
+    [MetricCore1SleepMs]   = {"core1_sleep_ms_total",  "Time core 1 slept in ms"},
+    [MetricPeriodicOverruns] = {"periodic_overruns_total", "Periodic jobs finished after the deadline"},
+    [MetricPeriodicSkipped]  = {"periodic_skipped_total",  "Periodic job releases dropped"},
+    [MetricStdoutDropped]    = {"stdout_dropped_total",    "stdout writes dropped, ring full"},
+    [MetricStdoutDroppedBytes] = {"stdout_dropped_bytes_total", "Bytes of the dropped stdout writes"},
+    [MetricLogSinkDropped]     = {"log_sink_dropped_total",     "Debug records lost by a sink"},
+    [MetricNetRxPackets]   = {"net_rx_packets_total",  "Frames received from the CYW43 driver"},
+    [MetricNetRxBytes]     = {"net_rx_bytes_total",    "Bytes received from the CYW43 driver"},
+    [MetricNetRxDropped]   = {"net_rx_dropped_total",  "Received frames refused by lwIP"},
+    [MetricNetTxPackets]   = {"net_tx_packets_total",  "Frames handed to the CYW43 driver"},
+    [MetricNetTxBytes]     = {"net_tx_bytes_total",    "Bytes handed to the CYW43 driver"},
+    [MetricNetTxFailed]    = {"net_tx_failed_total",   "Frames the CYW43 driver failed to send"},
+    [MetricPcapPackets]    = {"pcap_packets_total",    "Frames captured"},
+    [MetricPcapDropped]    = {"pcap_dropped_total",    "Frames not captured, ring full or over budget"},
+};
+
+static const sMetricDesc_t saGaugeDesc[NumMetricGauge] =
+{
+    [MetricFreeHeap]    = {"heap_free_bytes",     "Free FreeRTOS heap"},
+    [MetricMinFreeHeap] = {"heap_min_free_bytes", "Lowest free FreeRTOS heap"},
+    [MetricWsClients]   = {"ws_clients",          "Connected stream clients"},
+    [MetricXipHitPermille] = {"xip_hit_permille", "XIP cache hits per 1000 accesses, -1 = not measured"},
+    [MetricSysClkKhz]      = {"sys_clk_khz",      "Current system clock in kHz"},
+    [MetricCore0BusyPermille] = {"core0_busy_permille", "Load of core 0 in permille"},
+    [MetricCore1BusyPermille] = {"core1_busy_permille", "Load of core 1 in permille"},
+};
+
+static const sMetricDesc_t saHistoDesc[NumMetricHisto] =
+{
+    [MetricLogPrintUs]     = {"log_print_us",     "Time spent in a debug print"},
+    [MetricLogFormatUs]    = {"log_format_us",    "Time spent formatting a debug print"},
+    [MetricTlsHandshakeMs] = {"tls_handshake_ms", "Duration of TLS handshakes"},
+    [MetricFlashStallUs]   = {"flash_stall_us",   "XIP stall of a flash log write"},
+    [MetricLogUdpUs]       = {"log_udp_us",       "Time spent sending a debug print via UDP"},
+    [MetricLogXipMiss]     = {"log_xip_misses",   "XIP cache misses per debug print"},
+    [MetricUdpXipMiss]     = {"udp_xip_misses",   "XIP cache misses per UDP log record"},
+    [MetricPeriodicJitterUs] = {"periodic_jitter_us", "Start jitter of the periodic jobs"},
+    [MetricPeriodicExecUs]   = {"periodic_exec_us",   "Execution time of the periodic jobs"},
+};
+
+static char caMetricsText[METRICS_TEXT_SIZE];
+static TaskHandle_t xMetricsTask = NULL;
+
+/* --- Static function prototypes ------------------------------------------- */
+
+/**
+ * @brief Exporter task, sends a snapshot every METRICS_EXPORT_MS and on
+ *        request (@ref vMetricsExportNow).
+ *
+ * @param pvParameters Unused
+ */
+static void vMetricsTask(void *pvParameters);
+
+/**
+ * @brief Send the text snapshot split into datagrams at line boundaries
+ *
+ * @param uLen Length of the text in caMetricsText
+ */
+static void vMetricsSendText(const uint32_t uLen);
+
+/**
+ * @brief Send the snapshot as binary telemetry records
+ *
+ * One record with the counters, one with the gauges and one per histogram,
+ * each below TELEMETRY_RECORD_MAX.
+ *
+ * @param sSnapshot Snapshot to send
+ */
+static void vMetricsSendBinary(const sMetricSnapshot_t *const sSnapshot);
+
+/* --- Public functions ----------------------------------------------------- */
+
+void RAM_FUNC(RAM_HOT_METRICS, vMetricsObserve)(const eMetricHisto_t eHisto, const uint32_t uValue)
+{
+    uint32_t uBucket = (0UL == uValue) ? 0UL : (32UL - __builtin_clz(uValue));
+    uint32_t uIrq;
+    sMetricShard_t *sShard;
+
+    if (uBucket >= METRICS_HISTO_BUCKETS)
+    {
+        uBucket = METRICS_HISTO_BUCKETS - 1U;
+    }
+
+    uIrq = save_and_disable_interrupts();
+
+    sShard = &saMetricShard[get_core_num()];
+    sShard->uaHisto[eHisto][uBucket]++;
+    sShard->uaHistoSum[eHisto] += uValue;
+
+    restore_interrupts(uIrq);
+}
+
+
+eRetVal_t eMetricsRtosInit(void)
+{
+    eRetVal_t eRetVal = ErrNoError;
+    BaseType_t xReturned;
+
+    if (0UL != METRICS_EXPORT_MS)
+    {
+        xReturned = xTaskCreate(
+                        vMetricsTask,
+                        "Metrics",
+                        METRICS_STACK,
+                        NULL,
+                        METRICS_PRIORITY,
+                        &xMetricsTask);
+
+        if (pdPASS != xReturned)
+        {
+            eRetVal = ErrError;
+        }
+    }
+
+    return (eRetVal);
+}
+
+
+void vMetricsExportNow(void)
+{
+    if (NULL != xMetricsTask)
+    {
+        xTaskNotifyGive(xMetricsTask);
+    }
+}
+
+
+void vMetricsSnapshot(sMetricSnapshot_t *const sSnapshot)
+{
+    memset(sSnapshot, 0, sizeof(*sSnapshot));
+
+    vMetricsSet(MetricFreeHeap, (int32_t)xPortGetFreeHeapSize());
+    vMetricsSet(MetricMinFreeHeap, (int32_t)xPortGetMinimumEverFreeHeapSize());
+    vMetricsSet(MetricXipHitPermille, iXipProfileHitPermille());
+
+    for (uint32_t uCore = 0U; uCore < configNUMBER_OF_CORES; uCore++)
+    {
+        const sMetricShard_t *const sShard = &saMetricShard[uCore];
+
+        for (uint32_t i = 0U; i < NumMetricCounter; i++)
+        {
+            sSnapshot->uaCounter[i] += sShard->uaCounter[i];
+        }
+
+        for (uint32_t i = 0U; i < NumMetricHisto; i++)
+        {
+            for (uint32_t j = 0U; j < METRICS_HISTO_BUCKETS; j++)
+            {
+                sSnapshot->uaHisto[i][j] += sShard->uaHisto[i][j];
+            }
+            sSnapshot->uaHistoSum[i] += sShard->uaHistoSum[i];
+        }
+    }
+
+    for (uint32_t i = 0U; i < NumMetricGauge; i++)
+    {
+        sSnapshot->iaGauge[i] = iaMetricGauge[i];
+    }
+}
+
+
+uint32_t uMetricsRenderText(
+    const sMetricSnapshot_t *const sSnapshot,
+    char *const cpBuffer,
+    const uint32_t uSize)
+{
+    uint32_t uPos = 0U;
+    uint32_t uCount;
+
+// Appends to the buffer, stops silently if the buffer is full
+#define METRICS_APPEND(...)                                                   \
+    do                                                                        \
+    {                                                                         \
+        if (uPos < uSize)                                                     \
+        {                                                                     \
+            const int iLen = snprintf(&cpBuffer[uPos], uSize - uPos, __VA_ARGS__); \
+            uPos = (iLen < 0) ? uSize : (uPos + (uint32_t)iLen);              \
+        }                                                                     \
+    } while (0)
+
+    for (uint32_t i = 0U; i < NumMetricCounter; i++)
+    {
+        METRICS_APPEND(
+            "# HELP %s %s\n# TYPE %s counter\n%s %lu\n",
+            saCounterDesc[i].cpName, saCounterDesc[i].cpHelp,
+            saCounterDesc[i].cpName,
+            saCounterDesc[i].cpName, (unsigned long)sSnapshot->uaCounter[i]);
+    }
+
+    for (uint32_t i = 0U; i < NumMetricGauge; i++)
+    {
+        METRICS_APPEND(
+            "# HELP %s %s\n# TYPE %s gauge\n%s %ld\n",
+            saGaugeDesc[i].cpName, saGaugeDesc[i].cpHelp,
+            saGaugeDesc[i].cpName,
+            saGaugeDesc[i].cpName, (long)sSnapshot->iaGauge[i]);
+    }
+
+    for (uint32_t i = 0U; i < NumMetricHisto; i++)
+    {
+        METRICS_APPEND(
+            "# HELP %s %s\n# TYPE %s histogram\n",
+            saHistoDesc[i].cpName, saHistoDesc[i].cpHelp,
+            saHistoDesc[i].cpName);
+
+        uCount = 0UL;
+        for (uint32_t j = 0U; j < (METRICS_HISTO_BUCKETS - 1U); j++)
+        {
+            uCount += sSnapshot->uaHisto[i][j];
+            METRICS_APPEND(
+                "%s_bucket{le=\"%lu\"} %lu\n",
+                saHistoDesc[i].cpName,
+                (unsigned long)((1UL << j) - 1UL),
+                (unsigned long)uCount);
+        }
+        uCount += sSnapshot->uaHisto[i][METRICS_HISTO_BUCKETS - 1U];
+
+        METRICS_APPEND(
+            "%s_bucket{le=\"+Inf\"} %lu\n%s_sum %lu\n%s_count %lu\n",
+            saHistoDesc[i].cpName, (unsigned long)uCount,
+            saHistoDesc[i].cpName, (unsigned long)sSnapshot->uaHistoSum[i],
+            saHistoDesc[i].cpName, (unsigned long)uCount);
+    }
+
+#undef METRICS_APPEND
+
+    if (uPos >= uSize)
+    {
+        // Truncated, make sure it is terminated
+        uPos = uSize - 1U;
+        cpBuffer[uPos] = '\0';
+    }
+
+    return (uPos);
+}
+
+/* --- Static functions ----------------------------------------------------- */
+
+static void vMetricsTask(void *pvParameters)
+{
+    (void)pvParameters; // Silence 'unused parameters'
+
+    static sMetricSnapshot_t sSnapshot;
+    TickType_t xNextWake = xTaskGetTickCount() + pdMS_TO_TICKS(METRICS_EXPORT_MS);
+    TickType_t xWait;
+    uint32_t uLen;
+
+    while (1)
+    {
+        // Keep the period if a requested export comes in between
+        xWait = xNextWake - xTaskGetTickCount();
+        if ((int32_t)xWait < 0)
+        {
+            xWait = 0U;
+        }
+
+        if (0UL == ulTaskNotifyTake(pdTRUE, xWait))
+        {
+            xNextWake += pdMS_TO_TICKS(METRICS_EXPORT_MS);
+        }
+
+        vMetricsSnapshot(&sSnapshot);
+
+        if (bWlanIsConnected())
+        {
+            if (0U == METRICS_EXPORT_FORMAT)
+            {
+                uLen = uMetricsRenderText(&sSnapshot, caMetricsText, METRICS_TEXT_SIZE);
+                vMetricsSendText(uLen);
+
+                // The lwIP statistics follow, the buffer is free again
+                uLen = uNetStatsRenderText(caMetricsText, METRICS_TEXT_SIZE);
+                vMetricsSendText(uLen);
+            }
+            else
+            {
+                vMetricsSendBinary(&sSnapshot);
+            }
+        }
+    }
+}
+
+
+static void vMetricsSendText(const uint32_t uLen)
+{
+    uint32_t uStart = 0U;
+    uint32_t uEnd;
+
+    while (uStart < uLen)
+    {
+        uEnd = uLen;
+
+        if ((uEnd - uStart) > METRICS_DATAGRAM)
+        {
+            // Cut after the last complete line that fits
+            uEnd = uStart + METRICS_DATAGRAM;
+            while ((uEnd > uStart) && ('\n' != caMetricsText[uEnd - 1U]))
+            {
+                uEnd--;
+            }
+
+            if (uEnd == uStart)
+            {
+                uEnd = uStart + METRICS_DATAGRAM;
+            }
+        }
+
+        if (IS_ERR(eTcpUdpSendUdp(
+                        (const uint8_t *)&caMetricsText[uStart],
+                        (uint16_t)(uEnd - uStart),
+                        METRICS_PORT)))
+        {
+            break;
+        }
+
+        uStart = uEnd;
+    }
+}
+
+
+static void vMetricsSendBinary(const sMetricSnapshot_t *const sSnapshot)
+{
+    sTlmEncoder_t *sEnc;
+
+    // [channel, time, [counters]]
+    sEnc = sTelemetryBegin(METRICS_TLM_COUNTERS, 1U);
+    if (NULL != sEnc)
+    {
+        vTlmEncArray(sEnc, NumMetricCounter);
+        for (uint32_t i = 0U; i < NumMetricCounter; i++)
+        {
+            vTlmEncUint(sEnc, sSnapshot->uaCounter[i]);
+        }
+        vTelemetryEnd(sEnc);
+    }
+
+    // [channel, time, [gauges]]
+    sEnc = sTelemetryBegin(METRICS_TLM_GAUGES, 1U);
+    if (NULL != sEnc)
+    {
+        vTlmEncIntArray(sEnc, sSnapshot->iaGauge, NumMetricGauge);
+        vTelemetryEnd(sEnc);
+    }
+
+    // [channel, time, histogram, [buckets], sum] per histogram
+    for (uint32_t i = 0U; i < NumMetricHisto; i++)
+    {
+        sEnc = sTelemetryBegin(METRICS_TLM_HISTO, 3U);
+        if (NULL != sEnc)
+        {
+            vTlmEncUint(sEnc, i);
+            vTlmEncArray(sEnc, METRICS_HISTO_BUCKETS);
+            for (uint32_t j = 0U; j < METRICS_HISTO_BUCKETS; j++)
+            {
+                vTlmEncUint(sEnc, sSnapshot->uaHisto[i][j]);
+            }
+            vTlmEncUint(sEnc, sSnapshot->uaHistoSum[i]);
+            vTelemetryEnd(sEnc);
+        }
+    }
+}
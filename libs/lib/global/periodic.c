@@ -0,0 +1,354 @@
+/** ****************************************************************************
+ * @file   periodic.c
+ *
+ * @author Michael R.
+ *
+ * @brief  Periodic jobs run by a shared worker task per priority class
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+// pico-sdk includes
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+// FreeRTOS includes
+#include "FreeRTOS.h" /* Must come first. */
+#include "task.h"
+
+// Project includes
+#include "global/periodic.h"
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+/** Stack of a worker, shared by all jobs of the class */
+#define PERIODIC_STACK      (768UL)
+
+#define PERIODIC_TICK_US    (portTICK_PERIOD_MS * 1000UL)
+
+/* --- Local type/struct definitions ---------------------------------------- */
+
+typedef struct sPeriodicWorker_tag
+{
+    sPeriodicJob_t *volatile sJobs;
+    TaskHandle_t xTask;
+    TickType_t xWakeTick;       ///< Tick the worker saw first at uWakeUs
+    uint32_t uWakeUs;
+} sPeriodicWorker_t;
+
+/* --- Static variables ----------------------------------------------------- */
+
+static sPeriodicWorker_t saPeriodicWorker[NumPeriodicClass];
+
+static const UBaseType_t uaPeriodicPriority[NumPeriodicClass] =
+{
+    [PeriodicClassHigh]   = tskIDLE_PRIORITY + 4UL,
+    [PeriodicClassNormal] = tskIDLE_PRIORITY + 2UL,
+    [PeriodicClassLow]    = tskIDLE_PRIORITY + 1UL,
+};
+
+static const char *const cpaPeriodicTask[NumPeriodicClass] =
+{
+    [PeriodicClassHigh]   = "PeriodicHigh",
+    [PeriodicClassNormal] = "PeriodicNormal",
+    [PeriodicClassLow]    = "PeriodicLow",
+};
+
+/* --- Static function prototypes ------------------------------------------- */
+
+/**
+ * @brief Worker task of a class
+ *
+ * @param pvParameters The worker (sPeriodicWorker_t)
+ */
+static void vPeriodicWorker(void *pvParameters);
+
+/**
+ * @brief Job with the earliest release, the shorter deadline on a tie
+ *
+ * @param sWorker Worker
+ *
+ * @return Job
+ */
+static sPeriodicJob_t *sPeriodicNext(const sPeriodicWorker_t *const sWorker);
+
+/**
+ * @brief Run a released job, update its statistics and next release
+ *
+ * @param sWorker Worker
+ * @param sJob    Job
+ */
+static void vPeriodicRun(const sPeriodicWorker_t *const sWorker, sPeriodicJob_t *const sJob);
+
+/* --- Public functions ----------------------------------------------------- */
+
+eRetVal_t ePeriodicAdd(
+    sPeriodicJob_t *const sJob,
+    const char *const cpName,
+    const pfPeriodicJob_t pfJob,
+    void *const pvArg,
+    const uint32_t uPeriodMs,
+    const uint32_t uOffsetMs,
+    const uint32_t uDeadlineMs,
+    const ePeriodicClass_t eClass)
+{
+    const bool bRtosActive = !(taskSCHEDULER_NOT_STARTED == xTaskGetSchedulerState());
+    eRetVal_t eRetVal = ErrNoError;
+    sPeriodicWorker_t *sWorker;
+    BaseType_t xReturned;
+
+    if ((0UL == pdMS_TO_TICKS(uPeriodMs)) || (eClass >= NumPeriodicClass))
+    {
+        eRetVal = ErrError;
+    }
+    else
+    {
+        sWorker = &saPeriodicWorker[eClass];
+
+        sJob->cpName = cpName;
+        sJob->pfJob = pfJob;
+        sJob->pvArg = pvArg;
+        sJob->xPeriod = pdMS_TO_TICKS(uPeriodMs);
+        sJob->xDeadline = pdMS_TO_TICKS((0UL == uDeadlineMs) ? uPeriodMs : uDeadlineMs);
+        sJob->xRelease = xTaskGetTickCount() + pdMS_TO_TICKS(uOffsetMs);
+        sJob->eClass = eClass;
+        memset(&sJob->sStats, 0, sizeof(sJob->sStats));
+
+        // Jobs added from the init functions come before the scheduler
+        if (bRtosActive)
+        {
+            taskENTER_CRITICAL();
+        }
+
+        sJob->sNext = sWorker->sJobs;
+        __dmb();
+        sWorker->sJobs = sJob;
+
+        if (bRtosActive)
+        {
+            taskEXIT_CRITICAL();
+        }
+
+        if (NULL == sWorker->xTask)
+        {
+            xReturned = xTaskCreate(
+                            vPeriodicWorker,
+                            cpaPeriodicTask[eClass],
+                            PERIODIC_STACK,
+                            sWorker,
+                            uaPeriodicPriority[eClass],
+                            &sWorker->xTask);
+
+            if (pdPASS != xReturned)
+            {
+                eRetVal = ErrError;
+            }
+        }
+        else if (bRtosActive)
+        {
+            // The new job may be the next one
+            xTaskNotifyGive(sWorker->xTask);
+        }
+    }
+
+    return (eRetVal);
+}
+
+
+void vPeriodicGetStats(const sPeriodicJob_t *const sJob, sPeriodicStats_t *const sStats)
+{
+    taskENTER_CRITICAL();
+    *sStats = sJob->sStats;
+    taskEXIT_CRITICAL();
+}
+
+
+uint32_t uPeriodicRenderText(char *const cpBuffer, const uint32_t uSize)
+{
+    static const char caClass[NumPeriodicClass] = {'H', 'N', 'L'};
+    static sPeriodicStats_t sStats;
+    uint32_t uPos = 0U;
+
+// Appends to the buffer, stops silently if the buffer is full
+#define PERIODIC_APPEND(...)                                                  \
+    do                                                                        \
+    {                                                                         \
+        if (uPos < uSize)                                                     \
+        {                                                                     \
+            const int iLen = snprintf(&cpBuffer[uPos], uSize - uPos, __VA_ARGS__); \
+            uPos = (iLen < 0) ? uSize : (uPos + (uint32_t)iLen);              \
+        }                                                                     \
+    } while (0)
+
+    PERIODIC_APPEND(
+        "%-16s %1s %6s %6s %8s %6s %6s %8s %8s %8s\n",
+        "Name", "C", "Period", "Dline", "Runs", "Over", "Skip", "ExecAvg", "ExecMax", "JitMax");
+
+    for (uint32_t i = 0U; i < NumPeriodicClass; i++)
+    {
+        for (const sPeriodicJob_t *sJob = saPeriodicWorker[i].sJobs; NULL != sJob; sJob = sJob->sNext)
+        {
+            vPeriodicGetStats(sJob, &sStats);
+
+            PERIODIC_APPEND(
+                "%-16s %1c %6lu %6lu %8lu %6lu %6lu %8lu %8lu %8lu\n",
+                sJob->cpName,
+                caClass[i],
+                (unsigned long)(sJob->xPeriod * portTICK_PERIOD_MS),
+                (unsigned long)(sJob->xDeadline * portTICK_PERIOD_MS),
+                (unsigned long)sStats.uRuns,
+                (unsigned long)sStats.uOverruns,
+                (unsigned long)sStats.uSkipped,
+                (unsigned long)((0UL != sStats.uRuns) ? (sStats.uExecSumUs / sStats.uRuns) : 0U),
+                (unsigned long)sStats.uExecMaxUs,
+                (unsigned long)sStats.uJitterMaxUs);
+
+            // Jitter histogram, only the used buckets (le = upper bound in us)
+            PERIODIC_APPEND("  jitter_us");
+            for (uint32_t j = 0U; j < METRICS_HISTO_BUCKETS; j++)
+            {
+                if (0UL != sStats.uaJitter[j])
+                {
+                    if (j < (METRICS_HISTO_BUCKETS - 1U))
+                    {
+                        PERIODIC_APPEND(
+                            " le%lu:%lu",
+                            (unsigned long)((1UL << j) - 1UL),
+                            (unsigned long)sStats.uaJitter[j]);
+                    }
+                    else
+                    {
+                        PERIODIC_APPEND(" inf:%lu", (unsigned long)sStats.uaJitter[j]);
+                    }
+                }
+            }
+            PERIODIC_APPEND("\n");
+        }
+    }
+
+#undef PERIODIC_APPEND
+
+    if (uPos >= uSize)
+    {
+        // Truncated, make sure it is terminated
+        uPos = uSize - 1U;
+        cpBuffer[uPos] = '\0';
+    }
+
+    return (uPos);
+}
+
+/* --- Static functions ----------------------------------------------------- */
+
+static void vPeriodicWorker(void *pvParameters)
+{
+    sPeriodicWorker_t *const sWorker = (sPeriodicWorker_t *)pvParameters;
+    sPeriodicJob_t *sJob;
+    TickType_t xNow;
+
+    while (true)
+    {
+        sJob = sPeriodicNext(sWorker);
+        xNow = xTaskGetTickCount();
+
+        // Reference for the jitter of all jobs released up to this tick
+        if (xNow != sWorker->xWakeTick)
+        {
+            sWorker->xWakeTick = xNow;
+            sWorker->uWakeUs = time_us_32();
+        }
+
+        if ((int32_t)(sJob->xRelease - xNow) > 0)
+        {
+            // Absolute release time, a new job of the class wakes up early
+            (void)ulTaskNotifyTake(pdTRUE, sJob->xRelease - xNow);
+        }
+        else
+        {
+            vPeriodicRun(sWorker, sJob);
+        }
+    }
+}
+
+
+static sPeriodicJob_t *sPeriodicNext(const sPeriodicWorker_t *const sWorker)
+{
+    sPeriodicJob_t *sNext = sWorker->sJobs;
+    int32_t iDiff;
+
+    for (sPeriodicJob_t *sJob = sNext->sNext; NULL != sJob; sJob = sJob->sNext)
+    {
+        iDiff = (int32_t)(sJob->xRelease - sNext->xRelease);
+
+        if ((iDiff < 0) || ((0 == iDiff) && (sJob->xDeadline < sNext->xDeadline)))
+        {
+            sNext = sJob;
+        }
+    }
+
+    return (sNext);
+}
+
+
+static void vPeriodicRun(const sPeriodicWorker_t *const sWorker, sPeriodicJob_t *const sJob)
+{
+    const uint32_t uStartUs = time_us_32();
+    const uint32_t uJitterUs =
+        ((sWorker->xWakeTick - sJob->xRelease) * PERIODIC_TICK_US) + (uStartUs - sWorker->uWakeUs);
+    uint32_t uBucket = (0UL == uJitterUs) ? 0UL : (32UL - __builtin_clz(uJitterUs));
+    uint32_t uSkipped = 0UL;
+    uint32_t uExecUs;
+    bool bOverrun;
+    TickType_t xNow;
+
+    sJob->pfJob(sJob->pvArg);
+
+    uExecUs = time_us_32() - uStartUs;
+    bOverrun = ((uJitterUs + uExecUs) > (sJob->xDeadline * PERIODIC_TICK_US));
+
+    // Next release on the grid, drop the ones a whole period behind
+    xNow = xTaskGetTickCount();
+    sJob->xRelease += sJob->xPeriod;
+    while ((int32_t)(xNow - sJob->xRelease) >= (int32_t)sJob->xPeriod)
+    {
+        sJob->xRelease += sJob->xPeriod;
+        uSkipped++;
+    }
+
+    if (uBucket >= METRICS_HISTO_BUCKETS)
+    {
+        uBucket = METRICS_HISTO_BUCKETS - 1U;
+    }
+
+    taskENTER_CRITICAL();
+    sJob->sStats.uRuns++;
+    sJob->sStats.uOverruns += bOverrun ? 1UL : 0UL;
+    sJob->sStats.uSkipped += uSkipped;
+    sJob->sStats.uExecSumUs += uExecUs;
+    if (uExecUs > sJob->sStats.uExecMaxUs)
+    {
+        sJob->sStats.uExecMaxUs = uExecUs;
+    }
+    if (uJitterUs > sJob->sStats.uJitterMaxUs)
+    {
+        sJob->sStats.uJitterMaxUs = uJitterUs;
+    }
+    sJob->sStats.uaJitter[uBucket]++;
+    taskEXIT_CRITICAL();
+
+    vMetricsObserve(MetricPeriodicJitterUs, uJitterUs);
+    vMetricsObserve(MetricPeriodicExecUs, uExecUs);
+    if (bOverrun)
+    {
+        vMetricsInc(MetricPeriodicOverruns);
+    }
+    vMetricsAdd(MetricPeriodicSkipped, uSkipped);
+}
@@ -0,0 +1,224 @@
+/** ****************************************************************************
+ * @file   sha1.c
+ *
+ * @author Michael R.
+ *
+ * @brief  Small SHA-1 and HMAC-SHA1
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <string.h>
+
+// pico-sdk includes
+// FreeRTOS includes
+// Project includes
+#include "global/sha1.h"
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+#define SHA1_ROL(_VAL, _N) (((_VAL) << (_N)) | ((_VAL) >> (32U - (_N))))
+
+/* --- Local type/struct definitions ---------------------------------------- */
+
+/* --- Static variables ----------------------------------------------------- */
+
+/* --- Static function prototypes ------------------------------------------- */
+
+/**
+ * @brief Process the complete block in sSha1->uaBlock
+ *
+ * @param sSha1 State
+ */
+static void vSha1Block(sSha1_t *const sSha1);
+
+/* --- Public functions ----------------------------------------------------- */
+
+void vSha1Init(sSha1_t *const sSha1)
+{
+    sSha1->uaH[0] = 0x67452301UL;
+    sSha1->uaH[1] = 0xEFCDAB89UL;
+    sSha1->uaH[2] = 0x98BADCFEUL;
+    sSha1->uaH[3] = 0x10325476UL;
+    sSha1->uaH[4] = 0xC3D2E1F0UL;
+    sSha1->uTotal = 0UL;
+}
+
+
+void vSha1Update(sSha1_t *const sSha1, const uint8_t *pData, uint32_t uLen)
+{
+    uint32_t uFill = sSha1->uTotal & (SHA1_BLOCK_SIZE - 1U);
+    uint32_t uChunk;
+
+    sSha1->uTotal += uLen;
+
+    while (uLen > 0U)
+    {
+        uChunk = SHA1_BLOCK_SIZE - uFill;
+        if (uChunk > uLen)
+        {
+            uChunk = uLen;
+        }
+
+        memcpy(&sSha1->uaBlock[uFill], pData, uChunk);
+        uFill += uChunk;
+        pData += uChunk;
+        uLen  -= uChunk;
+
+        if (SHA1_BLOCK_SIZE == uFill)
+        {
+            vSha1Block(sSha1);
+            uFill = 0U;
+        }
+    }
+}
+
+
+void vSha1Final(sSha1_t *const sSha1, uint8_t *const pDigest)
+{
+    const uint32_t uBits = sSha1->uTotal * 8U;
+    uint32_t uFill = sSha1->uTotal & (SHA1_BLOCK_SIZE - 1U);
+
+    // 0x80 terminator, zero padding and the length in bits
+    sSha1->uaBlock[uFill++] = 0x80U;
+
+    if (uFill > (SHA1_BLOCK_SIZE - 8U))
+    {
+        memset(&sSha1->uaBlock[uFill], 0, SHA1_BLOCK_SIZE - uFill);
+        vSha1Block(sSha1);
+        uFill = 0U;
+    }
+
+    memset(&sSha1->uaBlock[uFill], 0, SHA1_BLOCK_SIZE - 4U - uFill);
+    sSha1->uaBlock[60] = (uint8_t)(uBits >> 24U);
+    sSha1->uaBlock[61] = (uint8_t)(uBits >> 16U);
+    sSha1->uaBlock[62] = (uint8_t)(uBits >> 8U);
+    sSha1->uaBlock[63] = (uint8_t)uBits;
+    vSha1Block(sSha1);
+
+    for (uint32_t i = 0U; i < SHA1_DIGEST_SIZE; i++)
+    {
+        pDigest[i] = (uint8_t)(sSha1->uaH[i / 4U] >> (24U - 8U * (i & 3U)));
+    }
+}
+
+
+void vSha1(const uint8_t *pData, const uint32_t uLen, uint8_t *const pDigest)
+{
+    sSha1_t sSha1;
+
+    vSha1Init(&sSha1);
+    vSha1Update(&sSha1, pData, uLen);
+    vSha1Final(&sSha1, pDigest);
+}
+
+
+void vHmacSha1(
+    const uint8_t *pKey,
+    const uint32_t uKeyLen,
+    const uint8_t *pData,
+    const uint32_t uLen,
+    uint8_t *const pDigest)
+{
+    uint8_t uaPad[SHA1_BLOCK_SIZE] = {0};
+    uint8_t uaInner[SHA1_DIGEST_SIZE];
+    sSha1_t sSha1;
+
+    // Longer keys are replaced by their hash
+    if (uKeyLen > SHA1_BLOCK_SIZE)
+    {
+        vSha1(pKey, uKeyLen, uaPad);
+    }
+    else
+    {
+        memcpy(uaPad, pKey, uKeyLen);
+    }
+
+    for (uint32_t i = 0U; i < SHA1_BLOCK_SIZE; i++)
+    {
+        uaPad[i] ^= 0x36U;
+    }
+
+    vSha1Init(&sSha1);
+    vSha1Update(&sSha1, uaPad, SHA1_BLOCK_SIZE);
+    vSha1Update(&sSha1, pData, uLen);
+    vSha1Final(&sSha1, uaInner);
+
+    // 0x36 ^ 0x5C turns the inner pad into the outer one
+    for (uint32_t i = 0U; i < SHA1_BLOCK_SIZE; i++)
+    {
+        uaPad[i] ^= (0x36U ^ 0x5CU);
+    }
+
+    vSha1Init(&sSha1);
+    vSha1Update(&sSha1, uaPad, SHA1_BLOCK_SIZE);
+    vSha1Update(&sSha1, uaInner, SHA1_DIGEST_SIZE);
+    vSha1Final(&sSha1, pDigest);
+}
+
+/* --- Static functions ----------------------------------------------------- */
+
+static void vSha1Block(sSha1_t *const sSha1)
+{
+    const uint8_t *const uaBlock = sSha1->uaBlock;
+    uint32_t uaW[16];
+    uint32_t uA, uB, uC, uD, uE, uF, uK, uTemp;
+
+    for (uint32_t i = 0U; i < 16U; i++)
+    {
+        uaW[i] = ((uint32_t)uaBlock[4U * i] << 24U) | ((uint32_t)uaBlock[4U * i + 1U] << 16U) |
+                 ((uint32_t)uaBlock[4U * i + 2U] << 8U) | (uint32_t)uaBlock[4U * i + 3U];
+    }
+
+    uA = sSha1->uaH[0];
+    uB = sSha1->uaH[1];
+    uC = sSha1->uaH[2];
+    uD = sSha1->uaH[3];
+    uE = sSha1->uaH[4];
+
+    for (uint32_t i = 0U; i < 80U; i++)
+    {
+        if (i >= 16U)
+        {
+            uTemp = uaW[(i + 13U) & 15U] ^ uaW[(i + 8U) & 15U] ^ uaW[(i + 2U) & 15U] ^ uaW[i & 15U];
+            uaW[i & 15U] = SHA1_ROL(uTemp, 1U);
+        }
+
+        if (i < 20U)
+        {
+            uF = (uB & uC) | (~uB & uD);
+            uK = 0x5A827999UL;
+        }
+        else if (i < 40U)
+        {
+            uF = uB ^ uC ^ uD;
+            uK = 0x6ED9EBA1UL;
+        }
+        else if (i < 60U)
+        {
+            uF = (uB & uC) | (uB & uD) | (uC & uD);
+            uK = 0x8F1BBCDCUL;
+        }
+        else
+        {
+            uF = uB ^ uC ^ uD;
+            uK = 0xCA62C1D6UL;
+        }
+
+        uTemp = SHA1_ROL(uA, 5U) + uF + uE + uK + uaW[i & 15U];
+        uE = uD;
+        uD = uC;
+        uC = SHA1_ROL(uB, 30U);
+        uB = uA;
+        uA = uTemp;
+    }
+
+    sSha1->uaH[0] += uA;
+    sSha1->uaH[1] += uB;
+    sSha1->uaH[2] += uC;
+    sSha1->uaH[3] += uD;
+    sSha1->uaH[4] += uE;
+}
@@ -0,0 +1,419 @@
+/** ****************************************************************************
+ * @file   stdout_async.c
+ *
+ * @author Michael R.
+ *
+ * @brief  Non-blocking stdout: printf copies into a ring, DMA/a task drains it
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdbool.h>
+#include <string.h>
+
+// pico-sdk includes
+#include "pico/stdlib.h"
+#include "pico/stdio/driver.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "hardware/uart.h"
+#if STDIO_UART
+    #include "pico/stdio_uart.h"
+#endif
+#if STDIO_USB
+    #include "pico/stdio_usb.h"
+#endif
+
+// FreeRTOS includes
+#include "FreeRTOS.h" /* Must come first. */
+#include "task.h"
+
+// Project includes
+#include "global/stdout_async.h"
+#include "global/metrics.h"
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+#if (0U != (STDOUT_RING_SIZE & (STDOUT_RING_SIZE - 1U)))
+    #error "STDOUT_RING_SIZE must be a power of 2"
+#endif
+
+#define STDOUT_MASK         (STDOUT_RING_SIZE - 1U)
+
+/** DMA_IRQ_1, DMA_IRQ_0 is left to the SDK drivers */
+#define STDOUT_DMA_IRQ_IDX  (1U)
+
+#define STDOUT_PRIORITY     (tskIDLE_PRIORITY + 1UL)
+#define STDOUT_STACK        (256UL)
+
+/** Largest piece handed to the USB driver at once */
+#define STDOUT_USB_CHUNK    (256UL)
+
+/* --- Local type/struct definitions ---------------------------------------- */
+
+typedef enum eStdoutPort_tag
+{
+    StdoutPortUart,
+    StdoutPortUsb,
+    NumStdoutPort
+} eStdoutPort_t;
+
+typedef struct sStdoutState_tag
+{
+    volatile uint32_t uHead;                    ///< Written by the producers (locked)
+    volatile uint32_t uaTail[NumStdoutPort];    ///< Written by the drain of the port
+    uint32_t uDmaLen;                           ///< Bytes of the running transfer, 0 = idle
+    spin_lock_t *sLock;
+    int iDma;
+    TaskHandle_t xUsbTask;
+} sStdoutState_t;
+
+/* --- Static variables ----------------------------------------------------- */
+
+static const bool baStdoutPort[NumStdoutPort] =
+{
+    [StdoutPortUart] = STDIO_UART,
+    [StdoutPortUsb]  = STDIO_USB,
+};
+
+static uint8_t uaStdoutRing[STDOUT_RING_SIZE];
+
+static sStdoutState_t sStdoutState =
+{
+    .iDma = -1,
+};
+
+/** Replaces the SDK drivers in the stdio driver list */
+static stdio_driver_t sStdoutDriver;
+
+/* --- Static function prototypes ------------------------------------------- */
+
+/**
+ * @brief stdio output of the driver, copies into the ring
+ *
+ * @param cpBuf Text
+ * @param iLen  Length
+ */
+static void vStdoutOutChars(const char *cpBuf, int iLen);
+
+/**
+ * @brief stdio input of the driver, taken from the pico-sdk drivers
+ *
+ * @param cpBuf Target
+ * @param iLen  Size of the target
+ *
+ * @return Characters read or PICO_ERROR_NO_DATA
+ */
+static int iStdoutInChars(char *cpBuf, int iLen);
+
+/**
+ * @brief Bytes in the ring not yet sent by the slowest port, lock held
+ *
+ * @return Bytes
+ */
+static uint32_t uStdoutUsed(void);
+
+/**
+ * @brief Start the DMA on the next piece if it is idle, lock held
+ */
+static void vStdoutUartKick(void);
+
+/**
+ * @brief DMA completion interrupt
+ */
+static void vStdoutDmaIrq(void);
+
+/**
+ * @brief Task handing the ring to the USB driver
+ *
+ * @param pvParameters Unused
+ */
+static void vStdoutUsbTask(void *pvParameters);
+
+/* --- Public functions ----------------------------------------------------- */
+
+eRetVal_t eStdoutPreInit(void)
+{
+    eRetVal_t eRetVal = ErrNoError;
+
+#if STDOUT_ASYNC
+    const int iLock = spin_lock_claim_unused(false);
+#if STDIO_UART
+    dma_channel_config sConfig;
+#endif
+
+    if (0 > iLock)
+    {
+        eRetVal = ErrError;
+    }
+    else
+    {
+        sStdoutState.sLock = spin_lock_init((uint)iLock);
+    }
+
+#if STDIO_UART
+    if (IS_NO_ERR(eRetVal))
+    {
+        sStdoutState.iDma = dma_claim_unused_channel(false);
+
+        if (0 > sStdoutState.iDma)
+        {
+            eRetVal = ErrError;
+        }
+    }
+
+    if (IS_NO_ERR(eRetVal))
+    {
+        // Ring -> UART data register, paced by the TX FIFO
+        sConfig = dma_channel_get_default_config((uint)sStdoutState.iDma);
+        channel_config_set_transfer_data_size(&sConfig, DMA_SIZE_8);
+        channel_config_set_read_increment(&sConfig, true);
+        channel_config_set_write_increment(&sConfig, false);
+        channel_config_set_dreq(&sConfig, uart_get_dreq_num(uart_default, true));
+        dma_channel_configure(
+            (uint)sStdoutState.iDma,
+            &sConfig,
+            &uart_get_hw(uart_default)->dr,
+            uaStdoutRing,
+            0U,
+            false);
+
+        dma_irqn_set_channel_enabled(STDOUT_DMA_IRQ_IDX, (uint)sStdoutState.iDma, true);
+        irq_add_shared_handler(
+            DMA_IRQ_NUM(STDOUT_DMA_IRQ_IDX),
+            vStdoutDmaIrq,
+            PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_NUM(STDOUT_DMA_IRQ_IDX), true);
+    }
+#endif
+
+    if (IS_NO_ERR(eRetVal))
+    {
+        sStdoutDriver.out_chars = vStdoutOutChars;
+        sStdoutDriver.in_chars = iStdoutInChars;
+#if PICO_STDIO_ENABLE_CRLF_SUPPORT
+        sStdoutDriver.crlf_enabled = PICO_STDIO_DEFAULT_CRLF;
+#endif
+
+        // The SDK drivers only send what the ring hands them from now on
+#if STDIO_UART
+        stdio_set_driver_enabled(&stdio_uart, false);
+#endif
+#if STDIO_USB
+        stdio_set_driver_enabled(&stdio_usb, false);
+#endif
+        stdio_set_driver_enabled(&sStdoutDriver, true);
+    }
+#endif
+
+    return (eRetVal);
+}
+
+
+eRetVal_t eStdoutRtosInit(void)
+{
+    eRetVal_t eRetVal = ErrNoError;
+
+#if STDOUT_ASYNC && STDIO_USB
+    BaseType_t xReturned;
+
+    xReturned = xTaskCreate(
+                    vStdoutUsbTask,
+                    "Stdout",
+                    STDOUT_STACK,
+                    NULL,
+                    STDOUT_PRIORITY,
+                    &sStdoutState.xUsbTask);
+
+    if (pdPASS != xReturned)
+    {
+        eRetVal = ErrError;
+    }
+#endif
+
+    return (eRetVal);
+}
+
+/* --- Static functions ----------------------------------------------------- */
+
+static void vStdoutOutChars(const char *cpBuf, int iLen)
+{
+    const uint32_t uLen = (iLen > 0) ? (uint32_t)iLen : 0UL;
+    const bool bWait = (StdoutOverflowWait == STDOUT_OVERFLOW) &&
+                       (taskSCHEDULER_RUNNING == xTaskGetSchedulerState()) &&
+                       (0U == __get_current_exception());
+    const TickType_t xStart = bWait ? xTaskGetTickCount() : 0U;
+    uint32_t uOffset;
+    uint32_t uFirst;
+    uint32_t uIrq;
+    bool bDone = false;
+    bool bStored = false;
+
+    while (!bDone)
+    {
+        uIrq = spin_lock_blocking(sStdoutState.sLock);
+
+        if (uLen <= (STDOUT_RING_SIZE - uStdoutUsed()))
+        {
+            // Only the producers move the head and they hold the lock
+            uOffset = sStdoutState.uHead & STDOUT_MASK;
+            uFirst = ((STDOUT_RING_SIZE - uOffset) < uLen) ? (STDOUT_RING_SIZE - uOffset) : uLen;
+            memcpy(&uaStdoutRing[uOffset], cpBuf, uFirst);
+            memcpy(uaStdoutRing, &cpBuf[uFirst], uLen - uFirst);
+            sStdoutState.uHead += uLen;
+
+            if (STDIO_UART)
+            {
+                vStdoutUartKick();
+            }
+            bStored = true;
+            bDone = true;
+        }
+
+        spin_unlock(sStdoutState.sLock, uIrq);
+
+        if (!bDone)
+        {
+            if (bWait && ((xTaskGetTickCount() - xStart) < pdMS_TO_TICKS(STDOUT_WAIT_MS)))
+            {
+                vTaskDelay(1U);
+            }
+            else
+            {
+                vMetricsInc(MetricStdoutDropped);
+                vMetricsAdd(MetricStdoutDroppedBytes, uLen);
+                bDone = true;
+            }
+        }
+    }
+
+    if (bStored && (NULL != sStdoutState.xUsbTask) &&
+        (taskSCHEDULER_NOT_STARTED != xTaskGetSchedulerState()))
+    {
+        if (0U != __get_current_exception())
+        {
+            vTaskNotifyGiveFromISR(sStdoutState.xUsbTask, NULL);
+        }
+        else
+        {
+            xTaskNotifyGive(sStdoutState.xUsbTask);
+        }
+    }
+}
+
+
+static int iStdoutInChars(char *cpBuf, int iLen)
+{
+    int iRead = PICO_ERROR_NO_DATA;
+
+#if STDIO_USB
+    iRead = stdio_usb.in_chars(cpBuf, iLen);
+#endif
+#if STDIO_UART
+    if (0 >= iRead)
+    {
+        iRead = stdio_uart.in_chars(cpBuf, iLen);
+    }
+#endif
+
+    return (iRead);
+}
+
+
+static uint32_t uStdoutUsed(void)
+{
+    uint32_t uUsed = 0UL;
+    uint32_t uPort;
+
+    for (uPort = 0U; uPort < NumStdoutPort; uPort++)
+    {
+        if (baStdoutPort[uPort] && ((sStdoutState.uHead - sStdoutState.uaTail[uPort]) > uUsed))
+        {
+            uUsed = sStdoutState.uHead - sStdoutState.uaTail[uPort];
+        }
+    }
+
+    return (uUsed);
+}
+
+
+static void vStdoutUartKick(void)
+{
+    const uint32_t uTail = sStdoutState.uaTail[StdoutPortUart];
+    const uint32_t uOffset = uTail & STDOUT_MASK;
+    uint32_t uLen = sStdoutState.uHead - uTail;
+
+    if ((0UL == sStdoutState.uDmaLen) && (0UL != uLen))
+    {
+        // Up to the end of the ring, the rest is the next transfer
+        if (uLen > (STDOUT_RING_SIZE - uOffset))
+        {
+            uLen = STDOUT_RING_SIZE - uOffset;
+        }
+
+        sStdoutState.uDmaLen = uLen;
+        dma_channel_transfer_from_buffer_now((uint)sStdoutState.iDma, &uaStdoutRing[uOffset], uLen);
+    }
+}
+
+
+static void vStdoutDmaIrq(void)
+{
+    uint32_t uIrq;
+
+    if (dma_irqn_get_channel_status(STDOUT_DMA_IRQ_IDX, (uint)sStdoutState.iDma))
+    {
+        dma_irqn_acknowledge_channel(STDOUT_DMA_IRQ_IDX, (uint)sStdoutState.iDma);
+
+        uIrq = spin_lock_blocking(sStdoutState.sLock);
+        sStdoutState.uaTail[StdoutPortUart] += sStdoutState.uDmaLen;
+        sStdoutState.uDmaLen = 0UL;
+        vStdoutUartKick();
+        spin_unlock(sStdoutState.sLock, uIrq);
+    }
+}
+
+
+static void vStdoutUsbTask(void *pvParameters)
+{
+    (void)pvParameters; // Silence 'unused parameters'
+
+    uint32_t uTail;
+    uint32_t uOffset;
+    uint32_t uLen;
+
+    while (true)
+    {
+        uTail = sStdoutState.uaTail[StdoutPortUsb];
+        uOffset = uTail & STDOUT_MASK;
+        uLen = sStdoutState.uHead - uTail;
+
+        if (0UL == uLen)
+        {
+            (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+        else
+        {
+            if (uLen > (STDOUT_RING_SIZE - uOffset))
+            {
+                uLen = STDOUT_RING_SIZE - uOffset;
+            }
+            if (uLen > STDOUT_USB_CHUNK)
+            {
+                uLen = STDOUT_USB_CHUNK;
+            }
+
+#if STDIO_USB
+            // Waits for the host here instead of in the caller of printf
+            stdio_usb.out_chars((const char *)&uaStdoutRing[uOffset], (int)uLen);
+#endif
+
+            __dmb();
+            sStdoutState.uaTail[StdoutPortUsb] = uTail + uLen;
+        }
+    }
+}
@@ -0,0 +1,290 @@
+/** ****************************************************************************
+ * @file   tickless.c
+ *
+ * @author Michael R.
+ *
+ * @brief  Tickless idle for the SMP kernel
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdbool.h>
+
+// pico-sdk includes
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#include "hardware/structs/scb.h"
+#include "hardware/structs/systick.h"
+
+// FreeRTOS includes
+#include "FreeRTOS.h" /* Must come first. */
+#include "task.h"
+
+// Project includes
+#include "global/tickless.h"
+#include "global/dvfs.h"
+#include "global/metrics.h"
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+#if (configSYSTICK_CLOCK_HZ != 1000000)
+    #error "tickless.c counts SysTick periods in us, set configSYSTICK_CLOCK_HZ to 1000000"
+#endif
+
+#if PICO_RP2040
+    #define TICKLESS_SYST_ENABLE    M0PLUS_SYST_CSR_ENABLE_BITS
+    #define TICKLESS_PENDSTSET      M0PLUS_ICSR_PENDSTSET_BITS
+#else
+    #define TICKLESS_SYST_ENABLE    M33_SYST_CSR_ENABLE_BITS
+    #define TICKLESS_PENDSTSET      M33_ICSR_PENDSTSET_BITS
+#endif
+
+/** Shortest SysTick reload after a sleep, a shorter rest counts the tick now */
+#define TICKLESS_MIN_RELOAD_US      (20UL)
+
+/** The core that does not run the tick */
+#define TICKLESS_OTHER_CORE         (1U - configTICK_CORE)
+
+/* --- Local type/struct definitions ---------------------------------------- */
+
+/* --- Static variables ----------------------------------------------------- */
+
+static int iTicklessAlarm = -1;
+
+/** Set by each core around its WFI */
+static volatile bool baTicklessAsleep[configNUMBER_OF_CORES];
+
+/** Sleep time below 1 ms not yet counted in the metrics */
+static uint32_t uaTicklessRestUs[configNUMBER_OF_CORES];
+
+/* --- Static function prototypes ------------------------------------------- */
+
+/**
+ * @brief Alarm callback, the interrupt itself is the wake-up
+ *
+ * @param uAlarm Unused
+ */
+static void vTicklessAlarm(uint uAlarm);
+
+/**
+ * @brief Sleep of the tick core, stops the tick if the other core sleeps too
+ *
+ * @return Ticks passed with the tick stopped and not stepped yet
+ */
+static TickType_t xTicklessSleepTickCore(void);
+
+/**
+ * @brief Sleep of the other core, its SysTick is paused
+ */
+static void vTicklessSleepOtherCore(void);
+
+/**
+ * @brief Wake-up and sleep time metrics, called with interrupts disabled
+ *
+ * @param uCore    Core that slept
+ * @param uSleptUs Time slept in us
+ */
+static void vTicklessAccount(const uint32_t uCore, const uint32_t uSleptUs);
+
+/* --- Public functions ----------------------------------------------------- */
+
+eRetVal_t eTicklessPreInit(void)
+{
+    eRetVal_t eRetVal = ErrNoError;
+
+#if TICKLESS_IDLE
+    // Runs on the tick core, the alarm interrupt is enabled there
+    iTicklessAlarm = hardware_alarm_claim_unused(false);
+
+    if (0 > iTicklessAlarm)
+    {
+        eRetVal = ErrError;
+    }
+    else
+    {
+        hardware_alarm_set_callback((uint)iTicklessAlarm, vTicklessAlarm);
+    }
+#endif
+
+    return (eRetVal);
+}
+
+
+void vTicklessIdle(void)
+{
+#if TICKLESS_IDLE
+    TickType_t xTicks = 0U;
+
+    if (0 <= iTicklessAlarm)
+    {
+        if (configTICK_CORE == get_core_num())
+        {
+            xTicks = xTicklessSleepTickCore();
+        }
+        else
+        {
+            vTicklessSleepOtherCore();
+        }
+
+        if (0U != xTicks)
+        {
+            // The ticks from the next time-out on: unblocks the tasks and pends
+            // the context switch
+            (void)xTaskCatchUpTicks(xTicks);
+        }
+    }
+#endif
+}
+
+/* --- Static functions ----------------------------------------------------- */
+
+static void vTicklessAlarm(uint uAlarm)
+{
+    (void)uAlarm; // Silence 'unused parameters'
+}
+
+
+static TickType_t xTicklessSleepTickCore(void)
+{
+    const uint32_t uIrq = save_and_disable_interrupts();
+    const uint32_t uReload = systick_hw->rvr;
+    const uint32_t uPeriodUs = uReload + 1UL;
+    const uint32_t uStartUs = time_us_32();
+    TickType_t xIdle = xTaskGetIdleTicks();
+    TickType_t xTicks = 0U;
+    uint32_t uElapsedUs;
+    uint32_t uSleepUs;
+    uint32_t uTotalUs;
+    uint32_t uRestUs;
+    uint32_t uSleptUs;
+
+    if (xIdle > TICKLESS_MAX_TICKS)
+    {
+        xIdle = TICKLESS_MAX_TICKS;
+    }
+
+    if (0UL != (scb_hw->icsr & TICKLESS_PENDSTSET))
+    {
+        // The tick is due, let it run first
+        xIdle = 0U;
+    }
+
+    // Pairs with the check in vTicklessSleepOtherCore(): one side sees the other
+    baTicklessAsleep[configTICK_CORE] = true;
+    __dmb();
+
+    if ((xIdle >= TICKLESS_MIN_TICKS) && baTicklessAsleep[TICKLESS_OTHER_CORE])
+    {
+        systick_hw->csr &= ~TICKLESS_SYST_ENABLE;
+        uElapsedUs = uReload - systick_hw->cvr;
+        uSleepUs = (xIdle * uPeriodUs) - uElapsedUs;
+
+        if (!hardware_alarm_set_target((uint)iTicklessAlarm, make_timeout_time_us(uSleepUs)))
+        {
+            __dsb();
+            __wfi();
+        }
+        hardware_alarm_cancel((uint)iTicklessAlarm);
+
+        uSleptUs = time_us_32() - uStartUs;
+
+        // Whole ticks passed, the rest continues the tick in phase
+        uTotalUs = uElapsedUs + uSleptUs;
+        xTicks = uTotalUs / uPeriodUs;
+        uRestUs = uPeriodUs - (uTotalUs % uPeriodUs);
+        if (uRestUs < TICKLESS_MIN_RELOAD_US)
+        {
+            xTicks++;
+            uRestUs += uPeriodUs;
+        }
+
+        // Writing cvr clears it, the next count loads the shortened reload
+        systick_hw->rvr = uRestUs - 1UL;
+        systick_hw->cvr = 0UL;
+        systick_hw->csr |= TICKLESS_SYST_ENABLE;
+        while (0UL == systick_hw->cvr)
+        {
+            tight_loop_contents();
+        }
+        systick_hw->rvr = uReload;
+
+        // Before the interrupt that woke the core can ready a task
+        xTicks = xTaskStepIdleTicks(xTicks);
+        __dmb();
+        baTicklessAsleep[configTICK_CORE] = false;
+
+        vMetricsInc(MetricTicklessSleeps);
+    }
+    else
+    {
+        // Until the next tick or interrupt
+        __dsb();
+        __wfi();
+
+        baTicklessAsleep[configTICK_CORE] = false;
+        uSleptUs = time_us_32() - uStartUs;
+    }
+
+    vTicklessAccount(configTICK_CORE, uSleptUs);
+
+    restore_interrupts(uIrq);
+
+    return (xTicks);
+}
+
+
+static void vTicklessSleepOtherCore(void)
+{
+    const uint32_t uIrq = save_and_disable_interrupts();
+    const uint32_t uCsr = systick_hw->csr;
+    const uint32_t uStartUs = time_us_32();
+    uint32_t uSleptUs;
+
+    // Only the tick core counts ticks, this one is woken by the scheduler
+    systick_hw->csr = uCsr & ~TICKLESS_SYST_ENABLE;
+
+    baTicklessAsleep[TICKLESS_OTHER_CORE] = true;
+    __dsb();
+    __wfi();
+    baTicklessAsleep[TICKLESS_OTHER_CORE] = false;
+    __dmb();
+
+    // The tick core steps its ticks before the interrupt here readies a task.
+    // It clears its flag after the step; a missed force ends with the alarm.
+    if (baTicklessAsleep[configTICK_CORE])
+    {
+        hardware_alarm_force_irq((uint)iTicklessAlarm);
+
+        while (baTicklessAsleep[configTICK_CORE])
+        {
+            tight_loop_contents();
+        }
+        __dmb();
+    }
+
+    systick_hw->csr = uCsr;
+    uSleptUs = time_us_32() - uStartUs;
+
+    vTicklessAccount(TICKLESS_OTHER_CORE, uSleptUs);
+
+    restore_interrupts(uIrq);
+}
+
+
+static void vTicklessAccount(const uint32_t uCore, const uint32_t uSleptUs)
+{
+    static const eMetricCounter_t eaSleepMs[] = {MetricCore0SleepMs, MetricCore1SleepMs};
+    static const eMetricCounter_t eaWakeups[] = {MetricCore0Wakeups, MetricCore1Wakeups};
+
+    uaTicklessRestUs[uCore] += uSleptUs;
+    vMetricsAdd(eaSleepMs[uCore], uaTicklessRestUs[uCore] / 1000UL);
+    uaTicklessRestUs[uCore] %= 1000UL;
+    vMetricsInc(eaWakeups[uCore]);
+
+    // WFI time is idle time for the clock governor
+    vDvfsIdleSlept(uSleptUs);
+}
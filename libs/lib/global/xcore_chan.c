@@ -0,0 +1,260 @@
+/** ****************************************************************************
+ * @file   xcore_chan.c
+ *
+ * @author Michael R.
+ *
+ * @brief  Zero-copy message channel between tasks on different cores
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <string.h>
+
+// pico-sdk includes
+#include "pico/multicore.h"
+#include "pico/platform.h"
+#include "hardware/irq.h"
+
+// FreeRTOS includes
+#include "FreeRTOS.h" /* Must come first. */
+#include "task.h"
+
+// Project includes
+#include "global/xcore_chan.h"
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+#define XCORE_INIT_STACK    (256UL)
+
+/** Doorbells exist on the RP2350 only */
+#ifdef NUM_DOORBELLS
+    #define XCORE_BELLS     (NUM_DOORBELLS)
+#else
+    #define XCORE_BELLS     (0U)
+#endif
+
+/* --- Local type/struct definitions ---------------------------------------- */
+
+/* --- Static variables ----------------------------------------------------- */
+
+#if XCORE_BELLS
+/** Channel of each claimed doorbell */
+static sXcoreChan_t *volatile saXcoreBell[XCORE_BELLS];
+#endif
+
+/* --- Static function prototypes ------------------------------------------- */
+
+#if XCORE_BELLS
+/**
+ * @brief Doorbell interrupt (runs on the core of the consumer's side)
+ */
+static void vXcoreBellIsr(void);
+
+/**
+ * @brief Enables the doorbell interrupt on core 1 and deletes itself
+ *
+ * @param pvParameters Unused
+ */
+static void vXcoreInitTask(void *pvParameters);
+#endif
+
+/**
+ * @brief Give the notification to the waiting consumer
+ *
+ * @param xTask Consumer task
+ */
+static void vXcoreNotify(const TaskHandle_t xTask);
+
+/* --- Public functions ----------------------------------------------------- */
+
+eRetVal_t eXcoreRtosInit(void)
+{
+    eRetVal_t eRetVal = ErrNoError;
+#if XCORE_BELLS
+    BaseType_t xReturned;
+
+    irq_add_shared_handler(SIO_IRQ_BELL, vXcoreBellIsr, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+
+    // The NVIC is per core: core 0 here, core 1 by a short-lived task on it
+    irq_set_enabled(SIO_IRQ_BELL, true);
+
+    xReturned = xTaskCreateAffinitySet(
+                    vXcoreInitTask,
+                    "XcoreInit",
+                    XCORE_INIT_STACK,
+                    NULL,
+                    configMAX_PRIORITIES - 1U,
+                    1UL << 1U,
+                    NULL);
+
+    if (pdPASS != xReturned)
+    {
+        eRetVal = ErrError;
+    }
+#endif
+
+    return (eRetVal);
+}
+
+
+eRetVal_t eXcoreChanInit(
+    sXcoreChan_t *const sChan,
+    void *const pvBuffer,
+    const uint32_t uSlotSize,
+    const uint32_t uSlots)
+{
+    eRetVal_t eRetVal = ErrNoError;
+
+    if ((0UL == uSlots) || (0UL != (uSlots & (uSlots - 1UL))))
+    {
+        eRetVal = ErrError;
+    }
+    else
+    {
+        vSpscInit(&sChan->sRing, pvBuffer, uSlotSize, uSlots);
+        sChan->xConsumer = NULL;
+        sChan->iBell = -1L;
+
+#if XCORE_BELLS
+        // Out of doorbells: still works with the direct notification
+        sChan->iBell = multicore_doorbell_claim_unused((1U << NUM_CORES) - 1U, false);
+        if (sChan->iBell >= 0L)
+        {
+            saXcoreBell[sChan->iBell] = sChan;
+        }
+#endif
+    }
+
+    return (eRetVal);
+}
+
+
+void vXcoreCommit(sXcoreChan_t *const sChan)
+{
+    TaskHandle_t xTask;
+
+    vSpscCommit(&sChan->sRing);
+
+    // Index store before the look at xConsumer, pairs with pvXcoreReceive
+    SPSC_BARRIER();
+    xTask = sChan->xConsumer;
+
+    if (NULL != xTask)
+    {
+#if XCORE_BELLS
+        if (sChan->iBell >= 0L)
+        {
+            multicore_doorbell_set_other_core((uint)sChan->iBell);
+        }
+        else
+#endif
+        {
+            vXcoreNotify(xTask);
+        }
+    }
+}
+
+
+bool bXcoreSend(sXcoreChan_t *const sChan, const void *pvData, const uint32_t uLen)
+{
+    bool bSent = false;
+    void *const pvSlot = pvXcoreReserve(sChan);
+
+    if ((NULL != pvSlot) && (uLen <= sChan->sRing.uSlotSize))
+    {
+        memcpy(pvSlot, pvData, uLen);
+        vXcoreCommit(sChan);
+        bSent = true;
+    }
+
+    return (bSent);
+}
+
+
+void *pvXcoreReceive(sXcoreChan_t *const sChan, const TickType_t xWait)
+{
+    void *pvSlot = pvXcorePeek(sChan);
+    TickType_t xRemaining = xWait;
+    TimeOut_t xTimeOut;
+
+    if ((NULL == pvSlot) && (0U != xWait))
+    {
+        vTaskSetTimeOutState(&xTimeOut);
+
+        // Announce the wait, then look again: a commit in between either
+        // is seen here or sees xConsumer
+        sChan->xConsumer = xTaskGetCurrentTaskHandle();
+        SPSC_BARRIER();
+
+        pvSlot = pvXcorePeek(sChan);
+        while ((NULL == pvSlot) && (pdFALSE == xTaskCheckForTimeOut(&xTimeOut, &xRemaining)))
+        {
+            // Wake-ups of an earlier wait may still be pending, just look again
+            ulTaskNotifyTakeIndexed(XCORE_NOTIFY_INDEX, pdTRUE, xRemaining);
+            pvSlot = pvXcorePeek(sChan);
+        }
+
+        sChan->xConsumer = NULL;
+    }
+
+    return (pvSlot);
+}
+
+/* --- Static functions ----------------------------------------------------- */
+
+#if XCORE_BELLS
+static void vXcoreBellIsr(void)
+{
+    BaseType_t xWoken = pdFALSE;
+    sXcoreChan_t *sChan;
+    TaskHandle_t xTask;
+
+    for (uint32_t i = 0U; i < XCORE_BELLS; i++)
+    {
+        sChan = saXcoreBell[i];
+
+        // Shared interrupt: only the own doorbells
+        if ((NULL != sChan) && multicore_doorbell_is_set_current_core(i))
+        {
+            multicore_doorbell_clear_current_core(i);
+
+            xTask = sChan->xConsumer;
+            if (NULL != xTask)
+            {
+                vTaskNotifyGiveIndexedFromISR(xTask, XCORE_NOTIFY_INDEX, &xWoken);
+            }
+        }
+    }
+
+    portYIELD_FROM_ISR(xWoken);
+}
+
+
+static void vXcoreInitTask(void *pvParameters)
+{
+    (void)pvParameters; // Silence 'unused parameters'
+
+    irq_set_enabled(SIO_IRQ_BELL, true);
+
+    vTaskDelete(NULL);
+}
+#endif
+
+
+static void vXcoreNotify(const TaskHandle_t xTask)
+{
+    BaseType_t xWoken = pdFALSE;
+
+    if (0U != __get_current_exception())
+    {
+        vTaskNotifyGiveIndexedFromISR(xTask, XCORE_NOTIFY_INDEX, &xWoken);
+        portYIELD_FROM_ISR(xWoken);
+    }
+    else
+    {
+        xTaskNotifyGiveIndexed(xTask, XCORE_NOTIFY_INDEX);
+    }
+}
@@ -0,0 +1,49 @@
+/** ****************************************************************************
+ * @file   xip_profile.c
+ *
+ * @author Michael R.
+ *
+ * @brief  XIP cache miss profiling of the log and network paths.
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+// pico-sdk includes
+// FreeRTOS includes
+// Project includes
+#include "global/xip_profile.h"
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+/* --- Local type/struct definitions ---------------------------------------- */
+
+/* --- Static variables ----------------------------------------------------- */
+
+/* --- Static function prototypes ------------------------------------------- */
+
+/* --- Public functions ----------------------------------------------------- */
+
+int32_t iXipProfileHitPermille(void)
+{
+    int32_t iPermille = -1L;
+#if XIP_PROFILE
+    const uint32_t uHit = xip_ctrl_hw->ctr_hit;
+    const uint32_t uAcc = xip_ctrl_hw->ctr_acc;
+
+    // Writing any value clears a counter
+    xip_ctrl_hw->ctr_hit = 0UL;
+    xip_ctrl_hw->ctr_acc = 0UL;
+
+    if ((0UL != uAcc) && (uHit <= uAcc))
+    {
+        iPermille = (int32_t)(((uint64_t)uHit * 1000ULL) / uAcc);
+    }
+#endif
+
+    return (iPermille);
+}
+
+/* --- Static functions ----------------------------------------------------- */
@@ -0,0 +1,998 @@
+/** ****************************************************************************
+ * @file   http_server.c
+ *
+ * @author Michael R.
+ *
+ * @brief  Minimal HTTP/1.1 status server (/metrics, /tasks, /net, /log)
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// pico-sdk includes
+#include "pico/cyw43_arch.h"
+#include "lwip/tcp.h"
+#include "lwip/ip4_addr.h"
+#include "lwip/timeouts.h"
+
+// FreeRTOS includes
+#include "FreeRTOS.h" /* Must come first. */
+#include "task.h"
+
+// Project includes
+#include "http/http_server.h"
+#include "http/websocket.h"
+
+#include "global/debug_print.h"
+#include "global/event_bus.h"
+#include "global/flash_log.h"
+#include "global/metrics.h"
+#include "global/periodic.h"
+#include "wlan/wlan.h"
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+#define HTTP_PRIORITY       (tskIDLE_PRIORITY + 1UL)
+#define HTTP_STACK          (512UL * 2U)
+
+/** Number of simultaneous connections */
+#define HTTP_MAX_CONN       (4U)
+
+/** Maximum size of a request header */
+#define HTTP_REQUEST_SIZE   (512U)
+
+/** Space reserved in front of each body for the response header */
+#define HTTP_HEADER_RESERVE (128U)
+
+#define HTTP_METRICS_SIZE   (HTTP_HEADER_RESERVE + METRICS_TEXT_SIZE)
+#define HTTP_TASKS_SIZE     (HTTP_HEADER_RESERVE + 1536U)
+#define HTTP_NET_SIZE       (HTTP_HEADER_RESERVE + 512U)
+#define HTTP_JOBS_SIZE      (HTTP_HEADER_RESERVE + 1536U)
+
+/** Maximum number of tasks listed on /tasks */
+#define HTTP_MAX_TASKS      (24U)
+
+/** Poll interval in units of the coarse TCP timer (500 ms) */
+#define HTTP_POLL_INTERVAL  (4U)
+
+/** Idle keep-alive connections are closed after this number of polls */
+#define HTTP_IDLE_POLLS     (15U)
+
+/** Path of the flash log download */
+#define HTTP_LOG_PATH       "/log"
+
+/** One line of the flash log download: time and message */
+#define HTTP_LOG_LINE       (12U + FLASH_LOG_MAX_TEXT)
+
+/** Pause between two query steps that found nothing to send */
+#define HTTP_LOG_STEP_MS    (10U)
+
+/* --- Local type/struct definitions ---------------------------------------- */
+
+/**
+ * @brief Pre-rendered page with two buffers
+ *
+ * uActive is only changed by the render task, the reference counters only in
+ * the lwIP context. The render task holds the lwIP lock while it checks the
+ * counters and switches the buffer.
+ */
+typedef struct sHttpPage_tag
+{
+    const char *cpPath;
+    char *cpaBuffer[2];
+    uint32_t uSize;
+    const char *cpaStart[2];      ///< Start of the response within the buffer
+    uint32_t uaLen[2];            ///< Length of the complete response
+    uint8_t uaInUse[2];           ///< Connections still referencing the buffer
+    volatile uint8_t uActive;     ///< Buffer handed out to new requests
+} sHttpPage_t;
+
+typedef enum eHttpPage_tag
+{
+    HttpPageMetrics,
+    HttpPageTasks,
+    HttpPageNet,
+    HttpPageJobs,
+    NumHttpPage
+} eHttpPage_t;
+
+typedef struct sHttpConn_tag
+{
+    struct tcp_pcb *sPcb;
+    char caRequest[HTTP_REQUEST_SIZE];
+    uint16_t uReqLen;
+    bool bOverflow;               ///< Request bytes did not fit, later ones ignored
+
+    sHttpPage_t *sPage;           ///< Referenced page, NULL for static replies
+    uint8_t uBuffer;              ///< Referenced buffer of sPage
+    const char *cpTx;             ///< Data not yet handed to lwIP
+    uint32_t uTxLeft;
+    uint32_t uUnacked;            ///< Data handed to lwIP but not acked
+    bool bClose;                  ///< Close after the current response
+    uint8_t uIdlePolls;
+
+    bool bLog;                    ///< Flash log records follow the header
+    bool bLogTimer;               ///< Next query step scheduled
+    sFlashLogQuery_t sLogQuery;
+} sHttpConn_t;
+
+typedef struct sHttpState_tag
+{
+    struct tcp_pcb *sListenPcb;
+    sHttpConn_t saConn[HTTP_MAX_CONN];
+} sHttpState_t;
+
+/* --- Static variables ----------------------------------------------------- */
+
+static char caMetricsPage[2][HTTP_METRICS_SIZE];
+static char caTasksPage[2][HTTP_TASKS_SIZE];
+static char caNetPage[2][HTTP_NET_SIZE];
+static char caJobsPage[2][HTTP_JOBS_SIZE];
+
+static sHttpPage_t saHttpPage[NumHttpPage] =
+{
+    [HttpPageMetrics] = {
+        .cpPath = "/metrics",
+        .cpaBuffer = {caMetricsPage[0], caMetricsPage[1]},
+        .uSize = HTTP_METRICS_SIZE,
+    },
+    [HttpPageTasks] = {
+        .cpPath = "/tasks",
+        .cpaBuffer = {caTasksPage[0], caTasksPage[1]},
+        .uSize = HTTP_TASKS_SIZE,
+    },
+    [HttpPageNet] = {
+        .cpPath = "/net",
+        .cpaBuffer = {caNetPage[0], caNetPage[1]},
+        .uSize = HTTP_NET_SIZE,
+    },
+    [HttpPageJobs] = {
+        .cpPath = "/jobs",
+        .cpaBuffer = {caJobsPage[0], caJobsPage[1]},
+        .uSize = HTTP_JOBS_SIZE,
+    },
+};
+
+static const char caHttp404[] =
+    "HTTP/1.1 404 Not Found\r\n"
+    "Content-Type: text/plain\r\n"
+    "Content-Length: 10\r\n"
+    "\r\n"
+    "Not found\n";
+
+static const char caHttp503[] =
+    "HTTP/1.1 503 Service Unavailable\r\n"
+    "Content-Length: 0\r\n"
+    "Connection: close\r\n"
+    "\r\n";
+
+static const char caHttpLog[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: text/plain\r\n"
+    "Connection: close\r\n"
+    "\r\n";
+
+static const char caHttp400[] =
+    "HTTP/1.1 400 Bad Request\r\n"
+    "Content-Length: 0\r\n"
+    "Connection: close\r\n"
+    "\r\n";
+
+static const char caHttp413[] =
+    "HTTP/1.1 413 Content Too Large\r\n"
+    "Content-Length: 0\r\n"
+    "Connection: close\r\n"
+    "\r\n";
+
+static sHttpState_t sHttpState;
+
+/** Link state, the render task skips the lwIP lock while the link is down */
+static volatile bool bHttpLinkUp = false;
+
+static sEventSub_t sHttpLinkUpSub;
+static sEventSub_t sHttpLinkDownSub;
+
+/* --- Static function prototypes ------------------------------------------- */
+
+/**
+ * @brief EventLinkUp/EventLinkDown: opens the listener, pauses the rendering
+ *
+ * @param eEvent Event
+ * @param uArg   Unused
+ */
+static void vHttpOnLink(const eEvent_t eEvent, const uint32_t uArg);
+
+/**
+ * @brief Render task. Refreshes all pages every HTTP_RENDER_MS.
+ *
+ * @param pvParameters Unused
+ */
+static void vHttpRenderTask(void *pvParameters);
+
+/**
+ * @brief Render the body of a page
+ *
+ * @param ePage    Page
+ * @param cpBody   Target
+ * @param uSize    Size of the target
+ *
+ * @return Length of the body, uSize - 1 if it was cut off
+ */
+static uint32_t uHttpRenderBody(const eHttpPage_t ePage, char *const cpBody, const uint32_t uSize);
+
+/**
+ * @brief Render page into its inactive buffer and activate it
+ *
+ * @param ePage    Page
+ */
+static void vHttpRenderPage(const eHttpPage_t ePage);
+
+/**
+ * @brief lwIP accept callback
+ */
+static err_t xHttpAccept(void *pvArg, struct tcp_pcb *sPcb, err_t xErr);
+
+/**
+ * @brief lwIP receive callback
+ */
+static err_t xHttpRecv(void *pvArg, struct tcp_pcb *sPcb, struct pbuf *sPb, err_t xErr);
+
+/**
+ * @brief lwIP sent callback
+ */
+static err_t xHttpSent(void *pvArg, struct tcp_pcb *sPcb, u16_t uLen);
+
+/**
+ * @brief lwIP poll callback, closes idle connections
+ */
+static err_t xHttpPoll(void *pvArg, struct tcp_pcb *sPcb);
+
+/**
+ * @brief lwIP error callback, the pcb is already gone
+ */
+static void vHttpErr(void *pvArg, err_t xErr);
+
+/**
+ * @brief Parse a complete request in the request buffer and start the reply
+ *
+ * @param sConn Connection
+ */
+static void vHttpHandleRequest(sHttpConn_t *const sConn);
+
+/**
+ * @brief Hand as much of the pending response to lwIP as fits
+ *
+ * @param sConn Connection
+ */
+static void vHttpSendPending(sHttpConn_t *const sConn);
+
+/**
+ * @brief Start a flash log download, parses from, to and level
+ *
+ * @param sConn  Connection
+ * @param cpArgs Query string after '?' or NULL
+ */
+static void vHttpStartLog(sHttpConn_t *const sConn, const char *cpArgs);
+
+/**
+ * @brief Hand flash log records to lwIP (copied) as long as they fit
+ *
+ * @param sConn Connection
+ */
+static void vHttpSendLog(sHttpConn_t *const sConn);
+
+/**
+ * @brief lwIP timeout: next query step of a flash log download
+ *
+ * @param pvArg Connection
+ */
+static void vHttpLogStep(void *pvArg);
+
+/**
+ * @brief Drop the reference on the page buffer
+ *
+ * @param sConn Connection
+ */
+static void vHttpReleasePage(sHttpConn_t *const sConn);
+
+/**
+ * @brief Close (or abort if data is still referenced) and free a connection
+ *
+ * @param sConn Connection
+ *
+ * @return err_t ERR_ABRT if the pcb was aborted
+ */
+static err_t xHttpClose(sHttpConn_t *const sConn);
+
+/* --- Public functions ----------------------------------------------------- */
+
+eRetVal_t eHttpRtosInit(void)
+{
+    eRetVal_t eRetVal = ErrNoError;
+    BaseType_t xReturned;
+
+    DBG_PR(DBG_INFO, FN_HTTP, "\n");
+
+    xReturned = xTaskCreate(
+                    vHttpRenderTask,
+                    "HTTP",
+                    HTTP_STACK,
+                    NULL,
+                    HTTP_PRIORITY,
+                    NULL);
+
+    if (pdPASS != xReturned)
+    {
+        eRetVal = ErrError;
+    }
+    else
+    {
+        vEventSubscribe(&sHttpLinkUpSub, EventLinkUp, vHttpOnLink, EventOrderNormal);
+        vEventSubscribe(&sHttpLinkDownSub, EventLinkDown, vHttpOnLink, EventOrderFirst);
+    }
+
+    return (eRetVal);
+}
+
+
+void vHttpStart(void)
+{
+    struct tcp_pcb *sPcb;
+
+    if (NULL == sHttpState.sListenPcb)
+    {
+        // Have valid pages before the first request arrives
+        for (uint32_t i = 0U; i < NumHttpPage; i++)
+        {
+            vHttpRenderPage(i);
+        }
+    }
+
+    cyw43_arch_lwip_begin();
+
+    if (NULL == sHttpState.sListenPcb)
+    {
+        sPcb = tcp_new_ip_type(IPADDR_TYPE_ANY);
+
+        if ((NULL != sPcb) && (ERR_OK == tcp_bind(sPcb, IP_ANY_TYPE, HTTP_PORT)))
+        {
+            sHttpState.sListenPcb = tcp_listen_with_backlog(sPcb, HTTP_MAX_CONN);
+            tcp_accept(sHttpState.sListenPcb, xHttpAccept);
+        }
+        else if (NULL != sPcb)
+        {
+            tcp_close(sPcb);
+        }
+    }
+
+    cyw43_arch_lwip_end();
+
+    if (NULL == sHttpState.sListenPcb)
+    {
+        DBG_PR(DBG_ERROR, FN_HTTP, "Listen on port %d failed!\n", HTTP_PORT);
+    }
+}
+
+/* --- Static functions ----------------------------------------------------- */
+
+static void vHttpOnLink(const eEvent_t eEvent, const uint32_t uArg)
+{
+    (void)uArg; // Silence 'unused parameters'
+
+    bHttpLinkUp = (EventLinkUp == eEvent);
+
+    if (bHttpLinkUp)
+    {
+        vHttpStart();
+    }
+}
+
+
+static void vHttpRenderTask(void *pvParameters)
+{
+    (void)pvParameters; // Silence 'unused parameters'
+
+    TickType_t xLastWake = xTaskGetTickCount();
+
+    while (1)
+    {
+        vTaskDelayUntil(&xLastWake, pdMS_TO_TICKS(HTTP_RENDER_MS));
+
+        // lwIP (and its lock) only exists once the server was started, and
+        // the driver may be de-initialised after a link loss
+        if (bHttpLinkUp && (NULL != sHttpState.sListenPcb))
+        {
+            for (uint32_t i = 0U; i < NumHttpPage; i++)
+            {
+                vHttpRenderPage(i);
+            }
+        }
+    }
+}
+
+
+static uint32_t uHttpRenderBody(const eHttpPage_t ePage, char *const cpBody, const uint32_t uSize)
+{
+    static sMetricSnapshot_t sSnapshot;
+    static TaskStatus_t saTasks[HTTP_MAX_TASKS];
+    static const char caState[] = {'X', 'R', 'B', 'S', 'D', '?'};
+    uint32_t uLen = 0U;
+    UBaseType_t uNumTasks;
+    int32_t iRssi = 0;
+    int iLen;
+
+    switch (ePage)
+    {
+    case HttpPageMetrics:
+        vMetricsSnapshot(&sSnapshot);
+        uLen = uMetricsRenderText(&sSnapshot, cpBody, uSize);
+        break;
+
+    case HttpPageTasks:
+        uNumTasks = uxTaskGetSystemState(saTasks, HTTP_MAX_TASKS, NULL);
+
+        iLen = snprintf(cpBody, uSize, "%-16s %5s %4s %8s\n", "Name", "State", "Prio", "StackHWM");
+        uLen = (iLen > 0) ? (uint32_t)iLen : 0U;
+
+        for (UBaseType_t i = 0U; (i < uNumTasks) && (uLen < uSize); i++)
+        {
+            iLen = snprintf(
+                &cpBody[uLen],
+                uSize - uLen,
+                "%-16s %5c %4lu %8lu\n",
+                saTasks[i].pcTaskName,
+                caState[(saTasks[i].eCurrentState < eInvalid) ? saTasks[i].eCurrentState : eInvalid],
+                (unsigned long)saTasks[i].uxCurrentPriority,
+                (unsigned long)saTasks[i].usStackHighWaterMark);
+            uLen += (iLen > 0) ? (uint32_t)iLen : 0U;
+        }
+        break;
+
+    case HttpPageNet:
+        if (bWlanIsConnected())
+        {
+            cyw43_arch_lwip_begin();
+            cyw43_wifi_get_rssi(&cyw43_state, &iRssi);
+            iLen = snprintf(
+                cpBody,
+                uSize,
+                "link: up\nip: %s\n",
+                ip4addr_ntoa(netif_ip4_addr(&cyw43_state.netif[CYW43_ITF_STA])));
+            uLen = (iLen > 0) ? (uint32_t)iLen : 0U;
+            iLen = snprintf(
+                &cpBody[uLen],
+                (uLen < uSize) ? (uSize - uLen) : 0U,
+                "gw: %s\nrssi: %ld dBm\n",
+                ip4addr_ntoa(netif_ip4_gw(&cyw43_state.netif[CYW43_ITF_STA])),
+                (long)iRssi);
+            uLen += (iLen > 0) ? (uint32_t)iLen : 0U;
+            cyw43_arch_lwip_end();
+        }
+        else
+        {
+            iLen = snprintf(cpBody, uSize, "link: down\n");
+            uLen = (iLen > 0) ? (uint32_t)iLen : 0U;
+        }
+        break;
+
+    case HttpPageJobs:
+        uLen = uPeriodicRenderText(cpBody, uSize);
+        break;
+
+    default:
+        break;
+    }
+
+    if (uLen >= uSize)
+    {
+        uLen = uSize - 1U;
+    }
+
+    return (uLen);
+}
+
+
+static void vHttpRenderPage(const eHttpPage_t ePage)
+{
+    sHttpPage_t *const sPage = &saHttpPage[ePage];
+    const uint8_t uTarget = sPage->uActive ^ 1U;
+    char *const cpBody = &sPage->cpaBuffer[uTarget][HTTP_HEADER_RESERVE];
+    char caHeader[HTTP_HEADER_RESERVE];
+    // Prometheus text format only for the metrics, the others are plain text
+    const char *const cpType = (HttpPageMetrics == ePage) ? "; version=0.0.4" : "";
+    const uint32_t uBodySize = sPage->uSize - HTTP_HEADER_RESERVE;
+    uint32_t uBodyLen;
+    int iHeaderLen;
+    bool bInUse;
+
+    cyw43_arch_lwip_begin();
+    bInUse = (0U != sPage->uaInUse[uTarget]);
+    cyw43_arch_lwip_end();
+
+    // A slow client still reads the old content, try again next time
+    if (!bInUse)
+    {
+        uBodyLen = uHttpRenderBody(ePage, cpBody, uBodySize);
+
+        if (uBodyLen >= (uBodySize - 1U))
+        {
+            // Cut off, a half page (e.g. a histogram) would be rejected
+            iHeaderLen = snprintf(
+                caHeader,
+                sizeof(caHeader),
+                "HTTP/1.1 500 Internal Server Error\r\n"
+                "Content-Length: 0\r\n"
+                "\r\n");
+            uBodyLen = 0U;
+        }
+        else
+        {
+            iHeaderLen = snprintf(
+                caHeader,
+                sizeof(caHeader),
+                "HTTP/1.1 200 OK\r\n"
+                "Content-Type: text/plain%s\r\n"
+                "Content-Length: %lu\r\n"
+                "\r\n",
+                cpType,
+                (unsigned long)uBodyLen);
+        }
+
+        if ((iHeaderLen > 0) && (iHeaderLen < (int)HTTP_HEADER_RESERVE))
+        {
+            // Place the header right in front of the body
+            memcpy(cpBody - iHeaderLen, caHeader, (size_t)iHeaderLen);
+
+            cyw43_arch_lwip_begin();
+            sPage->cpaStart[uTarget] = cpBody - iHeaderLen;
+            sPage->uaLen[uTarget] = uBodyLen + (uint32_t)iHeaderLen;
+            sPage->uActive = uTarget;
+            cyw43_arch_lwip_end();
+        }
+    }
+}
+
+
+static err_t xHttpAccept(void *pvArg, struct tcp_pcb *sPcb, err_t xErr)
+{
+    (void)pvArg;
+
+    err_t xRetVal = ERR_OK;
+    sHttpConn_t *sConn = NULL;
+
+    if ((ERR_OK != xErr) || (NULL == sPcb))
+    {
+        xRetVal = ERR_VAL;
+    }
+    else
+    {
+        for (uint32_t i = 0U; i < HTTP_MAX_CONN; i++)
+        {
+            if (NULL == sHttpState.saConn[i].sPcb)
+            {
+                sConn = &sHttpState.saConn[i];
+                break;
+            }
+        }
+
+        if (NULL == sConn)
+        {
+            tcp_abort(sPcb);
+            xRetVal = ERR_ABRT;
+        }
+        else
+        {
+            memset(sConn, 0, sizeof(*sConn));
+            sConn->sPcb = sPcb;
+
+            tcp_arg(sPcb, sConn);
+            tcp_recv(sPcb, xHttpRecv);
+            tcp_sent(sPcb, xHttpSent);
+            tcp_err(sPcb, vHttpErr);
+            tcp_poll(sPcb, xHttpPoll, HTTP_POLL_INTERVAL);
+            tcp_nagle_disable(sPcb);
+        }
+    }
+
+    return (xRetVal);
+}
+
+
+static err_t xHttpRecv(void *pvArg, struct tcp_pcb *sPcb, struct pbuf *sPb, err_t xErr)
+{
+    sHttpConn_t *const sConn = (sHttpConn_t *)pvArg;
+    err_t xRetVal = ERR_OK;
+    uint16_t uCopy;
+
+    (void)xErr;
+
+    if (NULL == sPb)
+    {
+        // Remote closed the connection
+        xRetVal = xHttpClose(sConn);
+    }
+    else
+    {
+        // After a loss the rest of the stream cannot be parsed, keep none
+        uCopy = sConn->bOverflow ? 0U : (HTTP_REQUEST_SIZE - 1U - sConn->uReqLen);
+        if (uCopy >= sPb->tot_len)
+        {
+            uCopy = sPb->tot_len;
+        }
+        else
+        {
+            sConn->bOverflow = true;
+        }
+
+        pbuf_copy_partial(sPb, &sConn->caRequest[sConn->uReqLen], uCopy, 0U);
+        sConn->uReqLen += uCopy;
+        sConn->caRequest[sConn->uReqLen] = '\0';
+        sConn->uIdlePolls = 0U;
+
+        tcp_recved(sPcb, sPb->tot_len);
+        pbuf_free(sPb);
+
+        // Only one response at a time, pipelined requests wait in the buffer
+        if ((NULL == sConn->cpTx) && (0U == sConn->uUnacked))
+        {
+            vHttpHandleRequest(sConn);
+        }
+    }
+
+    return (xRetVal);
+}
+
+
+static err_t xHttpSent(void *pvArg, struct tcp_pcb *sPcb, u16_t uLen)
+{
+    sHttpConn_t *const sConn = (sHttpConn_t *)pvArg;
+    err_t xRetVal = ERR_OK;
+
+    (void)sPcb;
+
+    sConn->uUnacked -= (uLen < sConn->uUnacked) ? uLen : sConn->uUnacked;
+    sConn->uIdlePolls = 0U;
+
+    if ((0U != sConn->uTxLeft) || sConn->bLog)
+    {
+        vHttpSendPending(sConn);
+    }
+
+    // A log download may end without sending anything more
+    if ((0U == sConn->uTxLeft) && !sConn->bLog && (0U == sConn->uUnacked))
+    {
+        // Response completely acked, buffer can be reused
+        vHttpReleasePage(sConn);
+        sConn->cpTx = NULL;
+
+        if (sConn->bClose)
+        {
+            xRetVal = xHttpClose(sConn);
+        }
+        else
+        {
+            vHttpHandleRequest(sConn);
+        }
+    }
+
+    return (xRetVal);
+}
+
+
+static err_t xHttpPoll(void *pvArg, struct tcp_pcb *sPcb)
+{
+    sHttpConn_t *const sConn = (sHttpConn_t *)pvArg;
+    err_t xRetVal = ERR_OK;
+
+    (void)sPcb;
+
+    sConn->uIdlePolls++;
+
+    if (sConn->uIdlePolls > HTTP_IDLE_POLLS)
+    {
+        xRetVal = xHttpClose(sConn);
+    }
+    else if ((0U != sConn->uTxLeft) || sConn->bLog)
+    {
+        // Retry if tcp_write failed due to missing memory
+        vHttpSendPending(sConn);
+    }
+
+    return (xRetVal);
+}
+
+
+static void vHttpErr(void *pvArg, err_t xErr)
+{
+    sHttpConn_t *const sConn = (sHttpConn_t *)pvArg;
+
+    (void)xErr;
+
+    if (NULL != sConn)
+    {
+        if (sConn->bLogTimer)
+        {
+            sys_untimeout(vHttpLogStep, sConn);
+            sConn->bLogTimer = false;
+        }
+
+        vHttpReleasePage(sConn);
+        sConn->sPcb = NULL;
+    }
+}
+
+
+static void vHttpHandleRequest(sHttpConn_t *const sConn)
+{
+    char *cpEnd = strstr(sConn->caRequest, "\r\n\r\n");
+    char *cpPath;
+    char *cpPathEnd;
+    uint32_t uConsumed;
+    sHttpPage_t *sPage = NULL;
+    bool bUpgraded = false;
+
+    if (NULL == cpEnd)
+    {
+        if (sConn->bOverflow || (sConn->uReqLen >= (HTTP_REQUEST_SIZE - 1U)))
+        {
+            // Request too large, the complete ones before were answered
+            sConn->cpTx = caHttp413;
+            sConn->uTxLeft = sizeof(caHttp413) - 1U;
+            sConn->bClose = true;
+            vHttpSendPending(sConn);
+        }
+    }
+    else
+    {
+        *cpEnd = '\0';
+        uConsumed = (uint32_t)(cpEnd - sConn->caRequest) + 4U;
+
+        cpPath = strchr(sConn->caRequest, ' ');
+        cpPathEnd = (NULL != cpPath) ? strchr(cpPath + 1, ' ') : NULL;
+
+        if ((0 != strncmp(sConn->caRequest, "GET ", 4U)) || (NULL == cpPathEnd))
+        {
+            sConn->cpTx = caHttp400;
+            sConn->uTxLeft = sizeof(caHttp400) - 1U;
+            sConn->bClose = true;
+        }
+        else
+        {
+            *cpPathEnd = '\0';
+            cpPath++;
+
+            // HTTP/1.0 closes by default, HTTP/1.1 keeps the connection
+            if (0 == strncmp(cpPathEnd + 1, "HTTP/1.0", 8U))
+            {
+                sConn->bClose = (NULL == strstr(cpPathEnd + 1, "eep-alive"));
+            }
+            else
+            {
+                sConn->bClose = (NULL != strstr(cpPathEnd + 1, "onnection: close"));
+            }
+
+            for (uint32_t i = 0U; i < NumHttpPage; i++)
+            {
+                if (0 == strcmp(cpPath, saHttpPage[i].cpPath))
+                {
+                    sPage = &saHttpPage[i];
+                    break;
+                }
+            }
+
+            if (0 == strcmp(cpPath, WS_PATH))
+            {
+                // The WebSocket server takes over the connection
+                bUpgraded = bWsUpgrade(sConn->sPcb, cpPathEnd + 1);
+
+                if (!bUpgraded)
+                {
+                    sConn->cpTx = caHttp503;
+                    sConn->uTxLeft = sizeof(caHttp503) - 1U;
+                    sConn->bClose = true;
+                }
+            }
+            else if ((0 == strncmp(cpPath, HTTP_LOG_PATH, sizeof(HTTP_LOG_PATH) - 1U)) &&
+                     (('\0' == cpPath[sizeof(HTTP_LOG_PATH) - 1U]) || ('?' == cpPath[sizeof(HTTP_LOG_PATH) - 1U])))
+            {
+                vHttpStartLog(sConn, strchr(cpPath, '?'));
+            }
+            else if (NULL != sPage)
+            {
+                sConn->sPage = sPage;
+                sConn->uBuffer = sPage->uActive;
+                sPage->uaInUse[sConn->uBuffer]++;
+                sConn->cpTx = sPage->cpaStart[sConn->uBuffer];
+                sConn->uTxLeft = sPage->uaLen[sConn->uBuffer];
+            }
+            else
+            {
+                sConn->cpTx = caHttp404;
+                sConn->uTxLeft = sizeof(caHttp404) - 1U;
+            }
+        }
+
+        if (bUpgraded)
+        {
+            // Free the slot without closing the pcb
+            sConn->sPcb = NULL;
+        }
+        else
+        {
+            // Keep pipelined requests
+            sConn->uReqLen -= uConsumed;
+            memmove(sConn->caRequest, &sConn->caRequest[uConsumed], sConn->uReqLen);
+            sConn->caRequest[sConn->uReqLen] = '\0';
+
+            vHttpSendPending(sConn);
+        }
+    }
+}
+
+
+static void vHttpSendPending(sHttpConn_t *const sConn)
+{
+    uint32_t uChunk = tcp_sndbuf(sConn->sPcb);
+
+    if (uChunk > sConn->uTxLeft)
+    {
+        uChunk = sConn->uTxLeft;
+    }
+
+    // No TCP_WRITE_FLAG_COPY: lwIP references the pre-rendered buffer
+    if ((0U != uChunk) &&
+        (ERR_OK == tcp_write(sConn->sPcb, sConn->cpTx, (u16_t)uChunk, 0U)))
+    {
+        sConn->cpTx += uChunk;
+        sConn->uTxLeft -= uChunk;
+        sConn->uUnacked += uChunk;
+        tcp_output(sConn->sPcb);
+    }
+
+    if ((0U == sConn->uTxLeft) && sConn->bLog)
+    {
+        vHttpSendLog(sConn);
+    }
+}
+
+
+static void vHttpStartLog(sHttpConn_t *const sConn, const char *cpArgs)
+{
+    uint32_t uFrom = 0UL;
+    uint32_t uTo = UINT32_MAX;
+    uint32_t uLevel = DBG_ALL;
+    const char *cpValue;
+
+    if (NULL != cpArgs)
+    {
+        cpValue = strstr(cpArgs, "from=");
+        uFrom = (NULL != cpValue) ? strtoul(cpValue + 5, NULL, 10) : uFrom;
+        cpValue = strstr(cpArgs, "to=");
+        uTo = (NULL != cpValue) ? strtoul(cpValue + 3, NULL, 10) : uTo;
+        cpValue = strstr(cpArgs, "level=");
+        uLevel = (NULL != cpValue) ? strtoul(cpValue + 6, NULL, 10) : uLevel;
+    }
+
+    vFlashLogQueryStart(&sConn->sLogQuery, uFrom, uTo, (logLevel_t)uLevel);
+
+    // The length is unknown, the end of the body is the end of the connection
+    sConn->bLog = true;
+    sConn->bClose = true;
+    sConn->cpTx = caHttpLog;
+    sConn->uTxLeft = sizeof(caHttpLog) - 1U;
+}
+
+
+static void vHttpSendLog(sHttpConn_t *const sConn)
+{
+    // Only used in the lwIP context, one buffer for all connections
+    static sFlashLogRecord_t sRecord;
+    static char caLine[HTTP_LOG_LINE];
+    sFlashLogQuery_t sPrevious;
+    eFlashLogQueryResult_t eResult = FlashLogQueryRecord;
+    int iLen;
+
+    while ((FlashLogQueryRecord == eResult) &&
+           sConn->bLog &&
+           (tcp_sndbuf(sConn->sPcb) >= HTTP_LOG_LINE) &&
+           (tcp_sndqueuelen(sConn->sPcb) < (TCP_SND_QUEUELEN / 2U)))
+    {
+        sPrevious = sConn->sLogQuery;
+        eResult = eFlashLogQueryNext(&sConn->sLogQuery, &sRecord);
+
+        if (FlashLogQueryRecord == eResult)
+        {
+            iLen = snprintf(caLine, sizeof(caLine), "%lu %s", (unsigned long)sRecord.uTime, sRecord.caText);
+            iLen = (iLen < (int)sizeof(caLine)) ? iLen : ((int)sizeof(caLine) - 1);
+
+            if (ERR_OK == tcp_write(sConn->sPcb, caLine, (u16_t)iLen, TCP_WRITE_FLAG_COPY))
+            {
+                sConn->uUnacked += (uint32_t)iLen;
+            }
+            else
+            {
+                // Out of memory: read the record again on the next sent/poll
+                sConn->sLogQuery = sPrevious;
+                eResult = FlashLogQueryPending;
+            }
+        }
+        else if (FlashLogQueryEnd == eResult)
+        {
+            sConn->bLog = false;
+        }
+        else if (!sConn->bLogTimer)
+        {
+            // Step without a match, the next one after a pause
+            sConn->bLogTimer = true;
+            sys_timeout(HTTP_LOG_STEP_MS, vHttpLogStep, sConn);
+        }
+    }
+
+    tcp_output(sConn->sPcb);
+}
+
+
+static void vHttpLogStep(void *pvArg)
+{
+    sHttpConn_t *const sConn = (sHttpConn_t *)pvArg;
+
+    sConn->bLogTimer = false;
+
+    if ((NULL != sConn->sPcb) && sConn->bLog && (0U == sConn->uTxLeft))
+    {
+        vHttpSendLog(sConn);
+
+        // Nothing in flight, no sent callback ends the download
+        if (!sConn->bLog && (0U == sConn->uUnacked))
+        {
+            (void)xHttpClose(sConn);
+        }
+    }
+}
+
+
+static void vHttpReleasePage(sHttpConn_t *const sConn)
+{
+    if (NULL != sConn->sPage)
+    {
+        sConn->sPage->uaInUse[sConn->uBuffer]--;
+        sConn->sPage = NULL;
+    }
+}
+
+
+static err_t xHttpClose(sHttpConn_t *const sConn)
+{
+    err_t xRetVal = ERR_OK;
+    struct tcp_pcb *const sPcb = sConn->sPcb;
+
+    tcp_arg(sPcb, NULL);
+    tcp_recv(sPcb, NULL);
+    tcp_sent(sPcb, NULL);
+    tcp_err(sPcb, NULL);
+    tcp_poll(sPcb, NULL, 0U);
+
+    if (sConn->bLogTimer)
+    {
+        sys_untimeout(vHttpLogStep, sConn);
+        sConn->bLogTimer = false;
+    }
+
+    // Segments still referencing the page must be gone before release
+    if ((0U != sConn->uUnacked) || (ERR_OK != tcp_close(sPcb)))
+    {
+        tcp_abort(sPcb);
+        xRetVal = ERR_ABRT;
+    }
+
+    vHttpReleasePage(sConn);
+    sConn->sPcb = NULL;
+
+    return (xRetVal);
+}
@@ -0,0 +1,810 @@
+/** ****************************************************************************
+ * @file   websocket.c
+ *
+ * @author Michael R.
+ *
+ * @brief  WebSocket stream of the debug output and the telemetry batches
+ *
+ * Each client owns a byte ring holding complete frames. Producers append
+ * frames inside a short critical section (uHead), the lwIP context hands the
+ * data to lwIP without copying (uSent) and frees it once acknowledged
+ * (uAcked). The HTTP 101 response is queued in the same ring in front of the
+ * first frame.
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdio.h>
+#include <string.h>
+
+// pico-sdk includes
+#include "pico/cyw43_arch.h"
+#include "hardware/sync.h"
+#include "lwip/tcp.h"
+
+// FreeRTOS includes
+#include "FreeRTOS.h" /* Must come first. */
+#include "task.h"
+
+// Project includes
+#include "http/websocket.h"
+
+#include "global/event_bus.h"
+#include "global/metrics.h"
+#include "global/sha1.h"
+#include "global/utils.h"
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+#define WS_PRIORITY         (tskIDLE_PRIORITY + 1UL)
+#define WS_STACK            (512UL)
+
+/** Receive buffer, only control frames are expected from the clients */
+#define WS_RX_SIZE          (6U + 125U + 1U)
+
+/** Poll interval in units of the coarse TCP timer (500 ms), i.e. 1 s */
+#define WS_POLL_INTERVAL    (2U)
+
+/** Largest frame header (server frames are not masked) */
+#define WS_HEADER_MAX       (4U)
+
+#define WS_OP_TEXT          (0x1U)
+#define WS_OP_CLOSE         (0x8U)
+#define WS_OP_PING          (0x9U)
+#define WS_OP_PONG          (0xAU)
+#define WS_FIN              (0x80U)
+#define WS_MASK             (0x80U)
+
+/** Close status: message too big */
+#define WS_STATUS_TOO_BIG   (1009U)
+
+#define WS_QUEUE_MASK       (WS_QUEUE_SIZE - 1U)
+
+#if (0U != (WS_QUEUE_SIZE & WS_QUEUE_MASK))
+    #error "WS_QUEUE_SIZE must be a power of 2"
+#endif
+
+/* --- Local type/struct definitions ---------------------------------------- */
+
+/**
+ * @brief Ennumeration of the Notification flags for the WebSocket task
+ */
+typedef enum eWsNotifications_tag
+{
+    WsDataQueued = (1UL << 0U),
+} eWsNotifications_t;
+
+/**
+ * @brief One stream client
+ *
+ * bActive and uHead are only changed inside a critical section. All other
+ * members belong to the lwIP context.
+ */
+typedef struct sWsClient_tag
+{
+    struct tcp_pcb *sPcb;
+    volatile bool bActive;        ///< Producers may queue frames
+    volatile uint32_t uHead;      ///< End of the queued data
+    uint32_t uSent;               ///< End of the data handed to lwIP
+    volatile uint32_t uAcked;     ///< End of the acknowledged data
+    uint32_t uDropped;            ///< Frames dropped since the last notice
+    bool bClosing;                ///< Close once everything is acked
+
+    uint32_t uLastAcked;
+    uint8_t uStallPolls;
+
+    uint8_t uaRx[WS_RX_SIZE];
+    uint16_t uRxLen;
+
+    uint8_t uaQueue[WS_QUEUE_SIZE];
+} sWsClient_t;
+
+typedef struct sWsState_tag
+{
+    sWsClient_t saClient[WS_MAX_CLIENTS];
+    volatile uint8_t uNumClients;
+    TaskHandle_t xTask;
+} sWsState_t;
+
+/* --- Static variables ----------------------------------------------------- */
+
+static const char caWsGuid[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+static const char caWsBase64[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static sWsState_t sWsState;
+
+/** Link state, the task skips the lwIP lock while the link is down */
+static volatile bool bWsLinkUp = false;
+
+static sEventSub_t sWsLinkUpSub;
+static sEventSub_t sWsLinkDownSub;
+
+/* --- Static function prototypes ------------------------------------------- */
+
+/**
+ * @brief EventLinkUp/EventLinkDown: a lost link closes every client
+ *
+ * Runs before the driver is de-initialised, so the lwIP lock is still valid.
+ *
+ * @param eEvent Event
+ * @param uArg   Unused
+ */
+static void vWsOnLink(const eEvent_t eEvent, const uint32_t uArg);
+
+/**
+ * @brief WebSocket task. Hands the queued frames to lwIP.
+ *
+ * @param pvParameters Unused
+ */
+static void vWsTask(void *pvParameters);
+
+/**
+ * @brief Append a frame to the queue of a client. Call in a critical section.
+ *
+ * @param sClient  Client
+ * @param uOpcode  Frame opcode
+ * @param pvData   Payload
+ * @param uLen     Length of the payload
+ *
+ * @return true if the frame was queued
+ */
+static bool bWsQueueFrame(sWsClient_t *const sClient, const uint8_t uOpcode, const void *pvData, const uint16_t uLen);
+
+/**
+ * @brief Append raw data to the queue. Space must have been checked.
+ *
+ * @param sClient  Client
+ * @param pvData   Data
+ * @param uLen     Length of the data
+ */
+static void vWsQueueRaw(sWsClient_t *const sClient, const void *pvData, const uint32_t uLen);
+
+/**
+ * @brief Hand all queued data to lwIP (lwIP context)
+ *
+ * @param sClient Client
+ */
+static void vWsFlush(sWsClient_t *const sClient);
+
+/**
+ * @brief Parse the received control frames (lwIP context)
+ *
+ * @param sClient Client
+ *
+ * @return err_t ERR_ABRT if the connection was aborted
+ */
+static err_t xWsParse(sWsClient_t *const sClient);
+
+/**
+ * @brief lwIP receive callback
+ */
+static err_t xWsRecv(void *pvArg, struct tcp_pcb *sPcb, struct pbuf *sPb, err_t xErr);
+
+/**
+ * @brief lwIP sent callback
+ */
+static err_t xWsSent(void *pvArg, struct tcp_pcb *sPcb, u16_t uLen);
+
+/**
+ * @brief lwIP poll callback, drops stalled clients
+ */
+static err_t xWsPoll(void *pvArg, struct tcp_pcb *sPcb);
+
+/**
+ * @brief lwIP error callback, the pcb is already gone
+ */
+static void vWsErr(void *pvArg, err_t xErr);
+
+/**
+ * @brief Stop the producers and release the connection
+ *
+ * @param sClient Client
+ *
+ * @return err_t ERR_ABRT if the pcb was aborted
+ */
+static err_t xWsClose(sWsClient_t *const sClient);
+
+/**
+ * @brief Mark client as unused (critical section)
+ *
+ * @param sClient Client
+ */
+static void vWsDeactivate(sWsClient_t *const sClient);
+
+/* --- Public functions ----------------------------------------------------- */
+
+eRetVal_t eWsRtosInit(void)
+{
+    eRetVal_t eRetVal = ErrNoError;
+    BaseType_t xReturned;
+
+    xReturned = xTaskCreate(
+                    vWsTask,
+                    "WebSocket",
+                    WS_STACK,
+                    NULL,
+                    WS_PRIORITY,
+                    &sWsState.xTask);
+
+    if (pdPASS != xReturned)
+    {
+        eRetVal = ErrError;
+    }
+    else
+    {
+        vEventSubscribe(&sWsLinkUpSub, EventLinkUp, vWsOnLink, EventOrderFirst);
+        vEventSubscribe(&sWsLinkDownSub, EventLinkDown, vWsOnLink, EventOrderFirst);
+    }
+
+    return (eRetVal);
+}
+
+
+bool bWsUpgrade(struct tcp_pcb *const sPcb, const char *cpHeader)
+{
+    sWsClient_t *sClient = NULL;
+    const char *cpKey = strstr(cpHeader, "ebSocket-Key: ");
+    char caResponse[160];
+    uint8_t uaKey[64];
+    uint8_t uaDigest[20];
+    char caAccept[29];
+    uint32_t uKeyLen = 0U;
+    uint32_t uOut = 0U;
+    uint32_t uTriple;
+    int iLen;
+
+    for (uint32_t i = 0U; i < WS_MAX_CLIENTS; i++)
+    {
+        if (NULL == sWsState.saClient[i].sPcb)
+        {
+            sClient = &sWsState.saClient[i];
+            break;
+        }
+    }
+
+    if ((NULL != sClient) && (NULL != cpKey))
+    {
+        cpKey += 14U;
+        while ((cpKey[uKeyLen] > ' ') && (uKeyLen < 24U))
+        {
+            uKeyLen++;
+        }
+    }
+
+    if (24U == uKeyLen)
+    {
+        // Sec-WebSocket-Accept = base64(sha1(key + GUID))
+        memcpy(uaKey, cpKey, uKeyLen);
+        memcpy(&uaKey[uKeyLen], caWsGuid, sizeof(caWsGuid) - 1U);
+        vSha1(uaKey, uKeyLen + sizeof(caWsGuid) - 1U, uaDigest);
+
+        for (uint32_t i = 0U; i < sizeof(uaDigest); i += 3U)
+        {
+            uTriple = (uint32_t)uaDigest[i] << 16U;
+            uTriple |= (i + 1U < sizeof(uaDigest)) ? ((uint32_t)uaDigest[i + 1U] << 8U) : 0U;
+            uTriple |= (i + 2U < sizeof(uaDigest)) ? (uint32_t)uaDigest[i + 2U] : 0U;
+
+            caAccept[uOut++] = caWsBase64[(uTriple >> 18U) & 0x3FU];
+            caAccept[uOut++] = caWsBase64[(uTriple >> 12U) & 0x3FU];
+            caAccept[uOut++] = (i + 1U < sizeof(uaDigest)) ? caWsBase64[(uTriple >> 6U) & 0x3FU] : '=';
+            caAccept[uOut++] = (i + 2U < sizeof(uaDigest)) ? caWsBase64[uTriple & 0x3FU] : '=';
+        }
+        caAccept[uOut] = '\0';
+
+        iLen = snprintf(
+            caResponse,
+            sizeof(caResponse),
+            "HTTP/1.1 101 Switching Protocols\r\n"
+            "Upgrade: websocket\r\n"
+            "Connection: Upgrade\r\n"
+            "Sec-WebSocket-Accept: %s\r\n"
+            "\r\n",
+            caAccept);
+
+        sClient->sPcb = sPcb;
+        sClient->uDropped = 0U;
+        sClient->bClosing = false;
+        sClient->uLastAcked = 0U;
+        sClient->uStallPolls = 0U;
+        sClient->uRxLen = 0U;
+
+        taskENTER_CRITICAL();
+        sClient->uHead = 0U;
+        sClient->uSent = 0U;
+        sClient->uAcked = 0U;
+        vWsQueueRaw(sClient, caResponse, (uint32_t)iLen);
+        sClient->bActive = true;
+        sWsState.uNumClients++;
+        taskEXIT_CRITICAL();
+
+        tcp_arg(sPcb, sClient);
+        tcp_recv(sPcb, xWsRecv);
+        tcp_sent(sPcb, xWsSent);
+        tcp_err(sPcb, vWsErr);
+        tcp_poll(sPcb, xWsPoll, WS_POLL_INTERVAL);
+
+        vWsFlush(sClient);
+        vMetricsSet(MetricWsClients, sWsState.uNumClients);
+    }
+
+    return (24U == uKeyLen);
+}
+
+
+void vWsPublish(const eWsFrame_t eType, const void *pvData, const uint16_t uLen)
+{
+    sWsClient_t *sClient;
+    uint32_t uDropped = 0U;
+    bool bQueued = false;
+
+    // Fast path, also keeps the function usable before the scheduler runs
+    if (0U != sWsState.uNumClients)
+    {
+        for (uint32_t i = 0U; i < WS_MAX_CLIENTS; i++)
+        {
+            sClient = &sWsState.saClient[i];
+
+            taskENTER_CRITICAL();
+            if (sClient->bActive)
+            {
+                if (bWsQueueFrame(sClient, (uint8_t)eType, pvData, uLen))
+                {
+                    bQueued = true;
+                }
+                else
+                {
+                    uDropped++;
+                }
+            }
+            taskEXIT_CRITICAL();
+        }
+
+        if (bQueued)
+        {
+            xTaskNotify(sWsState.xTask, WsDataQueued, eSetBits);
+        }
+
+        if (0U != uDropped)
+        {
+            vMetricsAdd(MetricWsDropped, uDropped);
+        }
+    }
+}
+
+/* --- Static functions ----------------------------------------------------- */
+
+static void vWsOnLink(const eEvent_t eEvent, const uint32_t uArg)
+{
+    (void)uArg; // Silence 'unused parameters'
+
+    bWsLinkUp = (EventLinkUp == eEvent);
+
+    if (!bWsLinkUp)
+    {
+        // No tcp_err follows once the driver is gone: stop the producers,
+        // drop the rings and free the slots now
+        cyw43_arch_lwip_begin();
+        for (uint32_t i = 0U; i < WS_MAX_CLIENTS; i++)
+        {
+            if (NULL != sWsState.saClient[i].sPcb)
+            {
+                (void)xWsClose(&sWsState.saClient[i]);
+            }
+        }
+        cyw43_arch_lwip_end();
+    }
+}
+
+
+static void vWsTask(void *pvParameters)
+{
+    (void)pvParameters; // Silence 'unused parameters'
+
+    uint32_t uNotifyVector = 0UL;
+
+    while (1)
+    {
+        xTaskNotifyWait(0UL, UINT32_MAX, &uNotifyVector, portMAX_DELAY);
+
+        if (TEST_PAT(uNotifyVector, WsDataQueued))
+        {
+            // Let more frames arrive, they end up in the same segment
+            vTaskDelay(pdMS_TO_TICKS(WS_COALESCE_MS));
+
+            // Without a link the clients are closed, the lock may be invalid
+            if (bWsLinkUp)
+            {
+                cyw43_arch_lwip_begin();
+                for (uint32_t i = 0U; i < WS_MAX_CLIENTS; i++)
+                {
+                    if (NULL != sWsState.saClient[i].sPcb)
+                    {
+                        vWsFlush(&sWsState.saClient[i]);
+                    }
+                }
+                cyw43_arch_lwip_end();
+            }
+        }
+    }
+}
+
+
+static bool bWsQueueFrame(sWsClient_t *const sClient, const uint8_t uOpcode, const void *pvData, const uint16_t uLen)
+{
+    char caNotice[48];            // 19 + up to 10 digits + 13
+    uint8_t uaHeader[WS_HEADER_MAX];
+    uint32_t uHeaderLen = 2U;
+    uint32_t uNoticeLen = 0U;
+    uint32_t uFree = WS_QUEUE_SIZE - (sClient->uHead - sClient->uAcked);
+    uint32_t uNum = sClient->uDropped;
+    uint32_t uDigits = 0U;
+    bool bQueued = false;
+
+    if (0U != uNum)
+    {
+        // The notice is a text frame of its own, built without printf
+        memcpy(caNotice, "\e[0;33m-W- stream: ", 19U);
+        uNoticeLen = 19U;
+        do
+        {
+            uDigits++;
+            uNum /= 10U;
+        } while (0U != uNum);
+
+        uNum = sClient->uDropped;
+        for (uint32_t i = uDigits; i > 0U; i--)
+        {
+            caNotice[uNoticeLen + i - 1U] = (char)('0' + (uNum % 10U));
+            uNum /= 10U;
+        }
+        uNoticeLen += uDigits;
+        memcpy(&caNotice[uNoticeLen], " dropped\e[0m\n", 13U);
+        uNoticeLen += 13U;
+    }
+
+    if (uLen >= 126U)
+    {
+        uHeaderLen = 4U;
+    }
+
+    if ((2U + uNoticeLen + uHeaderLen + uLen) <= uFree)
+    {
+        if (0U != uNoticeLen)
+        {
+            uaHeader[0] = WS_FIN | WS_OP_TEXT;
+            uaHeader[1] = (uint8_t)uNoticeLen;
+            vWsQueueRaw(sClient, uaHeader, 2U);
+            vWsQueueRaw(sClient, caNotice, uNoticeLen);
+            sClient->uDropped = 0U;
+        }
+
+        uaHeader[0] = WS_FIN | uOpcode;
+        if (uLen < 126U)
+        {
+            uaHeader[1] = (uint8_t)uLen;
+        }
+        else
+        {
+            uaHeader[1] = 126U;
+            uaHeader[2] = (uint8_t)(uLen >> 8U);
+            uaHeader[3] = (uint8_t)uLen;
+        }
+
+        vWsQueueRaw(sClient, uaHeader, uHeaderLen);
+        vWsQueueRaw(sClient, pvData, uLen);
+        bQueued = true;
+    }
+    else
+    {
+        sClient->uDropped++;
+    }
+
+    return (bQueued);
+}
+
+
+static void vWsQueueRaw(sWsClient_t *const sClient, const void *pvData, const uint32_t uLen)
+{
+    const uint32_t uOffset = sClient->uHead & WS_QUEUE_MASK;
+    const uint32_t uFirst = ((WS_QUEUE_SIZE - uOffset) < uLen) ? (WS_QUEUE_SIZE - uOffset) : uLen;
+
+    memcpy(&sClient->uaQueue[uOffset], pvData, uFirst);
+    memcpy(sClient->uaQueue, (const uint8_t *)pvData + uFirst, uLen - uFirst);
+
+    // Data must be complete before the other core sees the new head
+    __dmb();
+    sClient->uHead += uLen;
+}
+
+
+static void vWsFlush(sWsClient_t *const sClient)
+{
+    const uint32_t uHead = sClient->uHead;
+    uint32_t uOffset;
+    uint32_t uChunk;
+    bool bWritten = false;
+    err_t xErr = ERR_OK;
+
+    while ((uHead != sClient->uSent) && (ERR_OK == xErr))
+    {
+        uOffset = sClient->uSent & WS_QUEUE_MASK;
+        uChunk = uHead - sClient->uSent;
+
+        if (uChunk > (WS_QUEUE_SIZE - uOffset))
+        {
+            uChunk = WS_QUEUE_SIZE - uOffset;
+        }
+
+        if (uChunk > tcp_sndbuf(sClient->sPcb))
+        {
+            uChunk = tcp_sndbuf(sClient->sPcb);
+        }
+
+        // No TCP_WRITE_FLAG_COPY: the ring is freed once the data is acked
+        xErr = (0U == uChunk) ? ERR_MEM : tcp_write(
+            sClient->sPcb,
+            &sClient->uaQueue[uOffset],
+            (u16_t)uChunk,
+            ((sClient->uSent + uChunk) != uHead) ? TCP_WRITE_FLAG_MORE : 0U);
+
+        if (ERR_OK == xErr)
+        {
+            sClient->uSent += uChunk;
+            bWritten = true;
+        }
+    }
+
+    if (bWritten)
+    {
+        tcp_output(sClient->sPcb);
+    }
+}
+
+
+static err_t xWsParse(sWsClient_t *const sClient)
+{
+    err_t xRetVal = ERR_OK;
+    uint8_t uaStatus[2];
+    uint8_t *pPayload;
+    uint32_t uHeaderLen;
+    uint32_t uPayloadLen;
+    uint8_t uOpcode;
+    bool bQueued = false;
+    bool bDone = false;
+
+    while ((!bDone) && (sClient->uRxLen >= 2U))
+    {
+        uOpcode = sClient->uaRx[0] & 0x0FU;
+        uPayloadLen = sClient->uaRx[1] & 0x7FU;
+        uHeaderLen = (0U != (sClient->uaRx[1] & WS_MASK)) ? 6U : 2U;
+
+        if (uPayloadLen >= 126U)
+        {
+            // Only short control frames are expected
+            uaStatus[0] = (uint8_t)(WS_STATUS_TOO_BIG >> 8U);
+            uaStatus[1] = (uint8_t)WS_STATUS_TOO_BIG;
+            uOpcode = WS_OP_CLOSE;
+            pPayload = uaStatus;
+            uPayloadLen = sizeof(uaStatus);
+            sClient->uRxLen = 0U;
+        }
+        else if (sClient->uRxLen < (uHeaderLen + uPayloadLen))
+        {
+            bDone = true;
+        }
+        else
+        {
+            pPayload = &sClient->uaRx[uHeaderLen];
+
+            if (6U == uHeaderLen)
+            {
+                for (uint32_t i = 0U; i < uPayloadLen; i++)
+                {
+                    pPayload[i] ^= sClient->uaRx[2U + (i & 3U)];
+                }
+            }
+        }
+
+        if (!bDone)
+        {
+            if ((WS_OP_PING == uOpcode) || (WS_OP_CLOSE == uOpcode))
+            {
+                taskENTER_CRITICAL();
+                if (sClient->bActive)
+                {
+                    // Echo close, answer ping with pong
+                    bQueued |= bWsQueueFrame(
+                        sClient,
+                        (WS_OP_PING == uOpcode) ? WS_OP_PONG : WS_OP_CLOSE,
+                        pPayload,
+                        (uint16_t)uPayloadLen);
+                }
+                taskEXIT_CRITICAL();
+            }
+
+            if (WS_OP_CLOSE == uOpcode)
+            {
+                vWsDeactivate(sClient);
+                sClient->bClosing = true;
+                sClient->uRxLen = 0U;
+                bDone = true;
+            }
+            else if (0U != sClient->uRxLen)
+            {
+                sClient->uRxLen -= (uint16_t)(uHeaderLen + uPayloadLen);
+                memmove(sClient->uaRx, &sClient->uaRx[uHeaderLen + uPayloadLen], sClient->uRxLen);
+            }
+        }
+    }
+
+    if (bQueued)
+    {
+        vWsFlush(sClient);
+    }
+
+    if (sClient->bClosing && (sClient->uAcked == sClient->uHead))
+    {
+        xRetVal = xWsClose(sClient);
+    }
+
+    return (xRetVal);
+}
+
+
+static err_t xWsRecv(void *pvArg, struct tcp_pcb *sPcb, struct pbuf *sPb, err_t xErr)
+{
+    sWsClient_t *const sClient = (sWsClient_t *)pvArg;
+    err_t xRetVal = ERR_OK;
+    uint16_t uCopy;
+
+    (void)xErr;
+
+    if (NULL == sPb)
+    {
+        xRetVal = xWsClose(sClient);
+    }
+    else
+    {
+        uCopy = WS_RX_SIZE - sClient->uRxLen;
+        if (uCopy > sPb->tot_len)
+        {
+            uCopy = sPb->tot_len;
+        }
+
+        pbuf_copy_partial(sPb, &sClient->uaRx[sClient->uRxLen], uCopy, 0U);
+        sClient->uRxLen += uCopy;
+
+        tcp_recved(sPcb, sPb->tot_len);
+        pbuf_free(sPb);
+
+        xRetVal = xWsParse(sClient);
+    }
+
+    return (xRetVal);
+}
+
+
+static err_t xWsSent(void *pvArg, struct tcp_pcb *sPcb, u16_t uLen)
+{
+    sWsClient_t *const sClient = (sWsClient_t *)pvArg;
+    err_t xRetVal = ERR_OK;
+
+    (void)sPcb;
+
+    sClient->uAcked += uLen;
+
+    if (sClient->bClosing)
+    {
+        if (sClient->uAcked == sClient->uHead)
+        {
+            xRetVal = xWsClose(sClient);
+        }
+        else
+        {
+            vWsFlush(sClient);
+        }
+    }
+    else
+    {
+        vWsFlush(sClient);
+    }
+
+    return (xRetVal);
+}
+
+
+static err_t xWsPoll(void *pvArg, struct tcp_pcb *sPcb)
+{
+    sWsClient_t *const sClient = (sWsClient_t *)pvArg;
+    err_t xRetVal = ERR_OK;
+
+    (void)sPcb;
+
+    if ((sClient->uAcked == sClient->uLastAcked) && (sClient->uAcked != sClient->uHead))
+    {
+        sClient->uStallPolls++;
+    }
+    else
+    {
+        sClient->uStallPolls = 0U;
+    }
+    sClient->uLastAcked = sClient->uAcked;
+
+    if (sClient->uStallPolls > WS_STALL_SEC)
+    {
+        vMetricsInc(MetricWsStalled);
+        xRetVal = xWsClose(sClient);
+    }
+    else
+    {
+        // Retry if tcp_write failed due to missing memory
+        vWsFlush(sClient);
+    }
+
+    return (xRetVal);
+}
+
+
+static void vWsErr(void *pvArg, err_t xErr)
+{
+    sWsClient_t *const sClient = (sWsClient_t *)pvArg;
+
+    (void)xErr;
+
+    if (NULL != sClient)
+    {
+        vWsDeactivate(sClient);
+        sClient->sPcb = NULL;
+    }
+}
+
+
+static err_t xWsClose(sWsClient_t *const sClient)
+{
+    err_t xRetVal = ERR_OK;
+    struct tcp_pcb *const sPcb = sClient->sPcb;
+
+    vWsDeactivate(sClient);
+
+    tcp_arg(sPcb, NULL);
+    tcp_recv(sPcb, NULL);
+    tcp_sent(sPcb, NULL);
+    tcp_err(sPcb, NULL);
+    tcp_poll(sPcb, NULL, 0U);
+
+    // Segments still referencing the ring must be gone before it is reused
+    if ((sClient->uSent != sClient->uAcked) || (ERR_OK != tcp_close(sPcb)))
+    {
+        tcp_abort(sPcb);
+        xRetVal = ERR_ABRT;
+    }
+
+    sClient->sPcb = NULL;
+
+    return (xRetVal);
+}
+
+
+static void vWsDeactivate(sWsClient_t *const sClient)
+{
+    bool bWasActive;
+
+    taskENTER_CRITICAL();
+    bWasActive = sClient->bActive;
+    if (bWasActive)
+    {
+        sClient->bActive = false;
+        sWsState.uNumClients--;
+    }
+    taskEXIT_CRITICAL();
+
+    if (bWasActive)
+    {
+        vMetricsSet(MetricWsClients, sWsState.uNumClients);
+    }
+}
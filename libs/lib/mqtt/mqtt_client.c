@@ -0,0 +1,775 @@
+/** ****************************************************************************
+ * @file   mqtt_client.c
+ *
+ * @author Michael R.
+ *
+ * @brief  MQTT 3.1.1 publish client
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <string.h>
+
+// pico-sdk includes
+// FreeRTOS includes
+#include "FreeRTOS.h" /* Must come first. */
+#include "task.h"
+#include "queue.h"
+
+// Project includes
+#include "mqtt/mqtt_client.h"
+
+#include "global/debug_print.h"
+#include "global/event_bus.h"
+#include "global/metrics.h"
+#include "global/utils.h"
+#include "wlan/tcp_udp.h"
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+#define MQTT_PRIORITY       (tskIDLE_PRIORITY + 2UL)
+#define MQTT_STACK          (512UL * 2U)
+
+/** Batch buffer, one TCP segment */
+#define MQTT_TX_SIZE        (1460U)
+#define MQTT_RX_SIZE        (128U)
+
+/** Largest encoded PUBLISH packet */
+#define MQTT_MAX_PACKET     (5U + 2U + MQTT_MAX_TOPIC + 2U + MQTT_MAX_PAYLOAD)
+
+/** Longest wait in the socket while connected, also the latest a new
+ *  publish is picked up */
+#define MQTT_RECV_MS        (100UL)
+#define MQTT_CONNACK_MS     (5000UL)
+
+#define MQTT_BACKOFF_MIN_MS (1000UL)
+#define MQTT_BACKOFF_MAX_MS (60UL * 1000UL)
+
+#define MQTT_CONNECT     (0x10U)
+#define MQTT_CONNACK     (0x20U)
+#define MQTT_PUBLISH     (0x30U)
+#define MQTT_PUBACK      (0x40U)
+#define MQTT_PINGREQ     (0xC0U)
+#define MQTT_PINGRESP    (0xD0U)
+#define MQTT_DISCONNECT  (0xE0U)
+
+#define MQTT_FLAG_DUP    (0x08U)
+
+/* --- Local type/struct definitions ---------------------------------------- */
+
+/**
+ * @brief Ennumeration of the Notification flags for the MQTT task
+ */
+typedef enum eMqttNotifications_tag
+{
+    MqttLinkUp      = (1UL << 0U),
+    MqttLinkDown    = (1UL << 1U),
+    MqttMsgQueued   = (1UL << 2U),
+} eMqttNotifications_t;
+
+typedef struct sMqttMsg_tag
+{
+    char caTopic[MQTT_MAX_TOPIC];
+    uint8_t uaPayload[MQTT_MAX_PAYLOAD];
+    uint16_t uLen;
+    uint16_t uPacketId;
+    eMqttQos_t eQos;
+    bool bSent;
+} sMqttMsg_t;
+
+typedef struct sMqttState_tag
+{
+    sMqttMsg_t saMsg[MQTT_QUEUE_LEN];
+    QueueHandle_t xFreeQueue;       ///< Indices of unused messages
+    QueueHandle_t xPendingQueue;    ///< Indices of messages to be sent
+
+    uint8_t uaInflight[MQTT_INFLIGHT_MAX];
+    uint8_t uNumInflight;
+    uint8_t uaWaiting[MQTT_QUEUE_LEN];  ///< QoS1 held back by the full window, in order
+    uint8_t uNumWaiting;
+    uint16_t uNextPacketId;
+
+    sTcpUdpConn_t sConn;
+    bool bLinkUp;
+    bool bConnected;
+    bool bRefused;                  ///< CONNACK with a return code
+    uint32_t uBackoffMs;
+    TickType_t xNextConnect;
+    TickType_t xLastTx;
+    TickType_t xPingSent;
+    bool bPingPending;
+
+    uint8_t uaTx[MQTT_TX_SIZE];
+    uint16_t uTxLen;
+    uint8_t uaRx[MQTT_RX_SIZE];
+    uint16_t uRxLen;
+
+    TaskHandle_t xTask;
+} sMqttState_t;
+
+/* --- Static variables ----------------------------------------------------- */
+
+static sMqttState_t sMqttState;
+
+static sEventSub_t sMqttLinkUpSub;
+static sEventSub_t sMqttLinkDownSub;
+
+/* --- Static function prototypes ------------------------------------------- */
+
+/**
+ * @brief MQTT client task
+ *
+ * @param pvParameters Unused
+ */
+static void vMqttTask(void *pvParameters);
+
+/**
+ * @brief Open the TCP connection and do the CONNECT/CONNACK handshake
+ *
+ * @return eRetVal_t Returns success/error
+ */
+static eRetVal_t eMqttConnect(void);
+
+/**
+ * @brief Close the connection and schedule the next attempt
+ */
+static void vMqttDisconnect(void);
+
+/**
+ * @brief Encode pending messages into the batch buffer and send it
+ *
+ * @return eRetVal_t ErrError if the connection failed
+ */
+static eRetVal_t eMqttFlush(void);
+
+/**
+ * @brief Add a message taken from the queue to the batch buffer
+ *
+ * QoS1 messages get a packet id and go into the window, QoS0 slots are free
+ * again right away.
+ *
+ * @param uIndex Index of the message
+ */
+static void vMqttAddPublish(const uint8_t uIndex);
+
+/**
+ * @brief Append a PUBLISH packet for a message to the batch buffer
+ *
+ * @param sMsg Message
+ */
+static void vMqttEncodePublish(sMqttMsg_t *const sMsg);
+
+/**
+ * @brief Send the batch buffer
+ *
+ * @return eRetVal_t ErrError if the connection failed
+ */
+static eRetVal_t eMqttSendTx(void);
+
+/**
+ * @brief Read and process packets from the broker
+ *
+ * @param uTimeoutMs Maximum wait time for data
+ *
+ * @return eRetVal_t ErrError if the connection failed
+ */
+static eRetVal_t eMqttReceive(const uint32_t uTimeoutMs);
+
+/**
+ * @brief Handle a single complete packet
+ *
+ * @param uType    Packet type (upper nibble of the fixed header)
+ * @param pData    Variable header and payload
+ * @param uLen     Remaining length
+ */
+static void vMqttHandlePacket(const uint8_t uType, const uint8_t *pData, const uint32_t uLen);
+
+/**
+ * @brief Write the MQTT remaining length
+ *
+ * @param pBuffer  Target (at least 4 bytes)
+ * @param uLen     Length to encode
+ *
+ * @return Number of bytes written
+ */
+static uint8_t uMqttEncodeLength(uint8_t *const pBuffer, uint32_t uLen);
+
+/* --- Public functions ----------------------------------------------------- */
+
+eRetVal_t eMqttRtosInit(void)
+{
+    eRetVal_t eRetVal = ErrNoError;
+    BaseType_t xReturned;
+
+    DBG_PR(DBG_INFO, FN_MQTT, "\n");
+
+    sMqttState.sConn.iSocket = -1;
+    sMqttState.uBackoffMs = MQTT_BACKOFF_MIN_MS;
+    sMqttState.uNextPacketId = 1U;
+
+    sMqttState.xFreeQueue = xQueueCreate(MQTT_QUEUE_LEN, sizeof(uint8_t));
+    sMqttState.xPendingQueue = xQueueCreate(MQTT_QUEUE_LEN, sizeof(uint8_t));
+
+    if ((NULL == sMqttState.xFreeQueue) || (NULL == sMqttState.xPendingQueue))
+    {
+        eRetVal = ErrError;
+    }
+    else
+    {
+        for (uint8_t i = 0U; i < MQTT_QUEUE_LEN; i++)
+        {
+            xQueueSend(sMqttState.xFreeQueue, &i, 0);
+        }
+
+        xReturned = xTaskCreate(
+                        vMqttTask,
+                        "MQTT",
+                        MQTT_STACK,
+                        NULL,
+                        MQTT_PRIORITY,
+                        &sMqttState.xTask);
+
+        if (pdPASS != xReturned)
+        {
+            eRetVal = ErrError;
+        }
+        else
+        {
+            vEventSubscribeTask(&sMqttLinkUpSub, EventLinkUp, sMqttState.xTask, MqttLinkUp);
+            vEventSubscribeTask(&sMqttLinkDownSub, EventLinkDown, sMqttState.xTask, MqttLinkDown);
+        }
+    }
+
+    return (eRetVal);
+}
+
+
+eRetVal_t eMqttPublish(
+    const char *cpTopic,
+    const uint8_t *pPayload,
+    const uint16_t uLen,
+    const eMqttQos_t eQos)
+{
+    eRetVal_t eRetVal = ErrNoError;
+    const size_t uTopicLen = strnlen(cpTopic, MQTT_MAX_TOPIC);
+    sMqttMsg_t *sMsg;
+    uint8_t uIndex;
+
+    if ((uTopicLen >= MQTT_MAX_TOPIC) || (uLen > MQTT_MAX_PAYLOAD) ||
+        (NULL == sMqttState.xFreeQueue))
+    {
+        eRetVal = ErrError;
+    }
+    else if (pdTRUE != xQueueReceive(sMqttState.xFreeQueue, &uIndex, 0))
+    {
+        vMetricsInc(MetricMqttDropped);
+        eRetVal = ErrError;
+    }
+    else
+    {
+        sMsg = &sMqttState.saMsg[uIndex];
+
+        memcpy(sMsg->caTopic, cpTopic, uTopicLen + 1U);
+        memcpy(sMsg->uaPayload, pPayload, uLen);
+        sMsg->uLen = uLen;
+        sMsg->eQos = eQos;
+        sMsg->uPacketId = 0U;
+        sMsg->bSent = false;
+
+        xQueueSend(sMqttState.xPendingQueue, &uIndex, 0);
+        xTaskNotify(sMqttState.xTask, MqttMsgQueued, eSetBits);
+    }
+
+    return (eRetVal);
+}
+
+/* --- Static functions ----------------------------------------------------- */
+
+static void vMqttTask(void *pvParameters)
+{
+    (void)pvParameters; // Silence 'unused parameters'
+
+    uint32_t uNotifyVector = 0UL;
+    TickType_t xWait = portMAX_DELAY;
+    TickType_t xNow;
+    eRetVal_t eRetVal;
+
+    while (1)
+    {
+        xTaskNotifyWait(0UL, UINT32_MAX, &uNotifyVector, xWait);
+        xNow = xTaskGetTickCount();
+
+        if (TEST_PAT(uNotifyVector, MqttLinkDown))
+        {
+            sMqttState.bLinkUp = false;
+            if (sMqttState.bConnected)
+            {
+                vMqttDisconnect();
+            }
+        }
+
+        if (TEST_PAT(uNotifyVector, MqttLinkUp))
+        {
+            sMqttState.bLinkUp = true;
+            sMqttState.uBackoffMs = MQTT_BACKOFF_MIN_MS;
+            sMqttState.xNextConnect = xNow;
+        }
+
+        if (!sMqttState.bConnected && sMqttState.bLinkUp &&
+            ((TickType_t)(xNow - sMqttState.xNextConnect) < (portMAX_DELAY / 2U)))
+        {
+            vMetricsInc(MetricMqttConnects);
+
+            if (IS_NO_ERR(eMqttConnect()))
+            {
+                DBG_PR(DBG_INFO, FN_MQTT, "Connected to %s\n", MQTT_BROKER_HOST);
+                sMqttState.bConnected = true;
+                sMqttState.uBackoffMs = MQTT_BACKOFF_MIN_MS;
+            }
+            else
+            {
+                vMqttDisconnect();
+            }
+        }
+
+        if (sMqttState.bConnected)
+        {
+            eRetVal = eMqttFlush();
+
+            if (IS_NO_ERR(eRetVal))
+            {
+                // Sleeps in the socket until the broker sends something
+                eRetVal = eMqttReceive(MQTT_RECV_MS);
+            }
+
+            // Keep-alive: ping after 3/4 of the interval without traffic
+            xNow = xTaskGetTickCount();
+            if (IS_NO_ERR(eRetVal) && !sMqttState.bPingPending &&
+                ((xNow - sMqttState.xLastTx) > pdMS_TO_TICKS(MQTT_KEEPALIVE_S * 750UL)))
+            {
+                sMqttState.uaTx[sMqttState.uTxLen++] = MQTT_PINGREQ;
+                sMqttState.uaTx[sMqttState.uTxLen++] = 0U;
+                sMqttState.bPingPending = true;
+                sMqttState.xPingSent = xNow;
+                eRetVal = eMqttSendTx();
+            }
+
+            if (sMqttState.bPingPending &&
+                ((xNow - sMqttState.xPingSent) > pdMS_TO_TICKS(MQTT_KEEPALIVE_S * 1000UL)))
+            {
+                DBG_PR(DBG_WARN, FN_MQTT, "Broker does not answer\n");
+                eRetVal = ErrError;
+            }
+
+            if (IS_ERR(eRetVal))
+            {
+                vMqttDisconnect();
+            }
+        }
+
+        // Connected the task waits in the socket, only collect the events
+        if (sMqttState.bConnected)
+        {
+            xWait = 0U;
+        }
+        else if (sMqttState.bLinkUp)
+        {
+            xWait = sMqttState.xNextConnect - xTaskGetTickCount();
+            if (xWait > pdMS_TO_TICKS(MQTT_BACKOFF_MAX_MS))
+            {
+                xWait = 0U;
+            }
+        }
+        else
+        {
+            xWait = portMAX_DELAY;
+        }
+    }
+}
+
+
+static eRetVal_t eMqttConnect(void)
+{
+    eRetVal_t eRetVal;
+    const uint16_t uIdLen = (uint16_t)strlen(MQTT_CLIENT_ID);
+    uint8_t *const pTx = sMqttState.uaTx;
+    uint16_t uPos = 0U;
+    TickType_t xStart;
+
+    sMqttState.uTxLen = 0U;
+    sMqttState.uRxLen = 0U;
+    sMqttState.bPingPending = false;
+    sMqttState.bRefused = false;
+
+#if MQTT_USE_TLS
+    eRetVal = eTcpUdpConnectTls(&sMqttState.sConn, MQTT_BROKER_HOST, MQTT_BROKER_PORT);
+#else
+    eRetVal = eTcpUdpConnect(&sMqttState.sConn, MQTT_BROKER_HOST, MQTT_BROKER_PORT);
+#endif
+
+    if (IS_NO_ERR(eRetVal))
+    {
+        pTx[uPos++] = MQTT_CONNECT;
+        uPos += uMqttEncodeLength(&pTx[uPos], 10U + 2U + uIdLen);
+        pTx[uPos++] = 0U;
+        pTx[uPos++] = 4U;
+        memcpy(&pTx[uPos], "MQTT", 4U);
+        uPos += 4U;
+        pTx[uPos++] = 4U;       // Protocol level 3.1.1
+        pTx[uPos++] = 0x00U;    // Keep the session: unacked QoS1 are sent again
+        pTx[uPos++] = (uint8_t)(MQTT_KEEPALIVE_S >> 8U);
+        pTx[uPos++] = (uint8_t)(MQTT_KEEPALIVE_S & 0xFFU);
+        pTx[uPos++] = (uint8_t)(uIdLen >> 8U);
+        pTx[uPos++] = (uint8_t)(uIdLen & 0xFFU);
+        memcpy(&pTx[uPos], MQTT_CLIENT_ID, uIdLen);
+        uPos += uIdLen;
+
+        sMqttState.uTxLen = uPos;
+        eRetVal = eMqttSendTx();
+    }
+
+    // bConnected or bRefused is set by the CONNACK
+    xStart = xTaskGetTickCount();
+    while (IS_NO_ERR(eRetVal) && !sMqttState.bConnected)
+    {
+        eRetVal = eMqttReceive(MQTT_RECV_MS);
+
+        if (sMqttState.bRefused ||
+            ((xTaskGetTickCount() - xStart) > pdMS_TO_TICKS(MQTT_CONNACK_MS)))
+        {
+            eRetVal = ErrError;
+        }
+    }
+
+    if (IS_NO_ERR(eRetVal))
+    {
+        // Messages not acknowledged before the disconnect are sent again,
+        // with DUP and the same packet id into the kept session
+        for (uint8_t i = 0U; i < sMqttState.uNumInflight; i++)
+        {
+            vMqttEncodePublish(&sMqttState.saMsg[sMqttState.uaInflight[i]]);
+
+            if ((MQTT_TX_SIZE - sMqttState.uTxLen) < MQTT_MAX_PACKET)
+            {
+                eRetVal = eMqttSendTx();
+            }
+        }
+
+        if (IS_NO_ERR(eRetVal))
+        {
+            eRetVal = eMqttSendTx();
+        }
+    }
+
+    return (eRetVal);
+}
+
+
+static void vMqttDisconnect(void)
+{
+    if (sMqttState.bConnected)
+    {
+        DBG_PR(DBG_WARN, FN_MQTT, "Disconnected\n");
+    }
+
+    vTcpUdpDisconnect(&sMqttState.sConn);
+    sMqttState.bConnected = false;
+
+    sMqttState.xNextConnect = xTaskGetTickCount() + pdMS_TO_TICKS(sMqttState.uBackoffMs);
+    sMqttState.uBackoffMs *= 2U;
+    if (sMqttState.uBackoffMs > MQTT_BACKOFF_MAX_MS)
+    {
+        sMqttState.uBackoffMs = MQTT_BACKOFF_MAX_MS;
+    }
+}
+
+
+static eRetVal_t eMqttFlush(void)
+{
+    eRetVal_t eRetVal = ErrNoError;
+    sMqttMsg_t *sMsg;
+    uint8_t uIndex;
+
+    // QoS1 held back by the full window first, keeps their order
+    while (IS_NO_ERR(eRetVal) &&
+           (0U != sMqttState.uNumWaiting) &&
+           (sMqttState.uNumInflight < MQTT_INFLIGHT_MAX))
+    {
+        if ((MQTT_TX_SIZE - sMqttState.uTxLen) < MQTT_MAX_PACKET)
+        {
+            eRetVal = eMqttSendTx();
+        }
+
+        if (IS_NO_ERR(eRetVal))
+        {
+            uIndex = sMqttState.uaWaiting[0];
+            sMqttState.uNumWaiting--;
+            memmove(&sMqttState.uaWaiting[0], &sMqttState.uaWaiting[1], sMqttState.uNumWaiting);
+            vMqttAddPublish(uIndex);
+        }
+    }
+
+    while (IS_NO_ERR(eRetVal) &&
+           (pdTRUE == xQueuePeek(sMqttState.xPendingQueue, &uIndex, 0)))
+    {
+        sMsg = &sMqttState.saMsg[uIndex];
+
+        if ((MqttQos1 == sMsg->eQos) &&
+            ((0U != sMqttState.uNumWaiting) || (sMqttState.uNumInflight >= MQTT_INFLIGHT_MAX)))
+        {
+            // Window full: wait for PUBACKs, QoS0 behind it goes on
+            xQueueReceive(sMqttState.xPendingQueue, &uIndex, 0);
+            sMqttState.uaWaiting[sMqttState.uNumWaiting++] = uIndex;
+        }
+        else
+        {
+            if ((MQTT_TX_SIZE - sMqttState.uTxLen) < MQTT_MAX_PACKET)
+            {
+                eRetVal = eMqttSendTx();
+            }
+
+            if (IS_NO_ERR(eRetVal))
+            {
+                xQueueReceive(sMqttState.xPendingQueue, &uIndex, 0);
+                vMqttAddPublish(uIndex);
+            }
+        }
+    }
+
+    if (IS_NO_ERR(eRetVal))
+    {
+        eRetVal = eMqttSendTx();
+    }
+
+    return (eRetVal);
+}
+
+
+static void vMqttAddPublish(const uint8_t uIndex)
+{
+    sMqttMsg_t *const sMsg = &sMqttState.saMsg[uIndex];
+
+    if (MqttQos1 == sMsg->eQos)
+    {
+        sMsg->uPacketId = sMqttState.uNextPacketId++;
+        if (0U == sMqttState.uNextPacketId)
+        {
+            sMqttState.uNextPacketId = 1U;
+        }
+
+        sMqttState.uaInflight[sMqttState.uNumInflight++] = uIndex;
+        vMqttEncodePublish(sMsg);
+    }
+    else
+    {
+        // QoS0 is copied into the batch, the slot is free again
+        vMqttEncodePublish(sMsg);
+        xQueueSend(sMqttState.xFreeQueue, &uIndex, 0);
+    }
+
+    vMetricsInc(MetricMqttPublishes);
+}
+
+
+static void vMqttEncodePublish(sMqttMsg_t *const sMsg)
+{
+    uint8_t *const pTx = &sMqttState.uaTx[sMqttState.uTxLen];
+    const uint16_t uTopicLen = (uint16_t)strlen(sMsg->caTopic);
+    uint32_t uRemaining = 2U + uTopicLen + sMsg->uLen;
+    uint16_t uPos = 0U;
+
+    if (MqttQos1 == sMsg->eQos)
+    {
+        uRemaining += 2U;
+    }
+
+    pTx[uPos++] = MQTT_PUBLISH | ((uint8_t)sMsg->eQos << 1U) |
+                  (sMsg->bSent ? MQTT_FLAG_DUP : 0U);
+    uPos += uMqttEncodeLength(&pTx[uPos], uRemaining);
+    pTx[uPos++] = (uint8_t)(uTopicLen >> 8U);
+    pTx[uPos++] = (uint8_t)(uTopicLen & 0xFFU);
+    memcpy(&pTx[uPos], sMsg->caTopic, uTopicLen);
+    uPos += uTopicLen;
+
+    if (MqttQos1 == sMsg->eQos)
+    {
+        pTx[uPos++] = (uint8_t)(sMsg->uPacketId >> 8U);
+        pTx[uPos++] = (uint8_t)(sMsg->uPacketId & 0xFFU);
+    }
+
+    memcpy(&pTx[uPos], sMsg->uaPayload, sMsg->uLen);
+    uPos += sMsg->uLen;
+
+    sMsg->bSent = true;
+    sMqttState.uTxLen += uPos;
+}
+
+
+static eRetVal_t eMqttSendTx(void)
+{
+    eRetVal_t eRetVal = ErrNoError;
+
+    if (0U != sMqttState.uTxLen)
+    {
+        eRetVal = eTcpUdpWrite(&sMqttState.sConn, sMqttState.uaTx, sMqttState.uTxLen);
+        sMqttState.uTxLen = 0U;
+        sMqttState.xLastTx = xTaskGetTickCount();
+    }
+
+    return (eRetVal);
+}
+
+
+static eRetVal_t eMqttReceive(const uint32_t uTimeoutMs)
+{
+    eRetVal_t eRetVal = ErrNoError;
+    int32_t iLen;
+    uint32_t uPos;
+    uint32_t uRemaining;
+    uint32_t uMultiplier;
+    uint32_t uHeaderLen;
+    bool bComplete;
+
+    iLen = iTcpUdpRead(
+        &sMqttState.sConn,
+        &sMqttState.uaRx[sMqttState.uRxLen],
+        MQTT_RX_SIZE - sMqttState.uRxLen,
+        uTimeoutMs);
+
+    if (iLen < 0)
+    {
+        eRetVal = ErrError;
+    }
+    else
+    {
+        sMqttState.uRxLen += (uint16_t)iLen;
+    }
+
+    // Process all complete packets in the buffer
+    do
+    {
+        bComplete = false;
+
+        if (IS_NO_ERR(eRetVal) && (sMqttState.uRxLen >= 2U))
+        {
+            uPos = 1U;
+            uRemaining = 0U;
+            uMultiplier = 1U;
+
+            while ((uPos < sMqttState.uRxLen) && (uPos < 5U))
+            {
+                uRemaining += (sMqttState.uaRx[uPos] & 0x7FU) * uMultiplier;
+                uMultiplier *= 128U;
+                if (0U == (sMqttState.uaRx[uPos++] & 0x80U))
+                {
+                    bComplete = true;
+                    break;
+                }
+            }
+
+            uHeaderLen = uPos;
+
+            if (bComplete && ((uHeaderLen + uRemaining) > MQTT_RX_SIZE))
+            {
+                // We only subscribe to nothing, large packets are protocol errors
+                eRetVal = ErrError;
+                bComplete = false;
+            }
+            else if (bComplete && ((uHeaderLen + uRemaining) <= sMqttState.uRxLen))
+            {
+                vMqttHandlePacket(
+                    sMqttState.uaRx[0] & 0xF0U,
+                    &sMqttState.uaRx[uHeaderLen],
+                    uRemaining);
+
+                sMqttState.uRxLen -= (uint16_t)(uHeaderLen + uRemaining);
+                memmove(
+                    sMqttState.uaRx,
+                    &sMqttState.uaRx[uHeaderLen + uRemaining],
+                    sMqttState.uRxLen);
+            }
+            else
+            {
+                bComplete = false;
+            }
+        }
+    } while (bComplete);
+
+    return (eRetVal);
+}
+
+
+static void vMqttHandlePacket(const uint8_t uType, const uint8_t *pData, const uint32_t uLen)
+{
+    uint16_t uPacketId;
+    uint8_t uIndex;
+
+    switch (uType)
+    {
+    case MQTT_CONNACK:
+        if ((2U == uLen) && (0U == pData[1]))
+        {
+            sMqttState.bConnected = true;
+        }
+        else
+        {
+            // No need to wait for the time-out
+            sMqttState.bRefused = true;
+            DBG_PR(DBG_ERROR, FN_MQTT, "Connection refused (%d)\n", (2U == uLen) ? pData[1] : -1);
+        }
+        break;
+
+    case MQTT_PUBACK:
+        if (2U == uLen)
+        {
+            uPacketId = ((uint16_t)pData[0] << 8U) | pData[1];
+
+            for (uint8_t i = 0U; i < sMqttState.uNumInflight; i++)
+            {
+                uIndex = sMqttState.uaInflight[i];
+
+                if (sMqttState.saMsg[uIndex].uPacketId == uPacketId)
+                {
+                    // Keep the order of the remaining messages
+                    sMqttState.uNumInflight--;
+                    memmove(
+                        &sMqttState.uaInflight[i],
+                        &sMqttState.uaInflight[i + 1U],
+                        sMqttState.uNumInflight - i);
+                    xQueueSend(sMqttState.xFreeQueue, &uIndex, 0);
+                    break;
+                }
+            }
+        }
+        break;
+
+    case MQTT_PINGRESP:
+        sMqttState.bPingPending = false;
+        break;
+
+    default:
+        break;
+    }
+}
+
+
+static uint8_t uMqttEncodeLength(uint8_t *const pBuffer, uint32_t uLen)
+{
+    uint8_t uPos = 0U;
+
+    do
+    {
+        pBuffer[uPos] = (uint8_t)(uLen % 128U);
+        uLen /= 128U;
+        if (uLen > 0U)
+        {
+            pBuffer[uPos] |= 0x80U;
+        }
+        uPos++;
+    } while ((uLen > 0U) && (uPos < 4U));
+
+    return (uPos);
+}
@@ -24,6 +24,9 @@
 // Project includes
 #include "task1/task1.h"
 #include "global/debug_print.h"
+#include "global/periodic.h"
+#include "telemetry/telemetry.h"
+#include "mqtt/mqtt_client.h"
 
 #include "pico/time.h"
 #include "pico/aon_timer.h"
@@ -32,20 +35,32 @@
 
 /* --- Private macro defines ------------------------------------------------ */
 
-#define TASK1_PRIORITY (2)
+/** Period of the example job */
+#define TASK1_PERIOD_MS (1000UL)
+
+/** Latest end of the job after its release */
+#define TASK1_DEADLINE_MS (100UL)
+
+/** Telemetry channel used by this example */
+#define TASK1_TLM_CHANNEL (1U)
+
+/** MQTT topic of the counter (with MQTT_ENABLED) */
+#define TASK1_MQTT_TOPIC MQTT_CLIENT_ID "/task1"
 
 /* --- Local type/struct definitions ---------------------------------------- */
 
 /* --- Static variables ----------------------------------------------------- */
 
+static sPeriodicJob_t sTask1Job;
+
 /* --- Static function prototypes ------------------------------------------- */
 
 /**
- * @brief Main task for task1 example.
+ * @brief Periodic job of the task1 example.
  *
- * @param pvParameters Filled from FreRTOS scheduler, unused.
+ * @param pvArg Unused.
  */
-static void vTask1Main( void * pvParameters );
+static void vTask1Job(void *pvArg);
 
 
 /* --- Public functions ----------------------------------------------------- */
@@ -61,44 +76,56 @@ eRetVal_t eTask1HwInit(void)
 
 eRetVal_t eTask1RtosInit(void)
 {
-    eRetVal_t eRetVal = ErrNoError;
-    BaseType_t xReturned;
-
-    /* Create the queue receive task as described in the comments at the top
-    of this file. */
-    xReturned = xTaskCreate (vTask1Main,
-                    "Task1",
-                    configMINIMAL_STACK_SIZE,
-                    NULL,
-                    TASK1_PRIORITY,
-                    NULL
-                    );
-
-    if (pdPASS != xReturned)
-    {
-        eRetVal = ErrError;
-    }
+    eRetVal_t eRetVal;
+
+    /* Runs once a second in the worker of the normal class, no own task */
+    eRetVal = ePeriodicAdd(
+                &sTask1Job,
+                "Task1",
+                vTask1Job,
+                NULL,
+                TASK1_PERIOD_MS,
+                0UL,
+                TASK1_DEADLINE_MS,
+                PeriodicClassNormal);
 
     return (eRetVal);
 }
 
 /* --- Static functions ----------------------------------------------------- */
 
-void vTask1Main(void * pvParameters)
+static void vTask1Job(void *pvArg)
 {
-    uint32_t i = 0;
+    static uint32_t i = 0;
     struct tm tm;
-
-    (void) pvParameters;  // Silence compiler about unused parameters
-
-    while(1)
+    sTlmEncoder_t *sEnc;
+#if MQTT_ENABLED
+    char caPayload[12];
+    int iLen;
+#endif
+
+    (void) pvArg;  // Silence compiler about unused parameters
+
+    aon_timer_get_time_calendar(&tm);
+    i++;
+    DBG_PR(
+        DBG_ERROR,
+        FN_UNKNOWN,
+        "Ping %02d:%02d:%02d!\n", tm.tm_hour, tm.tm_min, tm.tm_sec);
+
+    // Same information as binary telemetry record [1, time, i, free heap]
+    sEnc = sTelemetryBegin(TASK1_TLM_CHANNEL, 2U);
+    if (NULL != sEnc)
     {
-        aon_timer_get_time_calendar(&tm);
-        i++;
-        vTaskDelay(1000);
-        DBG_PR(
-            DBG_ERROR,
-            FN_UNKNOWN,
-            "Ping %02d:%02d:%02d!\n", tm.tm_hour, tm.tm_min, tm.tm_sec);
+        vTlmEncUint(sEnc, i);
+        vTlmEncUint(sEnc, xPortGetFreeHeapSize());
+        vTelemetryEnd(sEnc);
     }
+
+#if MQTT_ENABLED
+    // Counter as MQTT message; while the broker is away the slots fill up and
+    // further messages are dropped (metric mqtt_dropped_total)
+    iLen = snprintf(caPayload, sizeof(caPayload), "%lu", (unsigned long)i);
+    (void)eMqttPublish(TASK1_MQTT_TOPIC, (const uint8_t *)caPayload, (uint16_t)iLen, MqttQos0);
+#endif
 }
@@ -0,0 +1,333 @@
+/** ****************************************************************************
+ * @file   telemetry.c
+ *
+ * @author Michael R.
+ *
+ * @brief  Typed binary telemetry (CBOR) with a batching UDP transport.
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+/* --- Includes ------------------------------------------------------------- */
+
+// pico-sdk includes
+#include "pico/time.h"
+#include "pico/aon_timer.h"
+#include "pico/unique_id.h"
+
+// FreeRTOS includes
+#include "FreeRTOS.h" /* Must come first. */
+#include "task.h"
+#include "timers.h"
+#include "semphr.h"
+
+// Project includes
+#include "telemetry/telemetry.h"
+
+#include "global/debug_print.h"
+#include "global/utils.h"
+#include "wlan/wlan.h"
+#include "wlan/tcp_udp.h"
+#include "http/websocket.h"
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+#define TELEMETRY_PRIORITY   (tskIDLE_PRIORITY + 1UL)
+#define TELEMETRY_STACK      (512UL)
+
+/** Format version sent in the header record */
+#define TELEMETRY_VERSION    (1U)
+
+#define CBOR_TAG_SELF_DESCRIBE (55799U)
+
+/* --- Local type/struct definitions ---------------------------------------- */
+
+/**
+ * @brief Ennumeration of the Notification flags for the telemetry task
+ */
+typedef enum eTlmNotifications_tag
+{
+    TlmTimerExpired = (1UL << 0U),
+    TlmBatchFull    = (1UL << 1U),
+} eTlmNotifications_t;
+
+typedef struct sTlmBatch_tag
+{
+    uint8_t uaData[TELEMETRY_BATCH_SIZE];
+    uint16_t uLen;
+} sTlmBatch_t;
+
+typedef struct sTlmState_tag
+{
+    sTlmBatch_t saBatch[2];         ///< Double buffer: one filled, one sent
+    uint8_t uActive;                ///< Index of the batch being filled
+    volatile bool bSendPending;     ///< Inactive batch waits for the task
+    uint16_t uHeaderLen;            ///< Length of the header in each batch
+    uint16_t uRecordStart;          ///< Start of the currently open record
+    uint16_t uRecords;              ///< Complete records in the active batch
+    sTlmEncoder_t sEnc;             ///< Encoder working on the active batch
+
+    uint32_t uDropped;              ///< Number of records dropped
+
+    SemaphoreHandle_t xMutex;
+    TaskHandle_t xTask;
+    TimerHandle_t xTimer;
+} sTlmState_t;
+
+/* --- Static variables ----------------------------------------------------- */
+
+static sTlmState_t sTlmState;
+
+/* --- Static function prototypes ------------------------------------------- */
+
+/**
+ * @brief Start a fresh batch in the active buffer (with header)
+ *
+ * Must be called with the mutex held.
+ */
+static void vTelemetryStartBatch(void);
+
+/**
+ * @brief Hand the active batch over to the task and switch buffers
+ *
+ * Must be called with the mutex held.
+ */
+static void vTelemetrySwapBatch(void);
+
+/**
+ * @brief Telemetry task. Sends filled batches.
+ *
+ * @param pvParameters Unused
+ */
+static void vTelemetryTask(void *pvParameters);
+
+/**
+ * @brief Timer function to flush the batch on regular basis.
+ *
+ * @param xTimer Unused
+ */
+static void vTelemetryTimerCB(TimerHandle_t xTimer);
+
+/* --- Public functions ----------------------------------------------------- */
+
+eRetVal_t eTelemetryRtosInit(void)
+{
+    eRetVal_t eRetVal = ErrNoError;
+    BaseType_t xReturned;
+
+    DBG_PR(DBG_INFO, FN_TELEMETRY, "\n");
+
+    sTlmState.xMutex = xSemaphoreCreateMutex();
+
+    if (NULL == sTlmState.xMutex)
+    {
+        eRetVal = ErrError;
+    }
+
+    if (IS_NO_ERR(eRetVal))
+    {
+        xReturned = xTaskCreate(
+                        vTelemetryTask,
+                        "Telemetry",
+                        TELEMETRY_STACK,
+                        NULL,
+                        TELEMETRY_PRIORITY,
+                        &sTlmState.xTask);
+
+        if (pdPASS != xReturned)
+        {
+            eRetVal = ErrError;
+        }
+    }
+
+    if (IS_NO_ERR(eRetVal))
+    {
+        sTlmState.xTimer = xTimerCreate(
+            "TLM_Tmr",
+            pdMS_TO_TICKS(TELEMETRY_FLUSH_MS),
+            pdTRUE,
+            0,
+            vTelemetryTimerCB);
+
+        if (NULL != sTlmState.xTimer)
+        {
+            xTimerStart(sTlmState.xTimer, 0);
+        }
+        else
+        {
+            eRetVal = ErrError;
+        }
+    }
+
+    if (IS_NO_ERR(eRetVal))
+    {
+        sTlmState.uActive = 0U;
+        vTelemetryStartBatch();
+    }
+
+    return (eRetVal);
+}
+
+
+uint64_t uTelemetryNowUs(void)
+{
+    uint64_t uNowUs;
+    struct timespec ts;
+
+    if (aon_timer_get_time(&ts) && (ts.tv_sec > 0))
+    {
+        uNowUs = ((uint64_t)ts.tv_sec * 1000000ULL) + ((uint64_t)ts.tv_nsec / 1000ULL);
+    }
+    else
+    {
+        uNowUs = time_us_64();
+    }
+
+    return (uNowUs);
+}
+
+
+sTlmEncoder_t *sTelemetryBegin(const uint16_t uChannel, const uint16_t uNumFields)
+{
+    sTlmEncoder_t *sEnc = NULL;
+
+    if ((NULL != sTlmState.xMutex) &&
+        (pdTRUE == xSemaphoreTake(sTlmState.xMutex, portMAX_DELAY)))
+    {
+        if ((sTlmState.sEnc.uSize - sTlmState.sEnc.uPos) < TELEMETRY_RECORD_MAX)
+        {
+            vTelemetrySwapBatch();
+        }
+
+        sEnc = &sTlmState.sEnc;
+        sTlmState.uRecordStart = sEnc->uPos;
+
+        vTlmEncArray(sEnc, 2U + uNumFields);
+        vTlmEncUint(sEnc, uChannel);
+        vTlmEncTimestamp(sEnc, uTelemetryNowUs());
+    }
+
+    return (sEnc);
+}
+
+
+void vTelemetryEnd(sTlmEncoder_t *const sEnc)
+{
+    if (NULL != sEnc)
+    {
+        if (sEnc->bOverflow)
+        {
+            // Record too large, drop it but keep the records before
+            sEnc->uPos = sTlmState.uRecordStart;
+            sEnc->bOverflow = false;
+            sTlmState.uDropped++;
+        }
+        else
+        {
+            sTlmState.uRecords++;
+        }
+
+        xSemaphoreGive(sTlmState.xMutex);
+    }
+}
+
+
+void vTelemetryFlush(void)
+{
+    if ((NULL != sTlmState.xMutex) &&
+        (pdTRUE == xSemaphoreTake(sTlmState.xMutex, portMAX_DELAY)))
+    {
+        if (sTlmState.sEnc.uPos > sTlmState.uHeaderLen)
+        {
+            vTelemetrySwapBatch();
+        }
+
+        xSemaphoreGive(sTlmState.xMutex);
+    }
+}
+
+/* --- Static functions ----------------------------------------------------- */
+
+static void vTelemetryStartBatch(void)
+{
+    pico_unique_board_id_t sBoardId;
+    sTlmEncoder_t *const sEnc = &sTlmState.sEnc;
+
+    pico_get_unique_board_id(&sBoardId);
+
+    vTlmEncInit(
+        sEnc,
+        sTlmState.saBatch[sTlmState.uActive].uaData,
+        TELEMETRY_BATCH_SIZE);
+
+    // Header record: [version, board-id, dropped records]
+    vTlmEncTag(sEnc, CBOR_TAG_SELF_DESCRIBE);
+    vTlmEncArray(sEnc, 3U);
+    vTlmEncUint(sEnc, TELEMETRY_VERSION);
+    vTlmEncBytes(sEnc, sBoardId.id, PICO_UNIQUE_BOARD_ID_SIZE_BYTES);
+    vTlmEncUint(sEnc, sTlmState.uDropped);
+
+    sTlmState.uHeaderLen = sEnc->uPos;
+    sTlmState.uRecords = 0U;
+}
+
+
+static void vTelemetrySwapBatch(void)
+{
+    if (sTlmState.bSendPending)
+    {
+        // Task did not manage to send the previous batch, drop the current
+        sTlmState.uDropped += sTlmState.uRecords;
+    }
+    else
+    {
+        sTlmState.saBatch[sTlmState.uActive].uLen = sTlmState.sEnc.uPos;
+        sTlmState.uActive ^= 1U;
+        sTlmState.bSendPending = true;
+
+        xTaskNotify(sTlmState.xTask, TlmBatchFull, eSetBits);
+    }
+
+    vTelemetryStartBatch();
+}
+
+
+static void vTelemetryTask(void *pvParameters)
+{
+    (void)pvParameters; // Silence 'unused parameters'
+
+    uint32_t uNotifyVector = 0UL;
+    sTlmBatch_t *sBatch;
+
+    while (1)
+    {
+        xTaskNotifyWait(0UL, UINT32_MAX, &uNotifyVector, portMAX_DELAY);
+
+        if (TEST_PAT(uNotifyVector, TlmTimerExpired))
+        {
+            vTelemetryFlush();
+        }
+
+        if (sTlmState.bSendPending)
+        {
+            sBatch = &sTlmState.saBatch[sTlmState.uActive ^ 1U];
+
+            if (bWlanIsConnected())
+            {
+                eTcpUdpSendUdp(sBatch->uaData, sBatch->uLen, TELEMETRY_PORT);
+            }
+
+            vWsPublish(WsBinary, sBatch->uaData, sBatch->uLen);
+
+            sTlmState.bSendPending = false;
+        }
+    }
+}
+
+
+static void vTelemetryTimerCB(TimerHandle_t xTimer)
+{
+    (void)xTimer;
+
+    xTaskNotify(sTlmState.xTask, TlmTimerExpired, eSetBits);
+}
@@ -0,0 +1,235 @@
+/** ****************************************************************************
+ * @file   tlm_encoder.c
+ *
+ * @author Michael R.
+ *
+ * @brief  CBOR encoder of the telemetry records.
+ *
+ * Plain C without SDK or FreeRTOS, so the host benchmark in tools/telemetry
+ * builds the same code.
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <string.h>
+
+// pico-sdk includes
+// FreeRTOS includes
+// Project includes
+#include "telemetry/telemetry.h"
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+#define CBOR_UINT   (0U << 5U)
+#define CBOR_NINT   (1U << 5U)
+#define CBOR_BYTES  (2U << 5U)
+#define CBOR_TEXT   (3U << 5U)
+#define CBOR_ARRAY  (4U << 5U)
+#define CBOR_MAP    (5U << 5U)
+#define CBOR_TAG    (6U << 5U)
+#define CBOR_SIMPLE (7U << 5U)
+
+#define CBOR_FALSE   (CBOR_SIMPLE | 20U)
+#define CBOR_TRUE    (CBOR_SIMPLE | 21U)
+#define CBOR_FLOAT32 (CBOR_SIMPLE | 26U)
+
+#define CBOR_TAG_EXT_TIME      (1001U)
+
+/* --- Local type/struct definitions ---------------------------------------- */
+
+/* --- Static variables ----------------------------------------------------- */
+
+/* --- Static function prototypes ------------------------------------------- */
+
+/**
+ * @brief Write the CBOR head (major type and argument)
+ *
+ * @param sEnc       Encoder
+ * @param uMajor     Major type (already shifted)
+ * @param uArgument  Argument
+ */
+static void vTlmEncHead(sTlmEncoder_t *const sEnc, const uint8_t uMajor, const uint64_t uArgument);
+
+/**
+ * @brief Write raw bytes
+ */
+static void vTlmEncRaw(sTlmEncoder_t *const sEnc, const void *pData, const uint16_t uLen);
+
+/* --- Public functions ----------------------------------------------------- */
+
+void vTlmEncInit(sTlmEncoder_t *const sEnc, uint8_t *const pBuf, const uint16_t uSize)
+{
+    sEnc->pBuf = pBuf;
+    sEnc->uSize = uSize;
+    sEnc->uPos = 0U;
+    sEnc->bOverflow = false;
+}
+
+
+void vTlmEncUint(sTlmEncoder_t *const sEnc, const uint64_t uValue)
+{
+    vTlmEncHead(sEnc, CBOR_UINT, uValue);
+}
+
+
+void vTlmEncInt(sTlmEncoder_t *const sEnc, const int64_t iValue)
+{
+    if (iValue < 0)
+    {
+        // CBOR negative integers are encoded as -1 - n
+        vTlmEncHead(sEnc, CBOR_NINT, (uint64_t)(-1 - iValue));
+    }
+    else
+    {
+        vTlmEncHead(sEnc, CBOR_UINT, (uint64_t)iValue);
+    }
+}
+
+
+void vTlmEncFloat(sTlmEncoder_t *const sEnc, const float fValue)
+{
+    uint32_t uBits;
+    uint8_t uaBytes[5];
+
+    memcpy(&uBits, &fValue, sizeof(uBits));
+
+    uaBytes[0] = CBOR_FLOAT32;
+    uaBytes[1] = (uint8_t)(uBits >> 24U);
+    uaBytes[2] = (uint8_t)(uBits >> 16U);
+    uaBytes[3] = (uint8_t)(uBits >>  8U);
+    uaBytes[4] = (uint8_t)(uBits >>  0U);
+
+    vTlmEncRaw(sEnc, uaBytes, sizeof(uaBytes));
+}
+
+
+void vTlmEncBool(sTlmEncoder_t *const sEnc, const bool bValue)
+{
+    const uint8_t uByte = bValue ? CBOR_TRUE : CBOR_FALSE;
+
+    vTlmEncRaw(sEnc, &uByte, 1U);
+}
+
+
+void vTlmEncTimestamp(sTlmEncoder_t *const sEnc, const uint64_t uTimeUs)
+{
+    // 1001({1: seconds, -6: microseconds})
+    vTlmEncHead(sEnc, CBOR_TAG, CBOR_TAG_EXT_TIME);
+    vTlmEncHead(sEnc, CBOR_MAP, 2U);
+    vTlmEncUint(sEnc, 1U);
+    vTlmEncUint(sEnc, uTimeUs / 1000000ULL);
+    vTlmEncInt(sEnc, -6);
+    vTlmEncUint(sEnc, uTimeUs % 1000000ULL);
+}
+
+
+void vTlmEncBytes(sTlmEncoder_t *const sEnc, const void *pData, const uint16_t uLen)
+{
+    vTlmEncHead(sEnc, CBOR_BYTES, uLen);
+    vTlmEncRaw(sEnc, pData, uLen);
+}
+
+
+void vTlmEncTag(sTlmEncoder_t *const sEnc, const uint64_t uTag)
+{
+    vTlmEncHead(sEnc, CBOR_TAG, uTag);
+}
+
+
+void vTlmEncText(sTlmEncoder_t *const sEnc, const char *cpText, const uint16_t uLen)
+{
+    vTlmEncHead(sEnc, CBOR_TEXT, uLen);
+    vTlmEncRaw(sEnc, cpText, uLen);
+}
+
+
+void vTlmEncArray(sTlmEncoder_t *const sEnc, const uint16_t uNumItems)
+{
+    vTlmEncHead(sEnc, CBOR_ARRAY, uNumItems);
+}
+
+
+void vTlmEncIntArray(sTlmEncoder_t *const sEnc, const int32_t *ipValues, const uint16_t uNum)
+{
+    vTlmEncArray(sEnc, uNum);
+
+    for (uint16_t i = 0U; i < uNum; i++)
+    {
+        vTlmEncInt(sEnc, ipValues[i]);
+    }
+}
+
+
+void vTlmEncFloatArray(sTlmEncoder_t *const sEnc, const float *fpValues, const uint16_t uNum)
+{
+    vTlmEncArray(sEnc, uNum);
+
+    for (uint16_t i = 0U; i < uNum; i++)
+    {
+        vTlmEncFloat(sEnc, fpValues[i]);
+    }
+}
+
+/* --- Static functions ----------------------------------------------------- */
+
+static void vTlmEncHead(sTlmEncoder_t *const sEnc, const uint8_t uMajor, const uint64_t uArgument)
+{
+    uint8_t uaBytes[9];
+    uint16_t uLen;
+
+    if (uArgument < 24U)
+    {
+        uaBytes[0] = uMajor | (uint8_t)uArgument;
+        uLen = 1U;
+    }
+    else if (uArgument <= UINT8_MAX)
+    {
+        uaBytes[0] = uMajor | 24U;
+        uaBytes[1] = (uint8_t)uArgument;
+        uLen = 2U;
+    }
+    else if (uArgument <= UINT16_MAX)
+    {
+        uaBytes[0] = uMajor | 25U;
+        uaBytes[1] = (uint8_t)(uArgument >> 8U);
+        uaBytes[2] = (uint8_t)(uArgument >> 0U);
+        uLen = 3U;
+    }
+    else if (uArgument <= UINT32_MAX)
+    {
+        uaBytes[0] = uMajor | 26U;
+        uaBytes[1] = (uint8_t)(uArgument >> 24U);
+        uaBytes[2] = (uint8_t)(uArgument >> 16U);
+        uaBytes[3] = (uint8_t)(uArgument >>  8U);
+        uaBytes[4] = (uint8_t)(uArgument >>  0U);
+        uLen = 5U;
+    }
+    else
+    {
+        uaBytes[0] = uMajor | 27U;
+        for (uint8_t i = 0U; i < 8U; i++)
+        {
+            uaBytes[1U + i] = (uint8_t)(uArgument >> (56U - (8U * i)));
+        }
+        uLen = 9U;
+    }
+
+    vTlmEncRaw(sEnc, uaBytes, uLen);
+}
+
+
+static void vTlmEncRaw(sTlmEncoder_t *const sEnc, const void *pData, const uint16_t uLen)
+{
+    if (!sEnc->bOverflow && ((sEnc->uSize - sEnc->uPos) >= uLen))
+    {
+        memcpy(&sEnc->pBuf[sEnc->uPos], pData, uLen);
+        sEnc->uPos += uLen;
+    }
+    else
+    {
+        sEnc->bOverflow = true;
+    }
+}
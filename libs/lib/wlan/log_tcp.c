@@ -0,0 +1,289 @@
+/** ****************************************************************************
+ * @file   log_tcp.c
+ *
+ * @author Michael R.
+ *
+ * @brief  Debug sink "tcp": log stream to one TCP client
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdbool.h>
+#include <stddef.h>
+
+// pico-sdk includes
+#include "pico/cyw43_arch.h"
+#include "lwip/tcp.h"
+
+// FreeRTOS includes
+// Project includes
+#include "wlan/log_tcp.h"
+
+#include "global/debug_print.h"
+#include "global/event_bus.h"
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+
+/* --- Local type/struct definitions ---------------------------------------- */
+
+typedef struct sLogTcpState_tag
+{
+    struct tcp_pcb *sListenPcb;
+    struct tcp_pcb *sPcb;       ///< Client, NULL if none (lwIP lock)
+} sLogTcpState_t;
+
+/* --- Static variables ----------------------------------------------------- */
+
+static sLogTcpState_t sLogTcpState = {NULL, NULL};
+
+static sDebugSink_t sLogTcpSink;
+static sDebugSlot_t saLogTcpSlots[LOG_TCP_SLOTS];
+
+/** The lwIP lock exists only with an initialised driver */
+static volatile bool bLogTcpLinkUp = false;
+
+static sEventSub_t sLogTcpLinkUpSub;
+static sEventSub_t sLogTcpLinkDownSub;
+
+/* --- Static function prototypes ------------------------------------------- */
+
+/**
+ * @brief EventLinkUp/EventLinkDown: start listening, switch the output
+ *
+ * @param eEvent Event
+ * @param uArg   IPv4 address (EventLinkUp)
+ */
+static void vLogTcpOnLink(const eEvent_t eEvent, const uint32_t uArg);
+
+/**
+ * @brief lwIP accept callback, replaces the current client
+ */
+static err_t xLogTcpAccept(void *pvArg, struct tcp_pcb *sPcb, err_t xErr);
+
+/**
+ * @brief lwIP receive callback, discards the input, closes on FIN
+ */
+static err_t xLogTcpRecv(void *pvArg, struct tcp_pcb *sPcb, struct pbuf *sPb, err_t xErr);
+
+/**
+ * @brief lwIP error callback, the pcb is already gone
+ */
+static void vLogTcpErr(void *pvArg, err_t xErr);
+
+/**
+ * @brief Close the client connection. lwIP lock must be held.
+ *
+ * @return ERR_ABRT if the connection had to be aborted
+ */
+static err_t xLogTcpClose(void);
+
+/**
+ * @brief Sink write (LogSink task): copy a record into the send buffer
+ *
+ * @param sRecord Record
+ * @param pvCtx   Unused
+ *
+ * @return false if the send buffer is full, the record is retried
+ */
+static bool bLogTcpWrite(const sDebugRecord_t *const sRecord, void *pvCtx);
+
+/**
+ * @brief Sink flush (LogSink task): send the batch
+ *
+ * @param pvCtx Unused
+ */
+static void vLogTcpFlush(void *pvCtx);
+
+/* --- Public functions ----------------------------------------------------- */
+
+eRetVal_t eLogTcpPreInit(void)
+{
+    eRetVal_t eRetVal = ErrNoError;
+
+    vDebugSinkSetQueue(&sLogTcpSink, saLogTcpSlots, LOG_TCP_SLOTS, LOG_TCP_BATCH, LOG_TCP_FLUSH_MS, vLogTcpFlush);
+    eRetVal = eDebugSinkAdd(&sLogTcpSink, "tcp", bLogTcpWrite, NULL, DBG_ALL);
+
+    if (IS_NO_ERR(eRetVal))
+    {
+        vEventSubscribe(&sLogTcpLinkUpSub, EventLinkUp, vLogTcpOnLink, EventOrderNormal);
+        vEventSubscribe(&sLogTcpLinkDownSub, EventLinkDown, vLogTcpOnLink, EventOrderFirst);
+    }
+
+    return (eRetVal);
+}
+
+
+void vLogTcpStart(void)
+{
+    struct tcp_pcb *sPcb;
+
+    cyw43_arch_lwip_begin();
+
+    if (NULL == sLogTcpState.sListenPcb)
+    {
+        sPcb = tcp_new_ip_type(IPADDR_TYPE_ANY);
+
+        if ((NULL != sPcb) && (ERR_OK == tcp_bind(sPcb, IP_ANY_TYPE, HOST_LOG_TCP_PORT)))
+        {
+            sLogTcpState.sListenPcb = tcp_listen_with_backlog(sPcb, 1U);
+            tcp_accept(sLogTcpState.sListenPcb, xLogTcpAccept);
+        }
+        else if (NULL != sPcb)
+        {
+            tcp_close(sPcb);
+        }
+    }
+
+    cyw43_arch_lwip_end();
+
+    if (NULL == sLogTcpState.sListenPcb)
+    {
+        DBG_PR(DBG_ERROR, FN_TCPUDP, "Listen on port %d failed!\n", HOST_LOG_TCP_PORT);
+    }
+}
+
+/* --- Static functions ----------------------------------------------------- */
+
+static void vLogTcpOnLink(const eEvent_t eEvent, const uint32_t uArg)
+{
+    (void)uArg; // Silence 'unused parameters'
+
+    bLogTcpLinkUp = (EventLinkUp == eEvent);
+
+    if (bLogTcpLinkUp)
+    {
+        vLogTcpStart();
+    }
+}
+
+
+static err_t xLogTcpAccept(void *pvArg, struct tcp_pcb *sPcb, err_t xErr)
+{
+    (void)pvArg; // Silence 'unused parameters'
+
+    err_t xRetVal = ERR_OK;
+
+    if ((ERR_OK != xErr) || (NULL == sPcb))
+    {
+        xRetVal = ERR_VAL;
+    }
+    else
+    {
+        if (NULL != sLogTcpState.sPcb)
+        {
+            (void)xLogTcpClose();
+        }
+
+        sLogTcpState.sPcb = sPcb;
+
+        tcp_arg(sPcb, NULL);
+        tcp_recv(sPcb, xLogTcpRecv);
+        tcp_err(sPcb, vLogTcpErr);
+        // The sink batches itself
+        tcp_nagle_disable(sPcb);
+
+        DBG_PR(DBG_INFO, FN_TCPUDP, "Log client %s connected\n", ipaddr_ntoa(&sPcb->remote_ip));
+    }
+
+    return (xRetVal);
+}
+
+
+static err_t xLogTcpRecv(void *pvArg, struct tcp_pcb *sPcb, struct pbuf *sPb, err_t xErr)
+{
+    (void)pvArg; // Silence 'unused parameters'
+    (void)xErr;
+
+    err_t xRetVal = ERR_OK;
+
+    if (NULL == sPb)
+    {
+        // Closed by the client
+        xRetVal = xLogTcpClose();
+    }
+    else
+    {
+        tcp_recved(sPcb, sPb->tot_len);
+        pbuf_free(sPb);
+    }
+
+    return (xRetVal);
+}
+
+
+static void vLogTcpErr(void *pvArg, err_t xErr)
+{
+    (void)pvArg; // Silence 'unused parameters'
+    (void)xErr;
+
+    sLogTcpState.sPcb = NULL;
+}
+
+
+static err_t xLogTcpClose(void)
+{
+    err_t xRetVal = ERR_OK;
+    struct tcp_pcb *const sPcb = sLogTcpState.sPcb;
+
+    tcp_recv(sPcb, NULL);
+    tcp_err(sPcb, NULL);
+
+    if (ERR_OK != tcp_close(sPcb))
+    {
+        tcp_abort(sPcb);
+        xRetVal = ERR_ABRT;
+    }
+
+    sLogTcpState.sPcb = NULL;
+
+    return (xRetVal);
+}
+
+
+static bool bLogTcpWrite(const sDebugRecord_t *const sRecord, void *pvCtx)
+{
+    (void)pvCtx; // Silence 'unused parameters'
+
+    bool bRetVal = true;
+
+    // Without link or client the record is discarded, the lock is only taken
+    // with an initialised driver
+    if (bLogTcpLinkUp && (NULL != sLogTcpState.sPcb))
+    {
+        cyw43_arch_lwip_begin();
+
+        if ((NULL != sLogTcpState.sPcb) &&
+            ((tcp_sndbuf(sLogTcpState.sPcb) < sRecord->uLen) ||
+             (ERR_MEM == tcp_write(sLogTcpState.sPcb, sRecord->cpText, sRecord->uLen, TCP_WRITE_FLAG_COPY))))
+        {
+            bRetVal = false;
+        }
+
+        cyw43_arch_lwip_end();
+    }
+
+    return (bRetVal);
+}
+
+
+static void vLogTcpFlush(void *pvCtx)
+{
+    (void)pvCtx; // Silence 'unused parameters'
+
+    if (bLogTcpLinkUp && (NULL != sLogTcpState.sPcb))
+    {
+        cyw43_arch_lwip_begin();
+
+        // Re-checked, the client may have gone meanwhile
+        if (NULL != sLogTcpState.sPcb)
+        {
+            (void)tcp_output(sLogTcpState.sPcb);
+        }
+
+        cyw43_arch_lwip_end();
+    }
+}
@@ -20,6 +20,8 @@
 // Project includes
 #include "wlan/mysntp.h"
 #include "global/debug_print.h"
+#include "global/event_bus.h"
+#include "global/metrics.h"
 
 /* --- Local macro definitions ---------------------------------------------- */
 
@@ -29,8 +31,21 @@
 
 /* --- Static function prototypes ------------------------------------------- */
 
+/**
+ * @brief Starts the time fetch once the link is up
+ *
+ * @param eEvent Unused
+ * @param uArg   Unused
+ */
+static void vSntpOnLinkUp(const eEvent_t eEvent, const uint32_t uArg);
+
 /* --- Static variables ----------------------------------------------------- */
 
+/** Unix time minus system timer in us, 0 until the first SNTP update */
+static volatile uint64_t uSntpOffsetUs = 0ULL;
+
+static sEventSub_t sSntpLinkUpSub;
+
 /* --- Public functions ----------------------------------------------------- */
 
 void vSntpPreInit(void)
@@ -45,6 +60,8 @@ void vSntpPreInit(void)
     sntp_setservername(0, SNTP_SERVER);
     sntp_setoperatingmode(SNTP_OPMODE_POLL);
     aon_timer_start(&ts);
+
+    vEventSubscribe(&sSntpLinkUpSub, EventLinkUp, vSntpOnLinkUp, EventOrderNormal);
 }
 
 
@@ -74,6 +91,45 @@ void vSntpStop(void)
 }
 
 
+void vSntpSetSystemTime(const uint32_t uSeconds, const uint32_t uMicros)
+{
+    const struct timespec ts = {
+        .tv_sec = uSeconds,
+        .tv_nsec = (long)uMicros * 1000L
+    };
+
+    uSntpOffsetUs = ((uint64_t)uSeconds * 1000000ULL) + uMicros - time_us_64();
+
+    aon_timer_set_time(&ts);
+    vMetricsInc(MetricSntpSyncs);
+
+    vEventPublish(EventTimeSynced, uSeconds);
+}
+
+
+void vSntpGetSystemTime(uint32_t *const uSeconds, uint32_t *const uMicros)
+{
+    const uint64_t uNowUs = uSntpGetTimeUs();
+
+    *uSeconds = (uint32_t)(uNowUs / 1000000ULL);
+    *uMicros  = (uint32_t)(uNowUs % 1000000ULL);
+}
+
+
+uint64_t uSntpGetTimeUs(void)
+{
+    uint64_t uOffsetUs;
+
+    // 64 bit access is not atomic, repeat if an update came in between
+    do
+    {
+        uOffsetUs = uSntpOffsetUs;
+    } while (uOffsetUs != uSntpOffsetUs);
+
+    return (time_us_64() + uOffsetUs);
+}
+
+
 uint32_t uSntpGetTimeBCD(void)
 {
     uint32_t uTimeBCD = 0UL;
@@ -121,3 +177,11 @@ uint32_t uSntpGetDateBCD(void)
 }
 
 /* --- Static functions ----------------------------------------------------- */
+
+static void vSntpOnLinkUp(const eEvent_t eEvent, const uint32_t uArg)
+{
+    (void)eEvent;
+    (void)uArg;
+
+    vSntpStart();
+}
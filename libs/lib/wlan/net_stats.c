@@ -0,0 +1,325 @@
+/** ****************************************************************************
+ * @file   net_stats.c
+ *
+ * @author Michael R.
+ *
+ * @brief  lwIP and CYW43 statistics that stay enabled in release builds
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+// pico-sdk includes
+#include "pico/cyw43_arch.h"
+#include "lwip/memp.h"
+#include "lwip/netif.h"
+#include "lwip/stats.h"
+
+// FreeRTOS includes
+// Project includes
+#include "wlan/net_stats.h"
+#include "wlan/pcap.h"
+
+#include "global/event_bus.h"
+#include "global/metrics.h"
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+#if !LWIP_STATS || !MEM_STATS || !MEMP_STATS || !SYS_STATS || !MIB2_STATS
+    #error "net_stats needs LWIP_STATS, MEM_STATS, MEMP_STATS, SYS_STATS and MIB2_STATS (src/lwipopts.h)"
+#endif
+
+/* --- Local type/struct definitions ---------------------------------------- */
+
+/**
+ * @brief Copy of a pool or heap statistic
+ */
+typedef struct sNetStatsMem_tag
+{
+    uint32_t uAvail;
+    uint32_t uUsed;
+    uint32_t uMax;             ///< High-water mark
+    uint32_t uErr;             ///< Failed allocations
+} sNetStatsMem_t;
+
+/**
+ * @brief Protocols in the copy
+ */
+typedef enum eNetStatsProto_tag
+{
+    NetStatsIp,
+    NetStatsUdp,
+    NetStatsTcp,
+    NumNetStatsProto
+} eNetStatsProto_t;
+
+/**
+ * @brief Copy of the lwIP statistics
+ */
+typedef struct sNetStatsSnap_tag
+{
+    sNetStatsMem_t saPool[MEMP_MAX];
+    sNetStatsMem_t sHeap;
+    struct stats_proto saProto[NumNetStatsProto];
+    uint32_t uMboxErr;         ///< Posts to a full mbox
+    uint32_t uSemErr;
+    uint32_t uMutexErr;
+    uint32_t uTcpRetrans;      ///< Retransmitted TCP segments
+} sNetStatsSnap_t;
+
+/* --- Static variables ----------------------------------------------------- */
+
+static netif_input_fn pfNetStatsInput = NULL;
+static netif_linkoutput_fn pfNetStatsLinkOutput = NULL;
+
+static sEventSub_t sNetStatsLinkUpSub;
+
+static sNetStatsSnap_t sNetStatsSnap;
+
+/** Pool names in the order of the memp enum */
+static const char *const cpaNetStatsPool[MEMP_MAX] =
+{
+#define LWIP_MEMPOOL(_name, _num, _size, _desc) #_name,
+#include "lwip/priv/memp_std.h"
+};
+
+static const char *const cpaNetStatsProto[NumNetStatsProto] =
+{
+    [NetStatsIp]  = "ip",
+    [NetStatsUdp] = "udp",
+    [NetStatsTcp] = "tcp",
+};
+
+/* --- Static function prototypes ------------------------------------------- */
+
+/**
+ * @brief EventLinkUp: install the hooks
+ *
+ * @param eEvent Event
+ * @param uArg   IPv4 address
+ */
+static void vNetStatsOnLinkUp(const eEvent_t eEvent, const uint32_t uArg);
+
+/**
+ * @brief Hook on netif->input (driver to lwIP)
+ */
+static err_t xNetStatsInput(struct pbuf *sPb, struct netif *sNetif);
+
+/**
+ * @brief Hook on netif->linkoutput (lwIP to driver)
+ */
+static err_t xNetStatsLinkOutput(struct netif *sNetif, struct pbuf *sPb);
+
+/**
+ * @brief Copy a pool or heap statistic
+ *
+ * @param sMem   Target
+ * @param sStats lwIP statistic, may be NULL
+ */
+static void vNetStatsCopyMem(sNetStatsMem_t *const sMem, const struct stats_mem *sStats);
+
+/* --- Public functions ----------------------------------------------------- */
+
+eRetVal_t eNetStatsPreInit(void)
+{
+    eRetVal_t eRetVal = ErrNoError;
+
+    // First, so the hooks see the traffic of the other link subscribers
+    vEventSubscribe(&sNetStatsLinkUpSub, EventLinkUp, vNetStatsOnLinkUp, EventOrderFirst);
+
+    return (eRetVal);
+}
+
+
+void vNetStatsInstall(void)
+{
+    struct netif *const sNetif = &cyw43_state.netif[CYW43_ITF_STA];
+
+    cyw43_arch_lwip_begin();
+
+    if (xNetStatsInput != sNetif->input)
+    {
+        pfNetStatsInput = sNetif->input;
+        sNetif->input = xNetStatsInput;
+    }
+
+    if (xNetStatsLinkOutput != sNetif->linkoutput)
+    {
+        pfNetStatsLinkOutput = sNetif->linkoutput;
+        sNetif->linkoutput = xNetStatsLinkOutput;
+    }
+
+    cyw43_arch_lwip_end();
+}
+
+
+uint32_t uNetStatsRenderText(char *const cpBuffer, const uint32_t uSize)
+{
+    sNetStatsSnap_t *const sSnap = &sNetStatsSnap;
+    uint32_t uPos = 0U;
+
+    // Only copies under the lock, the formatting is done outside
+    cyw43_arch_lwip_begin();
+
+    for (uint32_t i = 0U; i < MEMP_MAX; i++)
+    {
+        vNetStatsCopyMem(&sSnap->saPool[i], lwip_stats.memp[i]);
+    }
+    vNetStatsCopyMem(&sSnap->sHeap, &lwip_stats.mem);
+
+    sSnap->saProto[NetStatsIp]  = lwip_stats.ip;
+    sSnap->saProto[NetStatsUdp] = lwip_stats.udp;
+    sSnap->saProto[NetStatsTcp] = lwip_stats.tcp;
+    sSnap->uMboxErr    = lwip_stats.sys.mbox.err;
+    sSnap->uSemErr     = lwip_stats.sys.sem.err;
+    sSnap->uMutexErr   = lwip_stats.sys.mutex.err;
+    sSnap->uTcpRetrans = lwip_stats.mib2.tcpretranssegs;
+
+    cyw43_arch_lwip_end();
+
+// Appends to the buffer, stops silently if the buffer is full
+#define NET_STATS_APPEND(...)                                                 \
+    do                                                                        \
+    {                                                                         \
+        if (uPos < uSize)                                                     \
+        {                                                                     \
+            const int iLen = snprintf(&cpBuffer[uPos], uSize - uPos, __VA_ARGS__); \
+            uPos = (iLen < 0) ? uSize : (uPos + (uint32_t)iLen);              \
+        }                                                                     \
+    } while (0)
+
+// One family with a value per pool
+#define NET_STATS_POOLS(_NAME, _TYPE, _HELP, _FIELD)                          \
+    do                                                                        \
+    {                                                                         \
+        NET_STATS_APPEND("# HELP " _NAME " " _HELP "\n# TYPE " _NAME " " _TYPE "\n"); \
+        for (uint32_t i = 0U; i < MEMP_MAX; i++)                              \
+        {                                                                     \
+            NET_STATS_APPEND(_NAME "{pool=\"%s\"} %lu\n",                     \
+                             cpaNetStatsPool[i],                              \
+                             (unsigned long)sSnap->saPool[i]._FIELD);         \
+        }                                                                     \
+        NET_STATS_APPEND(_NAME "{pool=\"heap\"} %lu\n", (unsigned long)sSnap->sHeap._FIELD); \
+    } while (0)
+
+// One family with a value per protocol
+#define NET_STATS_PROTO(_NAME, _HELP, _FIELD)                                 \
+    do                                                                        \
+    {                                                                         \
+        NET_STATS_APPEND("# HELP " _NAME " " _HELP "\n# TYPE " _NAME " counter\n"); \
+        for (uint32_t i = 0U; i < NumNetStatsProto; i++)                      \
+        {                                                                     \
+            NET_STATS_APPEND(_NAME "{proto=\"%s\"} %lu\n",                    \
+                             cpaNetStatsProto[i],                             \
+                             (unsigned long)sSnap->saProto[i]._FIELD);        \
+        }                                                                     \
+    } while (0)
+
+    // The pools count elements, the heap bytes
+    NET_STATS_POOLS("lwip_pool_used",      "gauge",   "Elements (heap: bytes) in use",        uUsed);
+    NET_STATS_POOLS("lwip_pool_max",       "gauge",   "Most elements (heap: bytes) in use",   uMax);
+    NET_STATS_POOLS("lwip_pool_avail",     "gauge",   "Size of the pool (heap: bytes)",       uAvail);
+    NET_STATS_POOLS("lwip_pool_err_total", "counter", "Failed allocations",                   uErr);
+
+    NET_STATS_PROTO("lwip_xmit_total",   "Packets sent per protocol",                xmit);
+    NET_STATS_PROTO("lwip_recv_total",   "Packets received per protocol",            recv);
+    NET_STATS_PROTO("lwip_drop_total",   "Packets dropped per protocol",             drop);
+    NET_STATS_PROTO("lwip_memerr_total", "Packets lost for lack of memory",          memerr);
+    NET_STATS_PROTO("lwip_err_total",    "Other errors per protocol",                err);
+
+    NET_STATS_APPEND(
+        "# HELP lwip_tcp_retrans_total Retransmitted TCP segments\n"
+        "# TYPE lwip_tcp_retrans_total counter\n"
+        "lwip_tcp_retrans_total %lu\n"
+        "# HELP lwip_sys_err_total Failed mbox posts (full) and semaphore/mutex creations\n"
+        "# TYPE lwip_sys_err_total counter\n"
+        "lwip_sys_err_total{obj=\"mbox\"} %lu\n"
+        "lwip_sys_err_total{obj=\"sem\"} %lu\n"
+        "lwip_sys_err_total{obj=\"mutex\"} %lu\n",
+        (unsigned long)sSnap->uTcpRetrans,
+        (unsigned long)sSnap->uMboxErr,
+        (unsigned long)sSnap->uSemErr,
+        (unsigned long)sSnap->uMutexErr);
+
+#undef NET_STATS_PROTO
+#undef NET_STATS_POOLS
+#undef NET_STATS_APPEND
+
+    if (uPos >= uSize)
+    {
+        // Truncated, make sure it is terminated
+        uPos = uSize - 1U;
+        cpBuffer[uPos] = '\0';
+    }
+
+    return (uPos);
+}
+
+/* --- Static functions ----------------------------------------------------- */
+
+static void vNetStatsOnLinkUp(const eEvent_t eEvent, const uint32_t uArg)
+{
+    (void)eEvent; // Silence 'unused parameters'
+    (void)uArg;
+
+    vNetStatsInstall();
+}
+
+
+static err_t xNetStatsInput(struct pbuf *sPb, struct netif *sNetif)
+{
+    // Read before the stack owns (and may free) the pbuf
+    const uint32_t uLen = sPb->tot_len;
+    err_t xRetVal;
+
+    vPcapCapture(sPb, PcapDirRx);
+
+    xRetVal = pfNetStatsInput(sPb, sNetif);
+
+    vMetricsInc(MetricNetRxPackets);
+    vMetricsAdd(MetricNetRxBytes, uLen);
+    if (ERR_OK != xRetVal)
+    {
+        vMetricsInc(MetricNetRxDropped);
+    }
+
+    return (xRetVal);
+}
+
+
+static err_t xNetStatsLinkOutput(struct netif *sNetif, struct pbuf *sPb)
+{
+    err_t xRetVal;
+
+    vMetricsInc(MetricNetTxPackets);
+    vMetricsAdd(MetricNetTxBytes, sPb->tot_len);
+
+    vPcapCapture(sPb, PcapDirTx);
+
+    xRetVal = pfNetStatsLinkOutput(sNetif, sPb);
+
+    if (ERR_OK != xRetVal)
+    {
+        vMetricsInc(MetricNetTxFailed);
+    }
+
+    return (xRetVal);
+}
+
+
+static void vNetStatsCopyMem(sNetStatsMem_t *const sMem, const struct stats_mem *sStats)
+{
+    if (NULL != sStats)
+    {
+        sMem->uAvail = sStats->avail;
+        sMem->uUsed  = sStats->used;
+        sMem->uMax   = sStats->max;
+        sMem->uErr   = sStats->err;
+    }
+}
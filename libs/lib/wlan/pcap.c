@@ -0,0 +1,784 @@
+/** ****************************************************************************
+ * @file   pcap.c
+ *
+ * @author Michael R.
+ *
+ * @brief  Capture of the STA netif traffic, streamed as pcapng via TCP
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+// pico-sdk includes
+#include "pico/cyw43_arch.h"
+#include "pico/time.h"
+#include "lwip/tcp.h"
+
+// FreeRTOS includes
+#include "FreeRTOS.h" /* Must come first. */
+#include "task.h"
+
+// Project includes
+#include "wlan/pcap.h"
+
+#include "global/debug_print.h"
+#include "global/event_bus.h"
+#include "global/metrics.h"
+#include "global/spsc_ring.h"
+#include "wlan/mysntp.h"
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+#define PCAP_PRIORITY       (tskIDLE_PRIORITY + 1UL)
+#define PCAP_STACK          (512UL)
+
+#if (PCAP_SNAP_MAX > 255U) || (0U != (PCAP_SNAP_MAX % 4U))
+    #error "PCAP_SNAP_MAX must be a multiple of 4 below 256"
+#endif
+
+#define PCAP_ETH_HLEN       (14U)
+#define PCAP_ETH_IPV4       (0x0800U)
+#define PCAP_ETH_ARP        (0x0806U)
+#define PCAP_ARP_LEN        (28U)
+#define PCAP_IP_TCP         (6U)
+#define PCAP_IP_UDP         (17U)
+#define PCAP_IP_ICMP        (1U)
+
+/** The filter in one word: port, protocol and snap length */
+#define PCAP_FILTER(_PORT, _PROTO, _SNAP) \
+    ((uint32_t)(_PORT) | ((uint32_t)(_PROTO) << 16U) | ((uint32_t)(_SNAP) << 24U))
+
+/** pcapng block types */
+#define PCAPNG_SHB          (0x0A0D0D0AUL)
+#define PCAPNG_IDB          (0x00000001UL)
+#define PCAPNG_EPB          (0x00000006UL)
+#define PCAPNG_MAGIC        (0x1A2B3C4DUL)
+#define PCAPNG_LINK_ETH     (1U)
+
+/** epb_flags: inbound / outbound */
+#define PCAPNG_FLAG_IN      (1UL)
+#define PCAPNG_FLAG_OUT     (2UL)
+
+/* --- Local type/struct definitions ---------------------------------------- */
+
+/**
+ * @brief Captured frame, one ring slot
+ */
+typedef struct sPcapSlot_tag
+{
+    uint64_t uTimeUs;          ///< time_us_64() of the capture
+    uint16_t uOrigLen;         ///< Length on the wire
+    uint16_t uCapLen;          ///< Bytes in uaData
+    uint8_t uaData[PCAP_SNAP_MAX];
+} sPcapSlot_t;
+
+/**
+ * @brief State of one direction, written by its producer only
+ */
+typedef struct sPcapProducer_tag
+{
+    uint32_t uWindowUs;        ///< Start of the current budget second
+    uint32_t uCount;           ///< Frames captured in it
+    uint8_t uaScratch[PCAP_SNAP_MAX]; ///< Frame copy while the ring is full
+} sPcapProducer_t;
+
+/**
+ * @brief Result of the header parser
+ */
+typedef struct sPcapInfo_tag
+{
+    ePcapProto_t eProto;       ///< PcapProtoAny: none of the others
+    uint16_t uSrc;             ///< Ports, 0 without transport header
+    uint16_t uDst;
+} sPcapInfo_t;
+
+/**
+ * @brief Section header block
+ */
+typedef struct sPcapngShb_tag
+{
+    uint32_t uType;
+    uint32_t uLen;
+    uint32_t uMagic;
+    uint16_t uMajor;
+    uint16_t uMinor;
+    uint32_t uaSectionLen[2]; ///< -1: not specified (a stream)
+    uint32_t uLenEnd;
+} sPcapngShb_t;
+
+/**
+ * @brief Interface description block with if_name and if_tsresol
+ */
+typedef struct sPcapngIdb_tag
+{
+    uint32_t uType;
+    uint32_t uLen;
+    uint16_t uLinkType;
+    uint16_t uReserved;
+    uint32_t uSnapLen;
+    uint16_t uOptName;
+    uint16_t uOptNameLen;
+    char caName[8];
+    uint16_t uOptTsres;
+    uint16_t uOptTsresLen;
+    uint8_t uaTsres[4];
+    uint16_t uOptEnd;
+    uint16_t uOptEndLen;
+    uint32_t uLenEnd;
+} sPcapngIdb_t;
+
+/**
+ * @brief Stream header: SHB followed by the IDB
+ */
+typedef struct sPcapngHeader_tag
+{
+    sPcapngShb_t sShb;
+    sPcapngIdb_t sIdb;
+} sPcapngHeader_t;
+
+/**
+ * @brief Enhanced packet block in front of the frame
+ */
+typedef struct sPcapngEpb_tag
+{
+    uint32_t uType;
+    uint32_t uLen;
+    uint32_t uInterface;
+    uint32_t uTimeHigh;
+    uint32_t uTimeLow;
+    uint32_t uCapLen;
+    uint32_t uOrigLen;
+} sPcapngEpb_t;
+
+/**
+ * @brief Enhanced packet block behind the (padded) frame, with epb_flags
+ */
+typedef struct sPcapngEpbEnd_tag
+{
+    uint16_t uOptFlags;
+    uint16_t uOptFlagsLen;
+    uint32_t uFlags;
+    uint16_t uOptEnd;
+    uint16_t uOptEndLen;
+    uint32_t uLenEnd;
+} sPcapngEpbEnd_t;
+
+typedef struct sPcapState_tag
+{
+    struct tcp_pcb *sListenPcb;
+    struct tcp_pcb *sPcb;       ///< Client, NULL if none (lwIP lock)
+    bool bNew;                  ///< Client without header yet (lwIP lock)
+} sPcapState_t;
+
+/* --- Static variables ----------------------------------------------------- */
+
+static sPcapState_t sPcapState = {NULL, NULL, false};
+
+static TaskHandle_t xPcapTask = NULL;
+
+/** Set by the task once the header is sent, read by the producers */
+static volatile bool bPcapActive = false;
+
+/** Packed filter, see PCAP_FILTER */
+static volatile uint32_t uPcapFilter = PCAP_FILTER(0U, PcapProtoAny, 0U);
+
+static sSpscRing_t saPcapRing[NumPcapDir];
+static sPcapSlot_t saPcapSlots[NumPcapDir][PCAP_SLOTS];
+static sPcapProducer_t saPcapProducer[NumPcapDir];
+
+/** One block in the making, see uPcapBuildEpb */
+static uint32_t uaPcapBlock[(sizeof(sPcapngEpb_t) + PCAP_SNAP_MAX + sizeof(sPcapngEpbEnd_t)) / 4U];
+
+/** Link state, skips the lwIP lock while the link is down */
+static volatile bool bPcapLinkUp = false;
+
+static sEventSub_t sPcapLinkUpSub;
+static sEventSub_t sPcapLinkDownSub;
+
+static const sPcapngHeader_t sPcapngHeader =
+{
+    .sShb =
+    {
+        .uType        = PCAPNG_SHB,
+        .uLen         = sizeof(sPcapngShb_t),
+        .uMagic       = PCAPNG_MAGIC,
+        .uMajor       = 1U,
+        .uMinor       = 0U,
+        .uaSectionLen = {0xFFFFFFFFUL, 0xFFFFFFFFUL},
+        .uLenEnd      = sizeof(sPcapngShb_t),
+    },
+    .sIdb =
+    {
+        .uType        = PCAPNG_IDB,
+        .uLen         = sizeof(sPcapngIdb_t),
+        .uLinkType    = PCAPNG_LINK_ETH,
+        .uReserved    = 0U,
+        .uSnapLen     = PCAP_SNAP_MAX,
+        .uOptName     = 2U,     // if_name
+        .uOptNameLen  = 5U,
+        .caName       = "cyw43",
+        .uOptTsres    = 9U,     // if_tsresol
+        .uOptTsresLen = 1U,
+        .uaTsres      = {6U},   // us
+        .uOptEnd      = 0U,
+        .uOptEndLen   = 0U,
+        .uLenEnd      = sizeof(sPcapngIdb_t),
+    },
+};
+
+/* --- Static function prototypes ------------------------------------------- */
+
+/**
+ * @brief EventLinkUp/EventLinkDown: start listening, pause the stream
+ *
+ * @param eEvent Event
+ * @param uArg   IPv4 address
+ */
+static void vPcapOnLink(const eEvent_t eEvent, const uint32_t uArg);
+
+/**
+ * @brief Stream task: sends the captured frames every PCAP_FLUSH_MS
+ *
+ * @param pvParameters Unused
+ */
+static void vPcapTask(void *pvParameters);
+
+/**
+ * @brief lwIP accept callback, replaces the current client
+ */
+static err_t xPcapAccept(void *pvArg, struct tcp_pcb *sPcb, err_t xErr);
+
+/**
+ * @brief lwIP receive callback, discards the input, closes on FIN
+ */
+static err_t xPcapRecv(void *pvArg, struct tcp_pcb *sPcb, struct pbuf *sPb, err_t xErr);
+
+/**
+ * @brief lwIP error callback, the pcb is already gone
+ */
+static void vPcapErr(void *pvArg, err_t xErr);
+
+/**
+ * @brief Close the client connection. lwIP lock must be held.
+ *
+ * @return ERR_ABRT if the connection had to be aborted
+ */
+static err_t xPcapClose(void);
+
+/**
+ * @brief Discard all captured frames (consumer)
+ */
+static void vPcapDrain(void);
+
+/**
+ * @brief Write the captured frames, oldest first, while the send buffer
+ *        takes them. lwIP lock must be held.
+ */
+static void vPcapSend(void);
+
+/**
+ * @brief Build the enhanced packet block of a frame in uaPcapBlock
+ *
+ * @param sSlot     Frame
+ * @param eDir      Direction
+ * @param uOffsetUs Unix time minus time_us_64()
+ *
+ * @return Length of the block
+ */
+static uint32_t uPcapBuildEpb(const sPcapSlot_t *const sSlot, const ePcapDir_t eDir, const uint64_t uOffsetUs);
+
+/**
+ * @brief Find protocol, ports and the length of the headers
+ *
+ * @param puData Frame (Ethernet)
+ * @param uLen   Bytes in puData
+ * @param sInfo  Result
+ *
+ * @return Length of the Ethernet, IP and transport headers
+ */
+static uint32_t uPcapParse(const uint8_t *const puData, const uint32_t uLen, sPcapInfo_t *const sInfo);
+
+/**
+ * @brief Check a frame against the filter, the own stream never matches
+ *
+ * @param sInfo   Parsed frame
+ * @param uFilter Packed filter
+ *
+ * @return true if the frame is captured
+ */
+static bool bPcapMatch(const sPcapInfo_t *const sInfo, const uint32_t uFilter);
+
+/* --- Public functions ----------------------------------------------------- */
+
+eRetVal_t ePcapPreInit(void)
+{
+    eRetVal_t eRetVal = ErrNoError;
+
+    for (uint32_t i = 0U; i < NumPcapDir; i++)
+    {
+        vSpscInit(&saPcapRing[i], saPcapSlots[i], sizeof(sPcapSlot_t), PCAP_SLOTS);
+    }
+
+    vEventSubscribe(&sPcapLinkUpSub, EventLinkUp, vPcapOnLink, EventOrderNormal);
+    vEventSubscribe(&sPcapLinkDownSub, EventLinkDown, vPcapOnLink, EventOrderFirst);
+
+    return (eRetVal);
+}
+
+
+eRetVal_t ePcapRtosInit(void)
+{
+    eRetVal_t eRetVal = ErrNoError;
+    BaseType_t xReturned;
+
+    xReturned = xTaskCreate(
+                    vPcapTask,
+                    "Pcap",
+                    PCAP_STACK,
+                    NULL,
+                    PCAP_PRIORITY,
+                    &xPcapTask);
+
+    if (pdPASS != xReturned)
+    {
+        eRetVal = ErrError;
+    }
+
+    return (eRetVal);
+}
+
+
+void vPcapStart(void)
+{
+    struct tcp_pcb *sPcb;
+
+    cyw43_arch_lwip_begin();
+
+    if (NULL == sPcapState.sListenPcb)
+    {
+        sPcb = tcp_new_ip_type(IPADDR_TYPE_ANY);
+
+        if ((NULL != sPcb) && (ERR_OK == tcp_bind(sPcb, IP_ANY_TYPE, PCAP_PORT)))
+        {
+            sPcapState.sListenPcb = tcp_listen_with_backlog(sPcb, 1U);
+            tcp_accept(sPcapState.sListenPcb, xPcapAccept);
+        }
+        else if (NULL != sPcb)
+        {
+            tcp_close(sPcb);
+        }
+    }
+
+    cyw43_arch_lwip_end();
+
+    if (NULL == sPcapState.sListenPcb)
+    {
+        DBG_PR(DBG_ERROR, FN_TCPUDP, "Listen on port %d failed!\n", PCAP_PORT);
+    }
+}
+
+
+void vPcapCapture(const struct pbuf *sPb, const ePcapDir_t eDir)
+{
+    sPcapProducer_t *const sProd = &saPcapProducer[eDir];
+    sPcapSlot_t *sSlot;
+    uint8_t *puData;
+    uint32_t uFilter;
+    uint32_t uNowUs;
+    uint32_t uLen;
+    uint32_t uHdrLen;
+    sPcapInfo_t sInfo;
+
+    if (bPcapActive)
+    {
+        uFilter = uPcapFilter;
+        uNowUs = time_us_32();
+
+        if ((uNowUs - sProd->uWindowUs) >= 1000000UL)
+        {
+            sProd->uWindowUs = uNowUs;
+            sProd->uCount = 0UL;
+        }
+
+        // A full ring still needs the copy to tell a drop from a filtered frame
+        sSlot = (sPcapSlot_t *)pvSpscReserve(&saPcapRing[eDir]);
+        puData = (NULL != sSlot) ? sSlot->uaData : sProd->uaScratch;
+
+        uLen = pbuf_copy_partial(sPb, puData, PCAP_SNAP_MAX, 0U);
+        uHdrLen = uPcapParse(puData, uLen, &sInfo);
+
+        // A filtered frame leaves the reserved slot to the next one
+        if (bPcapMatch(&sInfo, uFilter))
+        {
+            if ((NULL == sSlot) || (sProd->uCount >= PCAP_MAX_PPS))
+            {
+                vMetricsInc(MetricPcapDropped);
+            }
+            else
+            {
+                uHdrLen += (uFilter >> 24U);
+                sSlot->uTimeUs  = time_us_64();
+                sSlot->uOrigLen = sPb->tot_len;
+                sSlot->uCapLen  = (uint16_t)((uHdrLen < uLen) ? uHdrLen : uLen);
+                vSpscCommit(&saPcapRing[eDir]);
+
+                sProd->uCount++;
+                vMetricsInc(MetricPcapPackets);
+            }
+        }
+    }
+}
+
+
+void vPcapSetFilter(const sPcapFilter_t *const sFilter)
+{
+    const uint32_t uSnap = (sFilter->uSnap < PCAP_SNAP_MAX) ? sFilter->uSnap : PCAP_SNAP_MAX;
+
+    uPcapFilter = PCAP_FILTER(sFilter->uPort, sFilter->eProto, uSnap);
+}
+
+
+void vPcapGetFilter(sPcapFilter_t *const sFilter)
+{
+    const uint32_t uFilter = uPcapFilter;
+
+    sFilter->uPort  = (uint16_t)(uFilter & 0xFFFFUL);
+    sFilter->eProto = (ePcapProto_t)((uFilter >> 16U) & 0xFFUL);
+    sFilter->uSnap  = (uint16_t)(uFilter >> 24U);
+}
+
+/* --- Static functions ----------------------------------------------------- */
+
+static void vPcapOnLink(const eEvent_t eEvent, const uint32_t uArg)
+{
+    (void)uArg; // Silence 'unused parameters'
+
+    bPcapLinkUp = (EventLinkUp == eEvent);
+
+    if (bPcapLinkUp)
+    {
+        vPcapStart();
+
+        // A waiting client resumes
+        if (NULL != xPcapTask)
+        {
+            xTaskNotifyGive(xPcapTask);
+        }
+    }
+}
+
+
+static void vPcapTask(void *pvParameters)
+{
+    (void)pvParameters; // Silence 'unused parameters'
+
+    bool bClient = false;
+
+    while (1)
+    {
+        // Without a client or a link only the accept or the link up wakes the task
+        (void)ulTaskNotifyTake(pdTRUE, (bClient && bPcapLinkUp) ? pdMS_TO_TICKS(PCAP_FLUSH_MS) : portMAX_DELAY);
+
+        // Without a link there is nothing to send, leave lwIP alone
+        if (bPcapLinkUp)
+        {
+            cyw43_arch_lwip_begin();
+
+            bClient = (NULL != sPcapState.sPcb);
+
+            if (!bClient)
+            {
+                bPcapActive = false;
+                vPcapDrain();
+            }
+            else
+            {
+                if (sPcapState.bNew)
+                {
+                    // The stream of a new client starts with the header, without old frames
+                    bPcapActive = false;
+                    vPcapDrain();
+                    if (ERR_OK == tcp_write(sPcapState.sPcb, &sPcapngHeader, sizeof(sPcapngHeader), TCP_WRITE_FLAG_COPY))
+                    {
+                        sPcapState.bNew = false;
+                        bPcapActive = true;
+                    }
+                }
+
+                if (bPcapActive)
+                {
+                    vPcapSend();
+                }
+
+                (void)tcp_output(sPcapState.sPcb);
+            }
+
+            cyw43_arch_lwip_end();
+        }
+    }
+}
+
+
+static err_t xPcapAccept(void *pvArg, struct tcp_pcb *sPcb, err_t xErr)
+{
+    (void)pvArg; // Silence 'unused parameters'
+
+    err_t xRetVal = ERR_OK;
+
+    if ((ERR_OK != xErr) || (NULL == sPcb))
+    {
+        xRetVal = ERR_VAL;
+    }
+    else
+    {
+        if (NULL != sPcapState.sPcb)
+        {
+            (void)xPcapClose();
+        }
+
+        sPcapState.sPcb = sPcb;
+        sPcapState.bNew = true;
+
+        tcp_arg(sPcb, NULL);
+        tcp_recv(sPcb, xPcapRecv);
+        tcp_err(sPcb, vPcapErr);
+        // The task batches itself
+        tcp_nagle_disable(sPcb);
+
+        if (NULL != xPcapTask)
+        {
+            xTaskNotifyGive(xPcapTask);
+        }
+
+        DBG_PR(DBG_INFO, FN_TCPUDP, "Capture client %s connected\n", ipaddr_ntoa(&sPcb->remote_ip));
+    }
+
+    return (xRetVal);
+}
+
+
+static err_t xPcapRecv(void *pvArg, struct tcp_pcb *sPcb, struct pbuf *sPb, err_t xErr)
+{
+    (void)pvArg; // Silence 'unused parameters'
+    (void)xErr;
+
+    err_t xRetVal = ERR_OK;
+
+    if (NULL == sPb)
+    {
+        // Closed by the client
+        xRetVal = xPcapClose();
+    }
+    else
+    {
+        tcp_recved(sPcb, sPb->tot_len);
+        pbuf_free(sPb);
+    }
+
+    return (xRetVal);
+}
+
+
+static void vPcapErr(void *pvArg, err_t xErr)
+{
+    (void)pvArg; // Silence 'unused parameters'
+    (void)xErr;
+
+    sPcapState.sPcb = NULL;
+}
+
+
+static err_t xPcapClose(void)
+{
+    err_t xRetVal = ERR_OK;
+    struct tcp_pcb *const sPcb = sPcapState.sPcb;
+
+    tcp_recv(sPcb, NULL);
+    tcp_err(sPcb, NULL);
+
+    if (ERR_OK != tcp_close(sPcb))
+    {
+        tcp_abort(sPcb);
+        xRetVal = ERR_ABRT;
+    }
+
+    sPcapState.sPcb = NULL;
+
+    return (xRetVal);
+}
+
+
+static void vPcapDrain(void)
+{
+    for (uint32_t i = 0U; i < NumPcapDir; i++)
+    {
+        while (NULL != pvSpscPeek(&saPcapRing[i]))
+        {
+            vSpscRelease(&saPcapRing[i]);
+        }
+    }
+}
+
+
+static void vPcapSend(void)
+{
+    // Time stamps are taken with the cheap timer, converted here
+    const uint64_t uOffsetUs = uSntpGetTimeUs() - time_us_64();
+    const sPcapSlot_t *sRx;
+    const sPcapSlot_t *sTx;
+    ePcapDir_t eDir;
+    uint32_t uLen;
+    bool bMore = true;
+
+    while (bMore)
+    {
+        sRx = (const sPcapSlot_t *)pvSpscPeek(&saPcapRing[PcapDirRx]);
+        sTx = (const sPcapSlot_t *)pvSpscPeek(&saPcapRing[PcapDirTx]);
+
+        if ((NULL == sRx) && (NULL == sTx))
+        {
+            bMore = false;
+        }
+        else
+        {
+            eDir = ((NULL == sRx) || ((NULL != sTx) && (sTx->uTimeUs < sRx->uTimeUs))) ? PcapDirTx : PcapDirRx;
+            uLen = uPcapBuildEpb((PcapDirRx == eDir) ? sRx : sTx, eDir, uOffsetUs);
+
+            // A full send buffer keeps the frame, the rings fill up and the producers drop
+            if ((tcp_sndbuf(sPcapState.sPcb) < uLen) ||
+                (ERR_OK != tcp_write(sPcapState.sPcb, uaPcapBlock, (u16_t)uLen, TCP_WRITE_FLAG_COPY)))
+            {
+                bMore = false;
+            }
+            else
+            {
+                vSpscRelease(&saPcapRing[eDir]);
+            }
+        }
+    }
+}
+
+
+static uint32_t uPcapBuildEpb(const sPcapSlot_t *const sSlot, const ePcapDir_t eDir, const uint64_t uOffsetUs)
+{
+    uint8_t *const puBlock = (uint8_t *)uaPcapBlock;
+    const uint32_t uPadded = (sSlot->uCapLen + 3UL) & ~3UL;
+    const uint32_t uLen = sizeof(sPcapngEpb_t) + uPadded + sizeof(sPcapngEpbEnd_t);
+    const uint64_t uTimeUs = sSlot->uTimeUs + uOffsetUs;
+    sPcapngEpb_t sEpb;
+    sPcapngEpbEnd_t sEnd;
+
+    sEpb.uType      = PCAPNG_EPB;
+    sEpb.uLen       = uLen;
+    sEpb.uInterface = 0UL;
+    sEpb.uTimeHigh  = (uint32_t)(uTimeUs >> 32U);
+    sEpb.uTimeLow   = (uint32_t)uTimeUs;
+    sEpb.uCapLen    = sSlot->uCapLen;
+    sEpb.uOrigLen   = sSlot->uOrigLen;
+
+    sEnd.uOptFlags    = 2U;     // epb_flags
+    sEnd.uOptFlagsLen = 4U;
+    sEnd.uFlags       = (PcapDirRx == eDir) ? PCAPNG_FLAG_IN : PCAPNG_FLAG_OUT;
+    sEnd.uOptEnd      = 0U;
+    sEnd.uOptEndLen   = 0U;
+    sEnd.uLenEnd      = uLen;
+
+    memcpy(puBlock, &sEpb, sizeof(sEpb));
+    memcpy(&puBlock[sizeof(sEpb)], sSlot->uaData, sSlot->uCapLen);
+    memset(&puBlock[sizeof(sEpb) + sSlot->uCapLen], 0, uPadded - sSlot->uCapLen);
+    memcpy(&puBlock[sizeof(sEpb) + uPadded], &sEnd, sizeof(sEnd));
+
+    return (uLen);
+}
+
+
+static uint32_t uPcapParse(const uint8_t *const puData, const uint32_t uLen, sPcapInfo_t *const sInfo)
+{
+    uint32_t uHdrLen = PCAP_ETH_HLEN;
+    uint32_t uL4;
+    uint32_t uType;
+
+    sInfo->eProto = PcapProtoAny;
+    sInfo->uSrc = 0U;
+    sInfo->uDst = 0U;
+
+    uType = (uLen >= PCAP_ETH_HLEN) ? (((uint32_t)puData[12] << 8U) | puData[13]) : 0UL;
+
+    if (PCAP_ETH_ARP == uType)
+    {
+        sInfo->eProto = PcapProtoArp;
+        uHdrLen += PCAP_ARP_LEN;
+    }
+    else if ((PCAP_ETH_IPV4 == uType) && (uLen >= (PCAP_ETH_HLEN + 20U)))
+    {
+        uL4 = PCAP_ETH_HLEN + (4U * (puData[PCAP_ETH_HLEN] & 0x0FU));
+        uHdrLen = uL4;
+
+        switch (puData[PCAP_ETH_HLEN + 9U])
+        {
+            case PCAP_IP_TCP:
+                sInfo->eProto = PcapProtoTcp;
+                uHdrLen += 20U;
+                break;
+
+            case PCAP_IP_UDP:
+                sInfo->eProto = PcapProtoUdp;
+                uHdrLen += 8U;
+                break;
+
+            case PCAP_IP_ICMP:
+                sInfo->eProto = PcapProtoIcmp;
+                uHdrLen += 8U;
+                break;
+
+            default:
+                break;
+        }
+
+        // Only the first fragment carries the transport header
+        if ((0U == (((puData[PCAP_ETH_HLEN + 6U] & 0x1FU) << 8U) | puData[PCAP_ETH_HLEN + 7U])) &&
+            ((PcapProtoTcp == sInfo->eProto) || (PcapProtoUdp == sInfo->eProto)) &&
+            (uLen >= (uL4 + 4U)))
+        {
+            sInfo->uSrc = (uint16_t)(((uint32_t)puData[uL4] << 8U) | puData[uL4 + 1U]);
+            sInfo->uDst = (uint16_t)(((uint32_t)puData[uL4 + 2U] << 8U) | puData[uL4 + 3U]);
+
+            if ((PcapProtoTcp == sInfo->eProto) && (uLen > (uL4 + 12U)))
+            {
+                // TCP options
+                uHdrLen = uL4 + (4U * (puData[uL4 + 12U] >> 4U));
+            }
+        }
+    }
+
+    return (uHdrLen);
+}
+
+
+static bool bPcapMatch(const sPcapInfo_t *const sInfo, const uint32_t uFilter)
+{
+    const uint16_t uPort = (uint16_t)(uFilter & 0xFFFFUL);
+    const ePcapProto_t eProto = (ePcapProto_t)((uFilter >> 16U) & 0xFFUL);
+    bool bRetVal;
+
+    // Never the own stream
+    bRetVal = !((PcapProtoTcp == sInfo->eProto) && ((PCAP_PORT == sInfo->uSrc) || (PCAP_PORT == sInfo->uDst)));
+
+    if (bRetVal && (PcapProtoAny != eProto))
+    {
+        bRetVal = (eProto == sInfo->eProto);
+    }
+
+    if (bRetVal && (0U != uPort))
+    {
+        bRetVal = (uPort == sInfo->uSrc) || (uPort == sInfo->uDst);
+    }
+
+    return (bRetVal);
+}
@@ -0,0 +1,529 @@
+/** ****************************************************************************
+ * @file   remote_ctrl.c
+ *
+ * @author Michael R.
+ *
+ * @brief  Authenticated runtime control of the debug output via UDP
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// pico-sdk includes
+#include "pico/cyw43_arch.h"
+#include "pico/aon_timer.h"
+#include "lwip/pbuf.h"
+#include "lwip/udp.h"
+
+// FreeRTOS includes
+// Project includes
+#include "wlan/remote_ctrl.h"
+
+#include "global/debug_print.h"
+#include "global/dvfs.h"
+#include "global/event_bus.h"
+#include "global/metrics.h"
+#include "global/sha1.h"
+#include "global/utils.h"
+#include "wlan/pcap.h"
+
+
+/**
+ * @brief  This file is not part of the public package.
+ *
+ * Besides the WLAN credentials it may contain the key of the remote control:
+ *
+ *  #define CTRL_KEY "a long random string"
+ */
+#if __has_include("_wlan_credentials.h")
+#include "_wlan_credentials.h"
+#endif
+
+#ifndef CTRL_KEY
+#define CTRL_KEY ""
+#endif
+
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+#define CTRL_KEY_LEN     (sizeof(CTRL_KEY) - 1U)
+
+/** Longest command text (without HMAC) */
+#define CTRL_MAX_TEXT    (128U)
+
+/** Size of the reply text */
+#define CTRL_REPLY_SIZE  (256U)
+
+/** Maximum number of words of a command */
+#define CTRL_MAX_ARGS    (4U)
+
+/** The clock is considered set via SNTP above this time (2001) */
+#define CTRL_TIME_VALID  (1000000000LL)
+
+/* --- Local type/struct definitions ---------------------------------------- */
+
+typedef struct sCtrlState_tag
+{
+    struct udp_pcb *sPcb;
+    uint64_t uLastNonce;                        ///< Nonce of the last accepted command
+} sCtrlState_t;
+
+/* --- Static variables ----------------------------------------------------- */
+
+static sCtrlState_t sCtrlState = {NULL, 0ULL};
+
+static sEventSub_t sCtrlLinkUpSub;
+
+static uint8_t uaCtrlRx[SHA1_DIGEST_SIZE + CTRL_MAX_TEXT + 1U];
+static uint8_t uaCtrlTx[SHA1_DIGEST_SIZE + CTRL_REPLY_SIZE];
+
+static const char *const caCtrlClass[NumCl] =
+{
+    [FN_UNKNOWN]   = "unknown",
+    [FN_MAIN]      = "main",
+    [FN_WLAN]      = "wlan",
+    [FN_SNTP]      = "sntp",
+    [FN_TCPUDP]    = "tcpudp",
+    [FN_TELEMETRY] = "telemetry",
+    [FN_HTTP]      = "http",
+    [FN_MQTT]      = "mqtt",
+    [FN_CTRL]      = "ctrl",
+    [FN_POWER]     = "power",
+};
+
+static const char *const caCtrlPcapProto[NumPcapProto] =
+{
+    [PcapProtoAny]  = "any",
+    [PcapProtoTcp]  = "tcp",
+    [PcapProtoUdp]  = "udp",
+    [PcapProtoIcmp] = "icmp",
+    [PcapProtoArp]  = "arp",
+};
+
+/* --- Static function prototypes ------------------------------------------- */
+
+/**
+ * @brief EventLinkUp: start listening
+ *
+ * @param eEvent Event
+ * @param uArg   IPv4 address
+ */
+static void vCtrlOnLinkUp(const eEvent_t eEvent, const uint32_t uArg);
+
+/**
+ * @brief lwIP receive callback, checks and executes a command
+ */
+static void vCtrlRecv(void *pvArg, struct udp_pcb *sPcb, struct pbuf *sPb, const ip_addr_t *sAddr, u16_t uPort);
+
+/**
+ * @brief Check the HMAC and the nonce of a received command
+ *
+ * @param uLen    Length of the datagram in uaCtrlRx
+ * @param uNonce  Target for the nonce
+ * @param bTimed  Returns true if the nonce was checked against the clock
+ *
+ * @return true if the command is authentic and new
+ */
+static bool bCtrlCheck(const uint32_t uLen, uint64_t *const uNonce, bool *const bTimed);
+
+/**
+ * @brief Execute a command
+ *
+ * @param cpaArg  Words of the command (without nonce)
+ * @param uArgs   Number of words
+ * @param bTimed  The nonce was checked against the clock, else only reading
+ *                commands are executed
+ * @param cpReply Target for the reply text
+ * @param uSize   Size of the target
+ *
+ * @return true on success
+ */
+static bool bCtrlExecute(
+    char *const cpaArg[],
+    const uint32_t uArgs,
+    const bool bTimed,
+    char *const cpReply,
+    const uint32_t uSize);
+
+/**
+ * @brief Look up a name in a table
+ *
+ * @param cpName  Name
+ * @param cpaList Table
+ * @param uNum    Entries in the table
+ *
+ * @return Index or uNum if not found
+ */
+static uint32_t uCtrlLookup(const char *cpName, const char *const cpaList[], const uint32_t uNum);
+
+/* --- Public functions ----------------------------------------------------- */
+
+eRetVal_t eRemoteCtrlPreInit(void)
+{
+    eRetVal_t eRetVal = ErrNoError;
+
+    vEventSubscribe(&sCtrlLinkUpSub, EventLinkUp, vCtrlOnLinkUp, EventOrderNormal);
+
+    return (eRetVal);
+}
+
+
+void vRemoteCtrlStart(void)
+{
+    struct udp_pcb *sPcb;
+
+    cyw43_arch_lwip_begin();
+
+    if ((NULL == sCtrlState.sPcb) && (0U != CTRL_KEY_LEN))
+    {
+        sPcb = udp_new_ip_type(IPADDR_TYPE_ANY);
+
+        if ((NULL != sPcb) && (ERR_OK == udp_bind(sPcb, IP_ANY_TYPE, CTRL_PORT)))
+        {
+            udp_recv(sPcb, vCtrlRecv, NULL);
+            sCtrlState.sPcb = sPcb;
+        }
+        else if (NULL != sPcb)
+        {
+            udp_remove(sPcb);
+        }
+    }
+
+    cyw43_arch_lwip_end();
+
+    if (0U == CTRL_KEY_LEN)
+    {
+        DBG_PR(DBG_WARN, FN_CTRL, "No CTRL_KEY, remote control disabled\n");
+    }
+    else if (NULL == sCtrlState.sPcb)
+    {
+        DBG_PR(DBG_ERROR, FN_CTRL, "Listen on port %d failed!\n", CTRL_PORT);
+    }
+}
+
+/* --- Static functions ----------------------------------------------------- */
+
+static void vCtrlOnLinkUp(const eEvent_t eEvent, const uint32_t uArg)
+{
+    (void)eEvent; // Silence 'unused parameters'
+    (void)uArg;
+
+    vRemoteCtrlStart();
+}
+
+
+static void vCtrlRecv(void *pvArg, struct udp_pcb *sPcb, struct pbuf *sPb, const ip_addr_t *sAddr, u16_t uPort)
+{
+    (void)pvArg; // Silence 'unused parameters'
+
+    char *cpaArg[CTRL_MAX_ARGS];
+    char *cpText;
+    char *cpSave;
+    char *const cpReply = (char *)&uaCtrlTx[SHA1_DIGEST_SIZE];
+    struct pbuf *sTx;
+    uint64_t uNonce = 0ULL;
+    bool bTimed = false;
+    uint32_t uLen;
+    uint32_t uArgs = 0U;
+    uint32_t uReplyLen;
+
+    uLen = sPb->tot_len;
+    if (uLen <= (SHA1_DIGEST_SIZE + CTRL_MAX_TEXT))
+    {
+        (void)pbuf_copy_partial(sPb, uaCtrlRx, uLen, 0U);
+    }
+    pbuf_free(sPb);
+
+    if ((uLen <= SHA1_DIGEST_SIZE) || (uLen > (SHA1_DIGEST_SIZE + CTRL_MAX_TEXT)) || !bCtrlCheck(uLen, &uNonce, &bTimed))
+    {
+        vMetricsInc(MetricCtrlRejected);
+        DBG_PR(DBG_WARN, FN_CTRL, "Rejected command from %s\n", ipaddr_ntoa(sAddr));
+    }
+    else
+    {
+        // Text behind the HMAC, the nonce is the first word
+        uaCtrlRx[uLen] = '\0';
+        cpText = strtok_r((char *)&uaCtrlRx[SHA1_DIGEST_SIZE], " \r\n", &cpSave);
+        while ((NULL != cpText) && (uArgs < CTRL_MAX_ARGS))
+        {
+            cpText = strtok_r(NULL, " \r\n", &cpSave);
+            if (NULL != cpText)
+            {
+                cpaArg[uArgs++] = cpText;
+            }
+        }
+
+        uReplyLen = (uint32_t)snprintf(cpReply, CTRL_REPLY_SIZE, "%llu ", uNonce);
+        if (bCtrlExecute(cpaArg, uArgs, bTimed, &cpReply[uReplyLen], CTRL_REPLY_SIZE - uReplyLen))
+        {
+            vMetricsInc(MetricCtrlCommands);
+        }
+        DBG_PR(DBG_INFO, FN_CTRL, "%s: %s\n", ipaddr_ntoa(sAddr), &cpReply[uReplyLen]);
+        uReplyLen += strlen(&cpReply[uReplyLen]);
+
+        vHmacSha1(
+            (const uint8_t *)CTRL_KEY,
+            CTRL_KEY_LEN,
+            (const uint8_t *)cpReply,
+            uReplyLen,
+            uaCtrlTx);
+
+        // Already in the lwIP context (callback), no lwip_begin needed
+        sTx = pbuf_alloc(PBUF_TRANSPORT, (u16_t)(SHA1_DIGEST_SIZE + uReplyLen), PBUF_RAM);
+        if (NULL != sTx)
+        {
+            memcpy(sTx->payload, uaCtrlTx, SHA1_DIGEST_SIZE + uReplyLen);
+            if (ERR_OK != udp_sendto(sPcb, sTx, sAddr, uPort))
+            {
+                vMetricsInc(MetricUdpSendFailed);
+            }
+            pbuf_free(sTx);
+        }
+    }
+}
+
+
+static bool bCtrlCheck(const uint32_t uLen, uint64_t *const uNonce, bool *const bTimed)
+{
+    uint8_t uaMac[SHA1_DIGEST_SIZE];
+    uint8_t uDiff = 0U;
+    char caNonce[24];
+    uint32_t uPos = 0U;
+    struct timespec sTime;
+    int64_t iDelta;
+    bool bOk;
+
+    vHmacSha1(
+        (const uint8_t *)CTRL_KEY,
+        CTRL_KEY_LEN,
+        &uaCtrlRx[SHA1_DIGEST_SIZE],
+        uLen - SHA1_DIGEST_SIZE,
+        uaMac);
+
+    // Constant time compare
+    for (uint32_t i = 0U; i < SHA1_DIGEST_SIZE; i++)
+    {
+        uDiff |= uaMac[i] ^ uaCtrlRx[i];
+    }
+    bOk = (0U == uDiff);
+
+    if (bOk)
+    {
+        while (((SHA1_DIGEST_SIZE + uPos) < uLen) && (uPos < (sizeof(caNonce) - 1U)) &&
+               (uaCtrlRx[SHA1_DIGEST_SIZE + uPos] >= '0') && (uaCtrlRx[SHA1_DIGEST_SIZE + uPos] <= '9'))
+        {
+            caNonce[uPos] = (char)uaCtrlRx[SHA1_DIGEST_SIZE + uPos];
+            uPos++;
+        }
+        caNonce[uPos] = '\0';
+
+        *uNonce = strtoull(caNonce, NULL, 10);
+        bOk = (0U != uPos) && (*uNonce > sCtrlState.uLastNonce);
+    }
+
+    // Replays of old commands after a reboot are caught by the time window.
+    // Without it the last nonce in RAM (0 after a reboot) is the only guard.
+    *bTimed = aon_timer_get_time(&sTime) && (sTime.tv_sec > CTRL_TIME_VALID);
+    if (bOk && *bTimed)
+    {
+        iDelta = (int64_t)(*uNonce / 1000ULL) - (int64_t)sTime.tv_sec;
+        bOk = (iDelta <= (int64_t)CTRL_WINDOW_S) && (iDelta >= -(int64_t)CTRL_WINDOW_S);
+    }
+
+    if (bOk)
+    {
+        sCtrlState.uLastNonce = *uNonce;
+    }
+
+    return (bOk);
+}
+
+
+static bool bCtrlExecute(
+    char *const cpaArg[],
+    const uint32_t uArgs,
+    const bool bTimed,
+    char *const cpReply,
+    const uint32_t uSize)
+{
+    const bool bReading = (1U == uArgs) && ((0 == strcmp(cpaArg[0], "get")) || (0 == strcmp(cpaArg[0], "stats")));
+    bool bOk = false;
+    bool bAll = false;
+    uint32_t uClass = NumCl;
+    sDebugSink_t *sSink;
+    uint32_t uPos;
+    long iValue;
+    sDvfsPolicy_t sPolicy;
+    sPcapFilter_t sFilter;
+
+    cpReply[0] = '\0';
+
+    if (uArgs >= 2U)
+    {
+        bAll   = (0 == strcmp(cpaArg[1], "all"));
+        uClass = uCtrlLookup(cpaArg[1], caCtrlClass, NumCl);
+    }
+
+    if (!bTimed && !bReading)
+    {
+        // A replayed command could change the settings, wait for SNTP
+        vMetricsInc(MetricCtrlRejected);
+        snprintf(cpReply, uSize, "err no time");
+    }
+    else if ((1U == uArgs) && (0 == strcmp(cpaArg[0], "get")))
+    {
+        // Sized for all classes and outputs, see CTRL_REPLY_SIZE. Appends stop
+        // once the reply is full, snprintf keeps it terminated.
+#define CTRL_APPEND(...)                                                      \
+    do                                                                        \
+    {                                                                         \
+        if (uPos < uSize)                                                     \
+        {                                                                     \
+            const int iLen = snprintf(&cpReply[uPos], uSize - uPos, __VA_ARGS__); \
+            uPos = (iLen < 0) ? uSize : (uPos + (uint32_t)iLen);              \
+        }                                                                     \
+    } while (0)
+
+        uPos = 0U;
+        CTRL_APPEND("ok level");
+        for (uint32_t i = 0U; i < NumCl; i++)
+        {
+            CTRL_APPEND(" %s=%d", caCtrlClass[i], (int)eDebugGetSeverity((function_t)i));
+        }
+
+        CTRL_APPEND(" sink");
+        for (sSink = sDebugSinkFirst(); (NULL != sSink) && (uPos < uSize); sSink = sSink->sNext)
+        {
+            if (sSink->bEnabled)
+            {
+                CTRL_APPEND(" %s=%d", sSink->cpName, (int)sSink->eLevel);
+            }
+            else
+            {
+                CTRL_APPEND(" %s=off", sSink->cpName);
+            }
+        }
+
+        vDvfsGetPolicy(&sPolicy);
+        CTRL_APPEND(" dvfs %lu %lu %lu",
+                    sPolicy.uUpPermille, sPolicy.uTargetPermille, sPolicy.uDownPeriods);
+
+        vPcapGetFilter(&sFilter);
+        CTRL_APPEND(" pcap %s %u %u",
+                    caCtrlPcapProto[sFilter.eProto], sFilter.uPort, sFilter.uSnap);
+
+#undef CTRL_APPEND
+        bOk = true;
+    }
+    else if ((3U == uArgs) && (0 == strcmp(cpaArg[0], "level")) && (bAll || (uClass < NumCl)))
+    {
+        iValue = strtol(cpaArg[2], NULL, 10);
+        if ((iValue >= DBG_OFF) && (iValue < NumDbgLvl))
+        {
+            for (uint32_t i = 0U; i < NumCl; i++)
+            {
+                if (bAll || (i == uClass))
+                {
+                    vDebugSetSeverity((function_t)i, (logLevel_t)iValue);
+                }
+            }
+            vEventPublish(EventConfigChanged, EventCfgLogLevel);
+            bOk = true;
+        }
+    }
+    else if ((3U == uArgs) && (0 == strcmp(cpaArg[0], "sink")))
+    {
+        // Built-in or user-defined sink, switched or given a level
+        sSink = sDebugSinkFind(cpaArg[1]);
+        iValue = strtol(cpaArg[2], NULL, 10);
+        if ((NULL != sSink) && ((0 == strcmp(cpaArg[2], "on")) || (0 == strcmp(cpaArg[2], "off"))))
+        {
+            vDebugSinkEnable(sSink, (0 == strcmp(cpaArg[2], "on")));
+            bOk = true;
+        }
+        else if ((NULL != sSink) && isdigit((unsigned char)cpaArg[2][0]) && (iValue < NumDbgLvl))
+        {
+            vDebugSinkSetLevel(sSink, (logLevel_t)iValue);
+            bOk = true;
+        }
+
+        if (bOk)
+        {
+            vEventPublish(EventConfigChanged, EventCfgLogSink);
+        }
+    }
+    else if ((4U == uArgs) && (0 == strcmp(cpaArg[0], "rate")) && (bAll || (uClass < NumCl)))
+    {
+        for (uint32_t i = 0U; i < NumCl; i++)
+        {
+            if (bAll || (i == uClass))
+            {
+                vDebugSetRateLimit(
+                    (function_t)i,
+                    (uint16_t)strtoul(cpaArg[2], NULL, 10),
+                    (uint16_t)strtoul(cpaArg[3], NULL, 10));
+            }
+        }
+        vEventPublish(EventConfigChanged, EventCfgLogRate);
+        bOk = true;
+    }
+    else if ((4U == uArgs) && (0 == strcmp(cpaArg[0], "dvfs")))
+    {
+        sPolicy.uUpPermille     = strtoul(cpaArg[1], NULL, 10);
+        sPolicy.uTargetPermille = strtoul(cpaArg[2], NULL, 10);
+        sPolicy.uDownPeriods    = strtoul(cpaArg[3], NULL, 10);
+        if (IS_NO_ERR(eDvfsSetPolicy(&sPolicy)))
+        {
+            vEventPublish(EventConfigChanged, EventCfgDvfs);
+            bOk = true;
+        }
+    }
+    else if ((4U == uArgs) && (0 == strcmp(cpaArg[0], "pcap")))
+    {
+        sFilter.eProto = (ePcapProto_t)uCtrlLookup(cpaArg[1], caCtrlPcapProto, NumPcapProto);
+        sFilter.uPort  = (uint16_t)strtoul(cpaArg[2], NULL, 10);
+        sFilter.uSnap  = (uint16_t)strtoul(cpaArg[3], NULL, 10);
+        if (sFilter.eProto < NumPcapProto)
+        {
+            vPcapSetFilter(&sFilter);
+            bOk = true;
+        }
+    }
+    else if ((1U == uArgs) && (0 == strcmp(cpaArg[0], "stats")))
+    {
+        vMetricsExportNow();
+        bOk = true;
+    }
+
+    if (!bOk && ('\0' == cpReply[0]))
+    {
+        snprintf(cpReply, uSize, "err");
+    }
+    else if (bOk && ('\0' == cpReply[0]))
+    {
+        snprintf(cpReply, uSize, "ok");
+    }
+
+    return (bOk);
+}
+
+
+static uint32_t uCtrlLookup(const char *cpName, const char *const cpaList[], const uint32_t uNum)
+{
+    uint32_t uIndex = 0U;
+
+    while ((uIndex < uNum) && (0 != strcmp(cpName, cpaList[uIndex])))
+    {
+        uIndex++;
+    }
+
+    return (uIndex);
+}
@@ -11,27 +11,38 @@
 /* --- Includes ------------------------------------------------------------- */
 
 // libc includes
+#include <errno.h>
 #include <string.h>
 
 // pico-sdk includes
 #include "pico/cyw43_arch.h"
+#include "pico/time.h"
 #include "lwip/sockets.h"
+#include "lwip/netdb.h"
 #include "lwip/udp.h"
 
 // FreeRTOS includes
 #include "FreeRTOS.h" /* Must come first. */
 #include "task.h"
 #include "queue.h"
+#include "timers.h"
 
 // Project includes
 #include "wlan/tcp_udp.h"
+#include "wlan/mysntp.h"
+#include "wlan/wlan.h"
 #include "wlan/wlan_state.h"
+#include "wlan/tls.h"
 
+#include "global/dbg_format.h"
 #include "global/debug_print.h"
+#include "global/log_lz.h"
+#include "global/metrics.h"
+#include "global/ram_func.h"
+#include "global/xip_profile.h"
 
 /* --- Local macro definitions ---------------------------------------------- */
 
-#define HOST_IP_ADDR ((const char*)IP_ADDR_ANY) // Broadcast
 #define TCP_UDP_SEN_QUEUE_LEN (5U)
 
 
@@ -41,6 +52,9 @@ typedef struct sUdpConf_tag
 {
     ip_addr_t tIp;
     uint16_t uPort;
+    eTcpUdpLogDest_t eDest;
+    bool bDestOk;                     ///< false: unicast set to the subnet broadcast
+    struct udp_pcb *sPcb;
 
     QueueHandle_t xUdpSendPointerQueue;
 } sUdpConf_t;
@@ -57,15 +71,85 @@ typedef struct sTcpUdpState_tag
     sTcpConf_t sTcp;
 } sTcpUdpState_t;
 
+#if HOST_LOG_COMPRESS
+/**
+ * @brief Datagram of the compressed log stream, header + LZSS data
+ */
+typedef struct sLogLzConf_tag
+{
+    sLogLz_t sLz;
+    uint8_t uaDatagram[HOST_LOG_DATAGRAM];
+    TimerHandle_t xFlushTimer;
+    sDebugSink_t *sSink;              ///< UDP sink, its task flushes
+    volatile bool bDue;               ///< Set by the timer
+} sLogLzConf_t;
+#endif
+
 
 /* --- Static variables ----------------------------------------------------- */
 
 static sTcpUdpState_t sTcpUdpState;
-struct pbuf *sPb;
+
+/** Copy of the record (with prefix), only the LogSink task sends (see global/debug_print.h) */
+static char caUdpRecord[HOST_LOG_SEQ_SIZE + MAX_UDP_BUFFER];
+
+#if HOST_LOG_SEQ
+static uint32_t uUdpRecordSeq = 0UL;
+#endif
+
+#if HOST_LOG_COMPRESS
+static sLogLzConf_t sLogLzConf;
+#endif
 
 
 /* --- Static function prototypes ------------------------------------------- */
 
+/**
+ * @brief Check a log destination and resolve its address
+ *
+ * @param eDest  Destination mode
+ * @param cpAddr Address in dotted notation, ignored for broadcast
+ * @param tIp    Resolved address
+ *
+ * @return ErrError if the mode or address is invalid
+ */
+static eRetVal_t eTcpUdpParseLogDest(const eTcpUdpLogDest_t eDest, const char *cpAddr, ip_addr_t *const tIp);
+
+/**
+ * @brief Check a unicast destination against the subnet of the STA netif
+ *
+ * Call with the lwIP lock held. Without an address the subnet is unknown
+ * and every destination passes.
+ *
+ * @param eDest  Destination mode
+ * @param tIp    Destination address
+ *
+ * @return false if a unicast destination is the subnet broadcast
+ */
+static bool bTcpUdpDestOk(const eTcpUdpLogDest_t eDest, const ip_addr_t *tIp);
+
+#if HOST_LOG_COMPRESS
+/**
+ * @brief Compress a log line into the current datagram
+ *
+ * @param cpMessage Log line
+ * @param uLen      Length of the line
+ */
+static void vTcpUdpLogLzAppend(const char *cpMessage, const uint16_t uLen);
+
+/**
+ * @brief Send the current datagram and start a new one
+ */
+static void vTcpUdpLogLzSend(void);
+
+/**
+ * @brief Flush timer, lets the LogSink task send a partially filled datagram
+ *
+ * @param xTimer Unused
+ */
+static void vTcpUdpLogLzTimerCB(TimerHandle_t xTimer);
+#endif
+
 /* --- Public functions ----------------------------------------------------- */
 
 eRetVal_t eTcpUdpRtosInit(void)
@@ -75,7 +159,14 @@ eRetVal_t eTcpUdpRtosInit(void)
     DBG_PR(DBG_INFO, FN_TCPUDP, "\n");
     sTcpUdpState.sTcp.iSocket = -1;
 
-    sTcpUdpState.sUdp.tIp.addr = ipaddr_addr(HOST_IP_ADDR);
+    sTcpUdpState.sUdp.sPcb = NULL;
+
+    // The driver (and with it the lwIP lock) does not exist yet, nobody else
+    // reads the destination before the socket is opened
+    eRetVal = eTcpUdpParseLogDest(HOST_LOG_DEST, HOST_LOG_ADDR, &sTcpUdpState.sUdp.tIp);
+    sTcpUdpState.sUdp.eDest = HOST_LOG_DEST;
+    sTcpUdpState.sUdp.bDestOk = true;
+
     sTcpUdpState.sUdp.xUdpSendPointerQueue =
                             xQueueCreate(TCP_UDP_SEN_QUEUE_LEN, sizeof(char *));
 
@@ -84,6 +175,30 @@ eRetVal_t eTcpUdpRtosInit(void)
         eRetVal = ErrError;
     }
 
+#if HOST_LOG_COMPRESS
+    vLogLzReset(&sLogLzConf.sLz, &sLogLzConf.uaDatagram[4], HOST_LOG_DATAGRAM - 4U);
+    sLogLzConf.sSink = sDebugSinkFind("udp");
+    sLogLzConf.bDue = false;
+    sLogLzConf.xFlushTimer = xTimerCreate(
+                                "LogLz",
+                                pdMS_TO_TICKS(HOST_LOG_FLUSH_MS),
+                                pdFALSE,
+                                NULL,
+                                vTcpUdpLogLzTimerCB);
+
+    if ((NULL == sLogLzConf.sSink) || (NULL == sLogLzConf.xFlushTimer))
+    {
+        eRetVal = ErrError;
+    }
+#endif
+
+#if TLS_ENABLED
+    if (IS_NO_ERR(eRetVal))
+    {
+        eRetVal = eTlsRtosInit();
+    }
+#endif
+
     return(eRetVal);
 }
 
@@ -98,6 +213,30 @@ eRetVal_t eTcpUdpOpenSocket(const eTcpUdpSocketType_t eType, const uint16_t uPor
     if (eType == IP_UDP)
     {
         sTcpUdpState.sUdp.uPort = uPort;
+
+        cyw43_arch_lwip_begin();
+        if (NULL == sTcpUdpState.sUdp.sPcb)
+        {
+            sTcpUdpState.sUdp.sPcb = udp_new();
+        }
+
+        if (NULL == sTcpUdpState.sUdp.sPcb)
+        {
+            eRetVal = ErrError;
+        }
+        else
+        {
+            udp_set_multicast_ttl(sTcpUdpState.sUdp.sPcb, HOST_LOG_MCAST_TTL);
+        }
+
+        // The subnet of the default destination is only known now
+        sTcpUdpState.sUdp.bDestOk = bTcpUdpDestOk(sTcpUdpState.sUdp.eDest, &sTcpUdpState.sUdp.tIp);
+        cyw43_arch_lwip_end();
+
+        if (!sTcpUdpState.sUdp.bDestOk)
+        {
+            DBG_PR(DBG_ERROR, FN_TCPUDP, "Unicast log destination is the subnet broadcast, not sent!\n");
+        }
     }
     else if (eType == IP_TCP)
     {
@@ -112,6 +251,13 @@ void vTcpUdpCloseSocket(const eTcpUdpSocketType_t eType)
 {
     if (eType == IP_UDP)
     {
+        cyw43_arch_lwip_begin();
+        if (NULL != sTcpUdpState.sUdp.sPcb)
+        {
+            udp_remove(sTcpUdpState.sUdp.sPcb);
+            sTcpUdpState.sUdp.sPcb = NULL;
+        }
+        cyw43_arch_lwip_end();
     }
     else if (eType == IP_TCP)
     {
@@ -121,6 +267,38 @@ void vTcpUdpCloseSocket(const eTcpUdpSocketType_t eType)
 }
 
 
+eRetVal_t eTcpUdpSetLogDest(const eTcpUdpLogDest_t eDest, const char *cpAddr)
+{
+    eRetVal_t eRetVal;
+    ip_addr_t tIp;
+
+    eRetVal = eTcpUdpParseLogDest(eDest, cpAddr, &tIp);
+
+    if (IS_NO_ERR(eRetVal))
+    {
+        cyw43_arch_lwip_begin();
+        if (bTcpUdpDestOk(eDest, &tIp))
+        {
+            ip_addr_copy(sTcpUdpState.sUdp.tIp, tIp);
+            sTcpUdpState.sUdp.eDest = eDest;
+            sTcpUdpState.sUdp.bDestOk = true;
+        }
+        else
+        {
+            eRetVal = ErrError;
+        }
+        cyw43_arch_lwip_end();
+
+        if (IS_ERR(eRetVal))
+        {
+            DBG_PR(DBG_ERROR, FN_TCPUDP, "Unicast log destination is the subnet broadcast!\n");
+        }
+    }
+
+    return (eRetVal);
+}
+
+
 void vTcpUdpSendTcp(char *const cpMessage)
 {
     if (sTcpUdpState.sTcp.iSocket != -1)
@@ -134,26 +312,420 @@ void vTcpUdpSendTcp(char *const cpMessage)
 }
 
 
-void vTcpUdpPrintUdp(char *const cpMessage)
+eRetVal_t eTcpUdpConnect(sTcpUdpConn_t *const sConn, const char *cpHost, const uint16_t uPort)
 {
-    struct udp_pcb* sPcb;
+    eRetVal_t eRetVal = ErrNoError;
+    const struct addrinfo sHints = {
+        .ai_family = AF_INET,
+        .ai_socktype = SOCK_STREAM,
+    };
+    struct addrinfo *sResult = NULL;
+    struct sockaddr_in sAddr;
+    const int iOne = 1;
+
+    sConn->iSocket = -1;
+    sConn->uRecvTimeoutMs = 0UL;
+    sConn->pvTls = NULL;
+
+    if ((0 != lwip_getaddrinfo(cpHost, NULL, &sHints, &sResult)) || (NULL == sResult))
+    {
+        DBG_PR(DBG_WARN, FN_TCPUDP, "Cannot resolve %s\n", cpHost);
+        eRetVal = ErrError;
+    }
+    else
+    {
+        memcpy(&sAddr, sResult->ai_addr, sizeof(sAddr));
+        sAddr.sin_port = lwip_htons(uPort);
+        lwip_freeaddrinfo(sResult);
+
+        sConn->iSocket = lwip_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+        if (sConn->iSocket < 0)
+        {
+            eRetVal = ErrError;
+        }
+        else if (0 != lwip_connect(sConn->iSocket, (struct sockaddr *)&sAddr, sizeof(sAddr)))
+        {
+            DBG_PR(DBG_WARN, FN_TCPUDP, "Connect to %s:%d failed\n", cpHost, uPort);
+            vTcpUdpDisconnect(sConn);
+            eRetVal = ErrError;
+        }
+        else
+        {
+            lwip_setsockopt(sConn->iSocket, IPPROTO_TCP, TCP_NODELAY, &iOne, sizeof(iOne));
+        }
+    }
+
+    return (eRetVal);
+}
+
+
+eRetVal_t eTcpUdpConnectTls(sTcpUdpConn_t *const sConn, const char *cpHost, const uint16_t uPort)
+{
+    eRetVal_t eRetVal = ErrError;
+
+#if TLS_ENABLED
+    eRetVal = eTcpUdpConnect(sConn, cpHost, uPort);
+
+    if (IS_NO_ERR(eRetVal))
+    {
+        eRetVal = eTlsHandshake(sConn->iSocket, cpHost, &sConn->pvTls);
+
+        if (IS_ERR(eRetVal))
+        {
+            vTcpUdpDisconnect(sConn);
+        }
+    }
+#else
+    (void)sConn;
+    (void)cpHost;
+    (void)uPort;
+    DBG_PR(DBG_ERROR, FN_TCPUDP, "TLS support not enabled\n");
+#endif
+
+    return (eRetVal);
+}
+
+
+eRetVal_t eTcpUdpWrite(sTcpUdpConn_t *const sConn, const uint8_t *pData, const uint32_t uLen)
+{
+    eRetVal_t eRetVal = ErrNoError;
+    uint32_t uSent = 0UL;
+    ssize_t iRet;
+
+#if TLS_ENABLED
+    if (NULL != sConn->pvTls)
+    {
+        eRetVal = eTlsWrite(sConn->pvTls, pData, uLen);
+        uSent = uLen;
+    }
+#endif
 
-    //Make sure that the buffer is NULL terminated
-    cpMessage[MAX_UDP_BUFFER - 1U] = '\0';
+    while (IS_NO_ERR(eRetVal) && (uSent < uLen))
+    {
+        iRet = lwip_send(sConn->iSocket, &pData[uSent], uLen - uSent, 0);
+
+        if (iRet <= 0)
+        {
+            eRetVal = ErrError;
+        }
+        else
+        {
+            uSent += (uint32_t)iRet;
+        }
+    }
 
-    sPb = pbuf_alloc(PBUF_TRANSPORT, MAX_UDP_BUFFER, PBUF_REF);
-    sPb->payload = cpMessage;
-    sPb->len = strnlen(cpMessage, MAX_UDP_BUFFER);
-    sPb->tot_len = strnlen(cpMessage, MAX_UDP_BUFFER);
+    return (eRetVal);
+}
 
-    sPcb = udp_new();
 
-    cyw43_arch_lwip_begin();
-    udp_sendto(sPcb, sPb, &sTcpUdpState.sUdp.tIp, sTcpUdpState.sUdp.uPort);
-    cyw43_arch_lwip_end();
-    udp_remove(sPcb);
+int32_t iTcpUdpRead(
+    sTcpUdpConn_t *const sConn,
+    uint8_t *const pBuffer,
+    const uint32_t uSize,
+    const uint32_t uTimeoutMs)
+{
+    int32_t iRetVal;
+    struct timeval sTimeout;
+    int iFlags = 0;
 
-    pbuf_free(sPb);
+#if TLS_ENABLED
+    if (NULL != sConn->pvTls)
+    {
+        iRetVal = iTlsRead(sConn->pvTls, pBuffer, uSize, uTimeoutMs);
+    }
+    else
+#endif
+    {
+        if (0UL == uTimeoutMs)
+        {
+            iFlags = MSG_DONTWAIT;
+        }
+        else if (uTimeoutMs != sConn->uRecvTimeoutMs)
+        {
+            sTimeout.tv_sec = uTimeoutMs / 1000UL;
+            sTimeout.tv_usec = (uTimeoutMs % 1000UL) * 1000UL;
+            lwip_setsockopt(sConn->iSocket, SOL_SOCKET, SO_RCVTIMEO, &sTimeout, sizeof(sTimeout));
+            sConn->uRecvTimeoutMs = uTimeoutMs;
+        }
+
+        iRetVal = lwip_recv(sConn->iSocket, pBuffer, uSize, iFlags);
+
+        if (iRetVal < 0)
+        {
+            // Timeout is no error
+            iRetVal = ((EWOULDBLOCK == errno) || (EAGAIN == errno)) ? 0 : -1;
+        }
+        else if (0 == iRetVal)
+        {
+            // Orderly shutdown by the peer
+            iRetVal = -1;
+        }
+    }
+
+    return (iRetVal);
+}
+
+
+void vTcpUdpDisconnect(sTcpUdpConn_t *const sConn)
+{
+#if TLS_ENABLED
+    if (NULL != sConn->pvTls)
+    {
+        vTlsClose(sConn->pvTls);
+        sConn->pvTls = NULL;
+    }
+#endif
+
+    if (sConn->iSocket >= 0)
+    {
+        lwip_close(sConn->iSocket);
+        sConn->iSocket = -1;
+    }
+}
+
+
+void RAM_FUNC(RAM_HOT_UDP, vTcpUdpPrintUdp)(const char *cpMessage, const uint16_t uLen)
+{
+    const uint32_t uStartUs = time_us_32();
+    sXipProbe_t sProbe;
+    uint32_t uPrefixLen = 0UL;
+    uint16_t uRecordLen;
+#if !HOST_LOG_COMPRESS
+    struct pbuf *sPb;
+#endif
+
+    vXipProbeStart(&sProbe);
+
+#if HOST_LOG_SEQ
+    // Counted before sending, so local send errors show up as loss as well
+    uPrefixLen = uDbgFormat(
+                    caUdpRecord,
+                    HOST_LOG_SEQ_SIZE,
+                    "#%lu@%llu ",
+                    uUdpRecordSeq++,
+                    uSntpGetTimeUs());
+#endif
+
+    // The record is shared with the other sinks, only the copy is sent
+    uRecordLen = (uLen < MAX_UDP_BUFFER) ? uLen : (uint16_t)(MAX_UDP_BUFFER - 1U);
+    memcpy(&caUdpRecord[uPrefixLen], cpMessage, uRecordLen);
+    uRecordLen += (uint16_t)uPrefixLen;
+
+#if HOST_LOG_COMPRESS
+    vTcpUdpLogLzAppend(caUdpRecord, uRecordLen);
+#else
+    // The pcb is created and removed under the lock, read it only there.
+    // The lock itself only exists while the driver is up.
+    if (bWlanDriverUp())
+    {
+        cyw43_arch_lwip_begin();
+        if ((NULL != sTcpUdpState.sUdp.sPcb) && sTcpUdpState.sUdp.bDestOk)
+        {
+            sPb = pbuf_alloc(PBUF_TRANSPORT, uRecordLen, PBUF_REF);
+
+            if (NULL != sPb)
+            {
+                sPb->payload = caUdpRecord;
+                sPb->len = uRecordLen;
+                sPb->tot_len = sPb->len;
+
+                if (ERR_OK != udp_sendto(
+                                sTcpUdpState.sUdp.sPcb,
+                                sPb,
+                                &sTcpUdpState.sUdp.tIp,
+                                sTcpUdpState.sUdp.uPort))
+                {
+                    vMetricsInc(MetricUdpSendFailed);
+                }
+                pbuf_free(sPb);
+            }
+            else
+            {
+                vMetricsInc(MetricUdpSendFailed);
+            }
+        }
+        cyw43_arch_lwip_end();
+    }
+#endif
+
+    vMetricsObserve(MetricLogUdpUs, time_us_32() - uStartUs);
+    vXipProbeEnd(&sProbe, MetricUdpXipMiss);
+}
+
+
+void vTcpUdpFlushUdp(const bool bLinkUp)
+{
+#if HOST_LOG_COMPRESS
+    if (sLogLzConf.bDue)
+    {
+        if (bLinkUp)
+        {
+            vTcpUdpLogLzSend();
+        }
+        else
+        {
+            // Lost like the records without a link
+            sLogLzConf.bDue = false;
+            vLogLzReset(&sLogLzConf.sLz, &sLogLzConf.uaDatagram[4], HOST_LOG_DATAGRAM - 4U);
+        }
+    }
+#else
+    (void)bLinkUp; // Silence 'unused parameters'
+#endif
+}
+
+
+
+eRetVal_t RAM_FUNC(RAM_HOT_UDP, eTcpUdpSendUdp)(const uint8_t *pData, const uint16_t uLen, const uint16_t uPort)
+{
+    eRetVal_t eRetVal = ErrError;
+    struct pbuf *sPb;
+
+    // The pcb is created and removed under the lock, read it only there.
+    // The lock itself only exists while the driver is up.
+    if (bWlanDriverUp())
+    {
+        cyw43_arch_lwip_begin();
+        if ((NULL != sTcpUdpState.sUdp.sPcb) && sTcpUdpState.sUdp.bDestOk)
+        {
+            sPb = pbuf_alloc(PBUF_TRANSPORT, uLen, PBUF_REF);
+
+            if (NULL != sPb)
+            {
+                sPb->payload = (void *)pData;
+
+                if (ERR_OK == udp_sendto(
+                                sTcpUdpState.sUdp.sPcb,
+                                sPb,
+                                &sTcpUdpState.sUdp.tIp,
+                                uPort))
+                {
+                    eRetVal = ErrNoError;
+                }
+                pbuf_free(sPb);
+            }
+        }
+        cyw43_arch_lwip_end();
+    }
+
+    if (IS_ERR(eRetVal))
+    {
+        vMetricsInc(MetricUdpSendFailed);
+    }
+
+    return (eRetVal);
 }
 
 /* --- Static functions ----------------------------------------------------- */
+
+static eRetVal_t eTcpUdpParseLogDest(const eTcpUdpLogDest_t eDest, const char *cpAddr, ip_addr_t *const tIp)
+{
+    eRetVal_t eRetVal = ErrNoError;
+
+    switch (eDest)
+    {
+    case LogDestBroadcast:
+        ip_addr_set_ip4_u32(tIp, IPADDR_BROADCAST);
+        break;
+
+    case LogDestMulticast:
+        if ((NULL == cpAddr) ||
+            (0 == ipaddr_aton(cpAddr, tIp)) ||
+            !ip_addr_ismulticast(tIp))
+        {
+            eRetVal = ErrError;
+        }
+        break;
+
+    case LogDestUnicast:
+        // The subnet broadcast is checked against the netif, see bTcpUdpDestOk
+        if ((NULL == cpAddr) ||
+            (0 == ipaddr_aton(cpAddr, tIp)) ||
+            ip_addr_ismulticast(tIp) ||
+            ip_addr_isany(tIp) ||
+            (IPADDR_BROADCAST == ip_addr_get_ip4_u32(tIp)))
+        {
+            eRetVal = ErrError;
+        }
+        break;
+
+    default:
+        eRetVal = ErrError;
+        break;
+    }
+
+    if (IS_ERR(eRetVal))
+    {
+        DBG_PR(DBG_ERROR, FN_TCPUDP, "Invalid log destination (%d)!\n", eDest);
+    }
+
+    return (eRetVal);
+}
+
+
+static bool bTcpUdpDestOk(const eTcpUdpLogDest_t eDest, const ip_addr_t *tIp)
+{
+    const struct netif *sNetif = &cyw43_state.netif[CYW43_ITF_STA];
+    bool bOk = true;
+
+    if ((LogDestUnicast == eDest) && !ip4_addr_isany_val(*netif_ip4_addr(sNetif)))
+    {
+        bOk = (0U == ip4_addr_isbroadcast_u32(ip_addr_get_ip4_u32(tIp), sNetif));
+    }
+
+    return (bOk);
+}
+
+
+#if HOST_LOG_COMPRESS
+static void RAM_FUNC(RAM_HOT_UDP, vTcpUdpLogLzAppend)(const char *cpMessage, const uint16_t uLen)
+{
+    // Only the LogSink task appends and sends, no lock needed
+    if (!bLogLzAppend(&sLogLzConf.sLz, cpMessage, uLen))
+    {
+        vTcpUdpLogLzSend();
+        bLogLzAppend(&sLogLzConf.sLz, cpMessage, uLen);
+    }
+
+    // First line of a new datagram: limit its delay
+    if (uLogLzRawLen(&sLogLzConf.sLz) == uLen)
+    {
+        xTimerStart(sLogLzConf.xFlushTimer, 0U);
+    }
+}
+
+
+static void RAM_FUNC(RAM_HOT_UDP, vTcpUdpLogLzSend)(void)
+{
+    const uint16_t uRaw = uLogLzRawLen(&sLogLzConf.sLz);
+    const uint16_t uLen = sLogLzConf.sLz.uOutPos + 4U;
+
+    if (0U != uRaw)
+    {
+        // Header: 0x00 'Z' <raw length>, a text datagram never starts with 0
+        sLogLzConf.uaDatagram[0] = 0U;
+        sLogLzConf.uaDatagram[1] = 'Z';
+        sLogLzConf.uaDatagram[2] = (uint8_t)(uRaw >> 8U);
+        sLogLzConf.uaDatagram[3] = (uint8_t)uRaw;
+
+        eTcpUdpSendUdp(sLogLzConf.uaDatagram, uLen, sTcpUdpState.sUdp.uPort);
+
+        vMetricsAdd(MetricLogRawBytes, uRaw);
+        vMetricsAdd(MetricLogWireBytes, uLen);
+    }
+
+    sLogLzConf.bDue = false;
+    vLogLzReset(&sLogLzConf.sLz, &sLogLzConf.uaDatagram[4], HOST_LOG_DATAGRAM - 4U);
+}
+
+
+static void vTcpUdpLogLzTimerCB(TimerHandle_t xTimer)
+{
+    (void)xTimer;
+
+    // Timer task: must not wait for the LogSink task
+    sLogLzConf.bDue = true;
+    vDebugSinkRequestFlush(sLogLzConf.sSink);
+}
+#endif
@@ -0,0 +1,518 @@
+/** ****************************************************************************
+ * @file   tls.c
+ *
+ * @author Michael R.
+ *
+ * @brief  mbedTLS transport for the TCP connections of tcp_udp
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <errno.h>
+#include <string.h>
+
+// pico-sdk includes
+#include "pico/time.h"
+#include "lwip/sockets.h"
+
+#include "mbedtls/ssl.h"
+#include "mbedtls/net_sockets.h"
+#include "mbedtls/ctr_drbg.h"
+#include "mbedtls/entropy.h"
+#include "mbedtls/memory_buffer_alloc.h"
+#include "mbedtls/x509_crt.h"
+
+// FreeRTOS includes
+#include "FreeRTOS.h" /* Must come first. */
+#include "semphr.h"
+
+// Project includes
+#include "wlan/tls.h"
+
+#include "global/debug_print.h"
+#include "global/metrics.h"
+
+/**
+ * @brief  This file is not part of the public package.
+ *
+ * The file may contain the CA certificate(s) used to verify the server:
+ *
+ *  #define TLS_CA_CERT_PEM "-----BEGIN CERTIFICATE-----\n...\n"
+ */
+#if __has_include("_tls_credentials.h")
+#include "_tls_credentials.h"
+#endif
+
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+/**
+ * Offered cipher suites. Defaults favour AES-GCM with ECDHE on curve25519
+ * or P-256 which are the cheapest ones with forward secrecy on a Cortex-M.
+ */
+#ifndef TLS_CIPHERSUITES
+#define TLS_CIPHERSUITES                                \
+    MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256,    \
+    MBEDTLS_TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256,      \
+    MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_CCM_8
+#endif
+
+#define TLS_HANDSHAKE_TIMEOUT_MS (15UL * 1000UL)
+#define TLS_MAX_HOST             (64U)
+
+/* --- Local type/struct definitions ---------------------------------------- */
+
+typedef struct sTlsConn_tag
+{
+    bool bUsed;
+    int iSocket;
+    uint32_t uTimeoutMs;          ///< Timeout of the next socket read
+    uint32_t uSockTimeoutMs;      ///< Timeout configured at the socket
+    mbedtls_ssl_context sSsl;
+} sTlsConn_t;
+
+typedef struct sTlsCache_tag
+{
+    char caHost[TLS_MAX_HOST];
+    bool bValid;
+    mbedtls_ssl_session sSession;
+} sTlsCache_t;
+
+typedef struct sTlsState_tag
+{
+    bool bReady;
+    SemaphoreHandle_t xMutex;     ///< mbedTLS is not thread safe (RNG, heap), released while waiting for the socket
+    mbedtls_entropy_context sEntropy;
+    mbedtls_ctr_drbg_context sDrbg;
+    mbedtls_ssl_config sConf;
+    mbedtls_x509_crt sCaCert;
+    sTlsConn_t saConn[TLS_MAX_CONN];
+    sTlsCache_t saCache[TLS_MAX_CACHE];
+    uint8_t uNextCache;
+} sTlsState_t;
+
+/* --- Static variables ----------------------------------------------------- */
+
+static uint8_t uaTlsHeap[TLS_HEAP_SIZE];
+static const int iaTlsCiphersuites[] = {TLS_CIPHERSUITES, 0};
+static const uint16_t uaTlsGroups[] =
+{
+    MBEDTLS_SSL_IANA_TLS_GROUP_X25519,
+    MBEDTLS_SSL_IANA_TLS_GROUP_SECP256R1,
+    MBEDTLS_SSL_IANA_TLS_GROUP_NONE
+};
+
+static sTlsState_t sTlsState;
+
+/* --- Static function prototypes ------------------------------------------- */
+
+/**
+ * @brief mbedTLS send callback, releases the lock while sending
+ */
+static int iTlsBioSend(void *pvCtx, const unsigned char *pBuf, size_t uLen);
+
+/**
+ * @brief mbedTLS receive callback, honours uTimeoutMs of the connection and
+ *        releases the lock while waiting
+ */
+static int iTlsBioRecv(void *pvCtx, unsigned char *pBuf, size_t uLen);
+
+/**
+ * @brief Find the session cache entry of a host
+ *
+ * @param cpHost  Host name
+ * @param bCreate Re-use the oldest entry if the host is not cached
+ *
+ * @return Cache entry or NULL
+ */
+static sTlsCache_t *sTlsFindCache(const char *cpHost, const bool bCreate);
+
+/* --- Public functions ----------------------------------------------------- */
+
+eRetVal_t eTlsRtosInit(void)
+{
+    eRetVal_t eRetVal = ErrNoError;
+    int iRet;
+
+    mbedtls_memory_buffer_alloc_init(uaTlsHeap, sizeof(uaTlsHeap));
+
+    sTlsState.xMutex = xSemaphoreCreateMutex();
+    if (NULL == sTlsState.xMutex)
+    {
+        eRetVal = ErrError;
+    }
+
+    if (IS_NO_ERR(eRetVal))
+    {
+        mbedtls_entropy_init(&sTlsState.sEntropy);
+        mbedtls_ctr_drbg_init(&sTlsState.sDrbg);
+        mbedtls_ssl_config_init(&sTlsState.sConf);
+        mbedtls_x509_crt_init(&sTlsState.sCaCert);
+
+        iRet = mbedtls_ctr_drbg_seed(
+            &sTlsState.sDrbg,
+            mbedtls_entropy_func,
+            &sTlsState.sEntropy,
+            NULL,
+            0U);
+
+        if (0 == iRet)
+        {
+            iRet = mbedtls_ssl_config_defaults(
+                &sTlsState.sConf,
+                MBEDTLS_SSL_IS_CLIENT,
+                MBEDTLS_SSL_TRANSPORT_STREAM,
+                MBEDTLS_SSL_PRESET_DEFAULT);
+        }
+
+        if (0 != iRet)
+        {
+            eRetVal = ErrError;
+        }
+    }
+
+    if (IS_NO_ERR(eRetVal))
+    {
+        mbedtls_ssl_conf_rng(&sTlsState.sConf, mbedtls_ctr_drbg_random, &sTlsState.sDrbg);
+        mbedtls_ssl_conf_ciphersuites(&sTlsState.sConf, iaTlsCiphersuites);
+        mbedtls_ssl_conf_groups(&sTlsState.sConf, uaTlsGroups);
+        mbedtls_ssl_conf_max_tls_version(&sTlsState.sConf, MBEDTLS_SSL_VERSION_TLS1_2);
+        mbedtls_ssl_conf_session_tickets(&sTlsState.sConf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+        mbedtls_ssl_conf_max_frag_len(&sTlsState.sConf, MBEDTLS_SSL_MAX_FRAG_LEN_2048);
+
+#ifdef TLS_CA_CERT_PEM
+        if (0 == mbedtls_x509_crt_parse(
+                    &sTlsState.sCaCert,
+                    (const unsigned char *)TLS_CA_CERT_PEM,
+                    sizeof(TLS_CA_CERT_PEM)))
+        {
+            mbedtls_ssl_conf_ca_chain(&sTlsState.sConf, &sTlsState.sCaCert, NULL);
+            mbedtls_ssl_conf_authmode(&sTlsState.sConf, MBEDTLS_SSL_VERIFY_REQUIRED);
+        }
+        else
+        {
+            eRetVal = ErrError;
+        }
+#else
+        DBG_PR(DBG_WARN, FN_TCPUDP, "No CA certificate, server is NOT verified!\n");
+        mbedtls_ssl_conf_authmode(&sTlsState.sConf, MBEDTLS_SSL_VERIFY_NONE);
+#endif
+    }
+
+    sTlsState.bReady = IS_NO_ERR(eRetVal);
+
+    return (eRetVal);
+}
+
+
+eRetVal_t eTlsHandshake(const int iSocket, const char *cpHost, void **ppvTls)
+{
+    eRetVal_t eRetVal = ErrNoError;
+    sTlsConn_t *sConn = NULL;
+    sTlsCache_t *sCache = NULL;
+    mbedtls_ssl_session sSession;
+    const uint64_t uStartUs = time_us_64();
+    uint32_t uDurationMs;
+    bool bOffered = false;
+    bool bResumed = false;
+    int iRet;
+
+    *ppvTls = NULL;
+
+    if (!sTlsState.bReady)
+    {
+        eRetVal = ErrError;
+    }
+    else
+    {
+        xSemaphoreTake(sTlsState.xMutex, portMAX_DELAY);
+
+        for (uint32_t i = 0U; i < TLS_MAX_CONN; i++)
+        {
+            if (!sTlsState.saConn[i].bUsed)
+            {
+                sConn = &sTlsState.saConn[i];
+                break;
+            }
+        }
+
+        if (NULL == sConn)
+        {
+            eRetVal = ErrError;
+        }
+        else
+        {
+            sConn->bUsed = true;
+            sConn->iSocket = iSocket;
+            sConn->uTimeoutMs = TLS_HANDSHAKE_TIMEOUT_MS;
+            sConn->uSockTimeoutMs = 0UL;
+
+            mbedtls_ssl_init(&sConn->sSsl);
+
+            if ((0 != mbedtls_ssl_setup(&sConn->sSsl, &sTlsState.sConf)) ||
+                (0 != mbedtls_ssl_set_hostname(&sConn->sSsl, cpHost)))
+            {
+                eRetVal = ErrError;
+            }
+        }
+
+        if (IS_NO_ERR(eRetVal))
+        {
+            mbedtls_ssl_set_bio(&sConn->sSsl, sConn, iTlsBioSend, iTlsBioRecv, NULL);
+
+            sCache = sTlsFindCache(cpHost, false);
+            if ((NULL != sCache) && (0 == mbedtls_ssl_set_session(&sConn->sSsl, &sCache->sSession)))
+            {
+                bOffered = true;
+            }
+
+            do
+            {
+                iRet = mbedtls_ssl_handshake(&sConn->sSsl);
+            } while (((MBEDTLS_ERR_SSL_WANT_READ == iRet) || (MBEDTLS_ERR_SSL_WANT_WRITE == iRet)) &&
+                     ((time_us_64() - uStartUs) < (TLS_HANDSHAKE_TIMEOUT_MS * 1000ULL)));
+
+            if (0 != iRet)
+            {
+                DBG_PR(DBG_WARN, FN_TCPUDP, "TLS handshake with %s failed (-0x%04x)\n", cpHost, -iRet);
+
+                // A rejected ticket must not be offered again. Looked up anew,
+                // the entry may have been recycled while the lock was released.
+                sCache = sTlsFindCache(cpHost, false);
+                if (NULL != sCache)
+                {
+                    mbedtls_ssl_session_free(&sCache->sSession);
+                    mbedtls_ssl_session_init(&sCache->sSession);
+                    sCache->bValid = false;
+                }
+                eRetVal = ErrError;
+            }
+        }
+
+        if (IS_NO_ERR(eRetVal))
+        {
+            // Remember the (possibly new) session for the next reconnect
+            mbedtls_ssl_session_init(&sSession);
+
+            if (0 == mbedtls_ssl_get_session(&sConn->sSsl, &sSession))
+            {
+                sCache = sTlsFindCache(cpHost, true);
+
+                bResumed = bOffered && sCache->bValid &&
+                    (0 == memcmp(
+                            sSession.MBEDTLS_PRIVATE(master),
+                            sCache->sSession.MBEDTLS_PRIVATE(master),
+                            sizeof(sSession.MBEDTLS_PRIVATE(master))));
+
+                mbedtls_ssl_session_free(&sCache->sSession);
+                sCache->sSession = sSession;
+                sCache->bValid = true;
+            }
+            else
+            {
+                mbedtls_ssl_session_free(&sSession);
+            }
+
+            sConn->uTimeoutMs = 0UL;
+            *ppvTls = sConn;
+        }
+        else if (NULL != sConn)
+        {
+            mbedtls_ssl_free(&sConn->sSsl);
+            sConn->bUsed = false;
+        }
+
+        xSemaphoreGive(sTlsState.xMutex);
+    }
+
+    if (IS_NO_ERR(eRetVal))
+    {
+        uDurationMs = (uint32_t)((time_us_64() - uStartUs) / 1000ULL);
+        vMetricsObserve(MetricTlsHandshakeMs, uDurationMs);
+        vMetricsInc(bResumed ? MetricTlsResumed : MetricTlsFull);
+
+        DBG_PR(
+            DBG_INFO,
+            FN_TCPUDP,
+            "TLS %s handshake with %s took %lu ms\n",
+            bResumed ? "resumed" : "full",
+            cpHost,
+            (unsigned long)uDurationMs);
+    }
+
+    return (eRetVal);
+}
+
+
+eRetVal_t eTlsWrite(void *pvTls, const uint8_t *pData, const uint32_t uLen)
+{
+    eRetVal_t eRetVal = ErrNoError;
+    sTlsConn_t *const sConn = (sTlsConn_t *)pvTls;
+    uint32_t uSent = 0UL;
+    int iRet;
+
+    xSemaphoreTake(sTlsState.xMutex, portMAX_DELAY);
+
+    while (IS_NO_ERR(eRetVal) && (uSent < uLen))
+    {
+        iRet = mbedtls_ssl_write(&sConn->sSsl, &pData[uSent], uLen - uSent);
+
+        if (iRet > 0)
+        {
+            uSent += (uint32_t)iRet;
+        }
+        else if (MBEDTLS_ERR_SSL_WANT_WRITE != iRet)
+        {
+            eRetVal = ErrError;
+        }
+    }
+
+    xSemaphoreGive(sTlsState.xMutex);
+
+    return (eRetVal);
+}
+
+
+int32_t iTlsRead(void *pvTls, uint8_t *const pBuffer, const uint32_t uSize, const uint32_t uTimeoutMs)
+{
+    sTlsConn_t *const sConn = (sTlsConn_t *)pvTls;
+    int32_t iRetVal;
+    int iRet;
+
+    xSemaphoreTake(sTlsState.xMutex, portMAX_DELAY);
+
+    sConn->uTimeoutMs = uTimeoutMs;
+    iRet = mbedtls_ssl_read(&sConn->sSsl, pBuffer, uSize);
+
+    xSemaphoreGive(sTlsState.xMutex);
+
+    if (iRet > 0)
+    {
+        iRetVal = iRet;
+    }
+    else if ((MBEDTLS_ERR_SSL_WANT_READ == iRet) || (MBEDTLS_ERR_SSL_WANT_WRITE == iRet))
+    {
+        iRetVal = 0;
+    }
+    else
+    {
+        // Close notify, connection reset or protocol error
+        iRetVal = -1;
+    }
+
+    return (iRetVal);
+}
+
+
+void vTlsClose(void *pvTls)
+{
+    sTlsConn_t *const sConn = (sTlsConn_t *)pvTls;
+
+    if (NULL != sConn)
+    {
+        xSemaphoreTake(sTlsState.xMutex, portMAX_DELAY);
+
+        sConn->uTimeoutMs = 0UL;
+        mbedtls_ssl_close_notify(&sConn->sSsl);
+        mbedtls_ssl_free(&sConn->sSsl);
+        sConn->bUsed = false;
+
+        xSemaphoreGive(sTlsState.xMutex);
+    }
+}
+
+/* --- Static functions ----------------------------------------------------- */
+
+static int iTlsBioSend(void *pvCtx, const unsigned char *pBuf, size_t uLen)
+{
+    const sTlsConn_t *const sConn = (const sTlsConn_t *)pvCtx;
+    int iRet;
+
+    // Only this task uses the context, the others may run mbedTLS meanwhile
+    xSemaphoreGive(sTlsState.xMutex);
+    iRet = lwip_send(sConn->iSocket, pBuf, uLen, 0);
+    xSemaphoreTake(sTlsState.xMutex, portMAX_DELAY);
+
+    if (iRet < 0)
+    {
+        iRet = ((EWOULDBLOCK == errno) || (EAGAIN == errno)) ?
+            MBEDTLS_ERR_SSL_WANT_WRITE : MBEDTLS_ERR_NET_SEND_FAILED;
+    }
+
+    return (iRet);
+}
+
+
+static int iTlsBioRecv(void *pvCtx, unsigned char *pBuf, size_t uLen)
+{
+    sTlsConn_t *const sConn = (sTlsConn_t *)pvCtx;
+    struct timeval sTimeout;
+    int iFlags = 0;
+    int iRet;
+
+    if (0UL == sConn->uTimeoutMs)
+    {
+        iFlags = MSG_DONTWAIT;
+    }
+    else if (sConn->uTimeoutMs != sConn->uSockTimeoutMs)
+    {
+        sTimeout.tv_sec = sConn->uTimeoutMs / 1000UL;
+        sTimeout.tv_usec = (sConn->uTimeoutMs % 1000UL) * 1000UL;
+        lwip_setsockopt(sConn->iSocket, SOL_SOCKET, SO_RCVTIMEO, &sTimeout, sizeof(sTimeout));
+        sConn->uSockTimeoutMs = sConn->uTimeoutMs;
+    }
+
+    xSemaphoreGive(sTlsState.xMutex);
+    iRet = lwip_recv(sConn->iSocket, pBuf, uLen, iFlags);
+    xSemaphoreTake(sTlsState.xMutex, portMAX_DELAY);
+
+    if (iRet < 0)
+    {
+        iRet = ((EWOULDBLOCK == errno) || (EAGAIN == errno)) ?
+            MBEDTLS_ERR_SSL_WANT_READ : MBEDTLS_ERR_NET_RECV_FAILED;
+    }
+    else if (0 == iRet)
+    {
+        iRet = MBEDTLS_ERR_NET_CONN_RESET;
+    }
+
+    return (iRet);
+}
+
+
+static sTlsCache_t *sTlsFindCache(const char *cpHost, const bool bCreate)
+{
+    sTlsCache_t *sCache = NULL;
+
+    for (uint32_t i = 0U; i < TLS_MAX_CACHE; i++)
+    {
+        if (sTlsState.saCache[i].bValid &&
+            (0 == strncmp(sTlsState.saCache[i].caHost, cpHost, TLS_MAX_HOST)))
+        {
+            sCache = &sTlsState.saCache[i];
+            break;
+        }
+    }
+
+    if ((NULL == sCache) && bCreate)
+    {
+        // Round robin replacement
+        sCache = &sTlsState.saCache[sTlsState.uNextCache];
+        sTlsState.uNextCache = (sTlsState.uNextCache + 1U) % TLS_MAX_CACHE;
+
+        if (sCache->bValid)
+        {
+            mbedtls_ssl_session_free(&sCache->sSession);
+        }
+
+        mbedtls_ssl_session_init(&sCache->sSession);
+        strncpy(sCache->caHost, cpHost, TLS_MAX_HOST - 1U);
+        sCache->caHost[TLS_MAX_HOST - 1U] = '\0';
+        sCache->bValid = false;
+    }
+
+    return (sCache);
+}
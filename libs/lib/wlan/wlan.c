@@ -30,6 +30,8 @@
 #include "wlan/mysntp.h"
 
 #include "global/debug_print.h"
+#include "global/event_bus.h"
+#include "global/metrics.h"
 #include "global/utils.h"
 
 
@@ -88,6 +90,12 @@ static bool bWlanNeedReconnect(void);
  */
 static eRetVal_t eWlanConnect(void);
 
+/**
+ * @brief Publish EventLinkDown once per lost link. Called before the driver
+ * is de-initialised, so no subscriber takes the lwIP lock afterwards.
+ */
+static void vWlanLinkDown(void);
+
 /**
  * @brief Timer function to trigger main task on regular basis.
  *
@@ -150,6 +158,12 @@ eRetVal_t eWlanRtosInit(void)
 }
 
 
+bool bWlanDriverUp(void)
+{
+    return (sWlanGetState()->bDriverUp);
+}
+
+
 bool bWlanIsConnected(void)
 {
     bool bRetVal = false;
@@ -176,6 +190,7 @@ static void vWlanMainTask(void *pvParameters)
 
     uint32_t uNotifyVector = 0UL;
     eRetVal_t eRetVal;
+    sWlanState_t *const sState = sWlanGetState();
 
     DBG_PR(DBG_INFO, FN_WLAN, "\n");
 
@@ -184,6 +199,10 @@ static void vWlanMainTask(void *pvParameters)
         DBG_PR(DBG_INFO, FN_WLAN, "Failed to initialise.\n");
         eRetVal = ErrError;
     }
+    else
+    {
+        sState->bDriverUp = true;
+    }
 
     while (1)
     {
@@ -195,10 +214,16 @@ static void vWlanMainTask(void *pvParameters)
 
             if (true == bWlanNeedReconnect())
             {
+                vWlanLinkDown();
+
+                vMetricsInc(MetricWlanReconnects);
                 eRetVal = eWlanConnect();
                 if (IS_NO_ERR(eRetVal))
                 {
-                    vSntpStart();
+                    sState->bLinkUp = true;
+                    vEventPublish(
+                        EventLinkUp,
+                        ip4_addr_get_u32(netif_ip4_addr(&cyw43_state.netif[CYW43_ITF_STA])));
                 }
             }
         }
@@ -244,7 +269,9 @@ static bool bWlanNeedReconnect(void)
             "Unknown wifi_link_status (%d)!\n",
             iStatus);
 
+        vWlanLinkDown();
         vSntpStop();
+        sWlanGetState()->bDriverUp = false;
         cyw43_arch_deinit();
         bRetVal = true;
         break;
@@ -276,7 +303,9 @@ static bool bWlanNeedReconnect(void)
                 "Unknown cyw43_tcpip_link_status (%d)!\n",
                 iStatus);
 
+            vWlanLinkDown();
             vSntpStop();
+            sWlanGetState()->bDriverUp = false;
             cyw43_arch_deinit();
             bRetVal = true;
             break;
@@ -299,6 +328,7 @@ static eRetVal_t eWlanConnect(void)
         if (0 != cyw43_arch_wifi_connect_timeout_ms(WLAN_SSID, WLAN_PASSWORD, CYW43_AUTH_WPA2_AES_PSK, 30000))
         {
             DBG_PR(DBG_INFO, FN_WLAN, "Failed to connect.\n");
+            sWlanGetState()->bDriverUp = false;
             cyw43_arch_deinit();
             eRetVal = ErrError;
         }
@@ -312,6 +342,19 @@ static eRetVal_t eWlanConnect(void)
 }
 
 
+static void vWlanLinkDown(void)
+{
+    sWlanState_t *const sState = sWlanGetState();
+
+    // Only the transitions, not every failed attempt
+    if (sState->bLinkUp)
+    {
+        sState->bLinkUp = false;
+        vEventPublish(EventLinkDown, 0UL);
+    }
+}
+
+
 /**
  * @brief Simple timer to wake the addressed task
  *
@@ -41,10 +41,12 @@
 
 /* Scheduler Related */
 #define configUSE_PREEMPTION 1
-#define configUSE_TICKLESS_IDLE 0
-#define configUSE_IDLE_HOOK 0
+#define configUSE_TICKLESS_IDLE 0  // not in the SMP kernel, see global/tickless.h
+#define configINCLUDE_FREERTOS_TASK_C_ADDITIONS_H 1  // freertos_tasks_c_additions.h, idle time for tickless.c
+#define configUSE_IDLE_HOOK 1  // load measurement of the clock governor (dvfs)
 #define configUSE_TICK_HOOK 0
 #define configTICK_RATE_HZ ((TickType_t)1000)
+#define configSYSTICK_CLOCK_HZ 1000000  // 1 us reference, the tick stays exact when sys_clk changes
 #define configMAX_PRIORITIES 32
 #define configMINIMAL_STACK_SIZE (configSTACK_DEPTH_TYPE)256
 #define configUSE_16_BIT_TICKS 0
@@ -58,6 +60,7 @@
 #define configUSE_COUNTING_SEMAPHORES 1
 #define configQUEUE_REGISTRY_SIZE 8
 #define configUSE_QUEUE_SETS 1
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES 2  // index 1: xcore_chan wake-up
 #define configUSE_TIME_SLICING 1
 #define configUSE_NEWLIB_REENTRANT 0
 // todo need this for lwip FreeRTOS sys_arch to compile
@@ -82,8 +85,8 @@
 #define configAPPLICATION_ALLOCATED_HEAP 0
 
 /* Hook function related definitions. */
-#define configCHECK_FOR_STACK_OVERFLOW 0
-#define configUSE_MALLOC_FAILED_HOOK 0
+#define configCHECK_FOR_STACK_OVERFLOW 2
+#define configUSE_MALLOC_FAILED_HOOK 1
 #define configUSE_DAEMON_TASK_STARTUP_HOOK 0
 
 /* Run time and task stats gathering related definitions. */
@@ -106,7 +109,7 @@
 
 /* SMP port only */
 /* SMP Related config. */
-#define configUSE_PASSIVE_IDLE_HOOK 0
+#define configUSE_PASSIVE_IDLE_HOOK 1  // same for the idle task of the other core
 #define configUSE_MINIMAL_IDLE_HOOK 0
 #define portSUPPORT_SMP 1
 
@@ -0,0 +1,69 @@
+/** ****************************************************************************
+ * @file   freertos_tasks_c_additions.h
+ *
+ * @author Michael R.
+ *
+ * @brief  Additions compiled into the FreeRTOS tasks.c
+ *
+ * Included at the end of tasks.c (configINCLUDE_FREERTOS_TASK_C_ADDITIONS_H),
+ * so the functions see the private state of the kernel. The prototypes are in
+ * the headers of the users.
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+/**
+ * Ticks until the next blocked task times out, see global/tickless.h.
+ *
+ * The SMP kernel has no tickless idle of its own, this gives the idle hook
+ * what prvGetExpectedIdleTime() computes. Reads single words without the
+ * kernel lock: the caller runs with interrupts disabled on the tick core and
+ * the other core sleeps, any interrupt there wakes the tick core up.
+ */
+TickType_t xTaskGetIdleTicks(void)
+{
+    TickType_t xIdle = xNextTaskUnblockTime - xTickCount;
+
+    // Running tasks stay in the ready lists: more than the idle tasks is work
+    if ((listCURRENT_LIST_LENGTH(&(pxReadyTasksLists[tskIDLE_PRIORITY])) > configNUMBER_OF_CORES) ||
+        (0U != xPendedTicks) ||
+        (0U != uxSchedulerSuspended))
+    {
+        xIdle = 0U;
+    }
+
+    // uxTopReadyPriority is only an upper bound in the SMP kernel
+    for (UBaseType_t uxPriority = tskIDLE_PRIORITY + 1U; uxPriority <= uxTopReadyPriority; uxPriority++)
+    {
+        if (pdFALSE == listLIST_IS_EMPTY(&(pxReadyTasksLists[uxPriority])))
+        {
+            xIdle = 0U;
+        }
+    }
+
+    return (xIdle);
+}
+
+
+/**
+ * Steps the slept ticks, see global/tickless.h.
+ *
+ * xTickCount is only written on the tick core, which runs this with
+ * interrupts disabled while the other core waits for it. Stopping one tick
+ * before xNextTaskUnblockTime keeps the unblocking and the wrap of the
+ * delayed lists in xTaskIncrementTick(), as vTaskStepTick() does.
+ */
+TickType_t xTaskStepIdleTicks(const TickType_t xTicks)
+{
+    const TickType_t xToDeadline = xNextTaskUnblockTime - xTickCount;
+    TickType_t xStep = xTicks;
+
+    if (xStep >= xToDeadline)
+    {
+        xStep = (0U != xToDeadline) ? (xToDeadline - 1U) : 0U;
+    }
+
+    xTickCount += xStep;
+
+    return (xTicks - xStep);
+}
@@ -24,10 +24,18 @@
 #define LWIP_NETIF_LINK_CALLBACK    1
 #define LWIP_NETIF_HOSTNAME         1
 #define LWIP_NETCONN                0
-#define MEM_STATS                   0
-#define SYS_STATS                   0
-#define MEMP_STATS                  0
-#define LINK_STATS                  0
+// Statistics stay in release builds (wlan/net_stats.h), the display code does not
+#define LWIP_STATS                  1
+#define LWIP_STATS_LARGE            1
+#define MEM_STATS                   1
+#define SYS_STATS                   1
+#define MEMP_STATS                  1
+#define MIB2_STATS                  1
+#define LINK_STATS                  0  //< The netif hooks count the CYW43 frames
+#define ETHARP_STATS                0
+#define IPFRAG_STATS                0
+#define ICMP_STATS                  0
+#define IGMP_STATS                  0
 // #define ETH_PAD_SIZE                2
 #define LWIP_CHKSUM_ALGORITHM       3
 #define LWIP_DHCP                   1
@@ -39,10 +47,11 @@
 #define LWIP_NETIF_TX_SINGLE_PBUF   1
 #define DHCP_DOES_ARP_CHECK         0
 #define LWIP_DHCP_DOES_ACD_CHECK    0
+#define LWIP_IGMP                   1
+#define LWIP_MULTICAST_TX_OPTIONS   1
 
 #ifndef NDEBUG
 #define LWIP_DEBUG                  1
-#define LWIP_STATS                  1
 #define LWIP_STATS_DISPLAY          1
 #endif
 
@@ -98,19 +107,15 @@
 #define SNTP_SERVER_DNS           (1)
 #define SNTP_DEBUG       LWIP_DBG_OFF
 #define SNTP_TIMEOFFSET          (+2)
-#define SNTP_CHECK_RESPONSE       (0)  //< No need for precission and round-trip compensation
+#define SNTP_CHECK_RESPONSE       (2)  //< Needed for the round-trip compensation
+#define SNTP_COMP_ROUNDTRIP       (1)  //< ms accuracy, the log records are time stamped in us
 
-// Seconds are sufficient, so use the simple SNTP_SET_SYSTEM_TIME
-#ifndef SNTP_SET_SYSTEM_TIME
-#define SNTP_SET_SYSTEM_TIME(_Xsec)    \
-    do                                 \
-    {                                  \
-        struct timespec ts = {         \
-            .tv_sec  = _Xsec,          \
-            .tv_nsec = 0               \
-        };                             \
-        aon_timer_set_time(&ts);       \
-    } while (0);
+// Fraction of the second is used for the log time stamps
+#ifndef SNTP_SET_SYSTEM_TIME_US
+void vSntpSetSystemTime(const uint32_t uSeconds, const uint32_t uMicros);
+void vSntpGetSystemTime(uint32_t *const uSeconds, uint32_t *const uMicros);
+#define SNTP_SET_SYSTEM_TIME_US(_Xsec, _Xus) vSntpSetSystemTime(_Xsec, _Xus)
+#define SNTP_GET_SYSTEM_TIME(_Xsec, _Xus)    vSntpGetSystemTime(&(_Xsec), &(_Xus))
 #endif
 
 #endif /* _LWIPOPTS_H */
@@ -26,9 +26,24 @@
 
 #include "task1/task1.h"
 #include "global/debug_print.h"
+#include "global/crash_log.h"
+#include "global/dvfs.h"
+#include "global/flash_log.h"
+#include "global/metrics.h"
+#include "global/stdout_async.h"
+#include "global/tickless.h"
 #include "global/utils.h"
+#include "global/xcore_chan.h"
 #include "wlan/wlan.h"
+#include "wlan/remote_ctrl.h"
+#include "wlan/log_tcp.h"
+#include "wlan/net_stats.h"
+#include "wlan/pcap.h"
 #include "wlan/tcp_udp.h"
+#include "telemetry/telemetry.h"
+#include "http/http_server.h"
+#include "http/websocket.h"
+#include "mqtt/mqtt_client.h"
 
 
 /* --- Private macro definitions -------------------------------------------- */
@@ -111,11 +126,27 @@ static eRetVal_t eMainPreInit( void )
 {
     eRetVal_t eRetVal = ErrNoError;
 
+    if (IS_NO_ERR(eRetVal))
+    {
+        // Freeze the log of the previous run before the first message
+        eRetVal = eCrashLogPreInit();
+    }
+
+    if (IS_NO_ERR(eRetVal))
+    {
+        eRetVal = eFlashLogPreInit();
+    }
+
     if (IS_NO_ERR(eRetVal))
     {
         /* Want to be able to printf */
         stdio_init_all();
         sleep_ms(800); // Wait a bit (UART via USB takes a while)
+        eRetVal = eStdoutPreInit();
+    }
+
+    if (IS_NO_ERR(eRetVal))
+    {
         eRetVal = eDebugPreInit();
     }
 
@@ -124,6 +155,31 @@ static eRetVal_t eMainPreInit( void )
         eRetVal = eWlanPreInit();
     }
 
+    if (IS_NO_ERR(eRetVal))
+    {
+        eRetVal = eRemoteCtrlPreInit();
+    }
+
+    if (IS_NO_ERR(eRetVal))
+    {
+        eRetVal = eLogTcpPreInit();
+    }
+
+    if (IS_NO_ERR(eRetVal))
+    {
+        eRetVal = eNetStatsPreInit();
+    }
+
+    if (IS_NO_ERR(eRetVal))
+    {
+        eRetVal = ePcapPreInit();
+    }
+
+    if (IS_NO_ERR(eRetVal))
+    {
+        eRetVal = eTicklessPreInit();
+    }
+
     if (IS_NO_ERR(eRetVal))
     {
         eRetVal = eTask1HwInit();
@@ -147,6 +203,16 @@ static eRetVal_t eMainRtosInit(void)
         eRetVal = eDebugRtosInit();
     }
 
+    if (IS_NO_ERR(eRetVal))
+    {
+        eRetVal = eStdoutRtosInit();
+    }
+
+    if (IS_NO_ERR(eRetVal))
+    {
+        eRetVal = eXcoreRtosInit();
+    }
+
     if (IS_NO_ERR(eRetVal))
     {
         eRetVal = eWlanRtosInit();
@@ -157,6 +223,48 @@ static eRetVal_t eMainRtosInit(void)
         eRetVal = eTcpUdpRtosInit();
     }
 
+    if (IS_NO_ERR(eRetVal))
+    {
+        eRetVal = eTelemetryRtosInit();
+    }
+
+    if (IS_NO_ERR(eRetVal))
+    {
+        eRetVal = eMetricsRtosInit();
+    }
+
+    if (IS_NO_ERR(eRetVal))
+    {
+        eRetVal = ePcapRtosInit();
+    }
+
+    if (IS_NO_ERR(eRetVal))
+    {
+        eRetVal = eDvfsRtosInit();
+    }
+
+    if (IS_NO_ERR(eRetVal))
+    {
+        eRetVal = eFlashLogRtosInit();
+    }
+
+    if (IS_NO_ERR(eRetVal))
+    {
+        eRetVal = eHttpRtosInit();
+    }
+
+    if (IS_NO_ERR(eRetVal))
+    {
+        eRetVal = eWsRtosInit();
+    }
+
+#if MQTT_ENABLED
+    if (IS_NO_ERR(eRetVal))
+    {
+        eRetVal = eMqttRtosInit();
+    }
+#endif
+
     if (IS_NO_ERR(eRetVal))
     {
         eRetVal = eTask1RtosInit();
@@ -187,20 +295,33 @@ void vApplicationMallocFailedHook( void )
     internally by FreeRTOS API functions that create tasks, queues, software
     timers, and semaphores.  The size of the FreeRTOS heap is set by the
     configTOTAL_HEAP_SIZE configuration constant in FreeRTOSConfig.h. */
-    panic("malloc failed");
+    panic("malloc failed");   // Recorded by vCrashLogPanic()
+}
+
+void vApplicationIdleHook( void )
+{
+    /* Called in the loop of the idle task, configUSE_IDLE_HOOK is 1. Must not
+    block. */
+    vDvfsIdle();
+    vTicklessIdle();
+}
+
+void vApplicationPassiveIdleHook( void )
+{
+    /* The same for the idle task of the other core (SMP), enabled by
+    configUSE_PASSIVE_IDLE_HOOK. */
+    vDvfsIdle();
+    vTicklessIdle();
 }
 
 void vApplicationStackOverflowHook( TaskHandle_t xTask, char *pcTaskName )
 {
-    ( void ) pcTaskName;
     ( void ) xTask;
 
-    printf ("FATAL: FreeRTOS detected Stack-Overflow!\n");
-
     /* Run time stack overflow checking is performed if
     configconfigCHECK_FOR_STACK_OVERFLOW is defined to 1 or 2.  This hook
     function is called if a stack overflow is detected.  pxCurrentTCB can be
     inspected in the debugger if the task name passed into this function is
-    corrupt. */
-    for( ;; );
+    corrupt. The crash log keeps the name and reboots. */
+    vCrashLogFatal(CrashStackOverflow, pcTaskName, "FreeRTOS detected Stack-Overflow");
 }
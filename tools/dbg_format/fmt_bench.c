@@ -0,0 +1,116 @@
+/** ****************************************************************************
+ * @file   fmt_bench.c
+ *
+ * @author Michael R.
+ *
+ * @brief  Host comparison of the DBG_PR formatter with the libc snprintf
+ *
+ * Checks that the output matches snprintf for the supported subset and
+ * measures the time per call for typical DBG_PR messages.
+ *
+ * <code>
+ * $ cc -O2 -I../../libs/include -o fmt_bench fmt_bench.c ../../libs/lib/global/dbg_format.c
+ * $ ./fmt_bench
+ * </code>
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// Project includes
+#include "global/dbg_format.h"
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+#define BENCH_LOOPS  (1000000UL)
+#define BENCH_BUFFER (128U)
+
+/** Compare one format with snprintf */
+#define CHECK(...)                                                            \
+    do                                                                        \
+    {                                                                         \
+        char caRef[BENCH_BUFFER];                                             \
+        char caOut[BENCH_BUFFER];                                             \
+        snprintf(caRef, sizeof(caRef), __VA_ARGS__);                          \
+        uDbgFormat(caOut, sizeof(caOut), __VA_ARGS__);                        \
+        uChecks++;                                                            \
+        if (0 != strcmp(caRef, caOut))                                        \
+        {                                                                     \
+            printf("MISMATCH %-28s libc \"%s\" dbg \"%s\"\n", #__VA_ARGS__, caRef, caOut); \
+            uFailed++;                                                        \
+        }                                                                     \
+    } while (0)
+
+/** Time both formatters for one format */
+#define TIME(...)                                                             \
+    do                                                                        \
+    {                                                                         \
+        char caOut[BENCH_BUFFER];                                             \
+        double dRef = dNow();                                                 \
+        for (unsigned long i = 0UL; i < BENCH_LOOPS; i++)                     \
+        {                                                                     \
+            snprintf(caOut, sizeof(caOut), __VA_ARGS__);                      \
+            __asm__ volatile("" : : "r"(caOut) : "memory");                   \
+        }                                                                     \
+        dRef = dNow() - dRef;                                                 \
+        double dDbg = dNow();                                                 \
+        for (unsigned long i = 0UL; i < BENCH_LOOPS; i++)                     \
+        {                                                                     \
+            uDbgFormat(caOut, sizeof(caOut), __VA_ARGS__);                    \
+            __asm__ volatile("" : : "r"(caOut) : "memory");                   \
+        }                                                                     \
+        dDbg = dNow() - dDbg;                                                 \
+        printf("%-44.44s %8.1f %8.1f %6.2fx\n", #__VA_ARGS__,                  \
+               dRef * 1e9 / BENCH_LOOPS, dDbg * 1e9 / BENCH_LOOPS, dRef / dDbg); \
+    } while (0)
+
+/* --- Static functions ----------------------------------------------------- */
+
+static double dNow(void)
+{
+    struct timespec sTime;
+
+    clock_gettime(CLOCK_MONOTONIC, &sTime);
+
+    return ((double)sTime.tv_sec + (double)sTime.tv_nsec * 1e-9);
+}
+
+
+int main(void)
+{
+    unsigned long uChecks = 0UL;
+    unsigned long uFailed = 0UL;
+
+    CHECK("%d %i %u", 0, -42, 4000000000U);
+    CHECK("%5d|%-5d|%05d|%+d|% d", 42, 42, -42, 42, 42);
+    CHECK("%x %X %08x %o", 0xdeadbeefU, 0xabcU, 0x12U, 8U);
+    CHECK("%ld %lu %lx", -123456789L, 123456789UL, 0xfffffffUL);
+    CHECK("%lld %llu", -9000000000000000000LL, 18446744073709551615ULL);
+    CHECK("%.3d|%.0d|%8.4d", 7, 0, -12);
+    CHECK("%s|%10s|%-10s|%.3s", "abc", "right", "left", "truncate");
+    CHECK("%c%c%3c", 'a', 'b', 'c');
+    CHECK("%*d|%-*d|%.*s", 6, 1, 6, 2, 2, "xyz");
+    CHECK("%zu %hu %hhd", (size_t)77, (unsigned short)65535, (signed char)-5);
+    CHECK("%f|%.2f|%.0f|%8.3f|%-8.1f|%+.1f", 3.14159, -2.005, 2.5, 1.0005, 0.25, 9.95);
+    CHECK("%.9f %f", 0.000000001, 123456789.125);
+    CHECK("%s C%d %s:%s.%d\e[0m: ", "\e[0;31m-E-", 1, "task1.c", "vTask1Main", 104);
+    CHECK("100%% done");
+
+    printf("%lu of %lu checks passed\n\n", uChecks - uFailed, uChecks);
+
+    printf("%-44s %8s %8s %7s\n", "format (ns per call)", "libc", "dbg", "speedup");
+    TIME("%s C%d %s:%s.%d\e[0m: ", "\e[0;31m-E-", 1, "task1.c", "vTask1Main", 104);
+    TIME("Ping %02d:%02d:%02d!\n", 12, 34, 56);
+    TIME("Connect to %s:%d failed\n", "mqtt.local", 1883);
+    TIME("Heap %lu bytes, addr %08lx\n", 123456UL, 0x20001234UL);
+    TIME("Temperature %.2f C\n", 23.456);
+
+    return ((0UL == uFailed) ? 0 : 1);
+}
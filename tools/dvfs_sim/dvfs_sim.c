@@ -0,0 +1,418 @@
+/** ****************************************************************************
+ * @file   dvfs_sim.c
+ *
+ * @author Michael R.
+ *
+ * @brief  Host simulation of the system clock governor with load traces
+ *
+ * Replays a load trace through the unchanged decision logic of
+ * <code>dvfs_policy.h</code>. A trace has one value per governor period: the
+ * CPU work the busier core has to do in MHz (cycles per second / 10^6),
+ * lines starting with '#' are ignored. Work the current clock can not do in
+ * the period is carried over (backlog), the backlog is the added latency.
+ *
+ * The report shows the transitions, the time per step, the worst backlog and
+ * the dynamic energy (busy * V^2 * f) relative to the fixed full clock.
+ * <code>-t</code> runs the built-in scenarios with their expected behaviour
+ * and exits with 1 if one fails.
+ *
+ * <code>
+ * $ cc -O2 -Wall -I../../libs/include -o dvfs_sim dvfs_sim.c
+ * $ ./dvfs_sim -t
+ * $ ./dvfs_sim [-c full clock MHz] [-u up] [-g target] [-d down periods] [-v] trace.txt
+ * $ ./dvfs_sim -s burst -v
+ * </code>
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Project includes
+#include "global/dvfs_policy.h"
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+#define SIM_STEPS       (4U)
+#define SIM_MAX_PERIODS (100000U)
+#define SIM_PERIOD_MS   (100U)
+
+/* --- Local type/struct definitions ---------------------------------------- */
+
+/**
+ * @brief Result of one run
+ */
+typedef struct sSimResult_tag
+{
+    uint32_t uUp;
+    uint32_t uDown;
+    uint32_t uaPeriods[SIM_STEPS];   ///< Periods spent at each step
+    uint32_t uFinalStep;
+    double dMaxBacklog;              ///< Worst carried over work in periods of the full clock
+    double dEnergy;                  ///< Relative to the full clock
+    double dMeanMhz;
+} sSimResult_t;
+
+/**
+ * @brief Built-in scenario
+ */
+typedef struct sSimScenario_tag
+{
+    const char *cpName;
+    const char *cpExpect;
+    bool (*pfCheck)(const sSimResult_t *const sRes, const uint32_t uPeriods);
+    double (*pfLoad)(const uint32_t uPeriod);
+    uint32_t uPeriods;
+} sSimScenario_t;
+
+/* --- Static variables ----------------------------------------------------- */
+
+/** Same steps and voltages as dvfs.c, the last clock set with -c */
+static uint32_t uaStepKhz[SIM_STEPS] = {48000U, 72000U, 96000U, 150000U};
+static const double daStepVolt[SIM_STEPS] = {1.00, 1.05, 1.05, 1.10};
+
+static sDvfsPolicy_t sPolicy = {DVFS_UP_PERMILLE, DVFS_TARGET_PERMILLE, DVFS_DOWN_PERIODS};
+static double daTrace[SIM_MAX_PERIODS];
+static bool bVerbose = false;
+
+/* --- Static function prototypes ------------------------------------------- */
+
+static void vSimRun(const double *pdLoad, const uint32_t uPeriods, sSimResult_t *const sRes);
+static void vSimReport(const char *cpName, const sSimResult_t *const sRes, const uint32_t uPeriods);
+static uint32_t uSimLoadFile(const char *cpFile);
+static int iSimSelfTest(void);
+
+static double dSimIdle(const uint32_t uPeriod);
+static double dSimBurst(const uint32_t uPeriod);
+static double dSimSteady(const uint32_t uPeriod);
+static double dSimRamp(const uint32_t uPeriod);
+static double dSimFlicker(const uint32_t uPeriod);
+static double dSimOverload(const uint32_t uPeriod);
+
+static bool bSimCheckIdle(const sSimResult_t *const sRes, const uint32_t uPeriods);
+static bool bSimCheckBurst(const sSimResult_t *const sRes, const uint32_t uPeriods);
+static bool bSimCheckSteady(const sSimResult_t *const sRes, const uint32_t uPeriods);
+static bool bSimCheckRamp(const sSimResult_t *const sRes, const uint32_t uPeriods);
+static bool bSimCheckFlicker(const sSimResult_t *const sRes, const uint32_t uPeriods);
+static bool bSimCheckOverload(const sSimResult_t *const sRes, const uint32_t uPeriods);
+
+static const sSimScenario_t saScenario[] =
+{
+    {"idle",     "steps down to the lowest clock after the down periods",  bSimCheckIdle,     dSimIdle,     100U},
+    {"burst",    "full clock in the period after a burst starts, backlog < 2 periods", bSimCheckBurst, dSimBurst, 200U},
+    {"steady",   "settles on the lowest step under the target, no oscillation", bSimCheckSteady, dSimSteady, 200U},
+    {"ramp",     "follows a slow ramp up and down step by step",          bSimCheckRamp,     dSimRamp,     400U},
+    {"flicker",  "short dips do not step down (hysteresis)",              bSimCheckFlicker,  dSimFlicker,  200U},
+    {"overload", "stays at the full clock while overloaded",              bSimCheckOverload, dSimOverload, 100U},
+};
+
+#define SIM_SCENARIOS (sizeof(saScenario) / sizeof(saScenario[0]))
+
+/* --- Public functions ----------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+    const char *cpScenario = NULL;
+    sSimResult_t sRes;
+    uint32_t uPeriods = 0U;
+    int iOpt;
+    int iRet = 0;
+
+    while (-1 != (iOpt = getopt(argc, argv, "c:u:g:d:s:tvh")))
+    {
+        switch (iOpt)
+        {
+        case 'c': uaStepKhz[SIM_STEPS - 1U] = (uint32_t)atoi(optarg) * 1000U; break;
+        case 'u': sPolicy.uUpPermille       = (uint32_t)atoi(optarg); break;
+        case 'g': sPolicy.uTargetPermille   = (uint32_t)atoi(optarg); break;
+        case 'd': sPolicy.uDownPeriods      = (uint32_t)atoi(optarg); break;
+        case 's': cpScenario = optarg; break;
+        case 'v': bVerbose = true; break;
+        case 't': return (iSimSelfTest());
+        default:
+            fprintf(stderr, "Usage: %s [-c full clock MHz (150)] [-u up (%u)] [-g target (%u)] "
+                            "[-d down periods (%u)] [-v] (-t | -s scenario | trace.txt)\n",
+                    argv[0], (unsigned)DVFS_UP_PERMILLE, (unsigned)DVFS_TARGET_PERMILLE, (unsigned)DVFS_DOWN_PERIODS);
+            return (2);
+        }
+    }
+
+    if (NULL != cpScenario)
+    {
+        iRet = 2;
+        for (uint32_t i = 0U; i < SIM_SCENARIOS; i++)
+        {
+            if (0 == strcmp(cpScenario, saScenario[i].cpName))
+            {
+                uPeriods = saScenario[i].uPeriods;
+                for (uint32_t j = 0U; j < uPeriods; j++)
+                {
+                    daTrace[j] = saScenario[i].pfLoad(j);
+                }
+                iRet = 0;
+            }
+        }
+    }
+    else if (optind < argc)
+    {
+        uPeriods = uSimLoadFile(argv[optind]);
+        iRet = (0U == uPeriods) ? 2 : 0;
+    }
+    else
+    {
+        iRet = 2;
+    }
+
+    if (0 != iRet)
+    {
+        fprintf(stderr, "No trace: give a file, -s idle|burst|steady|ramp|flicker|overload or -t\n");
+    }
+    else
+    {
+        vSimRun(daTrace, uPeriods, &sRes);
+        vSimReport((NULL != cpScenario) ? cpScenario : argv[optind], &sRes, uPeriods);
+    }
+
+    return (iRet);
+}
+
+/* --- Static functions ----------------------------------------------------- */
+
+static void vSimRun(const double *pdLoad, const uint32_t uPeriods, sSimResult_t *const sRes)
+{
+    sDvfsDecision_t sState = {SIM_STEPS - 1U, 0U};
+    const double dFullMhz = (double)uaStepKhz[SIM_STEPS - 1U] / 1000.0;
+    double dBacklog = 0.0;
+    double dWork;
+    double dDone;
+    double dMhz;
+    double dFullEnergy = 0.0;
+    double dSumMhz = 0.0;
+    uint32_t uBusy;
+    uint32_t uStep;
+
+    memset(sRes, 0, sizeof(*sRes));
+
+    for (uint32_t i = 0U; i < uPeriods; i++)
+    {
+        uStep = sState.uStep;
+        dMhz = (double)uaStepKhz[uStep] / 1000.0;
+
+        dWork = pdLoad[i] + dBacklog;
+        dDone = (dWork < dMhz) ? dWork : dMhz;
+        dBacklog = dWork - dDone;
+        uBusy = (uint32_t)((dDone * 1000.0 / dMhz) + 0.5);
+
+        // Energy ~ C * V^2 * cycles, the same work at the full clock as reference
+        sRes->dEnergy += dDone * daStepVolt[uStep] * daStepVolt[uStep];
+        dFullEnergy += pdLoad[i] * daStepVolt[SIM_STEPS - 1U] * daStepVolt[SIM_STEPS - 1U];
+        dSumMhz += dMhz;
+        sRes->uaPeriods[uStep]++;
+        if ((dBacklog / dFullMhz) > sRes->dMaxBacklog)
+        {
+            sRes->dMaxBacklog = dBacklog / dFullMhz;
+        }
+
+        (void)uDvfsDecide(&sState, &sPolicy, uaStepKhz, SIM_STEPS, uBusy);
+
+        if (sState.uStep > uStep)
+        {
+            sRes->uUp++;
+        }
+        else if (sState.uStep < uStep)
+        {
+            sRes->uDown++;
+        }
+
+        if (bVerbose)
+        {
+            printf("%5u load %7.1f MHz  clock %4.0f MHz  busy %4u  backlog %6.1f  -> %u MHz\n",
+                   i, pdLoad[i], dMhz, uBusy, dBacklog, uaStepKhz[sState.uStep] / 1000U);
+        }
+    }
+
+    sRes->uFinalStep = sState.uStep;
+    sRes->dMeanMhz = (0U != uPeriods) ? (dSumMhz / uPeriods) : 0.0;
+    if (dFullEnergy > 0.0)
+    {
+        sRes->dEnergy /= dFullEnergy;
+    }
+}
+
+
+static void vSimReport(const char *cpName, const sSimResult_t *const sRes, const uint32_t uPeriods)
+{
+    printf("%s: %u periods of %u ms, policy up %u target %u down %u\n",
+           cpName, uPeriods, SIM_PERIOD_MS, sPolicy.uUpPermille, sPolicy.uTargetPermille, sPolicy.uDownPeriods);
+    printf("  transitions      %u up, %u down\n", sRes->uUp, sRes->uDown);
+    for (uint32_t i = 0U; i < SIM_STEPS; i++)
+    {
+        printf("  %4u MHz         %5.1f %%\n", uaStepKhz[i] / 1000U,
+               (0U != uPeriods) ? (100.0 * sRes->uaPeriods[i] / uPeriods) : 0.0);
+    }
+    printf("  mean clock       %.1f MHz\n", sRes->dMeanMhz);
+    printf("  worst backlog    %.1f ms of full clock work\n", sRes->dMaxBacklog * SIM_PERIOD_MS);
+    printf("  dynamic energy   %.1f %% of the fixed full clock\n", sRes->dEnergy * 100.0);
+}
+
+
+static uint32_t uSimLoadFile(const char *cpFile)
+{
+    FILE *pFile = fopen(cpFile, "r");
+    char caLine[128];
+    uint32_t uPeriods = 0U;
+
+    if (NULL == pFile)
+    {
+        perror(cpFile);
+    }
+    else
+    {
+        while ((uPeriods < SIM_MAX_PERIODS) && (NULL != fgets(caLine, sizeof(caLine), pFile)))
+        {
+            if (('#' != caLine[0]) && ('\n' != caLine[0]))
+            {
+                daTrace[uPeriods++] = atof(caLine);
+            }
+        }
+        fclose(pFile);
+    }
+
+    return (uPeriods);
+}
+
+
+static int iSimSelfTest(void)
+{
+    sSimResult_t sRes;
+    uint32_t uFailed = 0U;
+    bool bOk;
+
+    for (uint32_t i = 0U; i < SIM_SCENARIOS; i++)
+    {
+        for (uint32_t j = 0U; j < saScenario[i].uPeriods; j++)
+        {
+            daTrace[j] = saScenario[i].pfLoad(j);
+        }
+
+        vSimRun(daTrace, saScenario[i].uPeriods, &sRes);
+        bOk = saScenario[i].pfCheck(&sRes, saScenario[i].uPeriods);
+        uFailed += bOk ? 0U : 1U;
+
+        printf("%-4s %-9s %s\n", bOk ? "ok" : "FAIL", saScenario[i].cpName, saScenario[i].cpExpect);
+        if (!bOk)
+        {
+            vSimReport(saScenario[i].cpName, &sRes, saScenario[i].uPeriods);
+        }
+    }
+
+    printf("%u of %u scenarios passed\n", (uint32_t)SIM_SCENARIOS - uFailed, (uint32_t)SIM_SCENARIOS);
+
+    return ((0U == uFailed) ? 0 : 1);
+}
+
+
+static double dSimIdle(const uint32_t uPeriod)
+{
+    (void)uPeriod;
+
+    return (3.0);
+}
+
+
+static double dSimBurst(const uint32_t uPeriod)
+{
+    // 1 s of heavy work every 10 s on an idle background
+    return (((uPeriod % 100U) >= 50U) && ((uPeriod % 100U) < 60U) ? 140.0 : 3.0);
+}
+
+
+static double dSimSteady(const uint32_t uPeriod)
+{
+    (void)uPeriod;
+
+    // 55 % busy at 72 MHz, 41 % at 96 MHz
+    return (40.0);
+}
+
+
+static double dSimRamp(const uint32_t uPeriod)
+{
+    const uint32_t uPos = (uPeriod < 200U) ? uPeriod : (400U - uPeriod);
+
+    return (2.0 + (double)uPos * 0.5);
+}
+
+
+static double dSimFlicker(const uint32_t uPeriod)
+{
+    // Medium load with a short dip every 4th period
+    return ((0U == (uPeriod % 4U)) ? 5.0 : 70.0);
+}
+
+
+static double dSimOverload(const uint32_t uPeriod)
+{
+    (void)uPeriod;
+
+    return (200.0);
+}
+
+
+static bool bSimCheckIdle(const sSimResult_t *const sRes, const uint32_t uPeriods)
+{
+    // Lowest step within (down periods + 1) per step, then no more changes
+    return ((0U == sRes->uFinalStep) && (0U == sRes->uUp) && (sRes->uDown <= (SIM_STEPS - 1U)) &&
+            (sRes->uaPeriods[0] >= (uPeriods - (sPolicy.uDownPeriods + 1U) * SIM_STEPS)));
+}
+
+
+static bool bSimCheckBurst(const sSimResult_t *const sRes, const uint32_t uPeriods)
+{
+    (void)uPeriods;
+
+    // One jump up per burst, the backlog stays below two periods
+    return ((2U == sRes->uUp) && (sRes->dMaxBacklog < 2.0) && (sRes->dEnergy < 1.0));
+}
+
+
+static bool bSimCheckSteady(const sSimResult_t *const sRes, const uint32_t uPeriods)
+{
+    (void)uPeriods;
+
+    // 40 MHz of work: 72 MHz would be 555 per mille, under the target
+    return ((1U == sRes->uFinalStep) && (0U == sRes->uUp) && (sRes->uDown <= 2U));
+}
+
+
+static bool bSimCheckRamp(const sSimResult_t *const sRes, const uint32_t uPeriods)
+{
+    (void)uPeriods;
+
+    // Every step is visited, no ping-pong between neighbours
+    return ((0U == sRes->uFinalStep) && (sRes->uUp <= 6U) && (sRes->uDown <= 8U) &&
+            (0U != sRes->uaPeriods[1]) && (0U != sRes->uaPeriods[2]));
+}
+
+
+static bool bSimCheckFlicker(const sSimResult_t *const sRes, const uint32_t uPeriods)
+{
+    (void)uPeriods;
+
+    // The dips are shorter than the down periods
+    return ((0U == sRes->uDown) && (0U == sRes->uUp));
+}
+
+
+static bool bSimCheckOverload(const sSimResult_t *const sRes, const uint32_t uPeriods)
+{
+    return ((SIM_STEPS - 1U == sRes->uFinalStep) && (uPeriods == sRes->uaPeriods[SIM_STEPS - 1U]));
+}
@@ -0,0 +1,721 @@
+/** ****************************************************************************
+ * @file   log_collector.c
+ *
+ * @author Michael R.
+ *
+ * @brief  Host collector for the UDP log stream of many devices (Linux)
+ *
+ * One receiver thread reads the socket in batches (recvmmsg) and hands the
+ * datagrams to a pool of worker threads. A device (source IP) is always
+ * handled by the same worker, so its lines stay in order and the workers
+ * need no locks for the per-device state. Workers decompress
+ * (HOST_LOG_COMPRESS), optionally strip the colour codes and write either to
+ * one rotating file per device or to stdout with the IP in front.
+ *
+ * Statistics on stderr: datagrams/s, lines/s, queue drops (workers too slow)
+ * and socket drops (receiver too slow, SO_RXQ_OVFL).
+ *
+ * <code>
+ * $ cc -O2 -pthread -I../../libs/include -o log_collector log_collector.c ../../libs/lib/global/log_lz.c
+ * $ ./log_collector [-p port] [-g group] [-w workers] [-o dir] [-s MB] [-k files] [-S] [-i s] [-t s]
+ * </code>
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+#define _GNU_SOURCE
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+// Project includes
+#include "global/log_lz.h"
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+/** Datagrams per recvmmsg call */
+#define COLL_BATCH       (64U)
+
+/** Largest datagram (firmware sends at most 1400 bytes) */
+#define COLL_DATAGRAM    (2048U)
+
+/** Queued datagrams per worker (power of 2) */
+#define COLL_QUEUE       (4096U)
+
+/** Devices per worker (power of 2) */
+#define COLL_DEVICES     (1024U)
+
+#define COLL_MAX_WORKERS (64U)
+
+/** Output buffer of a worker for the stdout mode */
+#define COLL_OUT_SIZE    (256U * 1024U)
+
+/** Open files are flushed at least this often */
+#define COLL_FLUSH_MS    (1000U)
+
+#define COLL_PATH_SIZE   (512U)
+
+/* --- Local type/struct definitions ---------------------------------------- */
+
+typedef struct sCollMsg_tag
+{
+    uint32_t uAddr;                         ///< Source IP (network order)
+    uint16_t uLen;
+    uint8_t uaData[COLL_DATAGRAM];
+} sCollMsg_t;
+
+typedef struct sCollDevice_tag
+{
+    uint32_t uAddr;                         ///< 0 = unused entry
+    FILE *pFile;
+    uint64_t uSize;                         ///< Bytes in the current file
+} sCollDevice_t;
+
+typedef struct sCollWorker_tag
+{
+    pthread_t xThread;
+    pthread_mutex_t xMutex;
+    pthread_cond_t xCond;
+    sCollMsg_t *saQueue;
+    uint32_t uHead;                         ///< Next slot to process (worker)
+    uint32_t uTail;                         ///< Next slot to fill (receiver)
+    sCollDevice_t saDevice[COLL_DEVICES];
+    char caText[LOG_LZ_BLOCK + 1U];
+    char *cpOut;
+    uint32_t uOutPos;
+
+    atomic_uint_fast64_t uDatagrams;
+    atomic_uint_fast64_t uLines;
+    atomic_uint_fast64_t uBytes;
+    atomic_uint_fast64_t uDropped;          ///< Queue full
+    atomic_uint_fast64_t uCorrupt;
+    atomic_uint_fast32_t uDevices;
+} sCollWorker_t;
+
+typedef struct sCollConf_tag
+{
+    uint16_t uPort;
+    const char *cpGroup;
+    uint32_t uWorkers;
+    const char *cpDir;                      ///< NULL = stdout
+    uint64_t uRotateBytes;
+    uint32_t uKeep;
+    bool bStrip;
+    uint32_t uIntervalS;
+    uint32_t uRunS;                         ///< 0 = until SIGINT
+    int iRcvBuf;
+} sCollConf_t;
+
+/* --- Static variables ----------------------------------------------------- */
+
+static sCollConf_t sConf =
+{
+    .uPort        = 54323U,
+    .cpGroup      = NULL,
+    .uWorkers     = 4U,
+    .cpDir        = NULL,
+    .uRotateBytes = 64ULL * 1024ULL * 1024ULL,
+    .uKeep        = 4U,
+    .bStrip       = false,
+    .uIntervalS   = 5U,
+    .uRunS        = 0U,
+    .iRcvBuf      = 16 * 1024 * 1024,
+};
+
+static sCollWorker_t *saWorker;
+static atomic_bool bStop = false;           ///< Receiver stops
+static atomic_bool bDone = false;           ///< Workers stop once their queue is empty
+static atomic_uint_fast32_t uSocketDrops = 0U;
+
+/* --- Static function prototypes ------------------------------------------- */
+
+static void vCollSignal(int iSignal);
+static void *pvCollReceiver(void *pvArg);
+static void *pvCollWorker(void *pvArg);
+static void vCollProcess(sCollWorker_t *const sWorker, const sCollMsg_t *const sMsg);
+static sCollDevice_t *sCollDevice(sCollWorker_t *const sWorker, const uint32_t uAddr);
+static void vCollOpen(sCollDevice_t *const sDevice);
+static void vCollRotate(sCollDevice_t *const sDevice);
+static uint32_t uCollStrip(char *const cpText, const uint32_t uLen);
+static void vCollFlushOut(sCollWorker_t *const sWorker);
+static uint64_t uCollNowMs(void);
+static void vCollUsage(const char *cpName);
+
+/* --- Public functions ----------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+    struct sigaction sAction;
+    pthread_t xReceiver;
+    uint64_t uStartMs;
+    uint64_t uLastMs;
+    uint64_t uNowMs;
+    uint64_t uLast[2] = {0U, 0U};
+    uint64_t uTotal[5];
+    uint32_t uDevices;
+    int iOpt;
+
+    while (-1 != (iOpt = getopt(argc, argv, "p:g:w:o:s:k:Si:t:b:h")))
+    {
+        switch (iOpt)
+        {
+        case 'p': sConf.uPort        = (uint16_t)atoi(optarg); break;
+        case 'g': sConf.cpGroup      = optarg; break;
+        case 'w': sConf.uWorkers     = (uint32_t)atoi(optarg); break;
+        case 'o': sConf.cpDir        = optarg; break;
+        case 's': sConf.uRotateBytes = strtoull(optarg, NULL, 10) * 1024ULL * 1024ULL; break;
+        case 'k': sConf.uKeep        = (uint32_t)atoi(optarg); break;
+        case 'S': sConf.bStrip       = true; break;
+        case 'i': sConf.uIntervalS   = (uint32_t)atoi(optarg); break;
+        case 't': sConf.uRunS        = (uint32_t)atoi(optarg); break;
+        case 'b': sConf.iRcvBuf      = atoi(optarg); break;
+        default:  vCollUsage(argv[0]); return (2);
+        }
+    }
+
+    if ((0U == sConf.uWorkers) || (sConf.uWorkers > COLL_MAX_WORKERS) || (0U == sConf.uIntervalS))
+    {
+        vCollUsage(argv[0]);
+        return (2);
+    }
+
+    if ((NULL != sConf.cpDir) && (0 != mkdir(sConf.cpDir, 0755)) && (EEXIST != errno))
+    {
+        perror(sConf.cpDir);
+        return (1);
+    }
+
+    memset(&sAction, 0, sizeof(sAction));
+    sAction.sa_handler = vCollSignal;        // No SA_RESTART: recvmmsg returns
+    sigaction(SIGINT, &sAction, NULL);
+    sigaction(SIGTERM, &sAction, NULL);
+
+    saWorker = calloc(sConf.uWorkers, sizeof(sCollWorker_t));
+    for (uint32_t i = 0U; i < sConf.uWorkers; i++)
+    {
+        saWorker[i].saQueue = malloc(COLL_QUEUE * sizeof(sCollMsg_t));
+        saWorker[i].cpOut = malloc(COLL_OUT_SIZE);
+        pthread_mutex_init(&saWorker[i].xMutex, NULL);
+        pthread_cond_init(&saWorker[i].xCond, NULL);
+        pthread_create(&saWorker[i].xThread, NULL, pvCollWorker, &saWorker[i]);
+    }
+
+    pthread_create(&xReceiver, NULL, pvCollReceiver, NULL);
+
+    uStartMs = uCollNowMs();
+    uLastMs = uStartMs;
+
+    while (!atomic_load(&bStop))
+    {
+        usleep(100U * 1000U);
+        uNowMs = uCollNowMs();
+
+        if ((0U != sConf.uRunS) && ((uNowMs - uStartMs) >= (sConf.uRunS * 1000ULL)))
+        {
+            atomic_store(&bStop, true);
+        }
+
+        if (((uNowMs - uLastMs) >= (sConf.uIntervalS * 1000ULL)) || atomic_load(&bStop))
+        {
+            memset(uTotal, 0, sizeof(uTotal));
+            uDevices = 0U;
+            for (uint32_t i = 0U; i < sConf.uWorkers; i++)
+            {
+                uTotal[0] += atomic_load(&saWorker[i].uDatagrams);
+                uTotal[1] += atomic_load(&saWorker[i].uLines);
+                uTotal[2] += atomic_load(&saWorker[i].uBytes);
+                uTotal[3] += atomic_load(&saWorker[i].uDropped);
+                uTotal[4] += atomic_load(&saWorker[i].uCorrupt);
+                uDevices  += (uint32_t)atomic_load(&saWorker[i].uDevices);
+            }
+
+            fprintf(stderr,
+                    "%u devices, %.0f datagrams/s, %.0f lines/s, %.1f MB total, "
+                    "%llu queue drops, %u socket drops, %llu corrupt\n",
+                    uDevices,
+                    (double)(uTotal[0] - uLast[0]) * 1000.0 / (double)(uNowMs - uLastMs + 1U),
+                    (double)(uTotal[1] - uLast[1]) * 1000.0 / (double)(uNowMs - uLastMs + 1U),
+                    (double)uTotal[2] / 1e6,
+                    (unsigned long long)uTotal[3],
+                    (unsigned)atomic_load(&uSocketDrops),
+                    (unsigned long long)uTotal[4]);
+
+            uLast[0] = uTotal[0];
+            uLast[1] = uTotal[1];
+            uLastMs = uNowMs;
+        }
+    }
+
+    pthread_join(xReceiver, NULL);
+    atomic_store(&bDone, true);
+
+    for (uint32_t i = 0U; i < sConf.uWorkers; i++)
+    {
+        pthread_mutex_lock(&saWorker[i].xMutex);
+        pthread_cond_signal(&saWorker[i].xCond);
+        pthread_mutex_unlock(&saWorker[i].xMutex);
+        pthread_join(saWorker[i].xThread, NULL);
+    }
+
+    return (0);
+}
+
+/* --- Static functions ----------------------------------------------------- */
+
+static void vCollSignal(int iSignal)
+{
+    (void)iSignal;
+    atomic_store(&bStop, true);
+}
+
+
+static void *pvCollReceiver(void *pvArg)
+{
+    static uint8_t uaBuffer[COLL_BATCH][COLL_DATAGRAM];
+    static uint8_t uaControl[COLL_BATCH][CMSG_SPACE(sizeof(uint32_t))];
+    struct mmsghdr saMsg[COLL_BATCH];
+    struct iovec saIov[COLL_BATCH];
+    struct sockaddr_in saFrom[COLL_BATCH];
+    struct sockaddr_in sAddr;
+    struct ip_mreq sMreq;
+    struct timeval sTimeout = {0, 200 * 1000};
+    struct cmsghdr *sCmsg;
+    sCollWorker_t *sWorker;
+    uint32_t uaTarget[COLL_BATCH];
+    uint32_t uDrops;
+    int iSocket;
+    int iOne = 1;
+    int iCount;
+
+    (void)pvArg;
+
+    iSocket = socket(AF_INET, SOCK_DGRAM, 0);
+    setsockopt(iSocket, SOL_SOCKET, SO_REUSEADDR, &iOne, sizeof(iOne));
+    setsockopt(iSocket, SOL_SOCKET, SO_RXQ_OVFL, &iOne, sizeof(iOne));
+    setsockopt(iSocket, SOL_SOCKET, SO_RCVTIMEO, &sTimeout, sizeof(sTimeout));
+
+    // Above rmem_max only with CAP_NET_ADMIN
+    if (0 != setsockopt(iSocket, SOL_SOCKET, SO_RCVBUFFORCE, &sConf.iRcvBuf, sizeof(sConf.iRcvBuf)))
+    {
+        setsockopt(iSocket, SOL_SOCKET, SO_RCVBUF, &sConf.iRcvBuf, sizeof(sConf.iRcvBuf));
+    }
+
+    memset(&sAddr, 0, sizeof(sAddr));
+    sAddr.sin_family = AF_INET;
+    sAddr.sin_port = htons(sConf.uPort);
+    sAddr.sin_addr.s_addr = htonl(INADDR_ANY);
+
+    if (0 != bind(iSocket, (struct sockaddr *)&sAddr, sizeof(sAddr)))
+    {
+        perror("bind");
+        atomic_store(&bStop, true);
+    }
+
+    if (NULL != sConf.cpGroup)
+    {
+        sMreq.imr_multiaddr.s_addr = inet_addr(sConf.cpGroup);
+        sMreq.imr_interface.s_addr = htonl(INADDR_ANY);
+        if (0 != setsockopt(iSocket, IPPROTO_IP, IP_ADD_MEMBERSHIP, &sMreq, sizeof(sMreq)))
+        {
+            perror("IP_ADD_MEMBERSHIP");
+        }
+    }
+
+    while (!atomic_load(&bStop))
+    {
+        for (uint32_t i = 0U; i < COLL_BATCH; i++)
+        {
+            saIov[i].iov_base = uaBuffer[i];
+            saIov[i].iov_len = COLL_DATAGRAM;
+            memset(&saMsg[i].msg_hdr, 0, sizeof(saMsg[i].msg_hdr));
+            saMsg[i].msg_hdr.msg_iov = &saIov[i];
+            saMsg[i].msg_hdr.msg_iovlen = 1U;
+            saMsg[i].msg_hdr.msg_name = &saFrom[i];
+            saMsg[i].msg_hdr.msg_namelen = sizeof(saFrom[i]);
+            saMsg[i].msg_hdr.msg_control = uaControl[i];
+            saMsg[i].msg_hdr.msg_controllen = sizeof(uaControl[i]);
+        }
+
+        // Block for the first datagram, then take what is already there
+        iCount = recvmmsg(iSocket, saMsg, COLL_BATCH, MSG_WAITFORONE, NULL);
+
+        for (int i = 0; i < iCount; i++)
+        {
+            for (sCmsg = CMSG_FIRSTHDR(&saMsg[i].msg_hdr); NULL != sCmsg; sCmsg = CMSG_NXTHDR(&saMsg[i].msg_hdr, sCmsg))
+            {
+                if ((SOL_SOCKET == sCmsg->cmsg_level) && (SO_RXQ_OVFL == sCmsg->cmsg_type))
+                {
+                    memcpy(&uDrops, CMSG_DATA(sCmsg), sizeof(uDrops));
+                    atomic_store(&uSocketDrops, uDrops);
+                }
+            }
+
+            uaTarget[i] = (ntohl(saFrom[i].sin_addr.s_addr) * 2654435761U) % sConf.uWorkers;
+        }
+
+        // One lock and wake-up per worker and batch
+        for (int i = 0; i < iCount; i++)
+        {
+            if (UINT32_MAX != uaTarget[i])
+            {
+                sWorker = &saWorker[uaTarget[i]];
+                pthread_mutex_lock(&sWorker->xMutex);
+
+                for (int j = i; j < iCount; j++)
+                {
+                    if (uaTarget[j] != uaTarget[i])
+                    {
+                        continue;
+                    }
+
+                    if ((sWorker->uTail - sWorker->uHead) < COLL_QUEUE)
+                    {
+                        sCollMsg_t *const sMsg = &sWorker->saQueue[sWorker->uTail & (COLL_QUEUE - 1U)];
+
+                        sMsg->uAddr = saFrom[j].sin_addr.s_addr;
+                        sMsg->uLen = (uint16_t)saMsg[j].msg_len;
+                        memcpy(sMsg->uaData, uaBuffer[j], saMsg[j].msg_len);
+                        sWorker->uTail++;
+                    }
+                    else
+                    {
+                        atomic_fetch_add(&sWorker->uDropped, 1U);
+                    }
+
+                    if (j != i)
+                    {
+                        uaTarget[j] = UINT32_MAX;
+                    }
+                }
+
+                pthread_cond_signal(&sWorker->xCond);
+                pthread_mutex_unlock(&sWorker->xMutex);
+            }
+        }
+    }
+
+    close(iSocket);
+
+    return (NULL);
+}
+
+
+static void *pvCollWorker(void *pvArg)
+{
+    sCollWorker_t *const sWorker = pvArg;
+    struct timespec sUntil;
+    uint64_t uFlushMs = uCollNowMs() + COLL_FLUSH_MS;
+    uint32_t uHead;
+    uint32_t uTail;
+    bool bRun = true;
+
+    while (bRun)
+    {
+        pthread_mutex_lock(&sWorker->xMutex);
+        while ((sWorker->uHead == sWorker->uTail) && !atomic_load(&bDone) && (uCollNowMs() < uFlushMs))
+        {
+            clock_gettime(CLOCK_REALTIME, &sUntil);
+            sUntil.tv_nsec += 100L * 1000L * 1000L;
+            if (sUntil.tv_nsec >= 1000000000L)
+            {
+                sUntil.tv_sec++;
+                sUntil.tv_nsec -= 1000000000L;
+            }
+            pthread_cond_timedwait(&sWorker->xCond, &sWorker->xMutex, &sUntil);
+        }
+        uHead = sWorker->uHead;
+        uTail = sWorker->uTail;
+        bRun = !(atomic_load(&bDone) && (uHead == uTail));
+        pthread_mutex_unlock(&sWorker->xMutex);
+
+        // The receiver does not touch the slots between head and tail
+        for (uint32_t i = uHead; i != uTail; i++)
+        {
+            vCollProcess(sWorker, &sWorker->saQueue[i & (COLL_QUEUE - 1U)]);
+        }
+
+        pthread_mutex_lock(&sWorker->xMutex);
+        sWorker->uHead = uTail;
+        pthread_mutex_unlock(&sWorker->xMutex);
+
+        vCollFlushOut(sWorker);
+
+        if ((uCollNowMs() >= uFlushMs) || !bRun)
+        {
+            uFlushMs = uCollNowMs() + COLL_FLUSH_MS;
+            for (uint32_t i = 0U; i < COLL_DEVICES; i++)
+            {
+                if (NULL != sWorker->saDevice[i].pFile)
+                {
+                    fflush(sWorker->saDevice[i].pFile);
+                }
+            }
+            fflush(stdout);
+        }
+    }
+
+    for (uint32_t i = 0U; i < COLL_DEVICES; i++)
+    {
+        if (NULL != sWorker->saDevice[i].pFile)
+        {
+            fclose(sWorker->saDevice[i].pFile);
+        }
+    }
+
+    return (NULL);
+}
+
+
+static void vCollProcess(sCollWorker_t *const sWorker, const sCollMsg_t *const sMsg)
+{
+    sCollDevice_t *const sDevice = sCollDevice(sWorker, sMsg->uAddr);
+    char caAddr[INET_ADDRSTRLEN];
+    uint32_t uLen = 0U;
+    uint32_t uStart = 0U;
+    uint32_t uLines = 0U;
+    int32_t iRaw;
+
+    // Compressed datagram: 00 'Z' <raw length>, a text datagram never starts with 0
+    if ((sMsg->uLen >= 4U) && (0U == sMsg->uaData[0]) && ('Z' == sMsg->uaData[1]))
+    {
+        iRaw = iLogLzDecode(&sMsg->uaData[4], (uint16_t)(sMsg->uLen - 4U),
+                            (uint8_t *)sWorker->caText, LOG_LZ_BLOCK);
+
+        if ((iRaw >= 0) && (iRaw == (((int32_t)sMsg->uaData[2] << 8) | sMsg->uaData[3])))
+        {
+            uLen = (uint32_t)iRaw;
+        }
+        else
+        {
+            atomic_fetch_add(&sWorker->uCorrupt, 1U);
+        }
+    }
+    else
+    {
+        uLen = (sMsg->uLen < LOG_LZ_BLOCK) ? sMsg->uLen : LOG_LZ_BLOCK;
+        memcpy(sWorker->caText, sMsg->uaData, uLen);
+    }
+
+    if (sConf.bStrip)
+    {
+        uLen = uCollStrip(sWorker->caText, uLen);
+    }
+
+    for (uint32_t i = 0U; i < uLen; i++)
+    {
+        uLines += ('\n' == sWorker->caText[i]) ? 1U : 0U;
+    }
+
+    atomic_fetch_add(&sWorker->uDatagrams, 1U);
+    atomic_fetch_add(&sWorker->uLines, uLines);
+    atomic_fetch_add(&sWorker->uBytes, uLen);
+
+    if ((0U == uLen) || (NULL == sDevice))
+    {
+        // Corrupt, empty or too many devices
+    }
+    else if (NULL != sConf.cpDir)
+    {
+        if (NULL == sDevice->pFile)
+        {
+            vCollOpen(sDevice);
+        }
+        else if (sDevice->uSize >= sConf.uRotateBytes)
+        {
+            vCollRotate(sDevice);
+        }
+
+        if (NULL != sDevice->pFile)
+        {
+            fwrite(sWorker->caText, 1U, uLen, sDevice->pFile);
+            sDevice->uSize += uLen;
+        }
+    }
+    else
+    {
+        // Every line with the source in front, written in one piece per batch
+        inet_ntop(AF_INET, &sMsg->uAddr, caAddr, sizeof(caAddr));
+        for (uint32_t i = 0U; i < uLen; i++)
+        {
+            if (('\n' == sWorker->caText[i]) || ((i + 1U) == uLen))
+            {
+                if ((sWorker->uOutPos + INET_ADDRSTRLEN + 2U + (i + 1U - uStart)) > COLL_OUT_SIZE)
+                {
+                    vCollFlushOut(sWorker);
+                }
+                sWorker->uOutPos += (uint32_t)sprintf(&sWorker->cpOut[sWorker->uOutPos], "%s ", caAddr);
+                memcpy(&sWorker->cpOut[sWorker->uOutPos], &sWorker->caText[uStart], i + 1U - uStart);
+                sWorker->uOutPos += i + 1U - uStart;
+                if ('\n' != sWorker->caText[i])
+                {
+                    sWorker->cpOut[sWorker->uOutPos++] = '\n';
+                }
+                uStart = i + 1U;
+            }
+        }
+    }
+}
+
+
+static sCollDevice_t *sCollDevice(sCollWorker_t *const sWorker, const uint32_t uAddr)
+{
+    uint32_t uIndex = (uAddr * 2654435761U) & (COLL_DEVICES - 1U);
+    sCollDevice_t *sDevice = NULL;
+
+    for (uint32_t i = 0U; (i < COLL_DEVICES) && (NULL == sDevice); i++)
+    {
+        sCollDevice_t *const sEntry = &sWorker->saDevice[(uIndex + i) & (COLL_DEVICES - 1U)];
+
+        if (0U == sEntry->uAddr)
+        {
+            sEntry->uAddr = uAddr;
+            sDevice = sEntry;
+            atomic_fetch_add(&sWorker->uDevices, 1U);
+        }
+        else if (uAddr == sEntry->uAddr)
+        {
+            sDevice = sEntry;
+        }
+    }
+
+    return (sDevice);
+}
+
+
+static void vCollOpen(sCollDevice_t *const sDevice)
+{
+    char caPath[COLL_PATH_SIZE];
+    char caAddr[INET_ADDRSTRLEN];
+    struct stat sStat;
+
+    inet_ntop(AF_INET, &sDevice->uAddr, caAddr, sizeof(caAddr));
+    snprintf(caPath, sizeof(caPath), "%s/%s.log", sConf.cpDir, caAddr);
+
+    sDevice->pFile = fopen(caPath, "a");
+    sDevice->uSize = (0 == stat(caPath, &sStat)) ? (uint64_t)sStat.st_size : 0U;
+
+    if (NULL == sDevice->pFile)
+    {
+        perror(caPath);
+    }
+    else
+    {
+        setvbuf(sDevice->pFile, NULL, _IOFBF, 64U * 1024U);
+    }
+}
+
+
+static void vCollRotate(sCollDevice_t *const sDevice)
+{
+    char caFrom[COLL_PATH_SIZE];
+    char caTo[COLL_PATH_SIZE];
+    char caAddr[INET_ADDRSTRLEN];
+
+    fclose(sDevice->pFile);
+    sDevice->pFile = NULL;
+
+    // <ip>.log.<keep - 1> is dropped, the others move up by one
+    inet_ntop(AF_INET, &sDevice->uAddr, caAddr, sizeof(caAddr));
+    for (uint32_t i = sConf.uKeep; i > 1U; i--)
+    {
+        snprintf(caFrom, sizeof(caFrom), "%s/%s.log.%u", sConf.cpDir, caAddr, i - 2U);
+        snprintf(caTo, sizeof(caTo), "%s/%s.log.%u", sConf.cpDir, caAddr, i - 1U);
+        rename(caFrom, caTo);
+    }
+
+    snprintf(caFrom, sizeof(caFrom), "%s/%s.log", sConf.cpDir, caAddr);
+    if (0U == sConf.uKeep)
+    {
+        unlink(caFrom);
+    }
+    else
+    {
+        snprintf(caTo, sizeof(caTo), "%s/%s.log.0", sConf.cpDir, caAddr);
+        rename(caFrom, caTo);
+    }
+
+    vCollOpen(sDevice);
+}
+
+
+static uint32_t uCollStrip(char *const cpText, const uint32_t uLen)
+{
+    uint32_t uOut = 0U;
+    uint32_t i = 0U;
+
+    // Drop ESC '[' ... 'm' (SGR colour codes)
+    while (i < uLen)
+    {
+        if (('\x1b' == cpText[i]) && ((i + 1U) < uLen) && ('[' == cpText[i + 1U]))
+        {
+            i += 2U;
+            while ((i < uLen) && ('m' != cpText[i]) && ('\n' != cpText[i]))
+            {
+                i++;
+            }
+            i += ((i < uLen) && ('m' == cpText[i])) ? 1U : 0U;
+        }
+        else
+        {
+            cpText[uOut++] = cpText[i++];
+        }
+    }
+
+    return (uOut);
+}
+
+
+static void vCollFlushOut(sCollWorker_t *const sWorker)
+{
+    if (0U != sWorker->uOutPos)
+    {
+        // One call per block, stdio locks the stream, so the lines of
+        // different workers do not mix
+        fwrite(sWorker->cpOut, 1U, sWorker->uOutPos, stdout);
+        sWorker->uOutPos = 0U;
+    }
+}
+
+
+static uint64_t uCollNowMs(void)
+{
+    struct timespec sNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+
+    return (((uint64_t)sNow.tv_sec * 1000U) + ((uint64_t)sNow.tv_nsec / 1000000U));
+}
+
+
+static void vCollUsage(const char *cpName)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  -p port     UDP port (54323)\n"
+            "  -g group    join multicast group\n"
+            "  -w workers  worker threads (4, max %u)\n"
+            "  -o dir      one file per device in dir (default stdout)\n"
+            "  -s MB       rotate files at this size (64)\n"
+            "  -k files    rotated files kept per device (4)\n"
+            "  -S          strip the colour codes\n"
+            "  -i s        statistics interval (5)\n"
+            "  -t s        stop after s seconds (0 = SIGINT)\n"
+            "  -b bytes    socket receive buffer (16 MB)\n",
+            cpName, COLL_MAX_WORKERS);
+}
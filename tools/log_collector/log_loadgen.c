@@ -0,0 +1,275 @@
+/** ****************************************************************************
+ * @file   log_loadgen.c
+ *
+ * @author Michael R.
+ *
+ * @brief  Synthetic DBG_PR traffic of many devices for the log collector
+ *
+ * Every simulated device sends lines in the format of the firmware
+ * (sequence number and time stamp of HOST_LOG_SEQ, colour, core, file,
+ * function, line, text) from its own source address. On the loopback
+ * interface the devices use 127.0.1.1, 127.0.1.2, ... so the collector sees
+ * them as different devices. -z compresses like HOST_LOG_COMPRESS, -l puts
+ * several lines into one plain datagram.
+ *
+ * <code>
+ * $ cc -O2 -I../../libs/include -o log_loadgen log_loadgen.c ../../libs/lib/global/log_lz.c
+ * $ ./log_collector -o /tmp/logs -i 1 &
+ * $ ./log_loadgen [-a addr] [-p port] [-d devices] [-r lines/s] [-t s] [-l lines] [-z]
+ * </code>
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+#define _GNU_SOURCE
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+// Project includes
+#include "global/log_lz.h"
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+/** Same values as the firmware (tcp_udp.h) */
+#define GEN_DATAGRAM  (1400U)
+#define GEN_HEADER    (4U)
+#define GEN_LINE      (160U)
+
+#define GEN_BATCH     (64U)
+#define GEN_MAX_DEV   (1024U)
+
+/* --- Local type/struct definitions ---------------------------------------- */
+
+typedef struct sGenDevice_tag
+{
+    int iSocket;
+    uint32_t uSeq;
+    uint32_t uRand;
+} sGenDevice_t;
+
+/* --- Static variables ----------------------------------------------------- */
+
+/** Typical messages of the framework, the numbers are randomised */
+static const char *const caGenMsg[] =
+{
+    "\x1b[0;32m-I- C0 wlan.c:vWlanTask.204\x1b[0m: connected\n",
+    "\x1b[0;32m-I- C1 task1.c:vTask1Main.83\x1b[0m: Ping %02u:%02u:%02u!\n",
+    "\x1b[0;37m-D- C0 tcp_udp.c:vTcpUdpPrintUdp.470\x1b[0m: queued %u bytes\n",
+    "\x1b[0;33m-W- C1 mqtt_client.c:vMqttTask.312\x1b[0m: Connect to mqtt.local:1883 failed\n",
+    "\x1b[0;37m-D- C1 telemetry.c:vTelemetryTask.140\x1b[0m: channel %u value %u.%03u\n",
+    "\x1b[0;31m-E- C0 http_server.c:vHttpStart.330\x1b[0m: Listen on port %u failed!\n",
+    "\x1b[0;32m-I- C0 mysntp.c:vSntpSetSystemTime.88\x1b[0m: time set %u\n",
+    "\x1b[0;37m---\x1b[0m last message repeated %u times\n",
+};
+
+#define GEN_NUM_MSG (sizeof(caGenMsg) / sizeof(caGenMsg[0]))
+
+static sGenDevice_t saDevice[GEN_MAX_DEV];
+static sLogLz_t sLz;
+
+/* --- Static function prototypes ------------------------------------------- */
+
+static uint32_t uGenLine(sGenDevice_t *const sDevice, char *const cpLine);
+static uint64_t uGenNowUs(void);
+
+/* --- Public functions ----------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+    static uint8_t uaBuffer[GEN_BATCH][GEN_DATAGRAM];
+    struct mmsghdr saMsg[GEN_BATCH];
+    struct iovec saIov[GEN_BATCH];
+    struct sockaddr_in sTarget;
+    struct sockaddr_in sSource;
+    const char *cpAddr = "127.0.0.1";
+    char caLine[GEN_LINE];
+    uint16_t uPort = 54323U;
+    uint32_t uDevices = 16U;
+    uint32_t uRate = 0U;
+    uint32_t uRunS = 5U;
+    uint32_t uLines = 1U;
+    bool bCompress = false;
+    bool bLoopback;
+    uint64_t uStartUs;
+    uint64_t uNowUs;
+    uint64_t uSentLines = 0U;
+    uint64_t uSentDatagrams = 0U;
+    uint64_t uSentBytes = 0U;
+    uint32_t uLen;
+    uint32_t uPos;
+    uint32_t uRaw;
+    uint32_t uInBatch;
+    int iSent;
+    int iOpt;
+
+    while (-1 != (iOpt = getopt(argc, argv, "a:p:d:r:t:l:zh")))
+    {
+        switch (iOpt)
+        {
+        case 'a': cpAddr    = optarg; break;
+        case 'p': uPort     = (uint16_t)atoi(optarg); break;
+        case 'd': uDevices  = (uint32_t)atoi(optarg); break;
+        case 'r': uRate     = (uint32_t)atoi(optarg); break;
+        case 't': uRunS     = (uint32_t)atoi(optarg); break;
+        case 'l': uLines    = (uint32_t)atoi(optarg); break;
+        case 'z': bCompress = true; break;
+        default:
+            fprintf(stderr, "Usage: %s [-a addr] [-p port] [-d devices (16)] [-r lines/s, 0 = max] "
+                            "[-t s (5)] [-l lines per datagram (1)] [-z compress]\n", argv[0]);
+            return (2);
+        }
+    }
+
+    if ((0U == uDevices) || (uDevices > GEN_MAX_DEV) || (0U == uLines))
+    {
+        fprintf(stderr, "1 to %u devices, at least one line per datagram\n", GEN_MAX_DEV);
+        return (2);
+    }
+
+    memset(&sTarget, 0, sizeof(sTarget));
+    sTarget.sin_family = AF_INET;
+    sTarget.sin_port = htons(uPort);
+    inet_pton(AF_INET, cpAddr, &sTarget.sin_addr);
+    bLoopback = (127U == (ntohl(sTarget.sin_addr.s_addr) >> 24U));
+
+    for (uint32_t i = 0U; i < uDevices; i++)
+    {
+        saDevice[i].iSocket = socket(AF_INET, SOCK_DGRAM, 0);
+        saDevice[i].uRand = 0x9E3779B9U * (i + 1U);
+
+        // Own source address per device on the loopback interface
+        if (bLoopback)
+        {
+            memset(&sSource, 0, sizeof(sSource));
+            sSource.sin_family = AF_INET;
+            sSource.sin_addr.s_addr = htonl(0x7F000101U + i);
+            bind(saDevice[i].iSocket, (struct sockaddr *)&sSource, sizeof(sSource));
+        }
+    }
+
+    uStartUs = uGenNowUs();
+    uNowUs = uStartUs;
+
+    while ((uNowUs - uStartUs) < (uRunS * 1000000ULL))
+    {
+        for (uint32_t uDev = 0U; uDev < uDevices; uDev++)
+        {
+            // Pace the total rate over all devices
+            if (0U != uRate)
+            {
+                while (((uSentLines * 1000000ULL) / uRate) > (uGenNowUs() - uStartUs))
+                {
+                    usleep(200U);
+                }
+            }
+
+            for (uInBatch = 0U; uInBatch < GEN_BATCH; uInBatch++)
+            {
+                if (bCompress)
+                {
+                    // Fill a block like the firmware does until the next line does not fit
+                    vLogLzReset(&sLz, &uaBuffer[uInBatch][GEN_HEADER], GEN_DATAGRAM - GEN_HEADER);
+                    for (uint32_t i = 0U; i < uLines; i++)
+                    {
+                        uLen = uGenLine(&saDevice[uDev], caLine);
+                        if (!bLogLzAppend(&sLz, caLine, (uint16_t)uLen))
+                        {
+                            saDevice[uDev].uSeq--;
+                            break;
+                        }
+                        uSentLines++;
+                    }
+                    uRaw = uLogLzRawLen(&sLz);
+                    uaBuffer[uInBatch][0] = 0U;
+                    uaBuffer[uInBatch][1] = 'Z';
+                    uaBuffer[uInBatch][2] = (uint8_t)(uRaw >> 8U);
+                    uaBuffer[uInBatch][3] = (uint8_t)uRaw;
+                    uPos = GEN_HEADER + sLz.uOutPos;
+                }
+                else
+                {
+                    uPos = 0U;
+                    for (uint32_t i = 0U; (i < uLines) && ((uPos + GEN_LINE) <= GEN_DATAGRAM); i++)
+                    {
+                        uPos += uGenLine(&saDevice[uDev], (char *)&uaBuffer[uInBatch][uPos]);
+                        uSentLines++;
+                    }
+                }
+
+                saIov[uInBatch].iov_base = uaBuffer[uInBatch];
+                saIov[uInBatch].iov_len = uPos;
+                memset(&saMsg[uInBatch].msg_hdr, 0, sizeof(saMsg[uInBatch].msg_hdr));
+                saMsg[uInBatch].msg_hdr.msg_iov = &saIov[uInBatch];
+                saMsg[uInBatch].msg_hdr.msg_iovlen = 1U;
+                saMsg[uInBatch].msg_hdr.msg_name = &sTarget;
+                saMsg[uInBatch].msg_hdr.msg_namelen = sizeof(sTarget);
+                uSentBytes += uPos;
+
+                // With a rate limit one datagram per device and round
+                if (0U != uRate)
+                {
+                    uInBatch++;
+                    break;
+                }
+            }
+
+            iSent = sendmmsg(saDevice[uDev].iSocket, saMsg, uInBatch, 0);
+            uSentDatagrams += (iSent > 0) ? (uint64_t)iSent : 0U;
+        }
+
+        uNowUs = uGenNowUs();
+    }
+
+    fprintf(stderr,
+            "%u devices: %llu lines in %llu datagrams (%.1f MB) in %.2f s = %.0f lines/s, %.0f datagrams/s\n",
+            uDevices,
+            (unsigned long long)uSentLines,
+            (unsigned long long)uSentDatagrams,
+            (double)uSentBytes / 1e6,
+            (double)(uNowUs - uStartUs) / 1e6,
+            (double)uSentLines * 1e6 / (double)(uNowUs - uStartUs),
+            (double)uSentDatagrams * 1e6 / (double)(uNowUs - uStartUs));
+
+    return (0);
+}
+
+/* --- Static functions ----------------------------------------------------- */
+
+static uint32_t uGenLine(sGenDevice_t *const sDevice, char *const cpLine)
+{
+    uint32_t uPos;
+
+    // xorshift32, cheap and good enough for the message mix
+    sDevice->uRand ^= sDevice->uRand << 13U;
+    sDevice->uRand ^= sDevice->uRand >> 17U;
+    sDevice->uRand ^= sDevice->uRand << 5U;
+
+    uPos = (uint32_t)snprintf(cpLine, GEN_LINE, "#%u@%llu ", sDevice->uSeq++,
+                              (unsigned long long)(time(NULL) * 1000000ULL + (sDevice->uRand % 1000000U)));
+    uPos += (uint32_t)snprintf(&cpLine[uPos], GEN_LINE - uPos, caGenMsg[sDevice->uRand % GEN_NUM_MSG],
+                               sDevice->uRand % 24U, sDevice->uRand % 60U, (sDevice->uRand >> 8U) % 60U);
+
+    return ((uPos < GEN_LINE) ? uPos : (GEN_LINE - 1U));
+}
+
+
+static uint64_t uGenNowUs(void)
+{
+    struct timespec sNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+
+    return (((uint64_t)sNow.tv_sec * 1000000U) + ((uint64_t)sNow.tv_nsec / 1000U));
+}
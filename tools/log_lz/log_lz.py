@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""Receiver/decompressor for the compressed log stream (HOST_LOG_COMPRESS).
+
+A compressed datagram starts with the header 00 'Z' <raw length, 16 bit BE>
+followed by the LZSS data (see libs/include/global/log_lz.h). Plain text
+datagrams are passed through, so the tool works with both settings.
+
+    $ ./log_lz.py --port 54323
+    $ ./log_lz.py --file blocks.bin      decode the output of lz_bench
+"""
+
+import argparse
+import signal
+import socket
+import struct
+import sys
+
+HEADER = struct.Struct(">BcH")
+
+# Must match caLogLzDict in libs/lib/global/log_lz.c (zero padded to 128)
+DICT = (
+    b"failed!\n connected\n"
+    b"\x1b[0;37m---\x1b[0;37m-D- C1 \x1b[0;33m-W- C1 \x1b[0;31m-E- C1 "
+    b".c:vTask.c:eWlan\x1b[0;32m-I- C0 \x1b[0m: \n"
+).ljust(128, b"\0")
+
+
+class DecodeError(Exception):
+    pass
+
+
+def decompress(data, raw_len=None):
+    """Decompress one LZSS block (without the datagram header)."""
+    out = bytearray(DICT)
+    pos = 0
+    while pos < len(data):
+        flags = data[pos]
+        pos += 1
+        for bit in range(8):
+            if pos >= len(data):
+                break
+            if flags & (1 << bit):
+                out.append(data[pos])
+                pos += 1
+            else:
+                if pos + 1 >= len(data):
+                    raise DecodeError("truncated match")
+                token = (data[pos] << 8) | data[pos + 1]
+                pos += 2
+                dist = (token >> 4) + 1
+                length = (token & 0x0F) + 3
+                start = len(out) - dist
+                if start < 0:
+                    raise DecodeError(f"distance {dist} out of window")
+                for i in range(length):
+                    out.append(out[start + i])
+
+    text = bytes(out[len(DICT):])
+    if raw_len is not None and raw_len != len(text):
+        raise DecodeError(f"length mismatch {len(text)} != {raw_len}")
+    return text
+
+
+def decode_datagram(data):
+    """Returns the log text of one datagram (compressed or plain)."""
+    if len(data) >= HEADER.size and data[0] == 0 and data[1:2] == b"Z":
+        _, _, raw_len = HEADER.unpack_from(data)
+        return decompress(data[HEADER.size:], raw_len)
+    return data
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--port", type=int, default=54323, help="UDP port")
+    parser.add_argument("--group", help="multicast group to join")
+    parser.add_argument("--file", help="length prefixed blocks written by lz_bench")
+    args = parser.parse_args()
+
+    if args.file:
+        with open(args.file, "rb") as handle:
+            blob = handle.read()
+        pos = 0
+        while pos < len(blob):
+            (size,) = struct.unpack_from(">H", blob, pos)
+            sys.stdout.buffer.write(decode_datagram(blob[pos + 2:pos + 2 + size]))
+            pos += 2 + size
+        return
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    sock.bind(("", args.port))
+    if args.group:
+        mreq = struct.pack("4s4s", socket.inet_aton(args.group), socket.inet_aton("0.0.0.0"))
+        sock.setsockopt(socket.IPPROTO_IP, socket.IP_ADD_MEMBERSHIP, mreq)
+
+    wire = 0
+    text = 0
+
+    def report(*_):
+        if text:
+            print(f"\n{wire} bytes received, {text} bytes text, ratio {text / max(wire, 1):.2f}",
+                  file=sys.stderr)
+        sys.exit(0)
+
+    signal.signal(signal.SIGINT, report)
+
+    while True:
+        data, _ = sock.recvfrom(2048)
+        try:
+            line = decode_datagram(data)
+        except DecodeError as exc:
+            print(f"-- corrupt datagram: {exc}", file=sys.stderr)
+            continue
+        wire += len(data)
+        text += len(line)
+        sys.stdout.write(line.decode(errors="replace"))
+        sys.stdout.flush()
+
+
+if __name__ == "__main__":
+    main()
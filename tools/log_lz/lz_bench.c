@@ -0,0 +1,184 @@
+/** ****************************************************************************
+ * @file   lz_bench.c
+ *
+ * @author Michael R.
+ *
+ * @brief  Host benchmark of the log compressor on a captured log
+ *
+ * Feeds the capture line by line into the same code and block size as the
+ * firmware (HOST_LOG_COMPRESS) and reports the compression ratio and the CPU
+ * time per kB of log text. The blocks can be written to a file to check them
+ * with <code>log_lz.py --file</code>. -n limits the lines per datagram, this
+ * models a slow log rate where the flush timer sends partially filled blocks.
+ *
+ * <code>
+ * $ cc -O2 -I../../libs/include -o lz_bench lz_bench.c ../../libs/lib/global/log_lz.c
+ * $ netcat -lu -p 54323 > capture.log
+ * $ ./lz_bench [-n lines] capture.log [blocks.bin]
+ * </code>
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Project includes
+#include "global/log_lz.h"
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+/** Same values as the firmware (tcp_udp.h) */
+#define BENCH_DATAGRAM   (1400U)
+#define BENCH_HEADER     (4U)
+#define BENCH_LINE       (128U)
+#define BENCH_REPEAT     (20U)
+
+/* --- Static variables ----------------------------------------------------- */
+
+static sLogLz_t sLz;
+static uint8_t uaOut[BENCH_DATAGRAM];
+
+/* --- Static functions ----------------------------------------------------- */
+
+static void vBenchEmit(FILE *pFile, unsigned long *puWire, unsigned long *puBlocks)
+{
+    const uint16_t uLen = sLz.uOutPos + BENCH_HEADER;
+    const uint16_t uRaw = uLogLzRawLen(&sLz);
+
+    if (0U != uRaw)
+    {
+        uaOut[0] = 0U;
+        uaOut[1] = 'Z';
+        uaOut[2] = (uint8_t)(uRaw >> 8U);
+        uaOut[3] = (uint8_t)uRaw;
+
+        if (NULL != pFile)
+        {
+            fputc(uLen >> 8U, pFile);
+            fputc(uLen & 0xFFU, pFile);
+            fwrite(uaOut, 1U, uLen, pFile);
+        }
+
+        *puWire += uLen;
+        (*puBlocks)++;
+    }
+
+    vLogLzReset(&sLz, &uaOut[BENCH_HEADER], BENCH_DATAGRAM - BENCH_HEADER);
+}
+
+
+int main(int argc, char **argv)
+{
+    FILE *pIn;
+    FILE *pOut = NULL;
+    char *cpText;
+    long iSize;
+    unsigned long uWire = 0UL;
+    unsigned long uBlocks = 0UL;
+    unsigned long uLines = 0UL;
+    struct timespec sStart;
+    struct timespec sStop;
+    unsigned long uMaxLines = 0UL;
+    unsigned long uBlockLines = 0UL;
+    double dNs;
+
+    if ((argc > 2) && (0 == strcmp(argv[1], "-n")))
+    {
+        uMaxLines = strtoul(argv[2], NULL, 0);
+        argc -= 2;
+        argv += 2;
+    }
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: lz_bench [-n lines] capture.log [blocks.bin]\n");
+        return (1);
+    }
+
+    pIn = fopen(argv[1], "rb");
+    if (NULL == pIn)
+    {
+        perror(argv[1]);
+        return (1);
+    }
+
+    fseek(pIn, 0L, SEEK_END);
+    iSize = ftell(pIn);
+    rewind(pIn);
+    cpText = malloc((size_t)iSize);
+    if ((NULL == cpText) || (iSize != (long)fread(cpText, 1U, (size_t)iSize, pIn)))
+    {
+        return (1);
+    }
+    fclose(pIn);
+
+    clock_gettime(CLOCK_MONOTONIC, &sStart);
+
+    for (unsigned int uRun = 0U; uRun < BENCH_REPEAT; uRun++)
+    {
+        // Write the blocks of the last run only
+        if ((uRun == (BENCH_REPEAT - 1U)) && (argc > 2))
+        {
+            pOut = fopen(argv[2], "wb");
+        }
+
+        uWire = 0UL;
+        uBlocks = 0UL;
+        uLines = 0UL;
+        uBlockLines = 0UL;
+        vLogLzReset(&sLz, &uaOut[BENCH_HEADER], BENCH_DATAGRAM - BENCH_HEADER);
+
+        for (long iPos = 0L; iPos < iSize; )
+        {
+            // One DBG_PR message: up to and including '\n', at most BENCH_LINE - 1
+            long iLen = 0L;
+            while (((iPos + iLen) < iSize) && (iLen < (long)(BENCH_LINE - 1U)))
+            {
+                if ('\n' == cpText[iPos + iLen++])
+                {
+                    break;
+                }
+            }
+
+            if (((0UL != uMaxLines) && (uBlockLines == uMaxLines)) ||
+                !bLogLzAppend(&sLz, &cpText[iPos], (uint16_t)iLen))
+            {
+                vBenchEmit(pOut, &uWire, &uBlocks);
+                bLogLzAppend(&sLz, &cpText[iPos], (uint16_t)iLen);
+                uBlockLines = 0UL;
+            }
+            uBlockLines++;
+
+            iPos += iLen;
+            uLines++;
+        }
+        vBenchEmit(pOut, &uWire, &uBlocks);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &sStop);
+
+    if (NULL != pOut)
+    {
+        fclose(pOut);
+    }
+
+    dNs = ((double)(sStop.tv_sec - sStart.tv_sec) * 1e9 + (double)(sStop.tv_nsec - sStart.tv_nsec))
+          / BENCH_REPEAT;
+
+    printf("lines        %lu\n", uLines);
+    printf("text         %ld bytes\n", iSize);
+    printf("datagrams    %lu (uncompressed: %lu)\n", uBlocks, uLines);
+    printf("wire         %lu bytes (with %u byte headers)\n", uWire, BENCH_HEADER);
+    printf("ratio        %.2f\n", (double)iSize / (double)uWire);
+    printf("cpu          %.1f us/kB (host)\n", dNs / 1000.0 / ((double)iSize / 1024.0));
+
+    free(cpText);
+
+    return (0);
+}
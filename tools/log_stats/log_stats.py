@@ -0,0 +1,167 @@
+#!/usr/bin/env python3
+"""Loss, reordering and latency of the UDP log stream per device (HOST_LOG_SEQ).
+
+Every record starts with "#<sequence>@<time us> ". The sequence number is
+counted per device, the time is the device's Unix time in us once it has
+synced via SNTP. Latency is the receive time minus the record time, so it
+includes the clock difference of host and device (both should run NTP).
+Plain and compressed (HOST_LOG_COMPRESS) datagrams are accepted.
+
+    $ ./log_stats.py --port 54323 --interval 10
+    $ ./log_stats.py --port 54323 --group 239.255.43.23 --print
+"""
+
+import argparse
+import os
+import re
+import select
+import socket
+import struct
+import sys
+import time
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "log_lz"))
+from log_lz import DecodeError, decode_datagram  # noqa: E402
+
+RECORD = re.compile(rb"^#(\d+)@(\d+) ")
+
+# Device times below this are the uptime (not yet synced)
+TIME_VALID_US = 1_000_000_000 * 1_000_000
+
+# A sequence number this far below the highest one is a restart of the device
+RESTART_GAP = 1000
+
+SEQ_MOD = 1 << 32
+
+
+class Device:
+    """Statistics of one source address."""
+
+    def __init__(self, name):
+        self.name = name
+        self.restarts = 0
+        self.latency = []
+        self.reset()
+
+    def reset(self):
+        self.first = None
+        self.top = 0            # highest offset to the first sequence number
+        self.seen = {}          # offset -> time stamp of the last RESTART_GAP records
+        self.received = 0
+        self.duplicates = 0
+        self.reordered = 0
+
+    def add(self, seq, stamp_us, now_us):
+        if self.first is not None:
+            offset = (seq - self.first) % SEQ_MOD
+            behind = (self.top - offset) % SEQ_MOD
+            known = self.seen.get(offset)
+            # Far behind or the same number with another time: counting restarted
+            if (RESTART_GAP < behind < SEQ_MOD // 2) or (known is not None and known != stamp_us):
+                self.restarts += 1
+                self.reset()
+
+        if self.first is None:
+            self.first = seq
+
+        # Arrived late but older than the first record: move the start back
+        shift = (self.first - seq) % SEQ_MOD
+        if 0 < shift <= RESTART_GAP:
+            self.first = seq
+            self.top += shift
+            self.seen = {k + shift: v for k, v in self.seen.items()}
+
+        offset = (seq - self.first) % SEQ_MOD
+        if offset in self.seen:
+            self.duplicates += 1
+            return
+
+        self.seen[offset] = stamp_us
+        self.received += 1
+        if offset < self.top:
+            self.reordered += 1
+        else:
+            self.top = offset
+
+        if len(self.seen) > 2 * RESTART_GAP:
+            self.seen = {k: v for k, v in self.seen.items() if k + RESTART_GAP >= self.top}
+
+        if stamp_us >= TIME_VALID_US:
+            self.latency.append(now_us - stamp_us)
+
+    def report(self):
+        """Loss since the start (or restart), latency since the last report."""
+        expected = self.top + 1 if self.first is not None else 0
+        lost = expected - self.received
+        loss = 100.0 * lost / expected if expected else 0.0
+        line = (f"{self.name:>15}: {self.received} received, {lost} lost ({loss:.2f} %), "
+                f"{self.reordered} reordered, {self.duplicates} duplicates, {self.restarts} restarts")
+        if self.latency:
+            values = sorted(self.latency)
+
+            def pct(p):
+                return values[min(len(values) - 1, int(p * len(values) / 100))] / 1000.0
+
+            line += (f", latency ms p50 {pct(50):.1f} p95 {pct(95):.1f} "
+                     f"p99 {pct(99):.1f} max {values[-1] / 1000.0:.1f}")
+            self.latency = []
+        else:
+            line += ", latency n/a"
+        return line
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--port", type=int, default=54323, help="UDP port")
+    parser.add_argument("--group", help="multicast group to join")
+    parser.add_argument("--interval", type=float, default=10.0, help="report interval in s")
+    parser.add_argument("--print", action="store_true", help="also print the records")
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 1 << 20)
+    sock.bind(("", args.port))
+    if args.group:
+        mreq = struct.pack("4s4s", socket.inet_aton(args.group), socket.inet_aton("0.0.0.0"))
+        sock.setsockopt(socket.IPPROTO_IP, socket.IP_ADD_MEMBERSHIP, mreq)
+
+    devices = {}
+    unnumbered = 0
+    next_report = time.monotonic() + args.interval
+
+    try:
+        while True:
+            ready, _, _ = select.select([sock], [], [], max(0.0, next_report - time.monotonic()))
+            if ready:
+                data, (addr, _) = sock.recvfrom(2048)
+                now_us = time.time_ns() // 1000
+                try:
+                    text = decode_datagram(data)
+                except DecodeError as exc:
+                    print(f"-- corrupt datagram from {addr}: {exc}", file=sys.stderr)
+                    continue
+
+                device = devices.setdefault(addr, Device(addr))
+                for line in text.splitlines(keepends=True):
+                    match = RECORD.match(line)
+                    if match is None:
+                        unnumbered += 1
+                        continue
+                    device.add(int(match.group(1)), int(match.group(2)), now_us)
+                    if args.print:
+                        sys.stdout.write(f"{addr} {line[match.end():].decode(errors='replace')}")
+
+            if time.monotonic() >= next_report:
+                next_report += args.interval
+                for device in devices.values():
+                    print(device.report(), file=sys.stderr)
+                if unnumbered:
+                    print(f"{unnumbered} records without sequence number (HOST_LOG_SEQ=0?)", file=sys.stderr)
+    except KeyboardInterrupt:
+        for device in devices.values():
+            print(device.report(), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""Remote control of the debug output (see libs/include/wlan/remote_ctrl.h).
+
+A command is sent as HMAC-SHA1(key, text) followed by the text
+"<nonce> <command> [arguments]", the nonce is the Unix time in ms. The
+signed reply "<nonce> ok|err [text]" is checked and printed.
+
+    $ ./log_ctrl.py --host picow --key "$CTRL_KEY" get
+    $ ./log_ctrl.py --host picow level wlan 4
+    $ ./log_ctrl.py --host picow sink udp off
+    $ ./log_ctrl.py --host picow rate all 20 5
+    $ ./log_ctrl.py --host picow stats
+    $ ./log_ctrl.py --host picow dvfs 800 600 5
+    $ ./log_ctrl.py --host picow pcap tcp 80 64
+
+The key may also be given via the environment variable CTRL_KEY.
+"""
+
+import argparse
+import hashlib
+import hmac
+import os
+import socket
+import sys
+import time
+
+DIGEST_SIZE = 20
+
+
+def sign(key, text):
+    """Return the datagram for text."""
+    return hmac.new(key, text, hashlib.sha1).digest() + text
+
+
+def verify(key, datagram):
+    """Return the text of a signed datagram or None if the HMAC is wrong."""
+    mac, text = datagram[:DIGEST_SIZE], datagram[DIGEST_SIZE:]
+    if len(mac) != DIGEST_SIZE:
+        return None
+    if not hmac.compare_digest(mac, hmac.new(key, text, hashlib.sha1).digest()):
+        return None
+    return text
+
+
+def send_command(host, port, key, words, timeout=2.0, retries=3):
+    """Send a command and return the reply text (without nonce)."""
+    with socket.socket(socket.AF_INET, socket.SOCK_DGRAM) as sock:
+        sock.settimeout(timeout)
+        for _ in range(retries):
+            # Every attempt needs a new nonce, the device drops repetitions
+            nonce = str(time.time_ns() // 1000000)
+            sock.sendto(sign(key, " ".join([nonce] + words).encode()), (host, port))
+            try:
+                while True:
+                    datagram, _ = sock.recvfrom(2048)
+                    text = verify(key, datagram)
+                    if text is None:
+                        print("reply with wrong HMAC dropped", file=sys.stderr)
+                        continue
+                    reply_nonce, _, reply = text.decode(errors="replace").partition(" ")
+                    if reply_nonce == nonce:
+                        return reply
+            except socket.timeout:
+                continue
+    return None
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--host", required=True, help="device name or IP")
+    parser.add_argument("--port", type=int, default=54326)
+    parser.add_argument("--key", default=os.environ.get("CTRL_KEY"), help="CTRL_KEY of the device")
+    parser.add_argument("command", nargs="+", help="get | level | sink | rate | stats | dvfs | pcap and arguments")
+    args = parser.parse_args()
+
+    if not args.key:
+        parser.error("no key, use --key or CTRL_KEY")
+
+    reply = send_command(args.host, args.port, args.key.encode(), args.command)
+    if reply is None:
+        print("no reply (wrong key, clock off by more than 30 s or device offline)", file=sys.stderr)
+        return 2
+
+    print(reply)
+    return 0 if reply.startswith("ok") else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
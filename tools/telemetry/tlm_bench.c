@@ -0,0 +1,183 @@
+/** ****************************************************************************
+ * @file   tlm_bench.c
+ *
+ * @author Michael R.
+ *
+ * @brief  Host comparison of the telemetry CBOR encoder with snprintf text
+ *
+ * Checks the encoder against examples of RFC 8949 (Appendix A) and
+ * measures the time and size of a typical record: channel, timestamp, three
+ * integers, two floats and a flag, once as CBOR and once as a text line like
+ * DBG_PR would print it. Absolute numbers say nothing about the RP2xxx, the
+ * ratios do.
+ *
+ * <code>
+ * $ cc -O2 -I../../libs/include -o tlm_bench tlm_bench.c ../../libs/lib/telemetry/tlm_encoder.c
+ * $ ./tlm_bench
+ * </code>
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// Project includes
+#include "telemetry/telemetry.h"
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+#define BENCH_LOOPS  (1000000UL)
+#define BENCH_BUFFER (128U)
+
+/** Encode one item and compare it with the expected bytes */
+#define CHECK(cpExpect, xEncode)                                              \
+    do                                                                        \
+    {                                                                         \
+        uint8_t uaOut[BENCH_BUFFER];                                          \
+        sTlmEncoder_t sEnc;                                                   \
+        vTlmEncInit(&sEnc, uaOut, sizeof(uaOut));                             \
+        xEncode;                                                              \
+        uChecks++;                                                            \
+        if (!bBenchEqual(uaOut, sEnc.uPos, cpExpect))                         \
+        {                                                                     \
+            printf("MISMATCH %-36s expected %s\n", #xEncode, cpExpect);       \
+            uFailed++;                                                        \
+        }                                                                     \
+    } while (0)
+
+/* --- Static variables ----------------------------------------------------- */
+
+// Values of the record, volatile so the compiler cannot fold them
+static volatile uint16_t uBenchChannel = 7U;
+static volatile uint64_t uBenchTimeUs = 1760000000123456ULL;
+static volatile int32_t iaBenchValue[3] = {-40, 1013, 123456};
+static volatile float faBenchValue[2] = {23.456F, 0.5F};
+static volatile int iBenchFlag = 1;
+
+/* --- Static functions ----------------------------------------------------- */
+
+static double dNow(void)
+{
+    struct timespec sTime;
+
+    clock_gettime(CLOCK_MONOTONIC, &sTime);
+
+    return ((double)sTime.tv_sec + (double)sTime.tv_nsec * 1e-9);
+}
+
+
+static int bBenchEqual(const uint8_t *pData, const uint16_t uLen, const char *cpHex)
+{
+    char caHex[2U * BENCH_BUFFER + 1U];
+
+    for (uint16_t i = 0U; i < uLen; i++)
+    {
+        snprintf(&caHex[2U * i], 3U, "%02x", pData[i]);
+    }
+    caHex[2U * uLen] = '\0';
+
+    return (0 == strcmp(caHex, cpHex));
+}
+
+
+static uint16_t uBenchCbor(uint8_t *const pBuf)
+{
+    sTlmEncoder_t sEnc;
+
+    vTlmEncInit(&sEnc, pBuf, BENCH_BUFFER);
+    vTlmEncArray(&sEnc, 8U);
+    vTlmEncUint(&sEnc, uBenchChannel);
+    vTlmEncTimestamp(&sEnc, uBenchTimeUs);
+    vTlmEncInt(&sEnc, iaBenchValue[0]);
+    vTlmEncInt(&sEnc, iaBenchValue[1]);
+    vTlmEncInt(&sEnc, iaBenchValue[2]);
+    vTlmEncFloat(&sEnc, faBenchValue[0]);
+    vTlmEncFloat(&sEnc, faBenchValue[1]);
+    vTlmEncBool(&sEnc, 0 != iBenchFlag);
+
+    return (sEnc.uPos);
+}
+
+
+static uint16_t uBenchText(char *const cpBuf)
+{
+    const uint64_t uTimeUs = uBenchTimeUs;
+    const int iLen = snprintf(
+                        cpBuf,
+                        BENCH_BUFFER,
+                        "ch=%u t=%llu.%06llu a=%ld b=%ld c=%ld x=%.3f y=%.3f ok=%d\n",
+                        (unsigned)uBenchChannel,
+                        (unsigned long long)(uTimeUs / 1000000ULL),
+                        (unsigned long long)(uTimeUs % 1000000ULL),
+                        (long)iaBenchValue[0],
+                        (long)iaBenchValue[1],
+                        (long)iaBenchValue[2],
+                        (double)faBenchValue[0],
+                        (double)faBenchValue[1],
+                        iBenchFlag);
+
+    return ((iLen > 0) ? (uint16_t)iLen : 0U);
+}
+
+
+int main(void)
+{
+    unsigned long uChecks = 0UL;
+    unsigned long uFailed = 0UL;
+    uint8_t uaCbor[BENCH_BUFFER];
+    char caText[BENCH_BUFFER];
+    uint16_t uCborLen = 0U;
+    uint16_t uTextLen = 0U;
+    double dCbor;
+    double dText;
+
+    CHECK("00", vTlmEncUint(&sEnc, 0U));
+    CHECK("17", vTlmEncUint(&sEnc, 23U));
+    CHECK("1818", vTlmEncUint(&sEnc, 24U));
+    CHECK("1903e8", vTlmEncUint(&sEnc, 1000U));
+    CHECK("1a000f4240", vTlmEncUint(&sEnc, 1000000U));
+    CHECK("1b000000e8d4a51000", vTlmEncUint(&sEnc, 1000000000000ULL));
+    CHECK("20", vTlmEncInt(&sEnc, -1));
+    CHECK("3863", vTlmEncInt(&sEnc, -100));
+    CHECK("3903e7", vTlmEncInt(&sEnc, -1000));
+    CHECK("fa47c35000", vTlmEncFloat(&sEnc, 100000.0F));
+    CHECK("f4", vTlmEncBool(&sEnc, false));
+    CHECK("f5", vTlmEncBool(&sEnc, true));
+    CHECK("6449455446", vTlmEncText(&sEnc, "IETF", 4U));
+    CHECK("4401020304", vTlmEncBytes(&sEnc, "\x01\x02\x03\x04", 4U));
+    CHECK("83010203", vTlmEncIntArray(&sEnc, (const int32_t[]){1, 2, 3}, 3U));
+    CHECK("d9d9f7", vTlmEncTag(&sEnc, 55799U));
+    CHECK("d903e9a2011a6553f100251904d2", vTlmEncTimestamp(&sEnc, 1700000000001234ULL));
+    CHECK("", (vTlmEncInit(&sEnc, uaOut, 2U), vTlmEncUint(&sEnc, 1000U)));
+
+    printf("%lu of %lu checks passed\n\n", uChecks - uFailed, uChecks);
+
+    dCbor = dNow();
+    for (unsigned long i = 0UL; i < BENCH_LOOPS; i++)
+    {
+        uCborLen = uBenchCbor(uaCbor);
+        __asm__ volatile("" : : "r"(uaCbor) : "memory");
+    }
+    dCbor = dNow() - dCbor;
+
+    dText = dNow();
+    for (unsigned long i = 0UL; i < BENCH_LOOPS; i++)
+    {
+        uTextLen = uBenchText(caText);
+        __asm__ volatile("" : : "r"(caText) : "memory");
+    }
+    dText = dNow() - dText;
+
+    printf("%-10s %10s %8s\n", "record", "ns/record", "bytes");
+    printf("%-10s %10.1f %8u\n", "cbor", dCbor * 1e9 / BENCH_LOOPS, (unsigned)uCborLen);
+    printf("%-10s %10.1f %8u\n", "snprintf", dText * 1e9 / BENCH_LOOPS, (unsigned)uTextLen);
+    printf("speedup %.2fx, size %.2fx\n", dText / dCbor, (double)uTextLen / (double)uCborLen);
+
+    return ((0UL == uFailed) ? 0 : 1);
+}
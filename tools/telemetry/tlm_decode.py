@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+"""Decoder for the binary telemetry stream (see libs/include/telemetry/telemetry.h).
+
+Each UDP datagram is a CBOR sequence:
+
+    55799([version, board_id, dropped])  header
+    [channel, 1001({1: sec, -6: usec}), field_0, ..., field_n]  records
+
+Usable as library (decode_datagram) or as receiver:
+
+    $ ./tlm_decode.py --port 54324
+"""
+
+import argparse
+import datetime
+import socket
+import struct
+import sys
+
+TAG_SELF_DESCRIBE = 55799
+TAG_EXT_TIME = 1001
+
+
+class Tagged:
+    """CBOR tag which has no special meaning for the decoder."""
+
+    def __init__(self, tag, value):
+        self.tag = tag
+        self.value = value
+
+    def __repr__(self):
+        return f"{self.tag}({self.value!r})"
+
+
+class DecodeError(Exception):
+    pass
+
+
+def _read_argument(buf, pos, info):
+    if info < 24:
+        return info, pos
+    if info == 24:
+        return buf[pos], pos + 1
+    if info == 25:
+        return struct.unpack_from(">H", buf, pos)[0], pos + 2
+    if info == 26:
+        return struct.unpack_from(">I", buf, pos)[0], pos + 4
+    if info == 27:
+        return struct.unpack_from(">Q", buf, pos)[0], pos + 8
+    raise DecodeError(f"unsupported additional info {info} at {pos - 1}")
+
+
+def decode_item(buf, pos=0):
+    """Decode one CBOR item starting at pos. Returns (value, next_pos)."""
+    if pos >= len(buf):
+        raise DecodeError("unexpected end of data")
+
+    major = buf[pos] >> 5
+    info = buf[pos] & 0x1F
+    pos += 1
+
+    if major == 7:
+        if info == 20:
+            return False, pos
+        if info == 21:
+            return True, pos
+        if info == 22:
+            return None, pos
+        if info == 25:
+            return struct.unpack_from(">e", buf, pos)[0], pos + 2
+        if info == 26:
+            return struct.unpack_from(">f", buf, pos)[0], pos + 4
+        if info == 27:
+            return struct.unpack_from(">d", buf, pos)[0], pos + 8
+        raise DecodeError(f"unsupported simple value {info}")
+
+    arg, pos = _read_argument(buf, pos, info)
+
+    if major == 0:
+        return arg, pos
+    if major == 1:
+        return -1 - arg, pos
+    if major == 2:
+        return bytes(buf[pos:pos + arg]), pos + arg
+    if major == 3:
+        return bytes(buf[pos:pos + arg]).decode("utf-8", "replace"), pos + arg
+    if major == 4:
+        items = []
+        for _ in range(arg):
+            item, pos = decode_item(buf, pos)
+            items.append(item)
+        return items, pos
+    if major == 5:
+        items = {}
+        for _ in range(arg):
+            key, pos = decode_item(buf, pos)
+            items[key], pos = decode_item(buf, pos)
+        return items, pos
+
+    # major == 6: tag
+    value, pos = decode_item(buf, pos)
+    if arg == TAG_EXT_TIME and isinstance(value, dict):
+        return value.get(1, 0) * 1000000 + value.get(-6, 0), pos
+    if arg == TAG_SELF_DESCRIBE:
+        return value, pos
+    return Tagged(arg, value), pos
+
+
+def decode_datagram(data):
+    """Decode one datagram. Returns (header dict, list of records).
+
+    A record is a dict with channel, time_us (int) and fields (list).
+    """
+    header, pos = decode_item(data, 0)
+    if not isinstance(header, list) or len(header) != 3:
+        raise DecodeError("missing header record")
+
+    hdr = {
+        "version": header[0],
+        "board_id": header[1].hex(),
+        "dropped": header[2],
+    }
+
+    records = []
+    while pos < len(data):
+        rec, pos = decode_item(data, pos)
+        if not isinstance(rec, list) or len(rec) < 2:
+            raise DecodeError(f"malformed record {rec!r}")
+        records.append({"channel": rec[0], "time_us": rec[1], "fields": rec[2:]})
+
+    return hdr, records
+
+
+def _format_time(time_us):
+    # Devices without SNTP sync report the time since boot
+    if time_us < 10**15:
+        return f"+{time_us / 1e6:.6f}s"
+    stamp = datetime.datetime.fromtimestamp(time_us / 1e6, datetime.timezone.utc)
+    return stamp.isoformat(timespec="microseconds")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--port", type=int, default=54324, help="UDP port")
+    parser.add_argument("--group", help="multicast group to join")
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    sock.bind(("", args.port))
+    if args.group:
+        mreq = socket.inet_aton(args.group) + socket.inet_aton("0.0.0.0")
+        sock.setsockopt(socket.IPPROTO_IP, socket.IP_ADD_MEMBERSHIP, mreq)
+
+    while True:
+        data, (addr, _) = sock.recvfrom(2048)
+        try:
+            hdr, records = decode_datagram(data)
+        except (DecodeError, struct.error, IndexError) as err:
+            print(f"{addr}: {err}", file=sys.stderr)
+            continue
+
+        for rec in records:
+            fields = ", ".join(repr(f) for f in rec["fields"])
+            print(f"{addr} {hdr['board_id']} {_format_time(rec['time_us'])} "
+                  f"ch{rec['channel']}: {fields}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,241 @@
+#!/usr/bin/env python3
+"""Client for the WebSocket stream (see libs/include/http/websocket.h).
+
+Text frames carry the debug output, binary frames the telemetry batches
+(decoded with ../telemetry/tlm_decode.py). Only the standard library is used.
+
+    $ ./ws_stream.py picow                 print log and telemetry
+    $ ./ws_stream.py picow --bench 60      throughput/latency for 60 s
+    $ ./ws_stream.py picow --clients 3 --bench 60 --slow 1
+
+Latency is the difference between the host clock and the timestamp of the
+telemetry records, it is only meaningful if the device is SNTP synced and
+the host clock is NTP synced.
+"""
+
+import argparse
+import base64
+import os
+import socket
+import statistics
+import struct
+import sys
+import threading
+import time
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "telemetry"))
+import tlm_decode  # noqa: E402
+
+OP_TEXT = 0x1
+OP_BINARY = 0x2
+OP_CLOSE = 0x8
+OP_PING = 0x9
+OP_PONG = 0xA
+
+
+class WsClient:
+    """Minimal WebSocket client (RFC 6455), enough for the stream."""
+
+    def __init__(self, host, port, path, timeout=10.0):
+        self.sock = socket.create_connection((host, port), timeout=timeout)
+        self.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        self.buf = b""
+
+        key = base64.b64encode(os.urandom(16)).decode()
+        request = (
+            f"GET {path} HTTP/1.1\r\n"
+            f"Host: {host}:{port}\r\n"
+            "Upgrade: websocket\r\n"
+            "Connection: Upgrade\r\n"
+            f"Sec-WebSocket-Key: {key}\r\n"
+            "Sec-WebSocket-Version: 13\r\n"
+            "\r\n"
+        )
+        self.sock.sendall(request.encode())
+
+        while b"\r\n\r\n" not in self.buf:
+            self._fill()
+        header, self.buf = self.buf.split(b"\r\n\r\n", 1)
+        status = header.split(b"\r\n", 1)[0]
+        if b" 101 " not in status:
+            raise ConnectionError(f"upgrade refused: {status.decode(errors='replace')}")
+
+    def _fill(self):
+        data = self.sock.recv(65536)
+        if not data:
+            raise ConnectionError("connection closed")
+        self.buf += data
+
+    def _take(self, num):
+        while len(self.buf) < num:
+            self._fill()
+        data, self.buf = self.buf[:num], self.buf[num:]
+        return data
+
+    def send(self, opcode, payload=b""):
+        mask = os.urandom(4)
+        header = bytes([0x80 | opcode, 0x80 | len(payload)]) + mask
+        masked = bytes(b ^ mask[i & 3] for i, b in enumerate(payload))
+        self.sock.sendall(header + masked)
+
+    def recv(self):
+        """Returns (opcode, payload) of the next frame."""
+        head = self._take(2)
+        opcode = head[0] & 0x0F
+        length = head[1] & 0x7F
+        if length == 126:
+            length = struct.unpack(">H", self._take(2))[0]
+        elif length == 127:
+            length = struct.unpack(">Q", self._take(8))[0]
+        if head[1] & 0x80:
+            raise ConnectionError("server frames must not be masked")
+        payload = self._take(length)
+        if opcode == OP_PING:
+            self.send(OP_PONG, payload)
+        return opcode, payload
+
+    def close(self):
+        try:
+            self.send(OP_CLOSE, struct.pack(">H", 1000))
+        except OSError:
+            pass
+        self.sock.close()
+
+
+class Stats:
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.frames = 0
+        self.bytes = 0
+        self.text = 0
+        self.records = 0
+        self.dropped_notices = 0
+        self.latency_ms = []
+        self.gaps_ms = []
+
+    def merge(self, other):
+        with self.lock:
+            self.frames += other.frames
+            self.bytes += other.bytes
+            self.text += other.text
+            self.records += other.records
+            self.dropped_notices += other.dropped_notices
+            self.latency_ms += other.latency_ms
+            self.gaps_ms += other.gaps_ms
+
+
+def _percentile(values, pct):
+    if not values:
+        return float("nan")
+    values = sorted(values)
+    return values[min(len(values) - 1, int(len(values) * pct / 100.0))]
+
+
+def run_client(args, duration, slow, stats):
+    local = Stats()
+    client = WsClient(args.host, args.port, args.path)
+    end = time.monotonic() + duration
+    last = None
+
+    try:
+        while time.monotonic() < end:
+            opcode, payload = client.recv()
+            now = time.time()
+            mono = time.monotonic()
+
+            if last is not None:
+                local.gaps_ms.append((mono - last) * 1000.0)
+            last = mono
+            local.frames += 1
+            local.bytes += len(payload)
+
+            if opcode == OP_TEXT:
+                local.text += 1
+                if b"stream: " in payload and b" dropped" in payload:
+                    local.dropped_notices += 1
+            elif opcode == OP_BINARY:
+                _, records = tlm_decode.decode_datagram(payload)
+                local.records += len(records)
+                for rec in records:
+                    if rec["time_us"] > 10**15:
+                        local.latency_ms.append(now * 1000.0 - rec["time_us"] / 1000.0)
+            elif opcode == OP_CLOSE:
+                break
+
+            if slow:
+                # Simulated slow consumer
+                time.sleep(slow)
+    except (ConnectionError, socket.timeout) as exc:
+        print(f"client: {exc}", file=sys.stderr)
+    finally:
+        client.close()
+
+    stats.merge(local)
+
+
+def bench(args):
+    stats = Stats()
+    threads = []
+    for i in range(args.clients):
+        # Only the last client is slow, the others show the isolation
+        slow = args.slow if (args.slow and i == args.clients - 1) else 0
+        thread = threading.Thread(target=run_client, args=(args, args.bench, slow, stats))
+        thread.start()
+        threads.append(thread)
+
+    for thread in threads:
+        thread.join()
+
+    print(f"clients          {args.clients}")
+    print(f"frames           {stats.frames} ({stats.frames / args.bench:.1f}/s)")
+    print(f"throughput       {stats.bytes / args.bench / 1024:.1f} kB/s")
+    print(f"log lines        {stats.text}")
+    print(f"tlm records      {stats.records}")
+    print(f"drop notices     {stats.dropped_notices}")
+    if stats.gaps_ms:
+        print(f"frame gap ms     p50 {_percentile(stats.gaps_ms, 50):.1f}"
+              f"  p99 {_percentile(stats.gaps_ms, 99):.1f}  max {max(stats.gaps_ms):.1f}")
+    if stats.latency_ms:
+        print(f"latency ms       p50 {_percentile(stats.latency_ms, 50):.1f}"
+              f"  p99 {_percentile(stats.latency_ms, 99):.1f}"
+              f"  mean {statistics.mean(stats.latency_ms):.1f}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("host", help="device name or address")
+    parser.add_argument("--port", type=int, default=80, help="HTTP port")
+    parser.add_argument("--path", default="/stream", help="stream path")
+    parser.add_argument("--bench", type=float, metavar="SEC", help="measure instead of printing")
+    parser.add_argument("--clients", type=int, default=1, help="parallel clients (bench)")
+    parser.add_argument("--slow", type=float, default=0.0, metavar="SEC",
+                        help="delay per frame of the last client (bench)")
+    args = parser.parse_args()
+
+    if args.bench:
+        bench(args)
+        return
+
+    client = WsClient(args.host, args.port, args.path)
+    try:
+        while True:
+            opcode, payload = client.recv()
+            if opcode == OP_TEXT:
+                sys.stdout.write(payload.decode(errors="replace"))
+            elif opcode == OP_BINARY:
+                hdr, records = tlm_decode.decode_datagram(payload)
+                for rec in records:
+                    fields = ", ".join(repr(f) for f in rec["fields"])
+                    print(f"[{hdr['board_id']}] ch {rec['channel']} "
+                          f"{tlm_decode._format_time(rec['time_us'])}: {fields}")
+            elif opcode == OP_CLOSE:
+                break
+            sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        client.close()
+
+
+if __name__ == "__main__":
+    main()
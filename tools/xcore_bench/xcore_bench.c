@@ -0,0 +1,356 @@
+/** ****************************************************************************
+ * @file   xcore_bench.c
+ *
+ * @author Michael R.
+ *
+ * @brief  Host benchmark of the SPSC ring of the inter-core channel (Linux)
+ *
+ * Two threads (pinned to different CPUs if there are several) exchange
+ * messages through the unchanged ring of <code>spsc_ring.h</code>:
+ *
+ *  - <b>spin</b>   both sides poll the ring (lower bound)
+ *  - <b>wake</b>   the consumer announces the wait and sleeps on a futex, the
+ *                  producer wakes it only if it waits; the same protocol as
+ *                  vXcoreCommit / pvXcoreReceive with the doorbell
+ *  - <b>queue</b>  mutex + condition variable + copy, comparable to a
+ *                  FreeRTOS queue
+ *
+ * For each a ping-pong round trip (latency percentiles) and a one-way stream
+ * (messages/s) are measured. Absolute numbers say nothing about the RP2xxx,
+ * the ratios between the modes do.
+ *
+ * <code>
+ * $ cc -O2 -pthread -I../../libs/include -o xcore_bench xcore_bench.c
+ * $ ./xcore_bench [-n round trips] [-m stream messages] [-s slot size]
+ * </code>
+ *
+ * @date   2026-10-19
+ **************************************************************************** */
+
+#define _GNU_SOURCE
+
+/* --- Includes ------------------------------------------------------------- */
+
+// libc includes
+#include <limits.h>
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+// Project includes
+#include "global/spsc_ring.h"
+
+/* --- Local macro definitions ---------------------------------------------- */
+
+#define BENCH_SLOTS      (64U)
+#define BENCH_MAX_SLOT   (256U)
+
+/* --- Local type/struct definitions ---------------------------------------- */
+
+typedef enum eBenchMode_tag
+{
+    BenchSpin,
+    BenchWake,
+    BenchQueue,
+    NumBenchMode
+} eBenchMode_t;
+
+/**
+ * @brief One direction: ring + futex wake-up, or the locked queue
+ */
+typedef struct sBenchChan_tag
+{
+    sSpscRing_t sRing;
+    volatile uint32_t uWaiting;     ///< Consumer sleeps (futex word)
+    uint8_t uaSlots[BENCH_SLOTS * BENCH_MAX_SLOT];
+
+    pthread_mutex_t xMutex;         ///< Queue mode only
+    pthread_cond_t xCond;
+    uint8_t uaQueue[BENCH_SLOTS * BENCH_MAX_SLOT];
+    uint32_t uQueueHead;
+    uint32_t uQueueTail;
+} sBenchChan_t;
+
+typedef struct sBenchConf_tag
+{
+    eBenchMode_t eMode;
+    uint32_t uSlotSize;
+    uint32_t uCount;
+    bool bPingPong;
+    uint64_t *puRttNs;
+} sBenchConf_t;
+
+/* --- Static variables ----------------------------------------------------- */
+
+static const char *const caModeName[NumBenchMode] = {"spin", "wake", "queue"};
+
+static sBenchChan_t sPing;
+static sBenchChan_t sPong;
+static sBenchConf_t sConf;
+static uint32_t uCpus;
+
+/* --- Static function prototypes ------------------------------------------- */
+
+static void vBenchChanInit(sBenchChan_t *const sChan);
+static void vBenchSend(sBenchChan_t *const sChan, const uint8_t *pData);
+static void vBenchReceive(sBenchChan_t *const sChan, uint8_t *const pData);
+static void *pvBenchEcho(void *pvArg);
+static void vBenchPin(const uint32_t uCpu);
+static uint64_t uBenchNowNs(void);
+static int iBenchCompare(const void *pvA, const void *pvB);
+
+/* --- Public functions ----------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+    uint32_t uRoundTrips = 100000U;
+    uint32_t uStream = 2000000U;
+    uint8_t uaMsg[BENCH_MAX_SLOT];
+    pthread_t xThread;
+    uint64_t uStartNs;
+    uint64_t uTotalNs;
+    uint64_t *puRtt;
+    int iOpt;
+
+    sConf.uSlotSize = 32U;
+
+    while (-1 != (iOpt = getopt(argc, argv, "n:m:s:h")))
+    {
+        switch (iOpt)
+        {
+        case 'n': uRoundTrips     = (uint32_t)atoi(optarg); break;
+        case 'm': uStream         = (uint32_t)atoi(optarg); break;
+        case 's': sConf.uSlotSize = (uint32_t)atoi(optarg); break;
+        default:
+            fprintf(stderr, "Usage: %s [-n round trips (100000)] [-m stream messages (2000000)] "
+                            "[-s slot size (32)]\n", argv[0]);
+            return (2);
+        }
+    }
+
+    if ((0U == uRoundTrips) || (0U == sConf.uSlotSize) || (sConf.uSlotSize > BENCH_MAX_SLOT))
+    {
+        fprintf(stderr, "At least one round trip, slot size 1 to %u\n", BENCH_MAX_SLOT);
+        return (2);
+    }
+
+    uCpus = (uint32_t)sysconf(_SC_NPROCESSORS_ONLN);
+    puRtt = calloc(uRoundTrips, sizeof(uint64_t));
+    memset(uaMsg, 0x5A, sizeof(uaMsg));
+
+    printf("%u CPUs, %u byte messages%s\n", uCpus, sConf.uSlotSize,
+           (uCpus < 2U) ? " (single CPU: spinning sides yield, latency is scheduler bound)" : "");
+    printf("%-6s %10s %10s %10s %10s %14s\n", "mode", "rtt p50", "rtt p99", "rtt max", "rtt mean", "stream msg/s");
+
+    for (eBenchMode_t eMode = BenchSpin; eMode < NumBenchMode; eMode++)
+    {
+        sConf.eMode = eMode;
+        vBenchPin(0U);
+
+        // Ping-pong: echo thread sends every message back
+        vBenchChanInit(&sPing);
+        vBenchChanInit(&sPong);
+        sConf.bPingPong = true;
+        sConf.uCount = uRoundTrips;
+        pthread_create(&xThread, NULL, pvBenchEcho, NULL);
+
+        for (uint32_t i = 0U; i < uRoundTrips; i++)
+        {
+            uStartNs = uBenchNowNs();
+            vBenchSend(&sPing, uaMsg);
+            vBenchReceive(&sPong, uaMsg);
+            puRtt[i] = uBenchNowNs() - uStartNs;
+        }
+        pthread_join(xThread, NULL);
+
+        // Stream: only the receiving side, no answer
+        vBenchChanInit(&sPing);
+        sConf.bPingPong = false;
+        sConf.uCount = uStream;
+        pthread_create(&xThread, NULL, pvBenchEcho, NULL);
+
+        uStartNs = uBenchNowNs();
+        for (uint32_t i = 0U; i < uStream; i++)
+        {
+            vBenchSend(&sPing, uaMsg);
+        }
+        pthread_join(xThread, NULL);
+        uTotalNs = uBenchNowNs() - uStartNs;
+
+        qsort(puRtt, uRoundTrips, sizeof(uint64_t), iBenchCompare);
+        uStartNs = 0U;
+        for (uint32_t i = 0U; i < uRoundTrips; i++)
+        {
+            uStartNs += puRtt[i];
+        }
+
+        printf("%-6s %8.2fus %8.2fus %8.2fus %8.2fus %14.0f\n",
+               caModeName[eMode],
+               (double)puRtt[uRoundTrips / 2U] / 1e3,
+               (double)puRtt[(uint64_t)uRoundTrips * 99U / 100U] / 1e3,
+               (double)puRtt[uRoundTrips - 1U] / 1e3,
+               (double)uStartNs / (double)uRoundTrips / 1e3,
+               (double)uStream * 1e9 / (double)uTotalNs);
+    }
+
+    free(puRtt);
+
+    return (0);
+}
+
+/* --- Static functions ----------------------------------------------------- */
+
+static void vBenchChanInit(sBenchChan_t *const sChan)
+{
+    vSpscInit(&sChan->sRing, sChan->uaSlots, sConf.uSlotSize, BENCH_SLOTS);
+    sChan->uWaiting = 0U;
+    sChan->uQueueHead = 0U;
+    sChan->uQueueTail = 0U;
+    pthread_mutex_init(&sChan->xMutex, NULL);
+    pthread_cond_init(&sChan->xCond, NULL);
+}
+
+
+static void vBenchSend(sBenchChan_t *const sChan, const uint8_t *pData)
+{
+    void *pvSlot;
+
+    if (BenchQueue == sConf.eMode)
+    {
+        pthread_mutex_lock(&sChan->xMutex);
+        while ((sChan->uQueueHead - sChan->uQueueTail) >= BENCH_SLOTS)
+        {
+            pthread_cond_wait(&sChan->xCond, &sChan->xMutex);
+        }
+        memcpy(&sChan->uaQueue[(sChan->uQueueHead % BENCH_SLOTS) * sConf.uSlotSize], pData, sConf.uSlotSize);
+        sChan->uQueueHead++;
+        pthread_cond_broadcast(&sChan->xCond);
+        pthread_mutex_unlock(&sChan->xMutex);
+    }
+    else
+    {
+        // Full: the firmware would report it, here the sender just waits
+        while (NULL == (pvSlot = pvSpscReserve(&sChan->sRing)))
+        {
+            sched_yield();
+        }
+        memcpy(pvSlot, pData, sConf.uSlotSize);
+        vSpscCommit(&sChan->sRing);
+
+        // Same as vXcoreCommit: ring the bell only for a waiting consumer
+        if (BenchWake == sConf.eMode)
+        {
+            SPSC_BARRIER();
+            if (0U != sChan->uWaiting)
+            {
+                sChan->uWaiting = 0U;
+                syscall(SYS_futex, &sChan->uWaiting, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+            }
+        }
+    }
+}
+
+
+static void vBenchReceive(sBenchChan_t *const sChan, uint8_t *const pData)
+{
+    void *pvSlot;
+
+    if (BenchQueue == sConf.eMode)
+    {
+        pthread_mutex_lock(&sChan->xMutex);
+        while (sChan->uQueueHead == sChan->uQueueTail)
+        {
+            pthread_cond_wait(&sChan->xCond, &sChan->xMutex);
+        }
+        memcpy(pData, &sChan->uaQueue[(sChan->uQueueTail % BENCH_SLOTS) * sConf.uSlotSize], sConf.uSlotSize);
+        sChan->uQueueTail++;
+        pthread_cond_broadcast(&sChan->xCond);
+        pthread_mutex_unlock(&sChan->xMutex);
+    }
+    else
+    {
+        while (NULL == (pvSlot = pvSpscPeek(&sChan->sRing)))
+        {
+            if (BenchWake == sConf.eMode)
+            {
+                // Same as pvXcoreReceive: announce, look again, then sleep
+                sChan->uWaiting = 1U;
+                SPSC_BARRIER();
+                if (NULL == pvSpscPeek(&sChan->sRing))
+                {
+                    syscall(SYS_futex, &sChan->uWaiting, FUTEX_WAIT_PRIVATE, 1, NULL, NULL, 0);
+                }
+                sChan->uWaiting = 0U;
+            }
+            else
+            {
+                sched_yield();
+            }
+        }
+
+        // Used in place, the copy only stands for the work on the data
+        pData[0] = *(uint8_t *)pvSlot;
+        vSpscRelease(&sChan->sRing);
+    }
+}
+
+
+static void *pvBenchEcho(void *pvArg)
+{
+    uint8_t uaMsg[BENCH_MAX_SLOT];
+
+    (void)pvArg;
+
+    vBenchPin(1U);
+
+    for (uint32_t i = 0U; i < sConf.uCount; i++)
+    {
+        vBenchReceive(&sPing, uaMsg);
+        if (sConf.bPingPong)
+        {
+            vBenchSend(&sPong, uaMsg);
+        }
+    }
+
+    return (NULL);
+}
+
+
+static void vBenchPin(const uint32_t uCpu)
+{
+    cpu_set_t xSet;
+
+    if (uCpus > 1U)
+    {
+        CPU_ZERO(&xSet);
+        CPU_SET(uCpu, &xSet);
+        pthread_setaffinity_np(pthread_self(), sizeof(xSet), &xSet);
+    }
+}
+
+
+static uint64_t uBenchNowNs(void)
+{
+    struct timespec sNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+
+    return (((uint64_t)sNow.tv_sec * 1000000000ULL) + (uint64_t)sNow.tv_nsec);
+}
+
+
+static int iBenchCompare(const void *pvA, const void *pvB)
+{
+    const uint64_t uA = *(const uint64_t *)pvA;
+    const uint64_t uB = *(const uint64_t *)pvB;
+
+    return ((uA > uB) - (uA < uB));
+}